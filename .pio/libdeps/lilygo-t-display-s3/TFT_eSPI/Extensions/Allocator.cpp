@@ -0,0 +1,316 @@
+/***************************************************************************************
+** Code for the Sprite arena and pool allocators
+***************************************************************************************/
+
+// Arena allocations are rounded up to 4 bytes so 16 bit access stays aligned
+#define ALLOC_ALIGN(n) (((n) + 3) & ~((size_t)3))
+
+/***************************************************************************************
+** Function name:           spriteSize
+** Description:             Return bytes needed for a Sprite (must match callocSprite)
+***************************************************************************************/
+size_t TFT_eSpriteAllocator::spriteSize(int16_t w, int16_t h, uint8_t bpp, uint8_t frames)
+{
+  if (w < 1 || h < 1) return 0;
+
+  if (frames > 2) frames = 2; // Currently restricted to 2 frame buffers
+  if (frames < 1) frames = 1;
+
+  // One extra "off screen" pixel per frame is included, see callocSprite()
+  if (bpp == 16) return ((size_t)frames * w * h + frames) * sizeof(uint16_t);
+  if (bpp == 8)  return  (size_t)frames * w * h + frames;
+  if (bpp == 4)
+  {
+    w = (w+1) & 0xFFFE;
+    return (((size_t)frames * w * h) >> 1) + frames;
+  }
+  if (bpp == 2)
+  {
+    w = (w+3) & 0xFFFC;
+    return (((size_t)frames * w * h) >> 2) + frames;
+  }
+
+  w = (w+7) & 0xFFF8;
+  return (size_t)frames * (w>>3) * h + frames;
+}
+
+
+/***************************************************************************************
+** Function name:           reserve
+** Description:             Reserve a block of memory for an allocator
+***************************************************************************************/
+uint8_t* TFT_eSpriteAllocator::reserve(size_t bytes, bool psram)
+{
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psram && psramFound() ) return (uint8_t*) ps_malloc(bytes);
+#else
+  (void)psram;
+#endif
+  return (uint8_t*) malloc(bytes);
+}
+
+
+/***************************************************************************************
+** Function name:           TFT_eSpriteArena
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eSpriteArena::TFT_eSpriteArena(void)
+{
+  _base  = nullptr;
+  _size  = 0;
+  _top   = 0;
+  _owned = false;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eSpriteArena
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eSpriteArena::~TFT_eSpriteArena(void)
+{
+  end();
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Reserve an arena block of bytes
+***************************************************************************************/
+bool TFT_eSpriteArena::begin(size_t bytes, bool psram)
+{
+  end();
+
+  uint8_t* ptr = reserve(bytes, psram);
+  if (ptr == nullptr) return false;
+
+  begin(ptr, bytes);
+  _owned = true;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Use a caller supplied buffer (4 byte aligned) as the arena
+***************************************************************************************/
+bool TFT_eSpriteArena::begin(void* buffer, size_t bytes)
+{
+  end();
+
+  if (buffer == nullptr) return false;
+
+  _base  = (uint8_t*)buffer;
+  _size  = bytes;
+  _top   = 0;
+  _owned = false;
+  _used  = 0;
+  _peak  = 0;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           end
+** Description:             Detach the arena and free the block if reserved by begin()
+***************************************************************************************/
+void TFT_eSpriteArena::end(void)
+{
+  if (_owned) free(_base);
+  _base  = nullptr;
+  _size  = 0;
+  _top   = 0;
+  _owned = false;
+  setUsed(0);
+}
+
+
+/***************************************************************************************
+** Function name:           available
+** Description:             Return the largest Sprite memory size that can be allocated
+***************************************************************************************/
+size_t TFT_eSpriteArena::available(void)
+{
+  if (_size - _top < sizeof(uint32_t)) return 0;
+  return (_size - _top - sizeof(uint32_t)) & ~((size_t)3);
+}
+
+
+/***************************************************************************************
+** Function name:           allocate
+** Description:             Allocate zeroed memory from the top of the arena
+***************************************************************************************/
+void* TFT_eSpriteArena::allocate(size_t bytes)
+{
+  // Each allocation is preceded by its rounded size so a delete of the top can unwind
+  size_t size = ALLOC_ALIGN(bytes);
+  if (_base == nullptr || bytes == 0 || size > available()) return nullptr;
+
+  uint8_t* ptr = _base + _top;
+  *(uint32_t*)ptr = size;
+  ptr += sizeof(uint32_t);
+  memset(ptr, 0, size);
+
+  _top += size + sizeof(uint32_t);
+  setUsed(_top);
+  return ptr;
+}
+
+
+/***************************************************************************************
+** Function name:           deallocate
+** Description:             Free the top allocation, others wait for release()
+***************************************************************************************/
+void TFT_eSpriteArena::deallocate(void* ptr)
+{
+  uint8_t* p = (uint8_t*)ptr;
+
+  // Ignore memory outside the allocated part of the arena (e.g. already released)
+  if (p < _base + sizeof(uint32_t) || p >= _base + _top) return;
+
+  size_t size = *(uint32_t*)(p - sizeof(uint32_t));
+  if (p + size != _base + _top) return;
+
+  _top = p - sizeof(uint32_t) - _base;
+  setUsed(_top);
+}
+
+
+/***************************************************************************************
+** Function name:           release
+** Description:             Free everything allocated after the mark
+***************************************************************************************/
+void TFT_eSpriteArena::release(size_t mark)
+{
+  if (mark >= _top) return;
+  _top = mark;
+  setUsed(_top);
+}
+
+
+/***************************************************************************************
+** Function name:           TFT_eSpritePool
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eSpritePool::TFT_eSpritePool(void)
+{
+  _base      = nullptr;
+  _head      = nullptr;
+  _inUse     = nullptr;
+  _blockSize = 0;
+  _count     = 0;
+  _free      = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eSpritePool
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eSpritePool::~TFT_eSpritePool(void)
+{
+  end();
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Reserve count blocks and link them into the free list
+***************************************************************************************/
+bool TFT_eSpritePool::begin(size_t blockSize, uint16_t count, bool psram)
+{
+  end();
+
+  if (blockSize == 0 || count == 0) return false;
+
+  // Blocks must be able to hold an aligned free list pointer
+  blockSize = (blockSize + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+  // The in use bitmap follows the blocks
+  _base = reserve(blockSize * count + ((count + 7) >> 3), psram);
+  if (_base == nullptr) return false;
+
+  _inUse = _base + blockSize * count;
+  memset(_inUse, 0, (count + 7) >> 3);
+
+  _blockSize = blockSize;
+  _count     = count;
+  _free      = count;
+
+  // Link blocks in address order
+  _head = nullptr;
+  for (int32_t i = count - 1; i >= 0; i--) {
+    void** block = (void**)(_base + i * blockSize);
+    *block = _head;
+    _head  = block;
+  }
+
+  _used = 0;
+  _peak = 0;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           end
+** Description:             Free the pool
+***************************************************************************************/
+void TFT_eSpritePool::end(void)
+{
+  free(_base);
+  _base      = nullptr;
+  _head      = nullptr;
+  _inUse     = nullptr;
+  _blockSize = 0;
+  _count     = 0;
+  _free      = 0;
+  setUsed(0);
+}
+
+
+/***************************************************************************************
+** Function name:           allocate
+** Description:             Take a zeroed block from the free list
+***************************************************************************************/
+void* TFT_eSpritePool::allocate(size_t bytes)
+{
+  if (_head == nullptr || bytes == 0 || bytes > _blockSize) return nullptr;
+
+  void** block = (void**)_head;
+  _head = *block;
+  _free--;
+  memset(block, 0, _blockSize);
+
+  size_t i = ((uint8_t*)block - _base) / _blockSize;
+  _inUse[i >> 3] |= 1 << (i & 7);
+
+  setUsed((size_t)(_count - _free) * _blockSize);
+  return block;
+}
+
+
+/***************************************************************************************
+** Function name:           deallocate
+** Description:             Return a block to the free list
+***************************************************************************************/
+void TFT_eSpritePool::deallocate(void* ptr)
+{
+  uint8_t* p = (uint8_t*)ptr;
+
+  // Ignore pointers that are not the start of a pool block
+  if (p < _base || p >= _base + _blockSize * _count) return;
+  if ((p - _base) % _blockSize) return;
+
+  // Ignore blocks already free, a second free would link the block in twice
+  size_t i = (p - _base) / _blockSize;
+  if (!(_inUse[i >> 3] & (1 << (i & 7)))) return;
+  _inUse[i >> 3] &= ~(1 << (i & 7));
+
+  *(void**)p = _head;
+  _head = p;
+  _free++;
+
+  setUsed((size_t)(_count - _free) * _blockSize);
+}
+
+#undef ALLOC_ALIGN
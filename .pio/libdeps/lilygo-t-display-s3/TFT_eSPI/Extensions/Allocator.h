@@ -0,0 +1,118 @@
+/***************************************************************************************
+// The following classes provide Sprite memory from a caller managed store instead of
+// the heap. A Sprite uses an allocator set with setAllocator() before createSprite().
+// An arena carves Sprites from one block and frees them all at once with release(),
+// a pool hands out fixed size blocks for Sprites of the same size and colour depth.
+// Repeated create/delete cycles then no longer fragment the heap.
+***************************************************************************************/
+
+class TFT_eSpriteAllocator {
+
+ public:
+
+  virtual ~TFT_eSpriteAllocator(void) { }
+
+           // Return bytes of zeroed memory, or nullptr if the request cannot be met
+  virtual void* allocate(size_t bytes) = 0;
+
+           // Return memory obtained from allocate()
+  virtual void  deallocate(void* ptr) = 0;
+
+           // Bytes currently allocated and the highest value seen since begin() or resetPeak()
+  size_t   used(void) { return _used; }
+  size_t   peak(void) { return _peak; }
+  void     resetPeak(void) { _peak = _used; }
+
+           // Bytes of Sprite memory createSprite() will request for a Sprite of this size
+  static size_t spriteSize(int16_t width, int16_t height, uint8_t bpp, uint8_t frames = 1);
+
+ protected:
+
+           // Reserve a block for the store, in PSRAM if requested and fitted
+  static uint8_t* reserve(size_t bytes, bool psram);
+
+  void     setUsed(size_t bytes) { _used = bytes; if (_used > _peak) _peak = _used; }
+
+  size_t   _used = 0;
+  size_t   _peak = 0;
+};
+
+
+/***************************************************************************************
+// Arena allocator: Sprites are taken from the top of a single block. mark() records
+// the top, release() returns everything allocated after the mark in one step, e.g.
+// for the Sprites of one screen. Deleting the most recently created Sprite frees its
+// memory at once, other deletes are reclaimed by the next release().
+***************************************************************************************/
+
+class TFT_eSpriteArena : public TFT_eSpriteAllocator {
+
+ public:
+
+  TFT_eSpriteArena(void);
+  ~TFT_eSpriteArena(void);
+
+           // Reserve an arena of the given size, or use a caller supplied buffer
+  bool     begin(size_t bytes, bool psram = false);
+  bool     begin(void* buffer, size_t bytes);
+           // Free the arena block if it was reserved by begin(bytes), all Sprites must be deleted first
+  void     end(void);
+
+  void*    allocate(size_t bytes);
+           // Only the top (most recent) allocation is reclaimed here, freeing any other
+           // allocation leaves its memory in use (see used()) until release() passes it
+  void     deallocate(void* ptr);
+
+           // Record the arena top, then release all memory allocated after the mark
+           // Sprites created after the mark must not be used once released
+  size_t   mark(void) { return _top; }
+  void     release(size_t mark);
+
+           // Total and remaining capacity in bytes
+  size_t   capacity(void) { return _size; }
+  size_t   available(void);
+
+ private:
+
+  uint8_t* _base;  // Arena block
+  size_t   _size;  // Arena size in bytes
+  size_t   _top;   // Offset of the first free byte
+  bool     _owned; // true if the block was reserved by begin(bytes)
+};
+
+
+/***************************************************************************************
+// Pool allocator: a fixed number of equal sized blocks, each holding one Sprite. Blocks
+// are returned to a free list when the Sprite is deleted so any order is allowed.
+// Freeing a block that is already free is ignored.
+***************************************************************************************/
+
+class TFT_eSpritePool : public TFT_eSpriteAllocator {
+
+ public:
+
+  TFT_eSpritePool(void);
+  ~TFT_eSpritePool(void);
+
+           // Reserve count blocks of blockSize bytes, see spriteSize() for the block size needed
+  bool     begin(size_t blockSize, uint16_t count, bool psram = false);
+           // Free the pool, all Sprites must be deleted first
+  void     end(void);
+
+  void*    allocate(size_t bytes);
+  void     deallocate(void* ptr);
+
+           // Block size, total blocks and blocks free
+  size_t   blockSize(void) { return _blockSize; }
+  uint16_t blocks(void) { return _count; }
+  uint16_t available(void) { return _free; }
+
+ private:
+
+  uint8_t* _base;      // Pool block
+  void*    _head;      // First free block, each free block holds a pointer to the next
+  uint8_t* _inUse;     // One bit per block, set while the block is allocated
+  size_t   _blockSize; // Block size in bytes, multiple of the pointer size
+  uint16_t _count;     // Number of blocks
+  uint16_t _free;      // Number of free blocks
+};
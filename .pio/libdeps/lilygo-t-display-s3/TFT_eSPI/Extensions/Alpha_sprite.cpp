@@ -0,0 +1,306 @@
+/***************************************************************************************
+** Code for the alpha (coverage) only Sprite class
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           TFT_eAlphaSprite
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eAlphaSprite::TFT_eAlphaSprite(TFT_eSPI *tft)
+{
+  _tft = tft;
+
+  _img     = nullptr;
+  _iwidth  = 0;
+  _iheight = 0;
+  _bits    = 8;
+  _created = false;
+
+  _allocator = nullptr; // Use the heap for alpha Sprite memory
+
+  _psram_enable = true;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eAlphaSprite
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eAlphaSprite::~TFT_eAlphaSprite(void)
+{
+  deleteSprite();
+}
+
+
+/***************************************************************************************
+** Function name:           createSprite
+** Description:             Create an alpha Sprite with 8 or 4 bits per pixel
+***************************************************************************************/
+void* TFT_eAlphaSprite::createSprite(int16_t w, int16_t h, uint8_t bits)
+{
+  if ( _created ) return _img;
+
+  if ( w < 1 || h < 1 ) return nullptr;
+
+  _bits = (bits > 4) ? 8 : 4;
+
+  uint32_t bytes = (_bits == 8) ? (uint32_t)w * h : (uint32_t)((w + 1) >> 1) * h;
+
+  _img = (uint8_t*) TFT_eSprite::allocSprite(bytes, _allocator, _psram_enable);
+
+  if (_img == nullptr) return nullptr;
+
+  _iwidth  = w;
+  _iheight = h;
+  _created = true;
+
+  return _img;
+}
+
+
+/***************************************************************************************
+** Function name:           setAllocator
+** Description:             Set the allocator used for alpha Sprite memory
+***************************************************************************************/
+bool TFT_eAlphaSprite::setAllocator(TFT_eSpriteAllocator *allocator)
+{
+  // Memory must be returned to the allocator it came from
+  if (_created) return false;
+
+  _allocator = allocator;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           getAllocator
+** Description:             Return the allocator, nullptr if the heap is used
+***************************************************************************************/
+TFT_eSpriteAllocator* TFT_eAlphaSprite::getAllocator(void)
+{
+  return _allocator;
+}
+
+
+/***************************************************************************************
+** Function name:           createFromImage
+** Description:             Create an alpha Sprite from 16 bpp (RGB565) artwork
+***************************************************************************************/
+bool TFT_eAlphaSprite::createFromImage(const uint16_t *image, int16_t w, int16_t h, uint8_t bits,
+                                       uint16_t fg, uint16_t bg)
+{
+  if (image == nullptr) return false;
+
+  deleteSprite();
+  if (!createSprite(w, h, bits)) return false;
+
+  // Most artwork has large areas of the same colour so cache the last result
+  uint16_t lastColor = bg;
+  uint8_t  lastAlpha = 0;
+
+  for (int32_t y = 0; y < h; y++) {
+    for (int32_t x = 0; x < w; x++) {
+      uint16_t color = pgm_read_word(image++);
+      if (color != lastColor) { lastColor = color; lastAlpha = colorCoverage(color, fg, bg); }
+      drawPixel(x, y, lastAlpha);
+    }
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           createFromSprite
+** Description:             Create an alpha Sprite from a Sprite of any colour depth
+***************************************************************************************/
+bool TFT_eAlphaSprite::createFromSprite(TFT_eSprite *spr, uint8_t bits, uint16_t fg, uint16_t bg)
+{
+  if (spr == nullptr || !spr->created()) return false;
+
+  int16_t w = spr->width();
+  int16_t h = spr->height();
+
+  deleteSprite();
+  if (!createSprite(w, h, bits)) return false;
+
+  uint16_t lastColor = bg;
+  uint8_t  lastAlpha = 0;
+
+  for (int32_t y = 0; y < h; y++) {
+    for (int32_t x = 0; x < w; x++) {
+      uint16_t color = spr->readPixel(x, y);
+      if (color != lastColor) { lastColor = color; lastAlpha = colorCoverage(color, fg, bg); }
+      drawPixel(x, y, lastAlpha);
+    }
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           colorCoverage
+** Description:             Return the position (0-255) of a colour between bg and fg
+***************************************************************************************/
+uint8_t TFT_eAlphaSprite::colorCoverage(uint16_t color, uint16_t fg, uint16_t bg)
+{
+  // Channels scaled to 6 bits so green is not given more weight
+  int32_t fr = (fg >> 10) & 0x3E, fgn = (fg >> 5) & 0x3F, fb = (fg & 0x1F) << 1;
+  int32_t br = (bg >> 10) & 0x3E, bgn = (bg >> 5) & 0x3F, bb = (bg & 0x1F) << 1;
+  int32_t cr = (color >> 10) & 0x3E, cg = (color >> 5) & 0x3F, cb = (color & 0x1F) << 1;
+
+  // Project the colour onto the line from bg to fg
+  int32_t dr = fr - br, dg = fgn - bgn, db = fb - bb;
+  int32_t len = dr * dr + dg * dg + db * db;
+  if (len == 0) return (color == fg) ? 255 : 0;
+
+  int32_t dot = (cr - br) * dr + (cg - bgn) * dg + (cb - bb) * db;
+  if (dot <= 0) return 0;
+  if (dot >= len) return 255;
+
+  return (dot * 255 + (len >> 1)) / len;
+}
+
+
+/***************************************************************************************
+** Function name:           deleteSprite
+** Description:             Delete the alpha Sprite to free up memory (RAM)
+***************************************************************************************/
+void TFT_eAlphaSprite::deleteSprite(void)
+{
+  if (_created)
+  {
+    TFT_eSprite::freeSprite(_img, _allocator);
+    _img = nullptr;
+    _created = false;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           created
+** Description:             Returns true if the alpha Sprite has been created
+***************************************************************************************/
+bool TFT_eAlphaSprite::created(void)
+{
+  return _created;
+}
+
+
+/***************************************************************************************
+** Function name:           getPointer
+** Description:             Returns pointer to start of the coverage values
+***************************************************************************************/
+void* TFT_eAlphaSprite::getPointer(void)
+{
+  if (!_created) return nullptr;
+  return _img;
+}
+
+
+/***************************************************************************************
+** Function name:           width
+** Description:             Return the width of the alpha Sprite
+***************************************************************************************/
+int16_t TFT_eAlphaSprite::width(void)
+{
+  if (!_created) return 0;
+  return _iwidth;
+}
+
+
+/***************************************************************************************
+** Function name:           height
+** Description:             Return the height of the alpha Sprite
+***************************************************************************************/
+int16_t TFT_eAlphaSprite::height(void)
+{
+  if (!_created) return 0;
+  return _iheight;
+}
+
+
+/***************************************************************************************
+** Function name:           getAlphaDepth
+** Description:             Return the bits per pixel (8 or 4)
+***************************************************************************************/
+uint8_t TFT_eAlphaSprite::getAlphaDepth(void)
+{
+  if (!_created) return 0;
+  return _bits;
+}
+
+
+/***************************************************************************************
+** Function name:           fillSprite
+** Description:             Set all pixels to a coverage value
+***************************************************************************************/
+void TFT_eAlphaSprite::fillSprite(uint8_t alpha)
+{
+  if (!_created) return;
+
+  if (_bits == 8) memset(_img, alpha, (uint32_t)_iwidth * _iheight);
+  else {
+    alpha = (alpha * 15 + 127) / 255; // Nearest of 16 levels
+    memset(_img, alpha << 4 | alpha, (uint32_t)((_iwidth + 1) >> 1) * _iheight);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixel
+** Description:             Set the coverage of the pixel at x,y
+***************************************************************************************/
+void TFT_eAlphaSprite::drawPixel(int32_t x, int32_t y, uint8_t alpha)
+{
+  if (!_created || x < 0 || y < 0 || x >= _iwidth || y >= _iheight) return;
+
+  if (_bits == 8) _img[x + y * _iwidth] = alpha;
+  else {
+    uint8_t* ptr = _img + (x >> 1) + y * ((_iwidth + 1) >> 1);
+    alpha = (alpha * 15 + 127) / 255; // Nearest of 16 levels
+    if (x & 1) *ptr = (*ptr & 0xF0) | alpha;
+    else       *ptr = (*ptr & 0x0F) | alpha << 4;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           readPixel
+** Description:             Return the coverage (0-255) of the pixel at x,y
+***************************************************************************************/
+uint8_t TFT_eAlphaSprite::readPixel(int32_t x, int32_t y)
+{
+  if (!_created || x < 0 || y < 0 || x >= _iwidth || y >= _iheight) return 0;
+
+  if (_bits == 8) return _img[x + y * _iwidth];
+
+  uint8_t a = _img[(x >> 1) + y * ((_iwidth + 1) >> 1)];
+  a = (x & 1) ? (a & 0x0F) : (a >> 4);
+  return a * 17;
+}
+
+
+/***************************************************************************************
+** Function name:           pushTinted
+** Description:             Draw the alpha Sprite in colour fg on the TFT
+***************************************************************************************/
+void TFT_eAlphaSprite::pushTinted(int32_t x, int32_t y, uint16_t fg, uint32_t bg)
+{
+  if (!_created) return;
+
+  _tft->pushAlphaImage(x, y, _iwidth, _iheight, _img, _bits, fg, bg);
+}
+
+
+/***************************************************************************************
+** Function name:           pushTinted
+** Description:             Draw the alpha Sprite in colour fg into a Sprite
+***************************************************************************************/
+void TFT_eAlphaSprite::pushTinted(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t fg, uint32_t bg)
+{
+  if (!_created || dspr == nullptr) return;
+
+  dspr->pushAlphaImage(x, y, _iwidth, _iheight, _img, _bits, fg, bg);
+}
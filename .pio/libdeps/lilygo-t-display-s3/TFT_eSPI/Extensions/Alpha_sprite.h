@@ -0,0 +1,73 @@
+/***************************************************************************************
+// The following class creates alpha (coverage) only Sprites in RAM. Each pixel holds an
+// 8 or 4 bit coverage value, so the shape of an anti-aliased icon or text is stored once
+// and can be drawn in any colour on the TFT or in a Sprite with pushTinted(). A 4 bit
+// alpha Sprite uses a quarter of the RAM of a 16 bpp Sprite.
+***************************************************************************************/
+
+class TFT_eAlphaSprite {
+
+ public:
+
+  explicit TFT_eAlphaSprite(TFT_eSPI *tft);
+  ~TFT_eAlphaSprite(void);
+
+           // Create an alpha Sprite of width x height pixels with 8 or 4 bits of coverage per pixel,
+           // return a pointer to the RAM area. 4 bit rows are padded to a whole byte with the even
+           // x pixel in the high nibble
+  void*    createSprite(int16_t width, int16_t height, uint8_t bits = 8);
+
+           // Take memory from an arena or pool instead of the heap, nullptr restores the heap.
+           // Must be set before createSprite(), returns false if the alpha Sprite has already been created
+  bool     setAllocator(TFT_eSpriteAllocator *allocator);
+  TFT_eSpriteAllocator* getAllocator(void);
+
+           // Create an alpha Sprite from 16 bpp artwork, the coverage of each pixel is the position of
+           // its colour between bg (0) and fg (full coverage), e.g. white text drawn on black
+  bool     createFromImage(const uint16_t *image, int16_t width, int16_t height, uint8_t bits = 8,
+                           uint16_t fg = TFT_WHITE, uint16_t bg = TFT_BLACK);
+           // As above from a Sprite of any colour depth
+  bool     createFromSprite(TFT_eSprite *spr, uint8_t bits = 8, uint16_t fg = TFT_WHITE, uint16_t bg = TFT_BLACK);
+
+           // Delete the alpha Sprite to free up the RAM
+  void     deleteSprite(void);
+
+           // Returns true if the alpha Sprite has been created
+  bool     created(void);
+
+           // Returns a pointer to the coverage values or nullptr if not created
+  void*    getPointer(void);
+
+           // Width, height and bits per pixel (8 or 4)
+  int16_t  width(void);
+  int16_t  height(void);
+  uint8_t  getAlphaDepth(void);
+
+           // Set all pixels, or the pixel at x,y, to a coverage of 0-255 (rounded to 16 levels for 4 bit Sprites)
+  void     fillSprite(uint8_t alpha);
+  void     drawPixel(int32_t x, int32_t y, uint8_t alpha);
+
+           // Read the coverage at x,y scaled to 0-255
+  uint8_t  readPixel(int32_t x, int32_t y);
+
+           // Draw the alpha Sprite in colour fg on the TFT at x,y, blended with bg or with the screen if
+           // bg is 0x00FFFFFF (the TFT must support pixel reads)
+  void     pushTinted(int32_t x, int32_t y, uint16_t fg, uint32_t bg = 0x00FFFFFF);
+           // As above into a Sprite, blended with the Sprite pixels if bg is 0x00FFFFFF
+  void     pushTinted(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t fg, uint32_t bg = 0x00FFFFFF);
+
+ private:
+
+  TFT_eSPI *_tft;
+
+           // Return coverage 0-255 of colour between bg and fg
+  static uint8_t colorCoverage(uint16_t color, uint16_t fg, uint16_t bg);
+
+  uint8_t  *_img;     // Coverage values
+  int16_t  _iwidth;   // Width and height in pixels
+  int16_t  _iheight;
+  uint8_t  _bits;     // Bits per pixel, 8 or 4
+  bool     _created;  // An alpha Sprite has been created and memory reserved
+  TFT_eSpriteAllocator *_allocator; // Alpha Sprite memory allocator, nullptr for heap
+  bool     _psram_enable;
+};
@@ -0,0 +1,206 @@
+/***************************************************************************************
+** Code for the smooth font handle class
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           TFT_eSmoothFont
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eSmoothFont::TFT_eSmoothFont(TFT_eSPI *tft)
+{
+  _tft    = tft;
+  _loaded = false;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eSmoothFont
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eSmoothFont::~TFT_eSmoothFont(void)
+{
+  unload();
+#ifdef FONT_FS_AVAILABLE
+  TFT_eSPI::reserveGlyphCache(&gCache, 0, false);
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           load
+** Description:             Load a font from an array
+***************************************************************************************/
+bool TFT_eSmoothFont::load(const uint8_t array[])
+{
+  unload();
+  _tft->loadFont(array);
+  take(_tft);
+  return _loaded;
+}
+
+
+#ifdef FONT_FS_AVAILABLE
+/***************************************************************************************
+** Function name:           load
+** Description:             Load a font file from a file system
+***************************************************************************************/
+bool TFT_eSmoothFont::load(String fontName, fs::FS &ffs)
+{
+  unload();
+  _tft->loadFont(fontName, ffs);
+  take(_tft);
+  return _loaded;
+}
+
+
+/***************************************************************************************
+** Function name:           load
+** Description:             Load a font file from SPIFFS
+***************************************************************************************/
+bool TFT_eSmoothFont::load(String fontName, bool flash)
+{
+  unload();
+  _tft->loadFont(fontName, flash);
+  take(_tft);
+  return _loaded;
+}
+
+
+/***************************************************************************************
+** Function name:           setGlyphCache
+** Description:             Reserve a glyph cache for this font
+***************************************************************************************/
+bool TFT_eSmoothFont::setGlyphCache(size_t bytes, bool psram)
+{
+  // A TFT or Sprite with the font selected lays the new block out when next used
+  return TFT_eSPI::reserveGlyphCache(&gCache, bytes, psram);
+}
+#endif
+
+
+/***************************************************************************************
+** Function name:           take
+** Description:             Take over the font loaded in a TFT, the TFT keeps it selected
+***************************************************************************************/
+void TFT_eSmoothFont::take(TFT_eSPI *tft)
+{
+  if (!tft->fontLoaded) return;
+
+  gFont      = tft->gFont;
+  gUnicode   = tft->gUnicode;
+  gHeight    = tft->gHeight;
+  gWidth     = tft->gWidth;
+  gxAdvance  = tft->gxAdvance;
+  gdY        = tft->gdY;
+  gdX        = tft->gdX;
+  gBitmap    = tft->gBitmap;
+  gBitmapEnd = tft->gBitmapEnd;
+  gAlphaBits = tft->gAlphaBits;
+  gLatin1    = tft->gLatin1;
+  gOrder     = tft->gOrder;
+  gSorted    = tft->gSorted;
+  gInPlace   = tft->gInPlace;
+
+#ifdef FONT_FS_AVAILABLE
+  fontFile   = tft->fontFile;
+  spiffs     = tft->spiffs;
+  fs_font    = tft->fs_font;
+  fontId     = tft->fontId;
+  tft->gCache = gCache.block ? &gCache : &tft->gCacheOwn;
+#endif
+
+#ifdef FONT_PARTITION_AVAILABLE
+  fontMap    = tft->fontMap;
+  fontMapped = tft->fontMapped;
+#endif
+
+  // The TFT now uses the font from this handle
+  tft->fontHandle = this;
+  _loaded = true;
+}
+
+
+/***************************************************************************************
+** Function name:           select
+** Description:             Point a TFT or Sprite at the font
+***************************************************************************************/
+void TFT_eSmoothFont::select(TFT_eSPI *tft)
+{
+  tft->gFont      = gFont;
+  tft->gUnicode   = gUnicode;
+  tft->gHeight    = gHeight;
+  tft->gWidth     = gWidth;
+  tft->gxAdvance  = gxAdvance;
+  tft->gdY        = gdY;
+  tft->gdX        = gdX;
+  tft->gBitmap    = gBitmap;
+  tft->gBitmapEnd = gBitmapEnd;
+  tft->gAlphaBits = gAlphaBits;
+  tft->gLatin1    = gLatin1;
+  tft->gOrder     = gOrder;
+  tft->gSorted    = gSorted;
+  tft->gInPlace   = gInPlace;
+
+#ifdef FONT_FS_AVAILABLE
+  tft->fontFile   = fontFile;
+  tft->spiffs     = spiffs;
+  tft->fs_font    = fs_font;
+  tft->fontId     = fontId;
+  // The cache is laid out for this font when next used, unless it holds it already
+  tft->gCache     = gCache.block ? &gCache : &tft->gCacheOwn;
+#endif
+
+#ifdef FONT_PARTITION_AVAILABLE
+  tft->fontMapped = fontMapped;
+#endif
+
+  tft->fontHandle = this;
+  tft->fontLoaded = true;
+}
+
+
+/***************************************************************************************
+** Function name:           unload
+** Description:             Free the font
+***************************************************************************************/
+void TFT_eSmoothFont::unload(void)
+{
+  if (!_loaded) return;
+
+  // Deselect the font in the TFT used to load it
+  if (_tft->fontHandle == this) _tft->unloadFont();
+
+  _loaded = false;
+
+#ifdef FONT_FS_AVAILABLE
+  if (fs_font && fontFile) fontFile.close();
+  fontFile = fs::File();
+  // The cache block is kept for the next font
+  gCache.font = 0;
+#endif
+
+#ifdef FONT_PARTITION_AVAILABLE
+  if (fontMapped)
+  {
+  #if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_munmap((esp_partition_mmap_handle_t)fontMap);
+  #else
+    spi_flash_munmap((spi_flash_mmap_handle_t)fontMap);
+  #endif
+    fontMapped = false;
+  }
+#endif
+
+  // In-place fonts are not allocated
+  if (gInPlace) return;
+
+  free(gUnicode);
+  free(gHeight);
+  free(gWidth);
+  free(gxAdvance);
+  free(gdY);
+  free(gdX);
+  free(gBitmap);
+  free(gLatin1);
+  free(gOrder);
+}
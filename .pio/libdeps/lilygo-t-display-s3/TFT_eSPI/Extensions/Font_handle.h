@@ -0,0 +1,74 @@
+/***************************************************************************************
+// The following class holds a loaded smooth font so several fonts can be kept loaded at
+// once. A TFT or Sprite selects a font with setFont(&handle), which only points it at the
+// metrics held by the handle, so a screen can mix fonts without reloading them and many
+// Sprites can share one copy of a font. The handle must stay loaded while selected.
+***************************************************************************************/
+
+class TFT_eSmoothFont { friend class TFT_eSPI;
+
+ public:
+
+  explicit TFT_eSmoothFont(TFT_eSPI *tft);
+  ~TFT_eSmoothFont(void);
+
+           // Load a font, the TFT is used to read it and is left with the font selected.
+           // Any font loaded in the TFT with loadFont() is unloaded
+  bool     load(const uint8_t array[]);
+#ifdef FONT_FS_AVAILABLE
+  bool     load(String fontName, fs::FS &ffs);
+  bool     load(String fontName, bool flash = true);
+#endif
+
+           // Free the font, the TFT used to load it is deselected. Other TFT_eSPI and Sprite
+           // instances must call setFont(nullptr), or select another font, before this
+  void     unload(void);
+
+  bool     loaded(void) { return _loaded; }
+
+#ifdef FONT_FS_AVAILABLE
+           // Give a font loaded from a file its own glyph cache, used by every TFT or Sprite
+           // while this font is selected and kept while other fonts are, bytes = 0 frees it.
+           // Without one the cache of the TFT or Sprite is used, see setGlyphCache()
+  bool     setGlyphCache(size_t bytes, bool psram = false);
+#endif
+
+ private:
+
+           // Take the font loaded in the TFT, or point a TFT or Sprite at the font
+  void     take(TFT_eSPI *tft);
+  void     select(TFT_eSPI *tft);
+
+  TFT_eSPI *_tft;
+  bool      _loaded;
+
+  // Copy of the TFT_eSPI smooth font members, see Smooth_font.h
+  TFT_eSPI::fontMetrics gFont;
+  uint16_t* gUnicode;
+  uint8_t*  gHeight;
+  uint8_t*  gWidth;
+  uint8_t*  gxAdvance;
+  int16_t*  gdY;
+  int8_t*   gdX;
+  uint32_t* gBitmap;
+  uint32_t  gBitmapEnd;
+  uint8_t   gAlphaBits;
+  uint16_t* gLatin1;
+  uint16_t* gOrder;
+  bool      gSorted;
+  bool      gInPlace;
+
+#ifdef FONT_FS_AVAILABLE
+  fs::File  fontFile;
+  bool      spiffs;
+  bool      fs_font;
+  uint32_t  fontId;
+
+  TFT_eSPI::glyphCache_t gCache = {};
+#endif
+
+#ifdef FONT_PARTITION_AVAILABLE
+  uint32_t  fontMap;
+  bool      fontMapped;
+#endif
+};
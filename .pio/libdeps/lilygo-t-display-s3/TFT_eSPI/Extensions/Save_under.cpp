@@ -0,0 +1,229 @@
+/***************************************************************************************
+** Code for the save-under class
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           TFT_eSaveUnder
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eSaveUnder::TFT_eSaveUnder(TFT_eSPI *tft)
+{
+  _tft   = tft;
+  _top   = nullptr;
+  _count = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eSaveUnder
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eSaveUnder::~TFT_eSaveUnder(void)
+{
+  end();
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Reserve a store of bytes for saved areas
+***************************************************************************************/
+bool TFT_eSaveUnder::begin(size_t bytes, bool psram)
+{
+  discard();
+  return _store.begin(bytes, psram);
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Use a caller supplied buffer as the store
+***************************************************************************************/
+bool TFT_eSaveUnder::begin(void* buffer, size_t bytes)
+{
+  discard();
+  return _store.begin(buffer, bytes);
+}
+
+
+/***************************************************************************************
+** Function name:           end
+** Description:             Discard saved areas and free the store
+***************************************************************************************/
+void TFT_eSaveUnder::end(void)
+{
+  discard();
+  _store.end();
+}
+
+
+/***************************************************************************************
+** Function name:           clipArea
+** Description:             Clip an area to the viewport and apply the datum
+***************************************************************************************/
+// An area with nothing visible is set to zero size so restore() calls still pair with save()
+bool TFT_eSaveUnder::clipArea(TFT_eSPI *tft, int32_t *x, int32_t *y, int32_t *w, int32_t *h)
+{
+  if (tft->_vpOoB) { *w = *h = 0; return false; }
+
+  int32_t xs = *x + tft->_xDatum;
+  int32_t ys = *y + tft->_yDatum;
+  int32_t xe = xs + *w;
+  int32_t ye = ys + *h;
+
+  if (xs < tft->_vpX) xs = tft->_vpX;
+  if (ys < tft->_vpY) ys = tft->_vpY;
+  if (xe > tft->_vpW) xe = tft->_vpW;
+  if (ye > tft->_vpH) ye = tft->_vpH;
+
+  if (xe <= xs || ye <= ys) { *w = *h = 0; return false; }
+
+  *x = xs; *y = ys; *w = xe - xs; *h = ye - ys;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           newArea
+** Description:             Take an area header and pixel storage from the store
+***************************************************************************************/
+TFT_eSaveUnder::saveArea_t* TFT_eSaveUnder::newArea(TFT_eSPI *tft, TFT_eSprite *spr, int32_t x, int32_t y,
+                                                    int32_t w, int32_t h, size_t bytes)
+{
+  saveArea_t* area = (saveArea_t*)_store.allocate(sizeof(saveArea_t) + bytes);
+  if (area == nullptr) return nullptr;
+
+  area->prev = _top;
+  area->tft  = tft;
+  area->spr  = spr;
+  area->bpp  = spr ? spr->_bpp : 16;
+  area->x = x; area->y = y; area->w = w; area->h = h;
+
+  _top = area;
+  _count++;
+
+  return area;
+}
+
+
+/***************************************************************************************
+** Function name:           save
+** Description:             Save an area of the TFT
+***************************************************************************************/
+bool TFT_eSaveUnder::save(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  clipArea(_tft, &x, &y, &w, &h);
+
+  saveArea_t* area = newArea(_tft, nullptr, x, y, w, h, (size_t)w * h * sizeof(uint16_t));
+  if (area == nullptr) return false;
+  if (w == 0) return true; // Nothing visible so nothing to save
+
+  // Pixels are read in the byte order expected by pushRect()
+  _tft->readRect(x - _tft->_xDatum, y - _tft->_yDatum, w, h, (uint16_t*)(area + 1));
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           save
+** Description:             Save an area of a Sprite
+***************************************************************************************/
+bool TFT_eSaveUnder::save(TFT_eSprite *spr, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  if (spr == nullptr || !spr->_created) return false;
+
+  // Pixels are copied in Sprite memory coordinates so a rotated 1 bpp Sprite is not supported
+  if (spr->_bpp == 1 && spr->rotation) return false;
+
+  clipArea(spr, &x, &y, &w, &h);
+
+  // Raw pixel values, 16 bpp are stored as 16 bits and other depths as 8 bits
+  bool wide = (spr->_bpp == 16);
+  saveArea_t* area = newArea(spr, spr, x, y, w, h, (size_t)w * h * (wide ? 2 : 1));
+  if (area == nullptr) return false;
+  if (w == 0) return true;
+
+  uint16_t* ptr16 = (uint16_t*)(area + 1);
+  uint8_t*  ptr8  = (uint8_t*)(area + 1);
+  uint16_t  line[w];
+
+  for (int32_t j = 0; j < h; j++) {
+    if (wide) { spr->readValues(ptr16, x, y + j, w); ptr16 += w; }
+    else {
+      spr->readValues(line, x, y + j, w);
+      for (int32_t i = 0; i < w; i++) *ptr8++ = line[i];
+    }
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           restore
+** Description:             Restore the most recently saved area
+***************************************************************************************/
+bool TFT_eSaveUnder::restore(void)
+{
+  saveArea_t* area = _top;
+  if (area == nullptr) return false;
+
+  int32_t x = area->x, y = area->y, w = area->w, h = area->h;
+
+  // Areas with nothing visible have zero size
+  if (w > 0 && area->spr == nullptr)
+  {
+    TFT_eSPI* tft = area->tft;
+    tft->pushRect(x - tft->_xDatum, y - tft->_yDatum, w, h, (uint16_t*)(area + 1));
+  }
+  else if (w > 0)
+  {
+    TFT_eSprite* spr = area->spr;
+
+    // A Sprite deleted or re-created at another depth or a smaller size is left alone
+    if (spr->_created && spr->_bpp == area->bpp && x + w <= spr->_iwidth && y + h <= spr->_iheight)
+    {
+      bool wide = (spr->_bpp == 16);
+      uint16_t* ptr16 = (uint16_t*)(area + 1);
+      uint8_t*  ptr8  = (uint8_t*)(area + 1);
+      uint16_t  line[w];
+
+      for (int32_t j = 0; j < h; j++) {
+        if (wide) { spr->writeValues(ptr16, x, y + j, w, nullptr, 0); ptr16 += w; }
+        else {
+          for (int32_t i = 0; i < w; i++) line[i] = *ptr8++;
+          spr->writeValues(line, x, y + j, w, nullptr, 0);
+        }
+      }
+    }
+  }
+
+  _top = area->prev;
+  _count--;
+  _store.deallocate(area);
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           restoreAll
+** Description:             Restore all saved areas, most recent first
+***************************************************************************************/
+void TFT_eSaveUnder::restoreAll(void)
+{
+  while (restore());
+}
+
+
+/***************************************************************************************
+** Function name:           discard
+** Description:             Forget all saved areas without restoring them
+***************************************************************************************/
+void TFT_eSaveUnder::discard(void)
+{
+  _store.release(0);
+  _top   = nullptr;
+  _count = 0;
+}
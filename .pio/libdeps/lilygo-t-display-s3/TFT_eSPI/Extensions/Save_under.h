@@ -0,0 +1,62 @@
+/***************************************************************************************
+// The following class saves the area of the TFT, or of a Sprite, that an overlay such as
+// a meter needle or cursor is about to cover. Restoring the area removes the overlay
+// without redrawing the background, so a moving overlay needs no full screen Sprite.
+// Areas are held in one store and are restored in the reverse order they were saved.
+***************************************************************************************/
+
+class TFT_eSaveUnder {
+
+ public:
+
+  explicit TFT_eSaveUnder(TFT_eSPI *tft);
+  ~TFT_eSaveUnder(void);
+
+           // Reserve a store of the given size, or use a caller supplied buffer (4 byte aligned)
+           // A TFT area needs 2 bytes per pixel, a Sprite area 2 bytes (16 bpp) or 1 byte per pixel
+  bool     begin(size_t bytes, bool psram = false);
+  bool     begin(void* buffer, size_t bytes);
+           // Discard all saved areas and free the store if it was reserved by begin(bytes)
+  void     end(void);
+
+           // Save an area of the TFT before an overlay is drawn, the TFT must support readRect()
+           // Returns false if the store is full, the area is clipped to the viewport. Each save
+           // is matched by one restore() even if nothing was visible
+  bool     save(int32_t x, int32_t y, int32_t w, int32_t h);
+           // Save an area of a Sprite (not a rotated 1 bpp Sprite)
+  bool     save(TFT_eSprite *spr, int32_t x, int32_t y, int32_t w, int32_t h);
+
+           // Restore the most recently saved area, returns false if no area is saved
+  bool     restore(void);
+           // Restore all saved areas, most recent first
+  void     restoreAll(void);
+           // Forget all saved areas without restoring them
+  void     discard(void);
+
+           // Number of areas saved, store bytes in use and bytes free
+  uint16_t count(void) { return _count; }
+  size_t   used(void) { return _store.used(); }
+  size_t   available(void) { return _store.available(); }
+
+ private:
+
+  typedef struct saveArea_t {
+    saveArea_t*  prev;       // Area saved before this one
+    TFT_eSPI*    tft;        // TFT or Sprite the area was saved from
+    TFT_eSprite* spr;        // Sprite or nullptr for the TFT
+    uint8_t      bpp;        // Sprite colour depth when saved
+    int16_t      x, y, w, h; // Area with the datum applied, pixels follow the header
+  } saveArea_t;
+
+           // Clip an area to the viewport of the TFT or Sprite and apply the datum
+  static bool clipArea(TFT_eSPI *tft, int32_t *x, int32_t *y, int32_t *w, int32_t *h);
+
+           // Take a header and bytes of pixel storage from the store
+  saveArea_t* newArea(TFT_eSPI *tft, TFT_eSprite *spr, int32_t x, int32_t y, int32_t w, int32_t h, size_t bytes);
+
+  TFT_eSPI *_tft;
+
+  TFT_eSpriteArena _store;  // Saved areas, the most recent at the top
+  saveArea_t*      _top;    // Most recently saved area or nullptr
+  uint16_t         _count;  // Number of areas saved
+};
@@ -1,6 +1,10 @@
  // Coded by Bodmer 10/2/18, see license in root directory.
  // This is part of the TFT_eSPI class and is associated with anti-aliased font functions
  
+#ifdef FONT_PARTITION_AVAILABLE
+  #include "esp_partition.h" // For fonts in a memory mapped data partition
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////////////
 // New anti-aliased (smoothed) font functions added below
@@ -13,10 +17,113 @@
 void TFT_eSPI::loadFont(const uint8_t array[])
 {
   if (array == nullptr) return;
+
+  // An in-place font starts with a marker, a vlw font starts with the glyph count
+  if (((uintptr_t)array & 3) == 0 && ((const inPlaceFont_t*)array)->magic == INPLACE_FONT_MAGIC)
+  {
+    loadInPlace(array);
+    return;
+  }
+
   fontPtr = (uint8_t*) array;
   loadFont("", false);
 }
 
+
+/***************************************************************************************
+** Function name:           loadInPlace
+** Description:             Use the metrics of an in-place font where they are stored
+*************************************************************************************x*/
+// Nothing is allocated or copied so changing fonts takes a few microseconds. The metric
+// arrays are read directly, so the font must be in byte addressable memory (not ESP8266
+// PROGMEM).
+void TFT_eSPI::loadInPlace(const uint8_t *font)
+{
+  if (fontLoaded) unloadFont();
+
+#if defined (ESP8266)
+  #ifdef TFT_eSPI_DEBUG
+  Serial.println("In-place fonts are not supported on the ESP8266");
+  #endif
+  return;
+#endif
+
+#ifdef FONT_FS_AVAILABLE
+  fs_font = false;
+#endif
+
+  const inPlaceFont_t* f = (const inPlaceFont_t*)font;
+
+  gFont.gArray     = font;
+  gFont.gCount     = f->gCount;
+  gFont.yAdvance   = f->yAdvance;
+  gFont.spaceWidth = f->spaceWidth;
+  gFont.ascent     = f->ascent;
+  gFont.descent    = f->descent;
+  gFont.maxAscent  = f->maxAscent;
+  gFont.maxDescent = f->maxDescent;
+
+  // The arrays are only read, const is cast away to share the members used by vlw fonts
+  gUnicode  = (uint16_t*)(font + f->unicode);
+  gHeight   =  (uint8_t*)(font + f->height);
+  gWidth    =  (uint8_t*)(font + f->width);
+  gxAdvance =  (uint8_t*)(font + f->xAdvance);
+  gdY       =  (int16_t*)(font + f->dY);
+  gdX       =   (int8_t*)(font + f->dX);
+  gBitmap   = (uint32_t*)(font + f->bitmap);
+  gLatin1   = f->latin1 ? (uint16_t*)(font + f->latin1) : NULL;
+
+  gBitmapEnd = f->bitmapEnd;
+  gAlphaBits = f->alphaBits;
+  gSorted    = f->sorted;
+  gInPlace   = true;
+
+  fontLoaded = true;
+}
+
+
+#ifdef FONT_PARTITION_AVAILABLE
+/***************************************************************************************
+** Function name:           loadFontPartition
+** Description:             Map a data partition holding an in-place font and use it
+*************************************************************************************x*/
+bool TFT_eSPI::loadFontPartition(const char *label)
+{
+  if (fontLoaded) unloadFont();
+
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (part == nullptr) return false;
+
+  const void* ptr = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_partition_mmap_handle_t handle;
+  if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &handle) != ESP_OK) return false;
+#else
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &ptr, &handle) != ESP_OK) return false;
+#endif
+
+  loadFont((const uint8_t*)ptr);
+
+  if (!gInPlace)
+  {
+    // Not an in-place font
+    if (fontLoaded) unloadFont();
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_munmap(handle);
+#else
+    spi_flash_munmap(handle);
+#endif
+    return false;
+  }
+
+  fontMap    = handle;
+  fontMapped = true;
+
+  return true;
+}
+#endif
+
 #ifdef FONT_FS_AVAILABLE
 /***************************************************************************************
 ** Function name:           loadFont
@@ -71,6 +178,16 @@ void TFT_eSPI::loadFont(String fontName, bool flash)
        a zero/one terminated character string giving the font name
        last byte is 0 for non-anti-aliased and 1 for anti-aliased (smoothed)
 
+    A run length coded variant (made by Tools/vlw_compress) has the version number
+    0x524C4504 for 4-bit alpha or 0x524C4502 for 2-bit alpha. The padding value of
+    each glyph holds the byte count of its bitmap. A bitmap is a stream of 4 or 2-bit
+    values packed most significant bits first, it starts on a byte boundary:
+      0            followed by n, n + 1 transparent pixels
+      15 (or 3)    followed by n, n + 1 opaque pixels
+      other        one partly transparent pixel
+    Runs do not continue onto the next row.
+    A 4-bit alpha value a is drawn as a * 17, a 2-bit value as a * 85.
+
 
     Glyph bitmap example is:
     // Cursor coordinate positions for this and next character are marked by 'C'
@@ -116,6 +233,11 @@ void TFT_eSPI::loadFont(String fontName, bool flash)
     if(!fontFile) return;
 
     fontFile.seek(0, fs::SeekSet);
+
+    // Each font file loaded gets a new id, so a glyph cache can tell which font it holds
+    static uint32_t fontCount = 0;
+    if (++fontCount == 0) fontCount = 1;
+    fontId = fontCount;
   }
 #else
   // Avoid unused varaible warning
@@ -126,7 +248,7 @@ void TFT_eSPI::loadFont(String fontName, bool flash)
   gFont.gArray   = (const uint8_t*)fontPtr;
 
   gFont.gCount   = (uint16_t)readInt32(); // glyph count in file
-                             readInt32(); // vlw encoder version - discard
+  uint32_t version =         readInt32(); // vlw encoder version, or run length coded variant
   gFont.yAdvance = (uint16_t)readInt32(); // Font size in points, not pixels
                              readInt32(); // discard
   gFont.ascent   = (uint16_t)readInt32(); // top of "d"
@@ -138,6 +260,9 @@ void TFT_eSPI::loadFont(String fontName, bool flash)
   gFont.yAdvance   = gFont.ascent + gFont.descent;
   gFont.spaceWidth = gFont.yAdvance / 4;  // Guess at space width
 
+  gAlphaBits = 8;
+  if (version == 0x524C4504 || version == 0x524C4502) gAlphaBits = version & 0xFF;
+
   fontLoaded = true;
 
   // Fetch the metrics for each glyph
@@ -197,7 +322,7 @@ void TFT_eSPI::loadMetrics(void)
     gxAdvance[gNum] =  (uint8_t)readInt32(); // xAdvance - to move x cursor
     gdY[gNum]       =  (int16_t)readInt32(); // y delta from baseline
     gdX[gNum]       =   (int8_t)readInt32(); // x delta from cursor
-    readInt32(); // ignored
+    uint32_t bytes  =           readInt32(); // Bitmap byte count if run length coded
 
     //Serial.print("Unicode = 0x"); Serial.print(gUnicode[gNum], HEX); Serial.print(", gHeight  = "); Serial.println(gHeight[gNum]);
     //Serial.print("Unicode = 0x"); Serial.print(gUnicode[gNum], HEX); Serial.print(", gWidth  = "); Serial.println(gWidth[gNum]);
@@ -236,15 +361,81 @@ void TFT_eSPI::loadMetrics(void)
 
     gBitmap[gNum] = bitmapPtr;
 
-    bitmapPtr += gWidth[gNum] * gHeight[gNum];
+    if (gAlphaBits == 8) bytes = gWidth[gNum] * gHeight[gNum];
+    bitmapPtr += bytes;
 
     gNum++;
     yield();
   }
 
+  gBitmapEnd = bitmapPtr;
+
   gFont.yAdvance = gFont.maxAscent + gFont.maxDescent;
 
   gFont.spaceWidth = (gFont.ascent + gFont.descent) * 2/7;  // Guess at space width
+
+  indexGlyphs();
+
+#ifdef FONT_FS_AVAILABLE
+  layoutGlyphCache();
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           indexGlyphs
+** Description:             Build the glyph look up tables used by getUnicodeIndex()
+*************************************************************************************x*/
+// Codes 0-255 are looked up in a direct table, other codes by a binary search. vlw files
+// list glyphs in code order so normally gUnicode is searched, otherwise a table of glyph
+// indexes is sorted into code order. If memory runs out the linear search is used.
+void TFT_eSPI::indexGlyphs(void)
+{
+  gLatin1 = (uint16_t*)malloc(256 * 2);
+  if (gLatin1)
+  {
+    memset(gLatin1, 0xFF, 256 * 2);
+    // Backwards so the first glyph of a duplicated code is found, as the linear search does
+    for (int32_t i = gFont.gCount - 1; i >= 0; i--)
+    {
+      if (gUnicode[i] < 256) gLatin1[gUnicode[i]] = i;
+    }
+  }
+
+  gSorted = true;
+  for (uint16_t i = 1; i < gFont.gCount; i++)
+  {
+    if (gUnicode[i] < gUnicode[i - 1]) { gSorted = false; break; }
+  }
+  if (gSorted) return;
+
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psramFound() ) gOrder = (uint16_t*)ps_malloc( gFont.gCount * 2);
+  else
+#endif
+  gOrder = (uint16_t*)malloc( gFont.gCount * 2);
+
+  if (!gOrder) return;
+
+  for (uint16_t i = 0; i < gFont.gCount; i++) gOrder[i] = i;
+
+  // Shell sort by code, then glyph index so duplicated codes stay in file order
+  for (uint16_t gap = gFont.gCount / 2; gap > 0; gap /= 2)
+  {
+    for (uint16_t i = gap; i < gFont.gCount; i++)
+    {
+      uint16_t v = gOrder[i];
+      uint16_t j = i;
+      while (j >= gap)
+      {
+        uint16_t u = gOrder[j - gap];
+        if (gUnicode[u] < gUnicode[v] || (gUnicode[u] == gUnicode[v] && u < v)) break;
+        gOrder[j] = u;
+        j -= gap;
+      }
+      gOrder[j] = v;
+    }
+  }
 }
 
 
@@ -254,6 +445,22 @@ void TFT_eSPI::loadMetrics(void)
 *************************************************************************************x*/
 void TFT_eSPI::unloadFont( void )
 {
+  // The metrics of an in-place font belong to the font, a font selected with setFont()
+  // belongs to its handle
+  if (gInPlace || fontHandle)
+  {
+    gUnicode  = NULL;
+    gHeight   = NULL;
+    gWidth    = NULL;
+    gxAdvance = NULL;
+    gdY       = NULL;
+    gdX       = NULL;
+    gBitmap   = NULL;
+    gLatin1   = NULL;
+    gOrder    = NULL;
+    gInPlace  = false;
+  }
+
   if (gUnicode)
   {
     free(gUnicode);
@@ -296,16 +503,65 @@ void TFT_eSPI::unloadFont( void )
     gBitmap = NULL;
   }
 
+  if (gLatin1)
+  {
+    free(gLatin1);
+    gLatin1 = NULL;
+  }
+
+  if (gOrder)
+  {
+    free(gOrder);
+    gOrder = NULL;
+  }
+
+  gSorted = false;
+
   gFont.gArray = nullptr;
 
 #ifdef FONT_FS_AVAILABLE
-  if (fs_font && fontFile) fontFile.close();
+  if (fontHandle) fontFile = fs::File();
+  else if (fs_font && fontFile) fontFile.close();
+
+  // The cache block is kept for the next font, a font handle keeps its own cache
+  gCache = &gCacheOwn;
+  fontId = 0;
 #endif
 
+#ifdef FONT_PARTITION_AVAILABLE
+  if (fontMapped && fontHandle) fontMapped = false;
+  else if (fontMapped)
+  {
+  #if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_munmap((esp_partition_mmap_handle_t)fontMap);
+  #else
+    spi_flash_munmap((spi_flash_mmap_handle_t)fontMap);
+  #endif
+    fontMapped = false;
+  }
+#endif
+
+  fontHandle = nullptr;
   fontLoaded = false;
 }
 
 
+/***************************************************************************************
+** Function name:           setFont
+** Description:             Select a font held by a font handle
+*************************************************************************************x*/
+void TFT_eSPI::setFont(TFT_eSmoothFont *font)
+{
+  if (font && font == fontHandle) return;
+
+  if (fontLoaded) unloadFont();
+
+  if (font == nullptr || !font->loaded()) return;
+
+  font->select(this);
+}
+
+
 /***************************************************************************************
 ** Function name:           readInt32
 ** Description:             Get a 32-bit integer from the font file
@@ -334,12 +590,52 @@ uint32_t TFT_eSPI::readInt32(void)
 }
 
 
+/***************************************************************************************
+** Function name:           glyphBytes
+** Description:             Get the byte count of a glyph bitmap
+*************************************************************************************x*/
+uint32_t TFT_eSPI::glyphBytes(uint16_t gNum)
+{
+  if (gAlphaBits == 8) return gWidth[gNum] * gHeight[gNum];
+
+  // Run length coded bitmaps are stored in glyph order
+  uint32_t end = (gNum + 1 < gFont.gCount) ? gBitmap[gNum + 1] : gBitmapEnd;
+  return end - gBitmap[gNum];
+}
+
+
 /***************************************************************************************
 ** Function name:           getUnicodeIndex
 ** Description:             Get the font file index of a Unicode character
 *************************************************************************************x*/
 bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 {
+  // ASCII and Latin-1 are looked up directly
+  if (unicode < 256 && gLatin1)
+  {
+    if (gLatin1[unicode] == 0xFFFF) return false;
+    *index = gLatin1[unicode];
+    return true;
+  }
+
+  // Binary search for the first glyph with the code
+  if (gSorted || gOrder)
+  {
+    uint32_t lo = 0, hi = gFont.gCount;
+    while (lo < hi)
+    {
+      uint32_t mid = (lo + hi) >> 1;
+      if (gUnicode[gOrder ? gOrder[mid] : mid] < unicode) lo = mid + 1;
+      else hi = mid;
+    }
+    if (lo == gFont.gCount) return false;
+
+    uint16_t i = gOrder ? gOrder[lo] : lo;
+    if (gUnicode[i] != unicode) return false;
+    *index = i;
+    return true;
+  }
+
   for (uint16_t i = 0; i < gFont.gCount; i++)
   {
     if (gUnicode[i] == unicode)
@@ -351,6 +647,188 @@ bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
   return false;
 }
 
+#ifdef FONT_FS_AVAILABLE
+/***************************************************************************************
+** Function name:           setGlyphCache
+** Description:             Reserve a block for caching glyph bitmaps read from a file
+*************************************************************************************x*/
+bool TFT_eSPI::setGlyphCache(size_t bytes, bool psram)
+{
+  if (!reserveGlyphCache(&gCacheOwn, bytes, psram)) return false;
+
+  if (fontLoaded && gCache == &gCacheOwn) layoutGlyphCache();
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           reserveGlyphCache
+** Description:             Free a glyph cache and reserve a new block for it
+*************************************************************************************x*/
+// The slots are laid out when the cache is next used
+bool TFT_eSPI::reserveGlyphCache(glyphCache_t *cache, size_t bytes, bool psram)
+{
+  if (cache->block) free(cache->block);
+  *cache = {};
+
+  if (bytes == 0) return true;
+
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psram && psramFound() ) cache->block = (uint8_t*)ps_malloc(bytes);
+  else
+#else
+  psram = psram; // Avoid unused variable warning
+#endif
+  cache->block = (uint8_t*)malloc(bytes);
+
+  if (!cache->block) return false;
+
+  cache->bytes = bytes;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           layoutGlyphCache
+** Description:             Divide the cache block into slots for the loaded font
+*************************************************************************************x*/
+// The block holds a glyph to slot table, the slot list and then the slot bitmaps. All
+// slots are the size of the largest glyph so a slot can be reused for any glyph.
+void TFT_eSPI::layoutGlyphCache(void)
+{
+  glyphCache_t* c = gCache;
+
+  c->font  = fontId;
+  c->slots = 0;
+  c->used  = 0;
+
+  if (!c->block || !fs_font) return;
+
+  uint32_t slotSize = 0;
+  for (uint16_t i = 0; i < gFont.gCount; i++)
+  {
+    uint32_t bytes = glyphBytes(i);
+    if (bytes > slotSize) slotSize = bytes;
+  }
+  slotSize = (slotSize + 3) & ~3;
+  if (slotSize == 0) slotSize = 4;
+
+  size_t tableBytes = (gFont.gCount * 2 + 3) & ~3;
+  if (c->bytes <= tableBytes) return;
+
+  size_t slots = (c->bytes - tableBytes) / (sizeof(glyphSlot_t) + slotSize);
+  if (slots > gFont.gCount) slots = gFont.gCount;
+  if (slots > 0xFFFE) slots = 0xFFFE;
+  if (slots == 0) return;
+
+  c->slotOf = (uint16_t*)c->block;
+  c->slot   = (glyphSlot_t*)(c->block + tableBytes);
+  c->bits   = c->block + tableBytes + ((slots * sizeof(glyphSlot_t) + 3) & ~3);
+
+  // The slot list rounding must still leave room for the bitmaps
+  if (c->bits + slots * slotSize > c->block + c->bytes) slots--;
+  if (slots == 0) return;
+
+  memset(c->slotOf, 0, gFont.gCount * 2);
+
+  c->slotSize = slotSize;
+  c->slots    = slots;
+}
+
+
+/***************************************************************************************
+** Function name:           cachedGlyph
+** Description:             Return the bitmap of a glyph, reading it into the cache if needed
+*************************************************************************************x*/
+// Returns nullptr if the cache is not in use or the read fails
+const uint8_t* TFT_eSPI::cachedGlyph(uint16_t gNum)
+{
+  glyphCache_t* c = gCache;
+
+  // The cache is laid out again only if it holds another font
+  if (c->font != fontId) layoutGlyphCache();
+
+  if (c->slots == 0) return nullptr;
+
+  uint16_t s = c->slotOf[gNum];
+
+  if (s == 0)
+  {
+    // Take an unused slot, or the least recently used one
+    bool unused = (c->used < c->slots);
+    s = unused ? c->used : c->lru;
+
+    if (!unused && c->slot[s].glyph != 0xFFFF)
+    {
+      c->slotOf[c->slot[s].glyph] = 0;
+      c->slot[s].glyph = 0xFFFF;
+    }
+
+    size_t bytes = glyphBytes(gNum);
+    if (bytes)
+    {
+      if (!spiffs) endWrite(); // Release SPI for SD card transaction
+
+      fontFile.seek(gBitmap[gNum], fs::SeekSet);
+      // A slot left empty is the next to be reused
+      if (fontFile.read(c->bits + s * c->slotSize, bytes) != bytes) return nullptr;
+    }
+
+    c->slot[s].glyph = gNum;
+    c->slotOf[gNum] = s + 1;
+
+    // A new slot joins the end of the list
+    if (unused)
+    {
+      if (c->used == 0) c->mru = s;
+      else
+      {
+        c->slot[c->lru].next = s;
+        c->slot[s].prev = c->lru;
+      }
+      c->lru = s;
+      c->used++;
+    }
+  }
+  else s--;
+
+  // Move to the front of the list
+  if (s != c->mru)
+  {
+    if (s == c->lru) c->lru = c->slot[s].prev;
+    else c->slot[c->slot[s].next].prev = c->slot[s].prev;
+    c->slot[c->slot[s].prev].next = c->slot[s].next;
+    c->slot[s].next = c->mru;
+    c->slot[c->mru].prev = s;
+    c->mru = s;
+  }
+
+  return c->bits + s * c->slotSize;
+}
+
+
+/***************************************************************************************
+** Function name:           prefetchGlyphs
+** Description:             Read the glyphs of a UTF-8 string into the cache
+*************************************************************************************x*/
+void TFT_eSPI::prefetchGlyphs(const char *text)
+{
+  if (!fontLoaded || !fs_font || gCache->block == nullptr || text == nullptr) return;
+
+  uint16_t len = strlen(text);
+  uint16_t n = 0;
+
+  while (n < len)
+  {
+    uint16_t uniCode = decodeUTF8((uint8_t*)text, &n, len - n);
+    uint16_t gNum = 0;
+    if (getUnicodeIndex(uniCode, &gNum)) cachedGlyph(gNum);
+  }
+}
+#endif
+
 
 /***************************************************************************************
 ** Function name:           drawGlyph
@@ -405,15 +883,34 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     if (cursor_x == 0) cursor_x -= gdX[gNum];
 
     uint8_t* pbuffer = nullptr;
-    const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
+    const uint8_t* gPtr = nullptr;
 
 #ifdef FONT_FS_AVAILABLE
     if (fs_font)
     {
-      fontFile.seek(gBitmap[gNum], fs::SeekSet);
-      pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
+      // Whole bitmap from the glyph cache, otherwise read row by row
+      gPtr = cachedGlyph(gNum);
+      if (!gPtr)
+      {
+        fontFile.seek(gBitmap[gNum], fs::SeekSet);
+        if (gAlphaBits < 8)
+        {
+          // Run length coded rows vary in length so read the whole bitmap
+          uint32_t bytes = glyphBytes(gNum);
+          pbuffer = (uint8_t*)malloc(bytes);
+          if (pbuffer)
+          {
+            if (!spiffs) endWrite(); // Release SPI for SD card transaction
+            fontFile.read(pbuffer, bytes);
+          }
+          gPtr = pbuffer;
+        }
+        else pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
+      }
     }
+    else
 #endif
+    gPtr = (const uint8_t*) gFont.gArray + gBitmap[gNum];
 
     int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
     int16_t cx = cursor_x + gdX[gNum];
@@ -458,10 +955,12 @@ void TFT_eSPI::drawGlyph(uint16_t code)
       }
     }
 
+    if (gAlphaBits < 8) drawGlyphRuns(gPtr, gNum, cx, cy, bx, fg, bg, false, getColor != nullptr);
+    else
     for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (pbuffer) {
         if (spiffs)
         {
           fontFile.read(pbuffer, gWidth[gNum]);
@@ -479,11 +978,8 @@ void TFT_eSPI::drawGlyph(uint16_t code)
 
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
-#ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
-        else
-#endif
-        pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
+        if (pbuffer) pixel = pbuffer[x];
+        else pixel = pgm_read_byte(gPtr + x + gWidth[gNum] * y);
 
         if (pixel)
         {
@@ -541,6 +1037,395 @@ void TFT_eSPI::drawGlyph(uint16_t code)
   last_cursor_x = cursor_x;
 }
 
+/***************************************************************************************
+** Function name:           drawGlyphRuns
+** Description:             Draw a run length coded glyph bitmap
+*************************************************************************************x*/
+// Transparent and opaque runs are drawn as lines. Partly transparent pixels, and opaque
+// runs of one pixel, are collected and drawn with drawPixels(), so the TFT sends adjacent
+// pixels in one window and Sprites write them without a call per pixel. The background of a
+// blended pixel is bg, or read from the Sprite if readBG is true, or taken from the getColor
+// callback if callBG is true. As for 8 bit bitmaps the TFT uses the callback and Sprites do
+// not. With a fixed bg each blended level is worked out once.
+void TFT_eSPI::drawGlyphRuns(const uint8_t* gPtr, uint16_t gNum, int32_t cx, int32_t cy, int32_t bx,
+                             uint16_t fg, uint16_t bg, bool readBG, bool callBG)
+{
+  uint8_t bits  = gAlphaBits;
+  uint8_t mask  = (1 << bits) - 1;
+  uint8_t scale = 255 / mask; // 17 for 4-bit alpha, 85 for 2-bit alpha
+  int32_t w     = gWidth[gNum];
+
+  // Values not yet decoded are the low "avail" bits of data
+  uint32_t data  = 0;
+  int32_t  avail = 0;
+
+  // Blended colour of each level, valid where the level bit of known is set
+  uint16_t lut[16];
+  uint16_t known = 0;
+  bool     fixedBG = !readBG && !callBG;
+
+  // Pixels waiting for drawPixels()
+  const uint16_t batchSize = 64;
+  int16_t  xy[2 * batchSize];
+  uint16_t color[batchSize];
+  uint16_t count = 0;
+
+  if (gPtr == nullptr) return; // Bitmap could not be read
+
+  for (int32_t y = cy; y < cy + gHeight[gNum]; y++)
+  {
+    int32_t  x   = 0;
+    int32_t  fxs = 0;
+    uint32_t fl  = 0;
+    int32_t  bxs = 0;
+    uint32_t bl  = 0;
+
+    while (x < w)
+    {
+      if (avail < bits) { data = data << 8 | pgm_read_byte(gPtr++); avail += 8; }
+      avail -= bits;
+      uint8_t alpha = (data >> avail) & mask;
+
+      if (alpha == 0 || alpha == mask)
+      {
+        // Run, the next value is the length - 1
+        if (avail < bits) { data = data << 8 | pgm_read_byte(gPtr++); avail += 8; }
+        avail -= bits;
+        int32_t n = ((data >> avail) & mask) + 1;
+        if (n > w - x) n = w - x; // Corrupt data, stay in the glyph box
+
+        if (alpha)
+        {
+          if (bl) { drawFastHLine(cx + bxs, y, bl, bg); bl = 0; }
+          if (fl == 0) fxs = x;
+          fl += n;
+        }
+        else
+        {
+          // Draw the background right of bx if filling
+          if (fl > 1) drawFastHLine(cx + fxs, y, fl, fg);
+          else if (fl) { xy[2 * count] = cx + fxs; xy[2 * count + 1] = y; color[count++] = fg; }
+          fl = 0;
+          if (_fillbg && x + n > bx)
+          {
+            int32_t xs = (x > bx) ? x : bx;
+            if (bl == 0) bxs = xs;
+            bl += x + n - xs;
+          }
+        }
+        x += n;
+      }
+      else
+      {
+        if (bl) { drawFastHLine(cx + bxs, y, bl, bg); bl = 0; }
+        if (fl > 1) drawFastHLine(cx + fxs, y, fl, fg);
+        else if (fl) { xy[2 * count] = cx + fxs; xy[2 * count + 1] = y; color[count++] = fg; }
+        fl = 0;
+
+        uint16_t c;
+        if (fixedBG)
+        {
+          if (!(known & (1 << alpha))) { lut[alpha] = alphaBlend(alpha * scale, fg, bg); known |= 1 << alpha; }
+          c = lut[alpha];
+        }
+        else
+        {
+          if (readBG) bg = readPixel(cx + x, y);
+          else bg = getColor(cx + x, y);
+          c = alphaBlend(alpha * scale, fg, bg);
+        }
+        xy[2 * count] = cx + x; xy[2 * count + 1] = y; color[count++] = c;
+        x++;
+      }
+
+      // Room is kept for a blended pixel and a single opaque pixel
+      if (count > batchSize - 2) { drawPixels(xy, color, count); count = 0; }
+    }
+
+    if (fl > 1) drawFastHLine(cx + fxs, y, fl, fg);
+    else if (fl) { xy[2 * count] = cx + fxs; xy[2 * count + 1] = y; color[count++] = fg; }
+    if (bl) drawFastHLine(cx + bxs, y, bl, bg);
+  }
+
+  if (count) drawPixels(xy, color, count);
+}
+
+/***************************************************************************************
+** Function name:           drawTextLine
+** Description:             Draw a line of opaque text a scanline at a time
+*************************************************************************************x*/
+// Called by drawString() when the text background is filled. Each scanline of the text box,
+// with the glyphs, blended edges, background and any padding, is composed in a line buffer
+// and sent in one window, in place of the fills, lines and pixels drawGlyph() sends for each
+// character. The pixels drawn are the same as drawing glyph by glyph, so false is returned
+// if that would wrap, start a new line, draw a missing glyph box or read the background.
+bool TFT_eSPI::drawTextLine(const char *string, uint16_t len, uint8_t padding, int32_t cwidth)
+{
+  if (getColor) return false;
+#ifdef FONT_FS_AVAILABLE
+  if (fs_font) return false; // Glyph bitmaps are read one at a time
+#endif
+
+  // Glyphs and spaces in text order, then up to two padding areas
+  textOp_t* op = (textOp_t*)malloc((len + 2) * sizeof(textOp_t));
+  if (op == nullptr) return false;
+
+  // Lay out the line the way drawGlyph() does
+  int32_t  x  = cursor_x;
+  int32_t  y  = cursor_y;
+  int32_t  bx = (last_cursor_x != cursor_x) ? cursor_x : bg_cursor_x;
+  // The line can be cached if the background starts at the cursor and no glyph after the
+  // first can land on x = 0, where it is moved by its dX
+  bool     fresh = (bx == x) && (x >= 0);
+  int32_t  left = x, right = x, top = y, bottom = y + gFont.yAdvance;
+  int32_t  gRight = INT16_MIN; // Right edge of the glyphs, for the text wrap test
+  uint16_t count = 0;
+  uint16_t n = 0;
+
+  while (n < len)
+  {
+    uint16_t code = decodeUTF8((uint8_t*)string, &n, len - n);
+    textOp_t* p = op + count;
+
+    if (code == 0x20)
+    {
+      p->gNum = 0xFFFF;
+      p->x0 = bx; p->x1 = x + gFont.spaceWidth;
+      x += gFont.spaceWidth;
+    }
+    else
+    {
+      uint16_t gNum = 0;
+      if (code == '\n' || !getUnicodeIndex(code, &gNum) ||
+          (textwrapX && (x + gWidth[gNum] + gdX[gNum] > width())) ||
+          (textwrapY && ((y + gFont.yAdvance) >= height()))) { free(op); return false; }
+
+      if (x == 0) x -= gdX[gNum];
+
+      p->gNum = gNum;
+      p->x0 = bx; p->x1 = x + gxAdvance[gNum];
+      p->cx = x + gdX[gNum];
+      p->cy = y + gFont.maxAscent - gdY[gNum];
+      p->ptr = gFont.gArray + gBitmap[gNum];
+      p->shift = 0;
+
+      if (p->cx < left) left = p->cx;
+      if (p->cx + gWidth[gNum] > gRight) gRight = p->cx + gWidth[gNum];
+      if (p->cy < top) top = p->cy;
+      if (p->cy + gHeight[gNum] > bottom) bottom = p->cy + gHeight[gNum];
+      x += gxAdvance[gNum];
+    }
+
+    if (p->x0 < left) left = p->x0;
+    if (p->x1 > right) right = p->x1;
+    bx = x;
+    count++;
+  }
+  if (gRight > right) right = gRight;
+
+  // Padding drawString() would fill after the text, as background spans
+  if ((padX > cwidth) && (textcolor != textbgcolor))
+  {
+    int32_t poX = cursor_x;
+    int32_t padXc = poX + cwidth;
+    textOp_t* p = op + count;
+    p[0].gNum = p[1].gNum = 0xFFFF;
+    p[0].x0 = p[0].x1 = p[1].x0 = p[1].x1 = 0;
+    switch (padding) {
+      case 1:
+        p[0].x0 = padXc; p[0].x1 = padXc + padX - cwidth;
+        break;
+      case 2:
+        p[0].x0 = padXc; p[0].x1 = padXc + ((padX - cwidth) >> 1);
+        p[1].x0 = poX - ((padX - cwidth) >> 1); p[1].x1 = poX;
+        break;
+      case 3:
+        // drawString() stops this at x = 0, but only pixels left of the screen or viewport
+        // are lost by not doing so and a cached text box is then the same at any position
+        p[0].x0 = poX + cwidth - padX; p[0].x1 = poX;
+        break;
+    }
+    for (uint8_t i = 0; i < 2; i++, count++) {
+      if (p[i].x1 <= p[i].x0) continue;
+      if (p[i].x0 < left) left = p[i].x0;
+      if (p[i].x1 > right) right = p[i].x1;
+    }
+  }
+
+  int32_t tx = cursor_x; // Start of the line
+  int32_t ty = cursor_y;
+
+  cursor_x      = x;
+  bg_cursor_x   = x;
+  last_cursor_x = x;
+
+  // Capture the whole text box for the cache, the box is only kept if every pixel is drawn
+  uint16_t* image = nullptr;
+  if (textCache && fresh) image = textCache->newEntry(string, right - left, bottom - top);
+  if (image)
+  {
+    int32_t w = right - left;
+    uint8_t set[w];
+    bool    full = true;
+    for (int32_t yp = top; yp < bottom; yp++)
+    {
+      memset(set, 0, w);
+      textRow(op, count, yp, ty, image + (yp - top) * w, set, left, w, true);
+      if (full) for (int32_t i = 0; i < w; i++) if (!set[i]) { full = false; break; }
+    }
+    if (full)
+    {
+      textCache->addEntry(left, top, tx, ty, x, gRight, cwidth);
+      free(op);
+      return true;
+    }
+    textCache->dropEntry();
+
+    // Draw it in the normal way, restart the glyph bitmaps
+    for (uint16_t i = 0; i < count; i++) {
+      if (op[i].gNum != 0xFFFF) { op[i].ptr = gFont.gArray + gBitmap[op[i].gNum]; op[i].shift = 0; }
+    }
+  }
+
+  // Clip the text box columns to the viewport
+  int32_t xs = left, xe = right;
+  if (xs < _vpX - _xDatum) xs = _vpX - _xDatum;
+  if (xe > _vpW - _xDatum) xe = _vpW - _xDatum;
+  if (_vpOoB || xe <= xs) { free(op); return true; }
+
+  int32_t  w = xe - xs;
+  uint16_t line[w];
+  uint8_t  set[w];
+
+  begin_tft_write();
+  inTransaction = true;
+
+  bool swap = _swapBytes; _swapBytes = true; // Line buffer holds native 565 colours
+
+  for (int32_t yp = top; yp < bottom; yp++)
+  {
+    bool visible = (yp + _yDatum >= _vpY) && (yp + _yDatum < _vpH);
+    if (visible) memset(set, 0, w);
+
+    textRow(op, count, yp, ty, line, set, xs, w, visible);
+
+    if (!visible) continue;
+
+    // Send each run of pixels set, normally the whole scanline of the text box
+    int32_t i = 0;
+    while (i < w)
+    {
+      if (!set[i]) { i++; continue; }
+      int32_t is = i;
+      while (i < w && set[i]) i++;
+      setWindow(xs + is + _xDatum, yp + _yDatum, xs + i - 1 + _xDatum, yp + _yDatum);
+      pushPixels(line + is, i - is);
+    }
+  }
+
+  _swapBytes = swap;
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+
+  free(op);
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           textRow
+** Description:             Compose one scanline of a line of text
+*************************************************************************************x*/
+// Paints in the same order as drawGlyph() so overlapping glyphs end up the same. The glyph
+// rows on scanline yp are decoded even if paint is false, run length coded rows are read
+// in order. The line buffer holds w pixels from x = xs, set[] marks the pixels painted.
+void TFT_eSPI::textRow(textOp_t *op, uint16_t count, int32_t yp, int32_t ty, uint16_t *line, uint8_t *set,
+                       int32_t xs, int32_t w, bool paint)
+{
+  uint16_t fg = textcolor;
+  uint16_t bg = textbgcolor;
+  uint8_t  mask  = (1 << gAlphaBits) - 1;
+  uint8_t  scale = 255 / mask;
+  uint8_t  alpha[256];
+  bool     band  = (yp >= ty) && (yp < ty + gFont.yAdvance);
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    textOp_t* p = op + i;
+
+    if (p->gNum == 0xFFFF)
+    {
+      // Space or padding
+      if (paint && band) textSpan(line, set, xs, w, p->x0, p->x1, bg);
+      continue;
+    }
+
+    uint16_t gNum = p->gNum;
+    int32_t  gw   = gWidth[gNum];
+
+    if (yp < p->cy || yp >= p->cy + gHeight[gNum])
+    {
+      // Above and below the glyph
+      if (paint && band) textSpan(line, set, xs, w, p->x0, p->x1, bg);
+      continue;
+    }
+
+    // Coverage of the next glyph row
+    if (gAlphaBits == 8) { for (int32_t gx = 0; gx < gw; gx++) alpha[gx] = pgm_read_byte(p->ptr++); }
+    else
+    {
+      int32_t gx = 0;
+      while (gx < gw)
+      {
+        if (p->shift == 0) { p->data = pgm_read_byte(p->ptr++); p->shift = 8; }
+        p->shift -= gAlphaBits;
+        uint8_t a = (p->data >> p->shift) & mask;
+        if (a == 0 || a == mask)
+        {
+          if (p->shift == 0) { p->data = pgm_read_byte(p->ptr++); p->shift = 8; }
+          p->shift -= gAlphaBits;
+          int32_t run = ((p->data >> p->shift) & mask) + 1;
+          if (run > gw - gx) run = gw - gx;
+          memset(alpha + gx, a ? 255 : 0, run);
+          gx += run;
+        }
+        else alpha[gx++] = a * scale;
+      }
+    }
+
+    if (!paint) continue;
+
+    // Background left and right of the glyph
+    if (p->x0 < p->cx) textSpan(line, set, xs, w, p->x0, p->cx, bg);
+    if (p->cx + gw < p->x1) textSpan(line, set, xs, w, p->cx + gw, p->x1, bg);
+
+    // Transparent pixels left of the background start are left alone
+    int32_t gx0 = (p->x0 > p->cx) ? p->x0 - p->cx : 0;
+    for (int32_t gx = 0; gx < gw; gx++)
+    {
+      int32_t ix = p->cx + gx - xs;
+      if (ix < 0 || ix >= w) continue;
+      uint8_t a = alpha[gx];
+      if (a == 0) { if (gx >= gx0) { line[ix] = bg; set[ix] = 1; } }
+      else { line[ix] = (a == 0xFF) ? fg : alphaBlend(a, fg, bg); set[ix] = 1; }
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           textSpan
+** Description:             Fill part of a scanline buffer
+*************************************************************************************x*/
+void TFT_eSPI::textSpan(uint16_t *line, uint8_t *set, int32_t x, int32_t w, int32_t x0, int32_t x1, uint16_t color)
+{
+  x0 -= x; x1 -= x;
+  if (x0 < 0) x0 = 0;
+  if (x1 > w) x1 = w;
+  for (int32_t i = x0; i < x1; i++) { line[i] = color; set[i] = 1; }
+}
+
 /***************************************************************************************
 ** Function name:           showFont
 ** Description:             Page through all characters in font, td ms between screens
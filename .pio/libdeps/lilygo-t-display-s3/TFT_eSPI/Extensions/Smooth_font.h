@@ -10,12 +10,29 @@
 #endif
   void     loadFont(String fontName, bool flash = true);
   void     unloadFont( void );
+#ifdef FONT_PARTITION_AVAILABLE
+  // Use an in-place font stored in a data partition, it is memory mapped so no RAM is used
+  bool     loadFontPartition(const char *label);
+#endif
+  // Select a font held by a TFT_eSmoothFont handle, the handle keeps the font. Nothing is
+  // copied so fonts can be changed freely. nullptr deselects the font
+  void     setFont(TFT_eSmoothFont *font);
   bool     getUnicodeIndex(uint16_t unicode, uint16_t *index);
 
   virtual void drawGlyph(uint16_t code);
 
   void     showFont(uint32_t td);
 
+#ifdef FONT_FS_AVAILABLE
+  // Cache of whole glyph bitmaps for fonts loaded from a file system, so repeated characters
+  // are drawn without file reads. The least recently used glyph is replaced when it is full.
+  // Each slot holds the largest glyph in the font, bytes = 0 frees the cache. A font handle
+  // can have its own cache, which is then used instead while its font is selected
+  bool     setGlyphCache(size_t bytes, bool psram = false);
+  // Read the glyphs of a UTF-8 string into the cache before they are drawn
+  void     prefetchGlyphs(const char *text);
+#endif
+
  // This is for the whole font
   typedef struct
   {
@@ -31,6 +48,34 @@
 
 fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
 
+  // Header of an in-place font, made by Tools/vlw_compress. The glyph metrics are stored
+  // as little-endian arrays that loadFont() uses where they are, so no RAM is allocated.
+  // Offsets are from the start of the font, which must be 4 byte aligned.
+  #define INPLACE_FONT_MAGIC 0x49574C56 // "VLWI"
+
+  typedef struct
+  {
+    uint32_t magic;                  // INPLACE_FONT_MAGIC
+    uint8_t  alphaBits;              // 8 for greyscale bitmaps, 4 or 2 for run length coded bitmaps
+    uint8_t  sorted;                 // 1 if the glyphs are in code order
+    uint16_t gCount;                 // Total number of characters
+    uint16_t yAdvance;               // Line advance
+    uint16_t spaceWidth;             // Width of a space character
+    int16_t  ascent;                 // Height of top of 'd' above baseline
+    int16_t  descent;                // Offset to bottom of 'p'
+    uint16_t maxAscent;              // Maximum ascent found in font
+    uint16_t maxDescent;             // Maximum descent found in font
+    uint32_t unicode;                // Offset of the uint16_t code array
+    uint32_t height;                 // Offset of the uint8_t height array
+    uint32_t width;                  // Offset of the uint8_t width array
+    uint32_t xAdvance;               // Offset of the uint8_t xAdvance array
+    uint32_t dY;                     // Offset of the int16_t dY array
+    uint32_t dX;                     // Offset of the int8_t dX array
+    uint32_t bitmap;                 // Offset of the uint32_t bitmap offset array
+    uint32_t latin1;                 // Offset of the uint16_t glyph index table for codes 0-255, 0 if none
+    uint32_t bitmapEnd;              // Offset after the last bitmap
+  } inPlaceFont_t;
+
   // These are for the metrics for each individual glyph (so we don't need to seek this in file and waste time)
   uint16_t* gUnicode = NULL;  //UTF-16 code, the codes are searched so do not need to be sequential
   uint8_t*  gHeight = NULL;   //cheight
@@ -39,6 +84,14 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   int16_t*  gdY = NULL;       //topExtent
   int8_t*   gdX = NULL;       //leftExtent
   uint32_t* gBitmap = NULL;   //file pointer to greyscale bitmap
+  uint32_t  gBitmapEnd = 0;   //file pointer after the last bitmap
+  uint8_t   gAlphaBits = 8;   //8 for greyscale bitmaps, 4 or 2 for run length coded bitmaps
+
+  // Glyph index look up tables built when the font is loaded, see getUnicodeIndex()
+  uint16_t* gLatin1 = NULL;   //glyph index of codes 0-255, 0xFFFF if not in font
+  uint16_t* gOrder = NULL;    //glyph indexes in code order, NULL if gUnicode is in code order
+  bool      gSorted = false;  //true if gUnicode is in code order
+  bool      gInPlace = false; //true if the metrics and tables are used in place from the font
 
   bool     fontLoaded = false; // Flags when a anti-aliased font is loaded
 
@@ -48,6 +101,33 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   bool     spiffs   = true;
   bool     fs_font = false;    // For ESP32/8266 use smooth font file or FLASH (PROGMEM) array
 
+  // Glyph bitmap cache, slots are linked in least recently used order
+  typedef struct
+  {
+    uint16_t glyph;                  // Glyph index held, 0xFFFF if none
+    uint16_t prev;                   // More recently used slot
+    uint16_t next;                   // Less recently used slot
+  } glyphSlot_t;
+
+  typedef struct
+  {
+    uint8_t*     block;              // Block reserved by setGlyphCache()
+    size_t       bytes;              // Size of the block
+    uint32_t     font;               // Id of the font the slots are laid out for, 0 if none
+    uint16_t*    slotOf;             // Slot + 1 holding each glyph, 0 if not cached
+    glyphSlot_t* slot;               // Slot list
+    uint8_t*     bits;               // Slot bitmaps
+    uint32_t     slotSize;           // Bytes per slot bitmap
+    uint16_t     slots;              // Number of slots, 0 if the cache is not in use
+    uint16_t     used;               // Slots filled since the cache was laid out
+    uint16_t     mru;                // Most recently used slot
+    uint16_t     lru;                // Least recently used slot
+  } glyphCache_t;
+
+  glyphCache_t  gCacheOwn = {};        // Cache reserved by setGlyphCache()
+  glyphCache_t* gCache = &gCacheOwn;   // Cache in use, a font handle can have its own
+  uint32_t      fontId = 0;            // Id of the font file loaded, 0 if none
+
 #else
   bool     fontFile = true;
 #endif
@@ -55,7 +135,43 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   private:
 
   void     loadMetrics(void);
+  void     loadInPlace(const uint8_t *font);
+  void     indexGlyphs(void);
+  uint32_t glyphBytes(uint16_t gNum);
+  void     drawGlyphRuns(const uint8_t* gPtr, uint16_t gNum, int32_t cx, int32_t cy, int32_t bx,
+                         uint16_t fg, uint16_t bg, bool readBG, bool callBG);
+  // Glyph, space or padding of a line of text drawn by drawTextLine()
+  typedef struct
+  {
+    int32_t        x0, x1;           // Background from the last cursor position to the advance
+    int32_t        cx, cy;           // Glyph bitmap top left
+    uint16_t       gNum;             // Glyph index, 0xFFFF for a space or padding
+    const uint8_t* ptr;              // Next bitmap row
+    uint8_t        data, shift;      // Run length decoder state
+  } textOp_t;
+
+  // Draw opaque text from drawString() a scanline at a time, false if it must be drawn glyph
+  // by glyph. The Sprite class overrides this
+  virtual bool drawTextLine(const char *string, uint16_t len, uint8_t padding, int32_t cwidth);
+  // Compose scanline yp of a line of text into a line buffer
+  void     textRow(textOp_t *op, uint16_t count, int32_t yp, int32_t ty, uint16_t *line, uint8_t *set,
+                   int32_t xs, int32_t w, bool paint);
+  // Fill x0 to x1 of a scanline buffer starting at x, marking the pixels set
+  static void textSpan(uint16_t *line, uint8_t *set, int32_t x, int32_t w, int32_t x0, int32_t x1, uint16_t color);
+#ifdef FONT_FS_AVAILABLE
+  static bool reserveGlyphCache(glyphCache_t *cache, size_t bytes, bool psram);
+  void     layoutGlyphCache(void);
+  const uint8_t* cachedGlyph(uint16_t gNum);
+#endif
   uint32_t readInt32(void);
 
   uint8_t* fontPtr = nullptr;
 
+  TFT_eSmoothFont* fontHandle = nullptr; // Handle holding the selected font, nullptr if held here
+  TFT_eTextCache*  textCache  = nullptr; // Cache of opaque strings drawn by drawString()
+
+#ifdef FONT_PARTITION_AVAILABLE
+  uint32_t fontMap  = 0;       // Partition memory map handle
+  bool     fontMapped = false; // true if the font is in a mapped partition
+#endif
+
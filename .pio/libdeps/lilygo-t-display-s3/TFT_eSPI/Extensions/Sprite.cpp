@@ -36,6 +36,13 @@ TFT_eSprite::TFT_eSprite(TFT_eSPI *tft)
 
   _colorMap = nullptr;
 
+  _allocator = nullptr; // Use the heap for Sprite memory
+
+  _frozen      = nullptr;
+  _frozenSize  = 0;
+  _frozenVpOoB = false;
+  _frozenAllocator = nullptr;
+
   _psram_enable = true;
   
   // Ensure end_tft_write() does nothing in inherited functions.
@@ -55,6 +62,9 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
 
   if ( w < 1 || h < 1 ) return nullptr;
 
+  // Discard a frozen Sprite
+  if ( _frozen ) deleteSprite();
+
   _iwidth  = _dwidth  = _bitwidth = w;
   _iheight = _dheight = h;
 
@@ -96,10 +106,17 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
     _img8_2 = _img8 + ( (w>>3) * h + 1 );
   }
 
+  if ( (_bpp == 2) && (frames > 1) )
+  {
+    w = (w+3) & 0xFFFC;
+    _img8_2 = _img8 + ( (w>>2) * h + 1 );
+  }
+
   if (_img8)
   {
     _created = true;
     if ( (_bpp == 4) && (_colorMap == nullptr)) createPalette(default_4bit_palette);
+    if ( (_bpp == 2) && (_colorMap == nullptr)) createPalette(default_2bit_palette, 4);
 
     rotation = 0;
     setViewport(0, 0, _dwidth, _dheight);
@@ -142,6 +159,9 @@ TFT_eSprite::~TFT_eSprite(void)
 
 #ifdef SMOOTH_FONT
   if(fontLoaded) unloadFont();
+  #ifdef FONT_FS_AVAILABLE
+  setGlyphCache(0);
+  #endif
 #endif
 }
 
@@ -155,90 +175,145 @@ void* TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames)
   // Add one extra "off screen" pixel to point out-of-bounds setWindow() coordinates
   // this means push/writeColor functions do not need additional bounds checks and
   // hence will run faster in normal circumstances.
-  uint8_t* ptr8 = nullptr;
-
   if (frames > 2) frames = 2; // Currently restricted to 2 frame buffers
   if (frames < 1) frames = 1;
 
-  if (_bpp == 16)
-  {
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable && !_tft->DMA_Enabled)
-    {
-      ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint16_t));
-      //Serial.println("PSRAM");
-    }
-    else
-#endif
-    {
-      ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint16_t));
-      //Serial.println("Normal RAM");
-    }
-  }
-
-  else if (_bpp == 8)
+  // Widths of 4, 2 and 1 bpp Sprites are rounded up so pixels of a line fill whole bytes
+  if (_bpp == 4)
   {
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * w * h + frames, sizeof(uint8_t));
-    else
-#endif
-    ptr8 = ( uint8_t*) calloc(frames * w * h + frames, sizeof(uint8_t));
+    _iwidth = (w+1) & 0xFFFE; // width needs to be multiple of 2, with an extra "off screen" pixel
   }
-
-  else if (_bpp == 4)
+  else if (_bpp == 2)
   {
-    w = (w+1) & 0xFFFE; // width needs to be multiple of 2, with an extra "off screen" pixel
-    _iwidth = w;
-#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(((frames * w * h) >> 1) + frames, sizeof(uint8_t));
-    else
-#endif
-    ptr8 = ( uint8_t*) calloc(((frames * w * h) >> 1) + frames, sizeof(uint8_t));
+    _iwidth = (w+3) & 0xFFFC; // width needs to be multiple of 4
   }
-
-  else // Must be 1 bpp
+  else if (_bpp == 1)
   {
     //_dwidth   Display width+height in pixels always in rotation 0 orientation
     //_dheight  Not swapped for sprite rotations
     // Note: for 1bpp _iwidth and _iheight are swapped during Sprite rotations
 
-    w =  (w+7) & 0xFFF8; // width should be the multiple of 8 bits to be compatible with epdpaint
-    _iwidth = w;         // _iwidth is rounded up to be multiple of 8, so might not be = _dwidth
-    _bitwidth = w;       // _bitwidth will not be rotated whereas _iwidth may be
+    _iwidth   = (w+7) & 0xFFF8; // width should be the multiple of 8 bits to be compatible with epdpaint
+    _bitwidth = _iwidth;        // _bitwidth will not be rotated whereas _iwidth may be
+  }
+
+  // DMA cannot use PSRAM for 16 bpp Sprites
+  bool psram = _psram_enable && (_bpp != 16 || !_tft->DMA_Enabled);
+
+  return allocSprite(TFT_eSpriteAllocator::spriteSize(w, h, _bpp, frames), _allocator, psram);
+}
+
+
+/***************************************************************************************
+** Function name:           allocSprite
+** Description:             Get zeroed memory from the allocator, or the heap if nullptr
+***************************************************************************************/
+void* TFT_eSprite::allocSprite(size_t bytes, TFT_eSpriteAllocator *allocator, bool psram)
+{
+  if (allocator) return allocator->allocate(bytes);
+
+  uint8_t* ptr8 = nullptr;
 
 #if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
-    if ( psramFound() && _psram_enable ) ptr8 = ( uint8_t*) ps_calloc(frames * (w>>3) * h + frames, sizeof(uint8_t));
-    else
+  if ( psramFound() && psram )
+  {
+    ptr8 = ( uint8_t*) ps_calloc(bytes, sizeof(uint8_t));
+    //Serial.println("PSRAM");
+  }
+  else
+#else
+  (void)psram;
 #endif
-    ptr8 = ( uint8_t*) calloc(frames * (w>>3) * h + frames, sizeof(uint8_t));
+  {
+    ptr8 = ( uint8_t*) calloc(bytes, sizeof(uint8_t));
+    //Serial.println("Normal RAM");
   }
 
   return ptr8;
 }
 
 
+/***************************************************************************************
+** Function name:           freeSprite
+** Description:             Return memory from allocSprite() to where it came from
+***************************************************************************************/
+void TFT_eSprite::freeSprite(void* ptr, TFT_eSpriteAllocator *allocator)
+{
+  if (allocator) allocator->deallocate(ptr);
+  else free(ptr);
+}
+
+
+/***************************************************************************************
+** Function name:           setAllocator
+** Description:             Set the allocator used for Sprite memory
+***************************************************************************************/
+bool TFT_eSprite::setAllocator(TFT_eSpriteAllocator *allocator)
+{
+  // Memory must be returned to the allocator it came from
+  if (_created || _frozen) return false;
+
+  _allocator = allocator;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           getAllocator
+** Description:             Return the allocator, nullptr if the heap is used
+***************************************************************************************/
+TFT_eSpriteAllocator* TFT_eSprite::getAllocator(void)
+{
+  return _allocator;
+}
+
+
+constexpr uint16_t PaletteCache8 = 32; // Colour to 8 bpp palette index cache entries
+
+/***************************************************************************************
+** Function name:           allocPalette
+** Description:             Allocate the color map and return the number of entries
+***************************************************************************************/
+// An 8 bpp map has 256 entries followed by a cache of colour and index pairs, see pixel8()
+uint16_t TFT_eSprite::allocPalette(void)
+{
+  uint16_t colors = (_bpp == 8) ? 256 : 16;
+
+  // Allocate and clear memory for the color map
+  if (_colorMap == nullptr)
+  {
+    if (_bpp == 8) _colorMap = (uint16_t *)calloc(256 + 2 * PaletteCache8, sizeof(uint16_t));
+    else _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
+    if (_colorMap == nullptr) return 0;
+  }
+  else if (_bpp == 8) memset(_colorMap + 256, 0, 2 * PaletteCache8 * sizeof(uint16_t));
+
+  if (_bpp == 2) colors = 4; // 2 bpp palettes only have 4 colours
+
+  return colors;
+}
+
+
 /***************************************************************************************
 ** Function name:           createPalette (from RAM array)
-** Description:             Set a palette for a 4-bit per pixel sprite
+** Description:             Set a palette for a 8, 4 or 2-bit per pixel sprite
 ***************************************************************************************/
-void TFT_eSprite::createPalette(uint16_t colorMap[], uint8_t colors)
+void TFT_eSprite::createPalette(uint16_t colorMap[], uint16_t colors)
 {
   if (!_created) return;
 
   if (colorMap == nullptr)
   {
     // Create a color map using the default FLASH map
-    createPalette(default_4bit_palette);
+    createPalette((const uint16_t *)nullptr, colors);
     return;
   }
 
-  // Allocate and clear memory for 16 color map
-  if (_colorMap == nullptr) _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
-
-  if (colors > 16) colors = 16;
+  uint16_t size = allocPalette();
+  if (colors > size) colors = size;
 
   // Copy map colors
-  for (uint8_t i = 0; i < colors; i++)
+  for (uint16_t i = 0; i < colors; i++)
   {
     _colorMap[i] = colorMap[i];
   }
@@ -247,25 +322,30 @@ void TFT_eSprite::createPalette(uint16_t colorMap[], uint8_t colors)
 
 /***************************************************************************************
 ** Function name:           createPalette (from FLASH array)
-** Description:             Set a palette for a 4-bit per pixel sprite
+** Description:             Set a palette for a 8, 4 or 2-bit per pixel sprite
 ***************************************************************************************/
-void TFT_eSprite::createPalette(const uint16_t colorMap[], uint8_t colors)
+void TFT_eSprite::createPalette(const uint16_t colorMap[], uint16_t colors)
 {
   if (!_created) return;
 
+  uint16_t size = allocPalette();
+  if (colors > size) colors = size;
+
   if (colorMap == nullptr)
   {
+    // 8 bpp defaults to the RGB332 colours so the image is unchanged
+    if (_bpp == 8)
+    {
+      for (uint16_t i = 0; i < size; i++) _colorMap[i] = color8to16(i);
+      return;
+    }
+
     // Create a color map using the default FLASH map
-    colorMap = default_4bit_palette;
+    colorMap = (_bpp == 2) ? default_2bit_palette : default_4bit_palette;
   }
 
-  // Allocate and clear memory for 16 color map
-  if (_colorMap == nullptr) _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
-
-  if (colors > 16) colors = 16;
-
   // Copy map colors
-  for (uint8_t i = 0; i < colors; i++)
+  for (uint16_t i = 0; i < colors; i++)
   {
     _colorMap[i] = pgm_read_word(colorMap++);
   }
@@ -296,7 +376,7 @@ void* TFT_eSprite::frameBuffer(int8_t f)
 
 /***************************************************************************************
 ** Function name:           setColorDepth
-** Description:             Set bits per pixel for colour (1, 8 or 16)
+** Description:             Set bits per pixel for colour (1, 2, 4, 8 or 16)
 ***************************************************************************************/
 void* TFT_eSprite::setColorDepth(int8_t b)
 {
@@ -306,11 +386,12 @@ void* TFT_eSprite::setColorDepth(int8_t b)
   // Validate the new colour depth
   if ( b > 8 ) _bpp = 16;  // Bytes per pixel
   else if ( b > 4 ) _bpp = 8;
-  else if ( b > 1 ) _bpp = 4;
+  else if ( b > 2 ) _bpp = 4;
+  else if ( b > 1 ) _bpp = 2;
   else _bpp = 1;
 
   // Can't change an existing sprite's colour depth so delete and create a new one
-  if (_created) {
+  if (_created || _frozen) {
     deleteSprite();
     return createSprite(_dwidth, _dheight);
   }
@@ -321,7 +402,7 @@ void* TFT_eSprite::setColorDepth(int8_t b)
 
 /***************************************************************************************
 ** Function name:           getColorDepth
-** Description:             Get bits per pixel for colour (1, 8 or 16)
+** Description:             Get bits per pixel for colour (1, 2, 4, 8 or 16)
 ***************************************************************************************/
 int8_t TFT_eSprite::getColorDepth(void)
 {
@@ -344,23 +425,26 @@ void TFT_eSprite::setBitmapColor(uint16_t c, uint16_t b)
 
 /***************************************************************************************
 ** Function name:           setPaletteColor
-** Description:             Set the 4bpp palette color at the given index
+** Description:             Set the 8, 4 or 2 bpp palette color at the given index
 ***************************************************************************************/
 void TFT_eSprite::setPaletteColor(uint8_t index, uint16_t color)
 {
-  if (_colorMap == nullptr || index > 15) return; // out of bounds
+  if (_colorMap == nullptr || (index > 15 && _bpp != 8)) return; // out of bounds
 
   _colorMap[index] = color;
+
+  // Cached nearest indexes may no longer be nearest
+  if (_bpp == 8) memset(_colorMap + 256, 0, 2 * PaletteCache8 * sizeof(uint16_t));
 }
 
 
 /***************************************************************************************
 ** Function name:           getPaletteColor
-** Description:             Return the palette color at 4bpp index, or 0 on error.
+** Description:             Return the palette color at 8 or 4bpp index, or 0 on error.
 ***************************************************************************************/
 uint16_t TFT_eSprite::getPaletteColor(uint8_t index)
 {
-  if (_colorMap == nullptr || index > 15) return 0; // out of bounds
+  if (_colorMap == nullptr || (index > 15 && _bpp != 8)) return 0; // out of bounds
 
   return _colorMap[index];
 }
@@ -378,9 +462,17 @@ void TFT_eSprite::deleteSprite(void)
     _colorMap = nullptr;
   }
 
+  if (_frozen != nullptr)
+  {
+    freeSprite(_frozen, _frozenAllocator);
+    _frozen = nullptr;
+    _frozenSize = 0;
+    _frozenAllocator = nullptr;
+  }
+
   if (_created)
   {
-    free(_img8_1);
+    freeSprite(_img8_1, _allocator);
     _img8 = nullptr;
     _created = false;
     _vpOoB   = true;  // TFT_eSPI class write() uses this to check for valid sprite
@@ -388,6 +480,208 @@ void TFT_eSprite::deleteSprite(void)
 }
 
 
+/***************************************************************************************
+** Function name:           freeze
+** Description:             Compress the Sprite into runs and free the Sprite memory
+***************************************************************************************/
+// The frozen Sprite starts with a table of _dheight row offsets (uint32_t, bytes from the
+// start of the runs) followed by the rows. Each row is a list of packets:
+//   16 bpp: uint16_t control word, bit 15 set: run of (bits 0-14) + 1 copies of the next word
+//                                  bit 15 clear: (bits 0-14) + 1 literal words follow
+//    8 bpp: uint8_t control byte,  bit 7 set: run of (bits 0-6) + 1 copies of the next byte
+//                                  bit 7 clear: (bits 0-6) + 1 literal bytes follow
+// Pixel values are stored as in the Sprite (byte swapped 565 or RGB332) so 16 bpp literals
+// can be sent to the TFT as they are.
+bool TFT_eSprite::freeze(TFT_eSpriteAllocator *allocator)
+{
+  if (!_created || (_bpp != 16 && _bpp != 8)) return false;
+
+  // Only one frame can be frozen
+  if (_img8_1 != _img8_2) return false;
+
+  uint32_t size = 0;
+  for (int32_t y = 0; y < _dheight; y++) size += freezeRow(y, nullptr);
+
+  // The frozen copy is made while the Sprite memory is still held, so it is not taken from the
+  // Sprite allocator: a pool would need a spare block and an arena could not unwind the Sprite
+  uint32_t tableSize = _dheight * sizeof(uint32_t);
+  uint8_t* ptr8 = (uint8_t*)allocSprite(tableSize + size, allocator, _psram_enable);
+
+  if (ptr8 == nullptr) return false;
+
+  uint32_t* offset = (uint32_t*)ptr8;
+  uint8_t*  runs   = ptr8 + tableSize;
+  uint32_t  pos    = 0;
+  for (int32_t y = 0; y < _dheight; y++) {
+    offset[y] = pos;
+    pos += freezeRow(y, runs + pos);
+  }
+
+  // Free the Sprite memory, the Sprite keeps its size, viewport, palette and settings
+  bool vpOoB = _vpOoB;
+  uint16_t* colorMap = _colorMap;
+  _colorMap = nullptr;
+  deleteSprite();
+  _colorMap = colorMap;
+
+  _frozen      = ptr8;
+  _frozenSize  = tableSize + size;
+  _frozenVpOoB = vpOoB;
+  _frozenAllocator = allocator;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           freezeRow
+** Description:             Encode a Sprite row as runs and literals
+***************************************************************************************/
+uint32_t TFT_eSprite::freezeRow(int32_t y, uint8_t *out)
+{
+  bool     wide = (_bpp == 16);
+  uint32_t maxCount = wide ? 0x8000 : 0x80;
+  uint32_t bytes = 0;
+
+  // Runs shorter than 3 pixels are kept in literals as they save no memory
+  const uint8_t  minRun = 3;
+
+  uint16_t* row16 = _img + y * _iwidth;
+  uint8_t*  row8  = _img8 + y * _iwidth;
+  #define FREEZE_PIXEL(i) (wide ? row16[i] : row8[i])
+
+  int32_t x = 0;
+  while (x < _dwidth)
+  {
+    // Length of the run starting at x
+    uint32_t run = 1;
+    while (x + run < (uint32_t)_dwidth && run < maxCount && FREEZE_PIXEL(x + run) == FREEZE_PIXEL(x)) run++;
+
+    uint32_t start = x;
+    uint32_t count;
+    bool     isRun = (run >= minRun);
+
+    if (isRun) {
+      count = run;
+      x += run;
+    }
+    else {
+      // Extend the literal up to the next run worth encoding
+      while (x < _dwidth && x - start < maxCount) {
+        uint32_t r = 1;
+        while (x + r < (uint32_t)_dwidth && r < minRun && FREEZE_PIXEL(x + r) == FREEZE_PIXEL(x)) r++;
+        if (r >= minRun) break;
+        x++;
+      }
+      count = x - start;
+    }
+
+    uint32_t values = isRun ? 1 : count;
+
+    if (wide) {
+      if (out) {
+        uint16_t* out16 = (uint16_t*)(out + bytes);
+        *out16++ = (isRun ? 0x8000 : 0) | (count - 1);
+        memcpy(out16, row16 + start, values * 2);
+      }
+      bytes += 2 + values * 2;
+    }
+    else {
+      if (out) {
+        out[bytes] = (isRun ? 0x80 : 0) | (count - 1);
+        memcpy(out + bytes + 1, row8 + start, values);
+      }
+      bytes += 1 + values;
+    }
+  }
+
+  #undef FREEZE_PIXEL
+
+  return bytes;
+}
+
+
+/***************************************************************************************
+** Function name:           thaw
+** Description:             Decompress a frozen Sprite back into Sprite memory
+***************************************************************************************/
+bool TFT_eSprite::thaw(void)
+{
+  if (!_frozen) return false;
+
+  uint8_t* ptr8 = (uint8_t*)callocSprite(_dwidth, _dheight, 1);
+  if (ptr8 == nullptr) return false;
+
+  uint32_t* offset = (uint32_t*)_frozen;
+  uint8_t*  runs   = _frozen + _dheight * sizeof(uint32_t);
+
+  for (int32_t y = 0; y < _dheight; y++)
+  {
+    uint8_t* in = runs + offset[y];
+    int32_t  x = 0;
+
+    if (_bpp == 16) {
+      uint16_t* in16 = (uint16_t*)in;
+      uint16_t* out  = (uint16_t*)ptr8 + y * _iwidth;
+      while (x < _dwidth) {
+        uint16_t control = *in16++;
+        uint32_t count = (control & 0x7FFF) + 1;
+        if (control & 0x8000) { uint16_t color = *in16++; while (count--) out[x++] = color; }
+        else { memcpy(out + x, in16, count * 2); in16 += count; x += count; }
+      }
+    }
+    else {
+      uint8_t* out = ptr8 + y * _iwidth;
+      while (x < _dwidth) {
+        uint8_t  control = *in++;
+        uint32_t count = (control & 0x7F) + 1;
+        if (control & 0x80) { memset(out + x, *in++, count); }
+        else { memcpy(out + x, in, count); in += count; }
+        x += count;
+      }
+    }
+  }
+
+  freeSprite(_frozen, _frozenAllocator);
+  _frozen     = nullptr;
+  _frozenSize = 0;
+  _frozenAllocator = nullptr;
+
+  _img8   = ptr8;
+  _img8_1 = ptr8;
+  _img8_2 = ptr8;
+  _img    = (uint16_t*) ptr8;
+  _img4   = ptr8;
+
+  _created = true;
+  _vpOoB   = _frozenVpOoB;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           frozen
+** Description:             Returns true if the Sprite is frozen
+***************************************************************************************/
+bool TFT_eSprite::frozen(void)
+{
+  return _frozen != nullptr;
+}
+
+
+/***************************************************************************************
+** Function name:           compressionRatio
+** Description:             Returns Sprite memory size / frozen size
+***************************************************************************************/
+float TFT_eSprite::compressionRatio(void)
+{
+  if (!_frozen) return 0;
+
+  return (float)TFT_eSpriteAllocator::spriteSize(_dwidth, _dheight, _bpp) / _frozenSize;
+}
+
+
 /***************************************************************************************
 ** Function name:           pushRotated - Fast fixed point integer maths version
 ** Description:             Push rotated Sprite to TFT screen
@@ -407,17 +701,25 @@ bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
   if ( !getRotatedBounds(angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
   uint16_t sline_buffer[max_x - min_x + 1];
+  uint16_t lut[(_bpp == 8) ? 256 : 16];
+  sampleTable(lut);
 
   int32_t xt = min_x - _tft->_xPivot;
   int32_t yt = min_y - _tft->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
+  bool     swapWH = (_bpp == 1 && (rotation & 1)); // Rotated 1 bpp Sprite
+  uint32_t xe = (swapWH ? _dheight : _dwidth) << FP_SCALE;
+  uint32_t ye = (swapWH ? _dwidth : _dheight) << FP_SCALE;
+  bool     useTransp = (transp != 0x00FFFFFF);
   uint16_t tpcolor = (uint16_t)transp;
 
-  if (transp != 0x00FFFFFF) {
-    if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
+  if (useTransp) {
+    if (_bpp == 4 || _bpp == 2) tpcolor = _colorMap[transp & 0x0F];
+    else if (_bpp == 8 && _colorMap) tpcolor = _colorMap[pixel8(tpcolor)];
     tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
   }
+
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
   _tft->startWrite(); // Avoid transaction overhead for every tft pixel
 
   // Scan destination bounding box and fetch transformed pixels from source Sprite
@@ -429,33 +731,18 @@ bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
     while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
     if (x == max_x) continue;
 
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) {rp = _img[xp + yp * _iwidth]; }
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          // TFT window is already clipped, so this is faster than pushImage()
-          _tft->setWindow(x - pixel_count, y, x - 1, y);
-          _tft->pushPixels(sline_buffer, pixel_count);
-          pixel_count = 0;
-        }
-      }
-      else {
-        sline_buffer[pixel_count++] = rp;
-      }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) {
-      // TFT window is already clipped, so this is faster than pushImage()
-      _tft->setWindow(x - pixel_count, y, x - 1, y);
-      _tft->pushPixels(sline_buffer, pixel_count);
-    }
+    // Count the pixels inside the Sprite, then sample them in one pass
+    int32_t  xl = x;
+    uint32_t xp = xs, yp = ys;
+    while (++x < max_x && (xp += _cosra) < xe && (yp += _sinra) < ye);
+
+    sampleLine(sline_buffer, lut, xs << (16 - FP_SCALE), ys << (16 - FP_SCALE),
+               _cosra * (1 << (16 - FP_SCALE)), _sinra * (1 << (16 - FP_SCALE)), x - xl);
+    pushSampled(nullptr, xl, y, sline_buffer, x - xl, useTransp, tpcolor);
   }
 
   _tft->endWrite(); // End transaction
+  _tft->setSwapBytes(oldSwapBytes);
 
   return true;
 }
@@ -465,11 +752,13 @@ bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
 ** Function name:           pushRotated - Fast fixed point integer maths version
 ** Description:             Push a rotated copy of the Sprite to another Sprite
 ***************************************************************************************/
-// Not compatible with 4bpp
+// The destination Sprite must be 16 or 8 bpp, or 4 or 2 bpp if this Sprite has the same
+// depth. In that case palette indexes are copied so both Sprites should use the same palette
 bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
 {
-  if ( !_created  || _bpp == 4) return false; // Check this Sprite is created
-  if ( !spr->_created  || spr->_bpp == 4) return false;  // Ckeck destination Sprite is created
+  if ( !_created || spr == this) return false; // Check this Sprite is created
+  if ( !spr->_created ) return false;  // Ckeck destination Sprite is created
+  if ( spr->_bpp == 1 || (spr->_bpp < 8 && spr->_bpp != _bpp)) return false;
 
   // Bounding box parameters
   int16_t min_x;
@@ -481,16 +770,27 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
   if ( !getRotatedBounds(spr, angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
   uint16_t sline_buffer[max_x - min_x + 1];
+  uint16_t lut[(_bpp == 8) ? 256 : 16];
+  sampleTable(lut);
+
+  // 4 (or 2) bpp to 4 (or 2) bpp copies the palette indexes
+  if (spr->_bpp < 8) for (uint8_t i = 0; i < 16; i++) lut[i] = i;
 
   int32_t xt = min_x - spr->_xPivot;
   int32_t yt = min_y - spr->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
+  bool     swapWH = (_bpp == 1 && (rotation & 1)); // Rotated 1 bpp Sprite
+  uint32_t xe = (swapWH ? _dheight : _dwidth) << FP_SCALE;
+  uint32_t ye = (swapWH ? _dwidth : _dheight) << FP_SCALE;
+  bool     useTransp = (transp != 0x00FFFFFF);
   uint16_t tpcolor = (uint16_t)transp;
   
-  if (transp != 0x00FFFFFF) {
-    if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
-    tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
+  if (useTransp) {
+    if (spr->_bpp < 8) tpcolor = transp & 0x0F;
+    else {
+      if (_bpp == 4 || _bpp == 2) tpcolor = _colorMap[transp & 0x0F];
+      else if (_bpp == 8 && _colorMap) tpcolor = _colorMap[pixel8(tpcolor)];
+      tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
+    }
   }
 
   bool oldSwapBytes = spr->getSwapBytes();
@@ -505,25 +805,16 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
     while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
     if (x == max_x) continue;
 
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) rp = _img[xp + yp * _iwidth];
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
-          pixel_count = 0;
-        }
-      }
-      else {
-        sline_buffer[pixel_count++] = rp;
-      }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
+    // Count the pixels inside the Sprite, then sample them in one pass
+    int32_t  xl = x;
+    uint32_t xp = xs, yp = ys;
+    while (++x < max_x && (xp += _cosra) < xe && (yp += _sinra) < ye);
+
+    sampleLine(sline_buffer, lut, xs << (16 - FP_SCALE), ys << (16 - FP_SCALE),
+               _cosra * (1 << (16 - FP_SCALE)), _sinra * (1 << (16 - FP_SCALE)), x - xl);
+    pushSampled(spr, xl, y, sline_buffer, x - xl, useTransp, tpcolor);
   }
+
   spr->setSwapBytes(oldSwapBytes);
   return true;
 }
@@ -653,1330 +944,3056 @@ void TFT_eSprite::getRotatedBounds(int16_t angle, int16_t w, int16_t h, int16_t
 
 
 /***************************************************************************************
-** Function name:           pushSprite
-** Description:             Push the sprite to the TFT at x, y
+** Function name:           pushTransformed
+** Description:             Push an affine transformed copy of the Sprite to the TFT
 ***************************************************************************************/
-void TFT_eSprite::pushSprite(int32_t x, int32_t y)
+bool TFT_eSprite::pushTransformed(const float m[6], uint8_t filter, uint32_t transp)
 {
-  if (!_created) return;
+  if ( !_created || _tft->_vpOoB) return false;
 
-  if (_bpp == 16)
-  {
-    bool oldSwapBytes = _tft->getSwapBytes();
-    _tft->setSwapBytes(false);
-    _tft->pushImage(x, y, _dwidth, _dheight, _img );
-    _tft->setSwapBytes(oldSwapBytes);
-  }
-  else if (_bpp == 4)
-  {
-    _tft->pushImage(x, y, _dwidth, _dheight, _img4, false, _colorMap);
-  }
-  else _tft->pushImage(x, y, _dwidth, _dheight, _img8, (bool)(_bpp == 8));
-}
+  // Work in absolute TFT coordinates so the viewport is the clip area
+  float ma[6] = { m[0], m[1], m[2] + _tft->_xDatum, m[3], m[4], m[5] + _tft->_yDatum };
 
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+  _tft->startWrite(); // Avoid transaction overhead for every tft pixel
 
-/***************************************************************************************
-** Function name:           pushSprite
-** Description:             Push the sprite to the TFT at x, y with transparent colour
-***************************************************************************************/
-void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp)
-{
-  if (!_created) return;
+  transformRows(nullptr, ma, _tft->_vpX, _tft->_vpY, _tft->_vpW - 1, _tft->_vpH - 1, filter, transp);
 
-  if (_bpp == 16)
-  {
-    bool oldSwapBytes = _tft->getSwapBytes();
-    _tft->setSwapBytes(false);
-    _tft->pushImage(x, y, _dwidth, _dheight, _img, transp );
-    _tft->setSwapBytes(oldSwapBytes);
-  }
-  else if (_bpp == 8)
-  {
-    transp = (uint8_t)((transp & 0xE000)>>8 | (transp & 0x0700)>>6 | (transp & 0x0018)>>3);
-    _tft->pushImage(x, y, _dwidth, _dheight, _img8, (uint8_t)transp, (bool)true);
-  }
-  else if (_bpp == 4)
-  {
-    _tft->pushImage(x, y, _dwidth, _dheight, _img4, (uint8_t)(transp & 0x0F), false, _colorMap);
-  }
-  else _tft->pushImage(x, y, _dwidth, _dheight, _img8, 0, (bool)false);
+  _tft->endWrite(); // End transaction
+  _tft->setSwapBytes(oldSwapBytes);
+
+  return true;
 }
 
 
 /***************************************************************************************
-** Function name:           pushToSprite
-** Description:             Push the sprite to another sprite at x, y
+** Function name:           pushTransformed
+** Description:             Push an affine transformed copy of the Sprite to another Sprite
 ***************************************************************************************/
-// Note: The following sprite to sprite colour depths are currently supported:
-//    Source    Destination
-//    16bpp  -> 16bpp
-//    16bpp  ->  8bpp
-//     8bpp  ->  8bpp
-//     4bpp  ->  4bpp (note: color translation depends on the 2 sprites palette colors)
-//     1bpp  ->  1bpp (note: color translation depends on the 2 sprites bitmap colors)
-
-bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y)
+bool TFT_eSprite::pushTransformed(TFT_eSprite *spr, const float m[6], uint8_t filter, uint32_t transp)
 {
-  if (!_created) return false;
-  if (!dspr->created()) return false;
+  if ( !_created  || spr == this) return false; // Check this Sprite is created
+  if ( !spr->_created || spr->_vpOoB) return false;  // Check destination Sprite is created
+  if ( spr->_bpp == 1 || (spr->_bpp < 8 && (_bpp != spr->_bpp || filter != SAMPLE_NEAREST))) return false;
 
-  // Check destination sprite compatibility
-  int8_t ds_bpp = dspr->getColorDepth();
-  if (_bpp == 16 && ds_bpp != 16 && ds_bpp !=  8) return false;
-  if (_bpp ==  8 && ds_bpp !=  8) return false;
-  if (_bpp ==  4 && ds_bpp !=  4) return false;
-  if (_bpp ==  1 && ds_bpp !=  1) return false;
+  bool oldSwapBytes = spr->getSwapBytes();
+  spr->setSwapBytes(false);
 
-  bool oldSwapBytes = dspr->getSwapBytes();
-  dspr->setSwapBytes(false);
-  dspr->pushImage(x, y, _dwidth, _dheight, _img, _bpp);
-  dspr->setSwapBytes(oldSwapBytes);
+  // Clip to the destination viewport, pushImage() adds the destination datum
+  transformRows(spr, m, spr->_vpX - spr->_xDatum, spr->_vpY - spr->_yDatum,
+                spr->_vpW - spr->_xDatum - 1, spr->_vpH - spr->_yDatum - 1, filter, transp);
+
+  spr->setSwapBytes(oldSwapBytes);
 
   return true;
 }
 
 
 /***************************************************************************************
-** Function name:           pushToSprite
-** Description:             Push the sprite to another sprite at x, y with transparent colour
+** Function name:           getTransform
+** Description:             Set matrix to scale and rotate about the pivot, then move it
 ***************************************************************************************/
-// Note: The following sprite to sprite colour depths are currently supported:
-//    Source    Destination
-//    16bpp  -> 16bpp
-//    16bpp  ->  8bpp
-//     8bpp  ->  8bpp
-//     1bpp  ->  1bpp
-
-bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transp)
+void TFT_eSprite::getTransform(float m[6], float angle, float sx, float sy, float x, float y)
 {
-  if ( !_created  || !dspr->_created) return false; // Check Sprites exist
+  // Positive angles rotate clockwise on the screen, as for pushRotated()
+  float radAngle = angle * 0.0174532925;
+  float sina = sin(radAngle);
+  float cosa = cos(radAngle);
 
-  // Check destination sprite compatibility
-  int8_t ds_bpp = dspr->getColorDepth();
-  if (_bpp == 16 && ds_bpp != 16 && ds_bpp !=  8) return false;
-  if (_bpp ==  8 && ds_bpp !=  8) return false;
-  if (_bpp ==  4 || ds_bpp ==  4) return false;
-  if (_bpp ==  1 && ds_bpp !=  1) return false;
+  m[0] = sx * cosa; m[1] = -sy * sina;
+  m[3] = sx * sina; m[4] =  sy * cosa;
+  m[2] = x - m[0] * _xPivot - m[1] * _yPivot;
+  m[5] = y - m[3] * _xPivot - m[4] * _yPivot;
+}
 
-  bool oldSwapBytes = dspr->getSwapBytes();
-  uint16_t sline_buffer[width()];
 
-  transp = transp>>8 | transp<<8;
+/***************************************************************************************
+** Function name:           transformRows
+** Description:             Render the transformed Sprite within the clip area
+***************************************************************************************/
+// Each destination pixel centre is mapped back into the Sprite with the inverse matrix.
+// The visible span of a row is found analytically, then Q16 source coordinates are
+// stepped along it. Transparent pixels split a row into separately pushed runs.
+void TFT_eSprite::transformRows(TFT_eSprite *spr, const float m[6], int32_t x0, int32_t y0,
+                                int32_t x1, int32_t y1, uint8_t filter, uint32_t transp)
+{
+  float det = m[0] * m[4] - m[1] * m[3];
+  if (fabsf(det) < 1.0E-6f) return; // Sprite squashed to a line
+
+  // Inverse matrix
+  float ia =  m[4] / det, ib = -m[1] / det;
+  float id = -m[3] / det, ie =  m[0] / det;
+  float ic = -(ia * m[2] + ib * m[5]);
+  float ig = -(id * m[2] + ie * m[5]);
+
+  // Size in rotated coordinates for a rotated 1 bpp Sprite
+  bool    swapWH = (_bpp == 1 && (rotation & 1));
+  int32_t w = swapWH ? _dheight : _dwidth;
+  int32_t h = swapWH ? _dwidth : _dheight;
+
+  // Destination bounding box of the Sprite corners, clipped to the clip area
+  float minx = m[2], maxx = m[2], miny = m[5], maxy = m[5];
+  for (uint8_t i = 1; i < 4; i++) {
+    float cx = (i & 1) ? w : 0;
+    float cy = (i & 2) ? h : 0;
+    float px = m[0] * cx + m[1] * cy + m[2];
+    float py = m[3] * cx + m[4] * cy + m[5];
+    if (px < minx) minx = px;
+    if (px > maxx) maxx = px;
+    if (py < miny) miny = py;
+    if (py > maxy) maxy = py;
+  }
+  if (minx > x1 || maxx < x0 || miny > y1 || maxy < y0) return;
+  if (minx > x0) x0 = floorf(minx);
+  if (maxx < x1) x1 = ceilf(maxx);
+  if (miny > y0) y0 = floorf(miny);
+  if (maxy < y1) y1 = ceilf(maxy);
+
+  bool     useTransp = (transp != 0x00FFFFFF);
+  uint16_t tp565 = (uint16_t)transp;
+  if (useTransp && (_bpp == 4 || _bpp == 2)) tp565 = _colorMap[transp & 0x0F];
+  else if (useTransp && _bpp == 8 && _colorMap) tp565 = _colorMap[pixel8(tp565)];
+  uint16_t tpcolor = tp565>>8 | tp565<<8; // Working with swapped color bytes
+
+  uint16_t sline_buffer[x1 - x0 + 1];
+  uint16_t lut[(_bpp == 8) ? 256 : 16];
+  sampleTable(lut);
+
+  // 4 (or 2) bpp to 4 (or 2) bpp copies the palette indexes
+  if (spr && spr->_bpp < 8) {
+    for (uint8_t i = 0; i < 16; i++) lut[i] = i;
+    tpcolor = transp & 0x0F;
+  }
 
-  // Scan destination bounding box and fetch transformed pixels from source Sprite
-  for (int32_t ys = 0; ys < height(); ys++) {
-    int32_t ox = x;
-    uint32_t pixel_count = 0;
-
-    for (int32_t xs = 0; xs < width(); xs++) {
-      uint16_t rp = 0;
-      if (_bpp == 16) rp = _img[xs + ys * width()];
-      else { rp = readPixel(xs, ys); rp = rp>>8 | rp<<8; }
-      //dspr->drawPixel(xs, ys, rp);
-
-      if (transp == rp) {
-        if (pixel_count) {
-          dspr->pushImage(ox, y, pixel_count, 1, sline_buffer, _bpp);
-          ox += pixel_count;
-          pixel_count = 0;
+  int32_t  dx = lroundf(ia * 65536.0f);
+  int32_t  dy = lroundf(id * 65536.0f);
+  uint32_t xe = w << 16;
+  uint32_t ye = h << 16;
+
+  for (int32_t y = y0; y <= y1; y++) {
+    // Source coordinates of the pixel centre at x = 0 on this row
+    float xr0 = ia * 0.5f + ib * (y + 0.5f) + ic;
+    float yr0 = id * 0.5f + ie * (y + 0.5f) + ig;
+
+    // Find span where 0 <= xs < w and 0 <= ys < h
+    float sl = x0, sr = x1;
+    if (!transformSpan(xr0, ia, w, &sl, &sr) || !transformSpan(yr0, id, h, &sl, &sr)) continue;
+
+    int32_t xl = ceilf(sl);
+    int32_t xr = floorf(sr);
+    int32_t xs = lroundf((xr0 + ia * xl) * 65536.0f);
+    int32_t ys = lroundf((yr0 + id * xl) * 65536.0f);
+
+    // Rounding can differ between float and fixed point so adjust the span ends
+    if (xl > x0 && (uint32_t)(xs - dx) < xe && (uint32_t)(ys - dy) < ye) { xl--; xs -= dx; ys -= dy; }
+    while (xl <= xr && ((uint32_t)xs >= xe || (uint32_t)ys >= ye)) { xl++; xs += dx; ys += dy; }
+    int32_t xt = xs + dx * (xr - xl);
+    int32_t yt = ys + dy * (xr - xl);
+    if (xr < x1 && (uint32_t)(xt + dx) < xe && (uint32_t)(yt + dy) < ye) xr++;
+    else while (xr >= xl && ((uint32_t)xt >= xe || (uint32_t)yt >= ye)) { xr--; xt -= dx; yt -= dy; }
+    if (xl > xr) continue;
+
+    int32_t n = xr - xl + 1;
+
+    if (filter == SAMPLE_BILINEAR) {
+      for (int32_t i = 0; i < n; i++, xs += dx, ys += dy) {
+        // Sample point relative to the centre of the top left pixel of the 2x2 block
+        int32_t  xf = xs - 0x8000, yf = ys - 0x8000;
+        int32_t  tx = xf >> 16, ty = yf >> 16;
+        // Fractions rounded to 0 - 256, 256 puts all the weight on the right or lower pixel
+        uint32_t fx = ((xf & 0xFFFF) + 0x80) >> 8, fy = ((yf & 0xFFFF) + 0x80) >> 8;
+        uint32_t r = 0, g = 0, b = 0, a = 0;
+
+        // Weights are fractions of 65536, pixels with no weight are not read
+        for (uint8_t k = 0; k < 4; k++) {
+          int32_t  px = tx + (k & 1), py = ty + (k >> 1);
+          uint32_t wt = ((k & 1) ? fx : 256 - fx) * ((k >> 1) ? fy : 256 - fy);
+          if (wt == 0) continue;
+          if (px < 0 || px >= w || py < 0 || py >= h) {
+            if (useTransp) continue; // Outside is transparent
+            if (px < 0) px = 0; else if (px >= w) px = w - 1;
+            if (py < 0) py = 0; else if (py >= h) py = h - 1;
+          }
+          uint16_t c = readTexel(px, py, lut);
+          if (useTransp && c == tp565) continue;
+          r += (c >> 11) * wt;
+          g += ((c >> 5) & 0x3F) * wt;
+          b += (c & 0x1F) * wt;
+          a += wt;
         }
-        ox++;
-      }
-      else {
-        sline_buffer[pixel_count++] = rp;
+
+        // Less than half covered by opaque pixels is transparent, else average opaque pixels
+        if (a == 0 || (useTransp && a < 0x8000)) { sline_buffer[i] = tpcolor; continue; }
+        uint16_t c;
+        if (a == 0x10000) c = ((r + 0x8000) >> 16) << 11 | ((g + 0x8000) >> 16) << 5 | ((b + 0x8000) >> 16);
+        else c = ((r + (a >> 1)) / a) << 11 | ((g + (a >> 1)) / a) << 5 | ((b + (a >> 1)) / a);
+        if (useTransp && c == tp565) c ^= 1; // Keep opaque pixels opaque
+        sline_buffer[i] = c >> 8 | c << 8;
       }
     }
-    if (pixel_count) dspr->pushImage(ox, y, pixel_count, 1, sline_buffer);
-    y++;
+    else sampleLine(sline_buffer, lut, xs, ys, dx, dy, n);
+
+    pushSampled(spr, xl, y, sline_buffer, n, useTransp, tpcolor);
   }
-  dspr->setSwapBytes(oldSwapBytes);
-  return true;
 }
 
 
 /***************************************************************************************
-** Function name:           pushSprite
-** Description:             Push a cropped sprite to the TFT at tx, ty
+** Function name:           transformSpan
+** Description:             Narrow xl to xr to where 0 <= p + dp * x < lim
 ***************************************************************************************/
-bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh)
+bool TFT_eSprite::transformSpan(float p, float dp, float lim, float *xl, float *xr)
 {
-  if (!_created) return false;
-
-  // Perform window boundary checks and crop if needed
-  setWindow(sx, sy, sx + sw - 1, sy + sh - 1);
-
-  /* These global variables are now populated for the sprite
-  _xs = x start coordinate
-  _ys = y start coordinate
-  _xe = x end coordinate (inclusive)
-  _ye = y end coordinate (inclusive)
-  */
+  if (fabsf(dp) < 1.0E-7f) return (p >= 0 && p < lim);
 
-  // Calculate new sprite window bounding box width and height
-  sw = _xe - _xs + 1;
-  sh = _ye - _ys + 1;
+  float t0 = -p / dp;
+  float t1 = (lim - p) / dp;
+  if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
 
-  if (_ys >= _iheight) return false;
+  if (t0 > *xl) *xl = t0;
+  if (t1 < *xr) *xr = t1;
 
-  if (_bpp == 16)
-  {
-    bool oldSwapBytes = _tft->getSwapBytes();
-    _tft->setSwapBytes(false);
+  return *xl <= *xr;
+}
 
-    // Check if a faster block copy to screen is possible
-    if ( sx == 0 && sw == _dwidth)
-      _tft->pushImage(tx, ty, sw, sh, _img + _iwidth * _ys );
-    else // Render line by line
-      while (sh--)
-        _tft->pushImage(tx, ty++, sw, 1, _img + _xs + _iwidth * _ys++ );
 
-    _tft->setSwapBytes(oldSwapBytes);
-  }
-  else if (_bpp == 8)
-  {
-    // Check if a faster block copy to screen is possible
-    if ( sx == 0 && sw == _dwidth)
-      _tft->pushImage(tx, ty, sw, sh, _img8 + _iwidth * _ys, (bool)true );
-    else // Render line by line
-    while (sh--)
-      _tft->pushImage(tx, ty++, sw, 1, _img8 + _xs + _iwidth * _ys++, (bool)true );
+/***************************************************************************************
+** Function name:           pushSampled
+** Description:             Push a sampled line to a Sprite or the TFT, skipping transparent
+***************************************************************************************/
+// Destination coordinates are absolute TFT coordinates or destination Sprite coordinates
+void TFT_eSprite::pushSampled(TFT_eSprite *spr, int32_t x, int32_t y, uint16_t *buf, int32_t n,
+                              bool useTransp, uint16_t tpcolor)
+{
+  int32_t i = 0;
+  while (i < n) {
+    if (useTransp) while (i < n && buf[i] == tpcolor) i++;
+    int32_t s = i;
+    if (useTransp) while (i < n && buf[i] != tpcolor) i++;
+    else i = n;
+    if (i == s) break;
+
+    if (!spr) {
+      // TFT window is already clipped, so this is faster than pushImage()
+      _tft->setWindow(x + s, y, x + i - 1, y);
+      _tft->pushPixels(buf + s, i - s);
+    }
+    else if (spr->_bpp < 8) {
+      // Palette indexes, runs of one index are clipped and written into Sprite memory
+      int32_t ym = y + spr->_yDatum;
+      if (ym < spr->_vpY || ym >= spr->_vpH) return;
+      int32_t xm = x + spr->_xDatum;
+      int32_t p  = (xm + s < spr->_vpX) ? spr->_vpX - xm : s;
+      int32_t e  = (xm + i > spr->_vpW) ? spr->_vpW - xm : i;
+      while (p < e) {
+        int32_t q = p + 1;
+        while (q < e && buf[q] == buf[p]) q++;
+        spr->fillRun(xm + p, xm + q - 1, ym, buf[p]);
+        p = q;
+      }
+    }
+    else spr->pushImage(x + s, y, i - s, 1, buf + s);
   }
-  else if (_bpp == 4)
-  {
-    // Check if a faster block copy to screen is possible
-    if ( sx == 0 && sw == _dwidth)
-      _tft->pushImage(tx, ty, sw, sh, _img4 + (_iwidth>>1) * _ys, false, _colorMap );
-    else // Render line by line
-    {
-      int32_t ds = _xs&1; // Odd x start pixel
+}
 
-      int32_t de = 0;     // Odd x end pixel
-      if ((sw > ds) && (_xe&1)) de = 1;
 
-      uint32_t dm = 0;     // Midsection pixel count
-      if (sw > (ds+de)) dm = sw - ds - de;
-      sw--;
+/***************************************************************************************
+** Function name:           sampleTable
+** Description:             Fill a table converting pixel values to byte swapped 565
+***************************************************************************************/
+// 256 entries are needed for 8 bpp, 16 for 4, 4 for 2 and 2 for 1 bpp. Not used for 16 bpp
+void TFT_eSprite::sampleTable(uint16_t *lut)
+{
+  uint16_t color;
 
-      uint32_t yp = (_xs + ds + _iwidth * _ys)>>1;
-      _tft->startWrite();
-      while (sh--)
-      {
-        if (ds) _tft->drawPixel(tx, ty, readPixel(_xs, _ys) );
-        if (dm) _tft->pushImage(tx + ds, ty, dm, 1, _img4 + yp, false, _colorMap );
-        if (de) _tft->drawPixel(tx + sw, ty, readPixel(_xe, _ys) );
-        _ys++;
-        ty++;
-        yp += (_iwidth>>1);
-      }
-      _tft->endWrite();
+  if (_bpp == 8) {
+    for (uint16_t i = 0; i < 256; i++) {
+      color = color8(i);
+      lut[i] = color >> 8 | color << 8;
     }
   }
-  else // 1bpp
-  {
-    // Check if a faster block copy to screen is possible
-    if ( sx == 0 && sw == _dwidth)
-      _tft->pushImage(tx, ty, sw, sh, _img8 + (_bitwidth>>3) * _ys, (bool)false );
-    else // Render line by line
-    {
-      _tft->startWrite();
-      while (sh--)
-      {
-        _tft->pushImage(tx, ty++, sw, 1, _img8 + (_bitwidth>>3) * _ys++, (bool)false );
-      }
-      _tft->endWrite();
+  else if (_bpp == 4 || _bpp == 2) {
+    for (uint8_t i = 0; i < (1 << _bpp); i++) {
+      color = _colorMap[i];
+      lut[i] = color >> 8 | color << 8;
     }
   }
-
-  return true;
+  else if (_bpp == 1) {
+    color = _tft->bitmap_bg;
+    lut[0] = color >> 8 | color << 8;
+    color = _tft->bitmap_fg;
+    lut[1] = color >> 8 | color << 8;
+  }
 }
 
 
 /***************************************************************************************
-** Function name:           readPixelValue
-** Description:             Read the color map index of a pixel at defined coordinates
+** Function name:           readTexel
+** Description:             Read the 565 colour of a pixel in Sprite memory
 ***************************************************************************************/
-uint16_t TFT_eSprite::readPixelValue(int32_t x, int32_t y)
+uint16_t TFT_eSprite::readTexel(int32_t x, int32_t y, const uint16_t *lut)
 {
-  if (_vpOoB  || !_created) return 0xFF;
+  uint16_t color;
 
-  x+= _xDatum;
-  y+= _yDatum;
+  if (_bpp == 16) color = _img[x + y * _iwidth];
+  else if (_bpp == 8) color = lut[_img8[x + y * _iwidth]];
+  else if (_bpp == 4) color = lut[(_img4[(x + y * _iwidth)>>1] >> ((x & 1) ? 0 : 4)) & 0x0F];
+  else if (_bpp == 2) color = lut[(_img8[(x + y * _iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03];
+  else {
+    if (rotation) rotatedXY(&x, &y);
+    color = lut[(_img8[(x + y * _bitwidth)>>3] >> (7 - (x & 0x7))) & 0x01];
+  }
 
-  // Range checking
-  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return 0xFF;
+  return (color >> 8) | (color << 8);
+}
 
-  if (_bpp == 16)
-  {
-    // Return the pixel colour
-    return readPixel(x - _xDatum, y - _yDatum);
-  }
 
-  if (_bpp == 8)
-  {
-    // Return the pixel byte value
-    return _img8[x + y * _iwidth];
-  }
+/***************************************************************************************
+** Function name:           rotatedXY
+** Description:             Map rotated 1 bpp Sprite coordinates to Sprite memory
+***************************************************************************************/
+// As drawPixel() maps them. Coordinates are from the rotated top left, no datum
+void TFT_eSprite::rotatedXY(int32_t *x, int32_t *y)
+{
+  int32_t tx = *x;
+  if (rotation == 1)      { *x = _dwidth - *y - 1; *y = tx; }
+  else if (rotation == 2) { *x = _dwidth - tx - 1; *y = _dheight - *y - 1; }
+  else if (rotation == 3) { *x = *y;               *y = _dheight - tx - 1; }
+}
 
-  if (_bpp == 4)
-  {
-    if (x >= _dwidth) return 0xFF;
-    if ((x & 0x01) == 0)
-      return _img4[((x+y*_iwidth)>>1)] >> 4;   // even index = bits 7 .. 4
-    else
-      return _img4[((x+y*_iwidth)>>1)] & 0x0F; // odd index = bits 3 .. 0.
-  }
 
-  if (_bpp == 1)
-  {
-    // Note: _dwidth and _dheight bounds not checked (rounded up -iwidth and _iheight used)
-    if (rotation == 1)
-    {
-      uint16_t tx = x;
-      x = _dheight - y - 1;
-      y = tx;
+/***************************************************************************************
+** Function name:           sampleLine
+** Description:             Nearest pixel sample a line of the Sprite into a buffer
+***************************************************************************************/
+// Source coordinates are Q16 and must stay within the Sprite, the output is byte swapped
+// 565 converted with the sampleTable() lut. Rotated 1 bpp Sprites map each pixel.
+void TFT_eSprite::sampleLine(uint16_t *buf, const uint16_t *lut, int32_t xs, int32_t ys,
+                             int32_t dx, int32_t dy, int32_t n)
+{
+  if (_bpp == 16) {
+    while (n--) {
+      *buf++ = _img[(xs >> 16) + (ys >> 16) * _iwidth];
+      xs += dx; ys += dy;
     }
-    else if (rotation == 2)
-    {
-      x = _dwidth - x - 1;
-      y = _dheight - y - 1;
+  }
+  else if (_bpp == 8) {
+    while (n--) {
+      *buf++ = lut[_img8[(xs >> 16) + (ys >> 16) * _iwidth]];
+      xs += dx; ys += dy;
     }
-    else if (rotation == 3)
-    {
-      uint16_t tx = x;
-      x = y;
-      y = _dwidth - tx - 1;
+  }
+  else if (_bpp == 4) {
+    while (n--) {
+      int32_t x = xs >> 16;
+      uint8_t b = _img4[(x + (ys >> 16) * _iwidth)>>1];
+      *buf++ = lut[(x & 1) ? b & 0x0F : b >> 4];
+      xs += dx; ys += dy;
+    }
+  }
+  else if (_bpp == 2) {
+    while (n--) {
+      int32_t x = xs >> 16;
+      *buf++ = lut[(_img8[(x + (ys >> 16) * _iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03];
+      xs += dx; ys += dy;
+    }
+  }
+  else if (rotation) {
+    while (n--) {
+      int32_t x = xs >> 16, y = ys >> 16;
+      rotatedXY(&x, &y);
+      *buf++ = lut[(_img8[(x + y * _bitwidth)>>3] >> (7 - (x & 0x7))) & 0x01];
+      xs += dx; ys += dy;
+    }
+  }
+  else {
+    while (n--) {
+      int32_t x = xs >> 16;
+      *buf++ = lut[(_img8[(x + (ys >> 16) * _bitwidth)>>3] >> (7 - (x & 0x7))) & 0x01];
+      xs += dx; ys += dy;
     }
-    // Return 1 or 0
-    return (_img8[(x + y * _bitwidth)>>3] >> (7-(x & 0x7))) & 0x01;
   }
-
-  return 0;
 }
 
+
 /***************************************************************************************
-** Function name:           readPixel
-** Description:             Read 565 colour of a pixel at defined coordinates
+** Function name:           pushSprite
+** Description:             Push the sprite to the TFT at x, y
 ***************************************************************************************/
-uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y)
+void TFT_eSprite::pushSprite(int32_t x, int32_t y)
 {
-  if (_vpOoB  || !_created) return 0xFFFF;
-
-  x+= _xDatum;
-  y+= _yDatum;
+  if (_frozen) { pushFrozen(x, y, false, 0); return; }
 
-  // Range checking
-  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return 0xFFFF;
+  if (!_created) return;
 
   if (_bpp == 16)
   {
-    uint16_t color = _img[x + y * _iwidth];
-    return (color >> 8) | (color << 8);
+    bool oldSwapBytes = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+    _tft->pushImage(x, y, _dwidth, _dheight, _img );
+    _tft->setSwapBytes(oldSwapBytes);
   }
-
-  if (_bpp == 8)
+  else if (_bpp == 4)
   {
-    uint16_t color = _img8[x + y * _iwidth];
-    if (color != 0)
-    {
-    uint8_t  blue[] = {0, 11, 21, 31};
-      color =   (color & 0xE0)<<8 | (color & 0xC0)<<5
-              | (color & 0x1C)<<6 | (color & 0x1C)<<3
-              | blue[color & 0x03];
-    }
-    return color;
+    _tft->pushImage(x, y, _dwidth, _dheight, _img4, false, _colorMap);
   }
+  else if (_bpp == 2) pushPacked(x, y, 0, 0, _dwidth, _dheight, false, 0);
+  else if (_bpp == 8) _tft->pushImage(x, y, _dwidth, _dheight, _img8, true, _colorMap);
+  else _tft->pushImage(x, y, _dwidth, _dheight, _img8, (bool)false);
+}
 
-  if (_bpp == 4)
-  {
-    if (x >= _dwidth) return 0xFFFF;
-    uint16_t color;
-    if ((x & 0x01) == 0)
-      color = _colorMap[_img4[((x+y*_iwidth)>>1)] >> 4];   // even index = bits 7 .. 4
-    else
-      color = _colorMap[_img4[((x+y*_iwidth)>>1)] & 0x0F]; // odd index = bits 3 .. 0.
-    return color;
-  }
 
-  // Note: Must be 1bpp
-  // _dwidth and _dheight bounds not checked (rounded up -iwidth and _iheight used)
-  if (rotation == 1)
+/***************************************************************************************
+** Function name:           pushSprite
+** Description:             Push the sprite to the TFT at x, y with transparent colour
+***************************************************************************************/
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp)
+{
+  if (_frozen) { pushFrozen(x, y, true, transp); return; }
+
+  if (!_created) return;
+
+  if (_bpp == 16)
   {
-    uint16_t tx = x;
-    x = _dheight - y - 1;
-    y = tx;
+    bool oldSwapBytes = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+    _tft->pushImage(x, y, _dwidth, _dheight, _img, transp );
+    _tft->setSwapBytes(oldSwapBytes);
   }
-  else if (rotation == 2)
+  else if (_bpp == 8)
   {
-    x = _dwidth - x - 1;
-    y = _dheight - y - 1;
+    transp = pixel8(transp);
+    _tft->pushImage(x, y, _dwidth, _dheight, _img8, (uint8_t)transp, (bool)true, _colorMap);
   }
-  else if (rotation == 3)
+  else if (_bpp == 4)
   {
-    uint16_t tx = x;
-    x = y;
-    y = _dwidth - tx - 1;
+    _tft->pushImage(x, y, _dwidth, _dheight, _img4, (uint8_t)(transp & 0x0F), false, _colorMap);
   }
-
-  uint16_t color = (_img8[(x + y * _bitwidth)>>3] << (x & 0x7)) & 0x80;
-
-  if (color) return _tft->bitmap_fg;
-  else       return _tft->bitmap_bg;
+  else if (_bpp == 2) pushPacked(x, y, 0, 0, _dwidth, _dheight, true, transp & 0x03);
+  else _tft->pushImage(x, y, _dwidth, _dheight, _img8, 0, (bool)false);
 }
 
 
 /***************************************************************************************
-** Function name:           pushImage
-** Description:             push image into a defined area of a sprite
+** Function name:           pushFrozen
+** Description:             Push a frozen Sprite to the TFT at x, y
 ***************************************************************************************/
-void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint8_t sbpp)
+// Runs are sent with pushBlock() and literals with pushPixels(), an opaque Sprite is sent
+// in a single window
+void TFT_eSprite::pushFrozen(int32_t x, int32_t y, bool useTransp, uint16_t transp)
 {
-  if (data == nullptr || !_created) return;
+  if (_tft->_vpOoB) return;
 
-  PI_CLIP;
+  x += _tft->_xDatum;
+  y += _tft->_yDatum;
 
-  if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
-  {
-    // Pointer within original image
-    uint8_t *ptro = (uint8_t *)data + ((dx + dy * w) << 1);
-    // Pointer within sprite image
-    uint8_t *ptrs = (uint8_t *)_img + ((x + y * _iwidth) << 1);
+  // Clip to the TFT viewport, dx,dy is the first Sprite pixel drawn
+  int32_t dx = 0, dy = 0, dw = _dwidth, dh = _dheight;
 
-    if(_swapBytes)
-    {
-      while (dh--)
-      {
-        // Fast copy with a 1 byte shift
-        memcpy(ptrs+1, ptro, (dw<<1) - 1);
-        // Now correct just the even numbered bytes
-        for (int32_t xp = 0; xp < (dw<<1); xp+=2)
-        {
-          ptrs[xp] = ptro[xp+1];;
-        }
-        ptro += w<<1;
-        ptrs += _iwidth<<1;
-      }
-    }
-    else
-    {
-      while (dh--)
-      {
-        memcpy(ptrs, ptro, dw<<1);
-        ptro += w << 1;
-        ptrs += _iwidth << 1;
-      }
-    }
-  }
-  else if (_bpp == 8 && sbpp == 8) // Plot a 8 bpp image into a 8 bpp Sprite
-  {
-    // Pointer within original image
-    uint8_t *ptro = (uint8_t *)data + (dx + dy * w);
-    // Pointer within sprite image
-    uint8_t *ptrs = (uint8_t *)_img + (x + y * _iwidth);
+  if (x < _tft->_vpX) { dx = _tft->_vpX - x; dw -= dx; x = _tft->_vpX; }
+  if (y < _tft->_vpY) { dy = _tft->_vpY - y; dh -= dy; y = _tft->_vpY; }
 
-    while (dh--)
-    {
-      memcpy(ptrs, ptro, dw);
-      ptro += w;
-      ptrs += _iwidth;
-    }
-  }
-  else if (_bpp == 8) // Plot a 16 bpp image into a 8 bpp Sprite
+  if ((x + dw) > _tft->_vpW ) dw = _tft->_vpW - x;
+  if ((y + dh) > _tft->_vpH ) dh = _tft->_vpH - y;
+
+  if (dw < 1 || dh < 1) return;
+
+  bool wide = (_bpp == 16);
+
+  // Transparent colour in the stored pixel format
+  uint16_t tpvalue = wide ? (uint16_t)(transp >> 8 | transp << 8)
+                          : pixel8(transp);
+
+  uint32_t* offset = (uint32_t*)_frozen;
+  uint8_t*  runs   = _frozen + _dheight * sizeof(uint32_t);
+
+  uint16_t lineBuf[0x80]; // 8 bpp literal converted to 565
+
+  bool oldSwapBytes = _tft->getSwapBytes();
+
+  _tft->startWrite();
+
+  if (!useTransp) _tft->setWindow(x, y, x + dw - 1, y + dh - 1);
+
+  for (int32_t row = dy; row < dy + dh; row++, y++)
   {
-    uint16_t lastColor = 0;
-    uint8_t  color8    = 0;
-    for (int32_t yp = dy; yp < dy + dh; yp++)
+    uint8_t*  in   = runs + offset[row];
+    uint16_t* in16 = (uint16_t*)in;
+    int32_t   p    = 0;
+
+    while (p < dx + dw)
     {
-      int32_t xyw = x + y * _iwidth;
-      int32_t dxypw = dx + yp * w;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t color = data[dxypw++];
-        if (color != lastColor) {
-          // When data source is a sprite, the bytes are already swapped
-          if(!_swapBytes) color8 = (uint8_t)((color & 0xE0) | (color & 0x07)<<2 | (color & 0x1800)>>11);
-          else color8 = (uint8_t)((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3);
-        }
-        lastColor = color;
-        _img8[xyw++] = color8;
-      }
-      y++;
-    }
-  }
-  else if (_bpp == 4)
-  {
-    // The image is assumed to be 4-bit, where each byte corresponds to two pixels.
-    // much faster when aligned to a byte boundary, because the alternative is slower, requiring
-    // tedious bit operations.
+      uint32_t control, count;
+      bool     isRun;
 
-    int sWidth = (_iwidth >> 1);
-    uint8_t *ptr = (uint8_t *)data;
+      if (wide) { control = *in16++; isRun = control & 0x8000; count = (control & 0x7FFF) + 1; }
+      else      { control = *in++;   isRun = control & 0x80;   count = (control & 0x7F) + 1; }
 
-    if ((x & 0x01) == 0 && (dx & 0x01) == 0 && (dw & 0x01) == 0)
-    {
-      x = (x >> 1) + y * sWidth;
-      dw = (dw >> 1);
-      dx = (dx >> 1) + dy * (w>>1);
-      while (dh--)
+      // Part a to b of the packet is inside the clipped area
+      int32_t a = p > dx ? p : dx;
+      int32_t b = p + (int32_t)count;
+      if (b > dx + dw) b = dx + dw;
+
+      if (isRun)
       {
-        memcpy(_img4 + x, ptr + dx, dw);
-        dx += (w >> 1);
-        x += sWidth;
+        uint16_t value = wide ? *in16++ : *in++;
+        if (a < b && !(useTransp && value == tpvalue)) {
+          uint16_t color = wide ? (uint16_t)(value >> 8 | value << 8) : color8(value);
+          if (useTransp) _tft->setWindow(x + a - dx, y, x + b - dx - 1, y);
+          _tft->pushBlock(color, b - a);
+        }
       }
-    }
-    else  // not optimized
-    {
-      for (int32_t yp = dy; yp < dy + dh; yp++)
+      else
       {
-        int32_t ox = x;
-        for (int32_t xp = dx; xp < dx + dw; xp++)
+        // Send the literal in segments of opaque pixels
+        while (a < b)
         {
-          uint32_t color;
-          if ((xp & 0x01) == 0)
-            color = (ptr[((xp+yp*w)>>1)] & 0xF0) >> 4; // even index = bits 7 .. 4
-          else
-            color = ptr[((xp-1+yp*w)>>1)] & 0x0F;      // odd index = bits 3 .. 0.
-          drawPixel(ox, y, color);
-          ox++;
+          int32_t s = a;
+          if (useTransp) {
+            while (s < b && (wide ? in16[s - p] : in[s - p]) == tpvalue) s++;
+            a = s;
+            while (a < b && (wide ? in16[a - p] : in[a - p]) != tpvalue) a++;
+          }
+          else a = b;
+
+          if (a == s) break;
+
+          if (useTransp) _tft->setWindow(x + s - dx, y, x + a - dx - 1, y);
+
+          if (wide) {
+            // Stored byte swapped so send as is
+            _tft->setSwapBytes(false);
+            _tft->pushPixels(in16 + s - p, a - s);
+          }
+          else {
+            for (int32_t i = s; i < a; i++) lineBuf[i - s] = color8(in[i - p]);
+            _tft->setSwapBytes(true);
+            _tft->pushPixels(lineBuf, a - s);
+          }
         }
-        y++;
+        if (wide) in16 += count;
+        else      in   += count;
       }
-    }
-  }
 
-  else // 1bpp
-  {
-    // Plot a 1bpp image into a 1bpp Sprite
-    uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
-    uint8_t *ptr = (uint8_t *)data;
-    for (int32_t yp = dy;  yp < dy + dh; yp++)
-    {
-      uint32_t yw = yp * ww;              // Byte starting the line containing source pixel
-      int32_t ox = x;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t readPixel = (ptr[(xp>>3) + yw] & (0x80 >> (xp & 0x7)) );
-        drawPixel(ox++, y, readPixel);
-      }
-      y++;
+      p += count;
     }
   }
+
+  _tft->endWrite();
+
+  _tft->setSwapBytes(oldSwapBytes);
 }
 
 
 /***************************************************************************************
-** Function name:           pushImage
-** Description:             push 565 colour FLASH (PROGMEM) image into a defined area
+** Function name:           pushPacked
+** Description:             Push an area of a 2 bpp Sprite to the TFT at x, y
 ***************************************************************************************/
-void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
+// Rows are expanded through the palette into a line buffer, an opaque area is sent in a
+// single window and a transparent one as runs of opaque pixels
+void TFT_eSprite::pushPacked(int32_t x, int32_t y, int32_t sx, int32_t sy, int32_t w, int32_t h,
+                             bool useTransp, uint8_t transp)
 {
-#ifdef ESP32
-  pushImage(x, y, w, h, (uint16_t*) data);
-#else
-  // Partitioned memory FLASH processor
-  if (data == nullptr || !_created) return;
+  if (_tft->_vpOoB) return;
 
-  PI_CLIP;
+  x += _tft->_xDatum;
+  y += _tft->_yDatum;
 
-  if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
-  {
-    for (int32_t yp = dy; yp < dy + dh; yp++)
-    {
-      int32_t ox = x;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t color = pgm_read_word(data + xp + yp * w);
-        if(_swapBytes) color = color<<8 | color>>8;
-        _img[ox + y * _iwidth] = color;
-        ox++;
-      }
-      y++;
-    }
-  }
+  // Clip to the TFT viewport
+  if (x < _tft->_vpX) { sx += _tft->_vpX - x; w -= _tft->_vpX - x; x = _tft->_vpX; }
+  if (y < _tft->_vpY) { sy += _tft->_vpY - y; h -= _tft->_vpY - y; y = _tft->_vpY; }
 
-  else if (_bpp == 8) // Plot a 16 bpp image into a 8 bpp Sprite
-  {
-    for (int32_t yp = dy; yp < dy + dh; yp++)
-    {
-      int32_t ox = x;
-      for (int32_t xp = dx; xp < dx + dw; xp++)
-      {
-        uint16_t color = pgm_read_word(data + xp + yp * w);
-        if(_swapBytes) color = color<<8 | color>>8;
-        _img8[ox + y * _iwidth] = (uint8_t)((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3);
-        ox++;
-      }
-      y++;
-    }
-  }
+  if ((x + w) > _tft->_vpW ) w = _tft->_vpW - x;
+  if ((y + h) > _tft->_vpH ) h = _tft->_vpH - y;
 
-  else if (_bpp == 4)
-  {
-    #ifdef TFT_eSPI_DEBUG
-    Serial.println("TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data) not implemented");
-    #endif
-    return;
-  }
+  if (w < 1 || h < 1) return;
 
-  else // Plot a 1bpp image into a 1bpp Sprite
+  uint16_t lineBuf[w];
+
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(true); // Line buffer holds 565 colours
+
+  _tft->startWrite();
+
+  if (!useTransp) _tft->setWindow(x, y, x + w - 1, y + h - 1);
+
+  for (int32_t row = sy; row < sy + h; row++, y++)
   {
-    x-= _xDatum;   // Remove offsets, drawPixel will add
-    y-= _yDatum;
-    uint16_t bsw =  (w+7) >> 3; // Width in bytes of source image line
-    uint8_t *ptr = ((uint8_t*)data) + dy * bsw;
-    
-    while (dh--) {
-      int32_t odx = dx;
-      int32_t ox  = x;
-      while (odx < dx + dw) {
-        uint8_t pbyte = pgm_read_byte(ptr + (odx>>3));
-        uint8_t mask = 0x80 >> (odx & 7);
-        while (mask) {
-          uint8_t p = pbyte & mask;
-          mask = mask >> 1;
-          drawPixel(ox++, y, p);
-          odx++;
-        }
+    readValues(lineBuf, sx, row, w);
+
+    int32_t i = 0;
+    while (i < w) {
+      int32_t s = i;
+      if (useTransp) {
+        while (s < w && lineBuf[s] == transp) s++;
+        i = s;
+        while (i < w && lineBuf[i] != transp) i++;
       }
-      ptr += bsw;
-      y++;
+      else i = w;
+
+      if (i == s) break;
+
+      for (int32_t p = s; p < i; p++) lineBuf[p] = _colorMap[lineBuf[p]];
+
+      if (useTransp) _tft->setWindow(x + s, y, x + i - 1, y);
+      _tft->pushPixels(lineBuf + s, i - s);
     }
   }
-#endif // if ESP32 check
+
+  _tft->endWrite();
+
+  _tft->setSwapBytes(oldSwapBytes);
 }
 
 
 /***************************************************************************************
-** Function name:           setWindow
-** Description:             Set the bounds of a window in the sprite
+** Function name:           pushToSprite
+** Description:             Push the sprite to another sprite at x, y
 ***************************************************************************************/
-// Intentionally not constrained to viewport area, does not manage 1bpp rotations
-void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+// All 1, 2, 4, 8 and 16 bpp source and destination Sprite combinations are supported:
+//    16 or 8 bpp destination: colours are converted, 4 and 2 bpp sources use the palette
+//                             and 1 bpp sources use the bitmap colours
+//    4 or 2 bpp destination:  palette indexes from a source of the same depth are copied,
+//                             other colours are mapped to the nearest palette colour
+//    1 bpp destination:       1 bpp source bits are copied, otherwise non-zero pixel
+//                             values (colour, byte or palette index) set the bit
+
+bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y)
 {
-  if (x0 > x1) transpose(x0, x1);
-  if (y0 > y1) transpose(y0, y1);
-  
-  int32_t w = width();
-  int32_t h = height();
+  return spriteToSprite(dspr, x, y, false, 0);
+}
 
-  if ((x0 >= w) || (x1 < 0) || (y0 >= h) || (y1 < 0))
-  { // Point to that extra "off screen" pixel
-    _xs = 0;
-    _ys = _dheight;
-    _xe = 0;
-    _ye = _dheight;
-  }
-  else
-  {
-    if (x0 < 0) x0 = 0;
-    if (x1 >= w) x1 = w - 1;
-    if (y0 < 0) y0 = 0;
-    if (y1 >= h) y1 = h - 1;
 
-    _xs = x0;
-    _ys = y0;
-    _xe = x1;
-    _ye = y1;
-  }
+/***************************************************************************************
+** Function name:           pushToSprite
+** Description:             Push the sprite to another sprite at x, y with transparent colour
+***************************************************************************************/
+// Conversions are as above. As for pushSprite() the transparent colour is a 565 colour
+// for 16 and 8 bpp Sprites and a palette index for a 4 or 2 bpp Sprite. For a 1 bpp Sprite
+// it is matched against the bitmap colours.
 
-  _xptr = _xs;
-  _yptr = _ys;
+bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transp)
+{
+  return spriteToSprite(dspr, x, y, true, transp);
 }
 
 
 /***************************************************************************************
-** Function name:           pushColor
-** Description:             Send a new pixel to the set window
+** Function name:           spriteToSprite
+** Description:             Copy the Sprite to another Sprite converting the colour depth
 ***************************************************************************************/
-void TFT_eSprite::pushColor(uint16_t color)
+// Each clipped row is read as raw pixel values, mapped to destination pixel values and
+// written straight into the destination Sprite memory. Mapping uses a table built once
+// for 1, 2, 4 and 8 bpp sources. Opaque copies between equal depths are memcpy'd, or
+// shifted a byte at a time for 2 bpp Sprites.
+bool TFT_eSprite::spriteToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, bool useTransp, uint16_t transp)
 {
-  if (!_created ) return;
-
-  // Write the colour to RAM in set window
-  if (_bpp == 16)
-    _img [_xptr + _yptr * _iwidth] = (uint16_t) (color >> 8) | (color << 8);
+  if ( !_created  || !dspr->_created || dspr == this) return false; // Check Sprites exist
+  if (dspr->_vpOoB) return true;
+
+  uint8_t db = dspr->_bpp;
+
+  // Clip to the destination viewport, sx,sy is the first source pixel
+  // A rotated 1 bpp source is read in rotated coordinates
+  bool    swapWH = (_bpp == 1 && (rotation & 1));
+  int32_t sx = 0, sy = 0, w = swapWH ? _dheight : _dwidth, h = swapWH ? _dwidth : _dheight;
+  x += dspr->_xDatum;
+  y += dspr->_yDatum;
+  if (x < dspr->_vpX) { sx = dspr->_vpX - x; w -= sx; x = dspr->_vpX; }
+  if (y < dspr->_vpY) { sy = dspr->_vpY - y; h -= sy; y = dspr->_vpY; }
+  if (x + w > dspr->_vpW) w = dspr->_vpW - x;
+  if (y + h > dspr->_vpH) h = dspr->_vpH - y;
+  if (w < 1 || h < 1) return true;
+
+  // 8 bpp values are RGB332 or palette indexes
+  bool same8 = (_bpp == 8 && db == 8 && (_colorMap == nullptr) == (dspr->_colorMap == nullptr));
+
+  // Opaque copies with the same pixel layout
+  if (!useTransp && _bpp == db && (db == 16 || same8)) {
+    uint8_t bytes = db >> 3;
+    for (int32_t j = 0; j < h; j++) {
+      memcpy(dspr->_img8 + (x + (y + j) * dspr->_iwidth) * bytes,
+             _img8 + (sx + (sy + j) * _iwidth) * bytes, w * bytes);
+    }
+    return true;
+  }
+  if (!useTransp && _bpp == 4 && db == 4 && !((x | sx | w) & 1)) {
+    for (int32_t j = 0; j < h; j++) {
+      memcpy(dspr->_img4 + ((x + (y + j) * dspr->_iwidth) >> 1),
+             _img4 + ((sx + (sy + j) * _iwidth) >> 1), w >> 1);
+    }
+    return true;
+  }
+  if (!useTransp && _bpp == 2 && db == 2) {
+    for (int32_t j = 0; j < h; j++) {
+      packedCopy(dspr->_img8 + (y + j) * (dspr->_iwidth >> 2), x,
+                 _img8 + (sy + j) * (_iwidth >> 2), sx, w);
+    }
+    return true;
+  }
 
-  else  if (_bpp == 8)
-    _img8[_xptr + _yptr * _iwidth] = (uint8_t )((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3);
+  // Transparent source pixel value
+  uint16_t tv = 0;
+  if (useTransp) {
+    if (_bpp == 16) tv = transp >> 8 | transp << 8;
+    else if (_bpp == 8) tv = pixel8(transp);
+    else if (_bpp == 4) tv = transp & 0x0F;
+    else if (_bpp == 2) tv = transp & 0x03;
+    else if (transp == _tft->bitmap_fg) tv = 1;
+    else if (transp == _tft->bitmap_bg) tv = 0;
+    else useTransp = false; // Neither bitmap colour is transparent
+  }
 
-  else if (_bpp == 4)
-  {
-    uint8_t c = (uint8_t)color & 0x0F;
-    if ((_xptr & 0x01) == 0) {
-      _img4[(_xptr + _yptr * _iwidth)>>1] = (c << 4) | (_img4[(_xptr + _yptr * _iwidth)>>1] & 0x0F);  // new color is in bits 7 .. 4
-    }
-    else {
-      _img4[(_xptr + _yptr * _iwidth)>>1] = (_img4[(_xptr + _yptr * _iwidth)>>1] & 0xF0) | c; // new color is the low bits
+  // Source to destination pixel value table
+  uint16_t map[(_bpp == 8) ? 256 : 16];
+  if (_bpp < 16) {
+    uint16_t n = 1 << _bpp;
+    sampleTable(map); // Byte swapped 565 colours
+    for (uint16_t i = 0; i < n; i++) {
+      uint16_t color = map[i] >> 8 | map[i] << 8;
+      if (db == 8) map[i] = dspr->pixel8(color);
+      else if (db == 4 || db == 2) map[i] = (_bpp == db) ? i : dspr->nearestIndex(color);
+      else if (db == 1) map[i] = (_bpp == 1) ? i : (i != 0);
     }
+    if (same8) for (uint16_t i = 0; i < n; i++) map[i] = i;
   }
 
-  else drawPixel(_xptr, _yptr, color);
+  uint16_t sval[w];
+  uint16_t dval[w];
+  uint16_t lastColor = 0;
+  uint8_t  lastIndex = dspr->nearestIndex(0);
 
-  // Increment x
-  _xptr++;
+  for (int32_t j = 0; j < h; j++) {
+    readValues(sval, sx, sy + j, w);
 
-  // Wrap on x and y to start, increment y if needed
-  if (_xptr > _xe)
-  {
-    _xptr = _xs;
-    _yptr++;
-    if (_yptr > _ye) _yptr = _ys;
+    if (_bpp < 16) for (int32_t i = 0; i < w; i++) dval[i] = map[sval[i]];
+    else if (db == 16) memcpy(dval, sval, w << 1);
+    else if (db == 8 && !dspr->_colorMap) {
+      for (int32_t i = 0; i < w; i++) {
+        uint16_t c = sval[i]; // Byte swapped
+        dval[i] = (c & 0xE0) | (c & 0x07)<<2 | (c & 0x1800)>>11;
+      }
+    }
+    else if (db == 8 || db == 4 || db == 2) {
+      for (int32_t i = 0; i < w; i++) {
+        uint16_t c = sval[i] >> 8 | sval[i] << 8;
+        if (c != lastColor) { lastColor = c; lastIndex = (db == 8) ? dspr->pixel8(c) : dspr->nearestIndex(c); }
+        dval[i] = lastIndex;
+      }
+    }
+    else for (int32_t i = 0; i < w; i++) dval[i] = (sval[i] != 0);
+
+    dspr->writeValues(dval, x, y + j, w, useTransp ? sval : nullptr, tv);
   }
 
+  return true;
 }
 
 
 /***************************************************************************************
-** Function name:           pushColor
-** Description:             Send a "len" new pixels to the set window
+** Function name:           readValues
+** Description:             Read n raw pixel values from Sprite memory starting at x,y
 ***************************************************************************************/
-void TFT_eSprite::pushColor(uint16_t color, uint32_t len)
+// 16 bpp values are byte swapped colours, 8 bpp RGB332 bytes or palette indexes, 4 and 2 bpp palette indexes
+// and 1 bpp bits. Rotated 1 bpp Sprites are read a pixel at a time in rotated coordinates.
+void TFT_eSprite::readValues(uint16_t *buf, int32_t x, int32_t y, int32_t n)
 {
-  if (!_created ) return;
+  if (_bpp == 16) memcpy(buf, _img + x + y * _iwidth, n << 1);
+  else if (_bpp == 8) {
+    uint8_t *ptr = _img8 + x + y * _iwidth;
+    while (n--) *buf++ = *ptr++;
+  }
+  else if (_bpp == 4) {
+    uint8_t *ptr = _img4 + ((x + y * _iwidth) >> 1);
+    if (x & 1) { *buf++ = *ptr++ & 0x0F; n--; }
+    while (n > 1) { *buf++ = *ptr >> 4; *buf++ = *ptr++ & 0x0F; n -= 2; }
+    if (n) *buf = *ptr >> 4;
+  }
+  else if (_bpp == 2) {
+    // Each byte is loaded once and shifted out from the top
+    uint8_t *ptr = _img8 + ((x + y * _iwidth) >> 2);
+    uint8_t  b = *ptr++ << ((x & 3) << 1);
+    uint8_t  k = 4 - (x & 3);
+    while (n--) {
+      if (k == 0) { b = *ptr++; k = 4; }
+      *buf++ = b >> 6;
+      b <<= 2;
+      k--;
+    }
+  }
+  else if (rotation) {
+    for (int32_t i = x; i < x + n; i++) {
+      int32_t mx = i, my = y;
+      rotatedXY(&mx, &my);
+      *buf++ = (_img8[(mx + my * _bitwidth) >> 3] >> (7 - (mx & 7))) & 0x01;
+    }
+  }
+  else {
+    uint8_t *ptr = _img8 + y * (_bitwidth >> 3);
+    for (int32_t i = x; i < x + n; i++) *buf++ = (ptr[i >> 3] >> (7 - (i & 7))) & 0x01;
+  }
+}
 
-  uint16_t pixelColor;
 
-  if (_bpp == 16)
-    pixelColor = (uint16_t) (color >> 8) | (color << 8);
+/***************************************************************************************
+** Function name:           writeValues
+** Description:             Write n pixel values to Sprite memory at x,y
+***************************************************************************************/
+// Coordinates are Sprite memory coordinates (datum applied and clipped). Pixels where
+// src[i] == tv are skipped if src is not nullptr. A rotated 1 bpp Sprite uses drawPixel()
+void TFT_eSprite::writeValues(const uint16_t *val, int32_t x, int32_t y, int32_t n,
+                              const uint16_t *src, uint16_t tv)
+{
+  if (_bpp == 16) {
+    uint16_t *ptr = _img + x + y * _iwidth;
+    if (!src) memcpy(ptr, val, n << 1);
+    else for (int32_t i = 0; i < n; i++) if (src[i] != tv) ptr[i] = val[i];
+  }
+  else if (_bpp == 8) {
+    uint8_t *ptr = _img8 + x + y * _iwidth;
+    for (int32_t i = 0; i < n; i++) if (!src || src[i] != tv) ptr[i] = val[i];
+  }
+  else if (_bpp == 4) {
+    uint8_t *ptr = _img4 + ((y * _iwidth) >> 1);
+    for (int32_t i = 0; i < n; i++, x++) {
+      if (src && src[i] == tv) continue;
+      if (x & 1) ptr[x >> 1] = (ptr[x >> 1] & 0xF0) | val[i];
+      else       ptr[x >> 1] = (ptr[x >> 1] & 0x0F) | (val[i] << 4);
+    }
+  }
+  else if (_bpp == 2) {
+    uint8_t *ptr = _img8 + ((y * _iwidth) >> 2);
+    for (int32_t i = 0; i < n; i++, x++) {
+      if (src && src[i] == tv) continue;
+      uint8_t shift = 6 - ((x & 3) << 1);
+      ptr[x >> 2] = (ptr[x >> 2] & ~(0x03 << shift)) | (val[i] << shift);
+    }
+  }
+  else if (rotation) {
+    for (int32_t i = 0; i < n; i++) {
+      if (!src || src[i] != tv) drawPixel(x + i - _xDatum, y - _yDatum, val[i]);
+    }
+  }
+  else {
+    uint8_t *ptr = _img8 + y * (_bitwidth >> 3);
+    for (int32_t i = 0; i < n; i++, x++) {
+      if (src && src[i] == tv) continue;
+      if (val[i]) ptr[x >> 3] |=  (0x80 >> (x & 7));
+      else        ptr[x >> 3] &= ~(0x80 >> (x & 7));
+    }
+  }
+}
 
-  else  if (_bpp == 8)
-    pixelColor = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
 
-  else pixelColor = (uint16_t) color; // for 1bpp or 4bpp
+/***************************************************************************************
+** Function name:           nearestIndex
+** Description:             Return the 8, 4 or 2 bpp palette index of the closest colour
+***************************************************************************************/
+// For a 1 bpp Sprite the bit of the closer bitmap colour is returned
+uint8_t TFT_eSprite::nearestIndex(uint16_t color)
+{
+  const uint16_t *map = _colorMap;
+  uint16_t colors = (_bpp == 8) ? 256 : (_bpp == 2) ? 4 : 16;
+  uint16_t bitmap[2];
+
+  if (_bpp == 1) {
+    bitmap[0] = _tft->bitmap_bg;
+    bitmap[1] = _tft->bitmap_fg;
+    map = bitmap;
+    colors = 2;
+  }
+  else if (!_colorMap) return 0;
+
+  int32_t  r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+  uint32_t best = 0xFFFFFFFF;
+  uint8_t  index = 0;
+
+  for (uint16_t i = 0; i < colors; i++) {
+    uint16_t c = map[i];
+    // Green has twice the range of red and blue
+    int32_t  dr = (int32_t)(c >> 11) - r, dg = (int32_t)((c >> 5) & 0x3F) - g, db = (int32_t)(c & 0x1F) - b;
+    uint32_t d = 4 * dr * dr + dg * dg + 4 * db * db;
+    if (d < best) { best = d; index = i; if (d == 0) break; }
+  }
 
-  while(len--) writeColor(pixelColor);
+  return index;
 }
 
 
 /***************************************************************************************
-** Function name:           writeColor
-** Description:             Write a pixel with pre-formatted colour to the set window
+** Function name:           pixel8
+** Description:             Return the 8 bpp pixel value of a 565 colour
 ***************************************************************************************/
-void TFT_eSprite::writeColor(uint16_t color)
+// RGB332 unless a palette has been created, then the index of the nearest palette colour.
+// Searching the palette is slow so indexes are held in a small direct mapped cache.
+uint8_t TFT_eSprite::pixel8(uint16_t color)
 {
-  if (!_created ) return;
+  if (!_colorMap) return (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
 
-  // Write 16-bit RGB 565 encoded colour to RAM
-  if (_bpp == 16) _img [_xptr + _yptr * _iwidth] = color;
+  uint16_t* entry = _colorMap + 256 + 2 * (((color >> 11) ^ (color >> 5) ^ color) & (PaletteCache8 - 1));
 
-  // Write 8-bit RGB 332 encoded colour to RAM
-  else if (_bpp == 8) _img8[_xptr + _yptr * _iwidth] = (uint8_t) color;
+  // Bit 8 of the index marks the entry as valid
+  if (entry[1] && entry[0] == color) return (uint8_t)entry[1];
 
-  else if (_bpp == 4)
-  {
-    uint8_t c = (uint8_t)color & 0x0F;
-    if ((_xptr & 0x01) == 0)
-      _img4[(_xptr + _yptr * _iwidth)>>1] = (c << 4) | (_img4[(_xptr + _yptr * _iwidth)>>1] & 0x0F);  // new color is in bits 7 .. 4
-    else
-      _img4[(_xptr + _yptr * _iwidth)>>1] = (_img4[(_xptr + _yptr * _iwidth)>>1] & 0xF0) | c; // new color is the low bits (x is odd)
-  }
+  entry[0] = color;
+  entry[1] = 0x100 | nearestIndex(color);
+  return (uint8_t)entry[1];
+}
 
-  else drawPixel(_xptr, _yptr, color);
 
-  // Increment x
-  _xptr++;
+/***************************************************************************************
+** Function name:           color8
+** Description:             Return the 565 colour of an 8 bpp pixel value
+***************************************************************************************/
+uint16_t TFT_eSprite::color8(uint8_t value)
+{
+  if (_colorMap) return _colorMap[value];
+  return color8to16(value);
+}
 
-  // Wrap on x and y to start, increment y if needed
-  if (_xptr > _xe)
-  {
-    _xptr = _xs;
-    _yptr++;
-    if (_yptr > _ye) _yptr = _ys;
+
+/***************************************************************************************
+** Function name:           packedFill
+** Description:             Set n 2 bpp pixels from x in a row to palette index c
+***************************************************************************************/
+// Partial bytes at the ends are masked, whole bytes in between are memset
+void TFT_eSprite::packedFill(uint8_t *row, int32_t x, int32_t n, uint8_t c)
+{
+  if (n < 1) return;
+
+  uint8_t* ptr = row + (x >> 2);
+  uint8_t  c4  = (c & 0x03) * 0x55; // Index in all 4 pixels of a byte
+  uint8_t  mask;
+
+  if (x & 3) {
+    int32_t k = 4 - (x & 3);
+    if (k > n) k = n;
+    mask = (0xFF >> ((x & 3) << 1)) & ~(0xFF >> (((x & 3) + k) << 1));
+    *ptr = (*ptr & ~mask) | (c4 & mask);
+    ptr++;
+    n -= k;
+  }
+
+  memset(ptr, c4, n >> 2);
+  ptr += n >> 2;
+
+  if (n & 3) {
+    mask = ~(0xFF >> ((n & 3) << 1));
+    *ptr = (*ptr & ~mask) | (c4 & mask);
   }
 }
 
 
 /***************************************************************************************
-** Function name:           setScrollRect
-** Description:             Set scroll area within the sprite and the gap fill colour
+** Function name:           packedCopy
+** Description:             Copy n 2 bpp pixels from src at sx to a row dst at dx
 ***************************************************************************************/
-// Intentionally not constrained to viewport area
-void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+// The areas must not overlap. Once dx is byte aligned whole destination bytes are copied,
+// with a shift to align the source pixels if needed
+void TFT_eSprite::packedCopy(uint8_t *dst, int32_t dx, const uint8_t *src, int32_t sx, int32_t n)
 {
-  if ((x >= _iwidth) || (y >= _iheight) || !_created ) return;
+  uint8_t shift;
 
-  if (x < 0) { w += x; x = 0; }
-  if (y < 0) { h += y; y = 0; }
+  while (n > 0 && (dx & 3)) {
+    shift = 6 - ((dx & 3) << 1);
+    uint8_t v = (src[sx >> 2] >> (6 - ((sx & 3) << 1))) & 0x03;
+    dst[dx >> 2] = (dst[dx >> 2] & ~(0x03 << shift)) | (v << shift);
+    dx++; sx++; n--;
+  }
 
-  if ((x + w) > _iwidth ) w = _iwidth  - x;
-  if ((y + h) > _iheight) h = _iheight - y;
+  if (n < 1) return;
 
-  if ( w < 1 || h < 1) return;
+  uint8_t*       d = dst + (dx >> 2);
+  const uint8_t* s = src + (sx >> 2);
+  int32_t        bytes = n >> 2;
 
-  _sx = x;
-  _sy = y;
-  _sw = w;
-  _sh = h;
+  shift = (sx & 3) << 1;
+  if (shift == 0) memcpy(d, s, bytes);
+  else for (int32_t i = 0; i < bytes; i++) d[i] = (s[i] << shift) | (s[i + 1] >> (8 - shift));
 
-  _scolor = color;
+  dx += bytes << 2;
+  sx += bytes << 2;
+  n  &= 3;
+
+  while (n--) {
+    shift = 6 - ((dx & 3) << 1);
+    uint8_t v = (src[sx >> 2] >> (6 - ((sx & 3) << 1))) & 0x03;
+    dst[dx >> 2] = (dst[dx >> 2] & ~(0x03 << shift)) | (v << shift);
+    dx++; sx++;
+  }
 }
 
 
 /***************************************************************************************
-** Function name:           scroll
-** Description:             Scroll dx,dy pixels, positive right,down, negative left,up
+** Function name:           pushSprite
+** Description:             Push a cropped sprite to the TFT at tx, ty
 ***************************************************************************************/
-void TFT_eSprite::scroll(int16_t dx, int16_t dy)
+bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh)
 {
-  if (abs(dx) >= _sw || abs(dy) >= _sh)
-  {
-    fillRect (_sx, _sy, _sw, _sh, _scolor);
-    return;
-  }
-
-  // Fetch the scroll area width and height set by setScrollRect()
-  uint32_t w  = _sw - abs(dx); // line width to copy
-  uint32_t h  = _sh - abs(dy); // lines to copy
-  int32_t iw  = _iwidth;       // rounded up width of sprite
+  if (!_created) return false;
 
-  // Fetch the x,y origin set by setScrollRect()
-  uint32_t tx = _sx; // to x
-  uint32_t fx = _sx; // from x
-  uint32_t ty = _sy; // to y
-  uint32_t fy = _sy; // from y
+  // Perform window boundary checks and crop if needed
+  setWindow(sx, sy, sx + sw - 1, sy + sh - 1);
 
-  // Adjust for x delta
-  if (dx <= 0) fx -= dx;
-  else tx += dx;
+  /* These global variables are now populated for the sprite
+  _xs = x start coordinate
+  _ys = y start coordinate
+  _xe = x end coordinate (inclusive)
+  _ye = y end coordinate (inclusive)
+  */
 
-  // Adjust for y delta
-  if (dy <= 0) fy -= dy;
-  else
-  { // Scrolling down so start copy from bottom
-    ty = ty + _sh - 1; // "To" pointer
-    iw = -iw;          // Pointer moves backwards
-    fy = ty - dy;      // "From" pointer
-  }
+  // Calculate new sprite window bounding box width and height
+  sw = _xe - _xs + 1;
+  sh = _ye - _ys + 1;
 
-  // Calculate "from y" and "to y" pointers in RAM
-  uint32_t fyp = fx + fy * _iwidth;
-  uint32_t typ = tx + ty * _iwidth;
+  if (_ys >= _iheight) return false;
 
-  // Now move the pixels in RAM
   if (_bpp == 16)
   {
-    while (h--)
-    { // move pixel lines (to, from, byte count)
-      memmove( _img + typ, _img + fyp, w<<1);
-      typ += iw;
-      fyp += iw;
-    }
+    bool oldSwapBytes = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+
+    // Check if a faster block copy to screen is possible
+    if ( sx == 0 && sw == _dwidth)
+      _tft->pushImage(tx, ty, sw, sh, _img + _iwidth * _ys );
+    else // Render line by line
+      while (sh--)
+        _tft->pushImage(tx, ty++, sw, 1, _img + _xs + _iwidth * _ys++ );
+
+    _tft->setSwapBytes(oldSwapBytes);
   }
   else if (_bpp == 8)
   {
-    while (h--)
-    { // move pixel lines (to, from, byte count)
-      memmove( _img8 + typ, _img8 + fyp, w);
-      typ += iw;
-      fyp += iw;
-    }
+    // Check if a faster block copy to screen is possible
+    if ( sx == 0 && sw == _dwidth)
+      _tft->pushImage(tx, ty, sw, sh, _img8 + _iwidth * _ys, (bool)true, _colorMap );
+    else // Render line by line
+    while (sh--)
+      _tft->pushImage(tx, ty++, sw, 1, _img8 + _xs + _iwidth * _ys++, (bool)true, _colorMap );
   }
   else if (_bpp == 4)
   {
-    // could optimize for scrolling by even # pixels using memove (later)
-    if (dx >  0) { tx += w; fx += w; } // Start from right edge
-    while (h--)
-    { // move pixels one by one
-      for (uint16_t xp = 0; xp < w; xp++)
+    // Check if a faster block copy to screen is possible
+    if ( sx == 0 && sw == _dwidth)
+      _tft->pushImage(tx, ty, sw, sh, _img4 + (_iwidth>>1) * _ys, false, _colorMap );
+    else // Render line by line
+    {
+      int32_t ds = _xs&1; // Odd x start pixel
+
+      int32_t de = 0;     // Odd x end pixel
+      if ((sw > ds) && (_xe&1)) de = 1;
+
+      uint32_t dm = 0;     // Midsection pixel count
+      if (sw > (ds+de)) dm = sw - ds - de;
+      sw--;
+
+      uint32_t yp = (_xs + ds + _iwidth * _ys)>>1;
+      _tft->startWrite();
+      while (sh--)
       {
-        if (dx <= 0) drawPixel(tx + xp, ty, readPixelValue(fx + xp, fy));
-        if (dx >  0) drawPixel(tx - xp, ty, readPixelValue(fx - xp, fy));
+        if (ds) _tft->drawPixel(tx, ty, readPixel(_xs, _ys) );
+        if (dm) _tft->pushImage(tx + ds, ty, dm, 1, _img4 + yp, false, _colorMap );
+        if (de) _tft->drawPixel(tx + sw, ty, readPixel(_xe, _ys) );
+        _ys++;
+        ty++;
+        yp += (_iwidth>>1);
       }
-      if (dy <= 0)  { ty++; fy++; }
-      else  { ty--; fy--; }
+      _tft->endWrite();
     }
   }
-  else if (_bpp == 1 )
+  else if (_bpp == 2)
   {
-    if (dx >  0) { tx += w; fx += w; } // Start from right edge
-    while (h--)
-    { // move pixels one by one
-      for (uint16_t xp = 0; xp < w; xp++)
+    pushPacked(tx, ty, _xs, _ys, sw, sh, false, 0);
+  }
+  else // 1bpp
+  {
+    // Check if a faster block copy to screen is possible
+    if ( sx == 0 && sw == _dwidth)
+      _tft->pushImage(tx, ty, sw, sh, _img8 + (_bitwidth>>3) * _ys, (bool)false );
+    else // Render line by line
+    {
+      _tft->startWrite();
+      while (sh--)
+      {
+        _tft->pushImage(tx, ty++, sw, 1, _img8 + (_bitwidth>>3) * _ys++, (bool)false );
+      }
+      _tft->endWrite();
+    }
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           readPixelValue
+** Description:             Read the color map index of a pixel at defined coordinates
+***************************************************************************************/
+uint16_t TFT_eSprite::readPixelValue(int32_t x, int32_t y)
+{
+  if (_vpOoB  || !_created) return 0xFF;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Range checking
+  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return 0xFF;
+
+  if (_bpp == 16)
+  {
+    // Return the pixel colour
+    return readPixel(x - _xDatum, y - _yDatum);
+  }
+
+  if (_bpp == 8)
+  {
+    // Return the pixel byte value
+    return _img8[x + y * _iwidth];
+  }
+
+  if (_bpp == 4)
+  {
+    if (x >= _dwidth) return 0xFF;
+    if ((x & 0x01) == 0)
+      return _img4[((x+y*_iwidth)>>1)] >> 4;   // even index = bits 7 .. 4
+    else
+      return _img4[((x+y*_iwidth)>>1)] & 0x0F; // odd index = bits 3 .. 0.
+  }
+
+  if (_bpp == 2)
+  {
+    // x % 4 == 0 is in bits 7 .. 6
+    return (_img8[(x+y*_iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03;
+  }
+
+  if (_bpp == 1)
+  {
+    // Note: _dwidth and _dheight bounds not checked (rounded up -iwidth and _iheight used)
+    if (rotation == 1)
+    {
+      uint16_t tx = x;
+      x = _dwidth - y - 1;
+      y = tx;
+    }
+    else if (rotation == 2)
+    {
+      x = _dwidth - x - 1;
+      y = _dheight - y - 1;
+    }
+    else if (rotation == 3)
+    {
+      uint16_t tx = x;
+      x = y;
+      y = _dheight - tx - 1;
+    }
+    // Return 1 or 0
+    return (_img8[(x + y * _bitwidth)>>3] >> (7-(x & 0x7))) & 0x01;
+  }
+
+  return 0;
+}
+
+/***************************************************************************************
+** Function name:           readPixel
+** Description:             Read 565 colour of a pixel at defined coordinates
+***************************************************************************************/
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y)
+{
+  if (_vpOoB  || !_created) return 0xFFFF;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Range checking
+  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return 0xFFFF;
+
+  if (_bpp == 16)
+  {
+    uint16_t color = _img[x + y * _iwidth];
+    return (color >> 8) | (color << 8);
+  }
+
+  if (_bpp == 8)
+  {
+    uint16_t color = _img8[x + y * _iwidth];
+    if (_colorMap) return _colorMap[color];
+    if (color != 0)
+    {
+    uint8_t  blue[] = {0, 11, 21, 31};
+      color =   (color & 0xE0)<<8 | (color & 0xC0)<<5
+              | (color & 0x1C)<<6 | (color & 0x1C)<<3
+              | blue[color & 0x03];
+    }
+    return color;
+  }
+
+  if (_bpp == 4)
+  {
+    if (x >= _dwidth) return 0xFFFF;
+    uint16_t color;
+    if ((x & 0x01) == 0)
+      color = _colorMap[_img4[((x+y*_iwidth)>>1)] >> 4];   // even index = bits 7 .. 4
+    else
+      color = _colorMap[_img4[((x+y*_iwidth)>>1)] & 0x0F]; // odd index = bits 3 .. 0.
+    return color;
+  }
+
+  if (_bpp == 2)
+  {
+    return _colorMap[(_img8[(x+y*_iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03];
+  }
+
+  // Note: Must be 1bpp
+  // _dwidth and _dheight bounds not checked (rounded up -iwidth and _iheight used)
+  if (rotation == 1)
+  {
+    uint16_t tx = x;
+    x = _dwidth - y - 1;
+    y = tx;
+  }
+  else if (rotation == 2)
+  {
+    x = _dwidth - x - 1;
+    y = _dheight - y - 1;
+  }
+  else if (rotation == 3)
+  {
+    uint16_t tx = x;
+    x = y;
+    y = _dheight - tx - 1;
+  }
+
+  uint16_t color = (_img8[(x + y * _bitwidth)>>3] << (x & 0x7)) & 0x80;
+
+  if (color) return _tft->bitmap_fg;
+  else       return _tft->bitmap_bg;
+}
+
+
+/***************************************************************************************
+** Function name:           pushImage
+** Description:             push image into a defined area of a sprite
+***************************************************************************************/
+void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint8_t sbpp)
+{
+  if (data == nullptr || !_created) return;
+
+  PI_CLIP;
+
+  if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
+  {
+    // Pointer within original image
+    uint8_t *ptro = (uint8_t *)data + ((dx + dy * w) << 1);
+    // Pointer within sprite image
+    uint8_t *ptrs = (uint8_t *)_img + ((x + y * _iwidth) << 1);
+
+    if(_swapBytes)
+    {
+      while (dh--)
+      {
+        // Fast copy with a 1 byte shift
+        memcpy(ptrs+1, ptro, (dw<<1) - 1);
+        // Now correct just the even numbered bytes
+        for (int32_t xp = 0; xp < (dw<<1); xp+=2)
+        {
+          ptrs[xp] = ptro[xp+1];;
+        }
+        ptro += w<<1;
+        ptrs += _iwidth<<1;
+      }
+    }
+    else
+    {
+      while (dh--)
+      {
+        memcpy(ptrs, ptro, dw<<1);
+        ptro += w << 1;
+        ptrs += _iwidth << 1;
+      }
+    }
+  }
+  else if (_bpp == 8 && sbpp == 8) // Plot a 8 bpp image into a 8 bpp Sprite
+  {
+    // Pointer within original image
+    uint8_t *ptro = (uint8_t *)data + (dx + dy * w);
+    // Pointer within sprite image
+    uint8_t *ptrs = (uint8_t *)_img + (x + y * _iwidth);
+
+    while (dh--)
+    {
+      memcpy(ptrs, ptro, dw);
+      ptro += w;
+      ptrs += _iwidth;
+    }
+  }
+  else if (_bpp == 8) // Plot a 16 bpp image into a 8 bpp Sprite
+  {
+    uint16_t lastColor = 0;
+    uint8_t  color8    = pixel8(0);
+    for (int32_t yp = dy; yp < dy + dh; yp++)
+    {
+      int32_t xyw = x + y * _iwidth;
+      int32_t dxypw = dx + yp * w;
+      for (int32_t xp = dx; xp < dx + dw; xp++)
+      {
+        uint16_t color = data[dxypw++];
+        if (color != lastColor) {
+          // When data source is a sprite, the bytes are already swapped
+          if(!_swapBytes) color8 = _colorMap ? pixel8(color >> 8 | color << 8)
+                                             : (uint8_t)((color & 0xE0) | (color & 0x07)<<2 | (color & 0x1800)>>11);
+          else color8 = pixel8(color);
+        }
+        lastColor = color;
+        _img8[xyw++] = color8;
+      }
+      y++;
+    }
+  }
+  else if (_bpp == 4)
+  {
+    // The image is assumed to be 4-bit, where each byte corresponds to two pixels.
+    // much faster when aligned to a byte boundary, because the alternative is slower, requiring
+    // tedious bit operations.
+
+    int sWidth = (_iwidth >> 1);
+    uint8_t *ptr = (uint8_t *)data;
+
+    if ((x & 0x01) == 0 && (dx & 0x01) == 0 && (dw & 0x01) == 0)
+    {
+      x = (x >> 1) + y * sWidth;
+      dw = (dw >> 1);
+      dx = (dx >> 1) + dy * (w>>1);
+      while (dh--)
+      {
+        memcpy(_img4 + x, ptr + dx, dw);
+        dx += (w >> 1);
+        x += sWidth;
+      }
+    }
+    else  // not optimized
+    {
+      for (int32_t yp = dy; yp < dy + dh; yp++)
+      {
+        int32_t ox = x;
+        for (int32_t xp = dx; xp < dx + dw; xp++)
+        {
+          uint32_t color;
+          if ((xp & 0x01) == 0)
+            color = (ptr[((xp+yp*w)>>1)] & 0xF0) >> 4; // even index = bits 7 .. 4
+          else
+            color = ptr[((xp-1+yp*w)>>1)] & 0x0F;      // odd index = bits 3 .. 0.
+          drawPixel(ox, y, color);
+          ox++;
+        }
+        y++;
+      }
+    }
+  }
+
+  else if (_bpp == 2)
+  {
+    // The image is assumed to be 2-bit, 4 pixels per byte with each line padded to a whole
+    // byte. Lines are copied a byte at a time, shifted if x and dx are not aligned alike
+    uint32_t ww = (w+3)>>2; // Width of source image line in bytes
+    uint8_t *ptr = (uint8_t *)data + dy * ww;
+    while (dh--)
+    {
+      packedCopy(_img8 + y * (_iwidth >> 2), x, ptr, dx, dw);
+      ptr += ww;
+      y++;
+    }
+  }
+
+  else // 1bpp
+  {
+    // Plot a 1bpp image into a 1bpp Sprite
+    uint32_t ww =  (w+7)>>3; // Width of source image line in bytes
+    uint8_t *ptr = (uint8_t *)data;
+    for (int32_t yp = dy;  yp < dy + dh; yp++)
+    {
+      uint32_t yw = yp * ww;              // Byte starting the line containing source pixel
+      int32_t ox = x;
+      for (int32_t xp = dx; xp < dx + dw; xp++)
+      {
+        uint16_t readPixel = (ptr[(xp>>3) + yw] & (0x80 >> (xp & 0x7)) );
+        drawPixel(ox++, y, readPixel);
+      }
+      y++;
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushImage
+** Description:             push 565 colour FLASH (PROGMEM) image into a defined area
+***************************************************************************************/
+void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
+{
+#ifdef ESP32
+  pushImage(x, y, w, h, (uint16_t*) data);
+#else
+  // Partitioned memory FLASH processor
+  if (data == nullptr || !_created) return;
+
+  PI_CLIP;
+
+  if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
+  {
+    for (int32_t yp = dy; yp < dy + dh; yp++)
+    {
+      int32_t ox = x;
+      for (int32_t xp = dx; xp < dx + dw; xp++)
+      {
+        uint16_t color = pgm_read_word(data + xp + yp * w);
+        if(_swapBytes) color = color<<8 | color>>8;
+        _img[ox + y * _iwidth] = color;
+        ox++;
+      }
+      y++;
+    }
+  }
+
+  else if (_bpp == 8) // Plot a 16 bpp image into a 8 bpp Sprite
+  {
+    for (int32_t yp = dy; yp < dy + dh; yp++)
+    {
+      int32_t ox = x;
+      for (int32_t xp = dx; xp < dx + dw; xp++)
+      {
+        uint16_t color = pgm_read_word(data + xp + yp * w);
+        if(_swapBytes) color = color<<8 | color>>8;
+        _img8[ox + y * _iwidth] = pixel8(color);
+        ox++;
+      }
+      y++;
+    }
+  }
+
+  else if (_bpp == 4 || _bpp == 2)
+  {
+    #ifdef TFT_eSPI_DEBUG
+    Serial.println("TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data) not implemented");
+    #endif
+    return;
+  }
+
+  else // Plot a 1bpp image into a 1bpp Sprite
+  {
+    x-= _xDatum;   // Remove offsets, drawPixel will add
+    y-= _yDatum;
+    uint16_t bsw =  (w+7) >> 3; // Width in bytes of source image line
+    uint8_t *ptr = ((uint8_t*)data) + dy * bsw;
+    
+    while (dh--) {
+      int32_t odx = dx;
+      int32_t ox  = x;
+      while (odx < dx + dw) {
+        uint8_t pbyte = pgm_read_byte(ptr + (odx>>3));
+        uint8_t mask = 0x80 >> (odx & 7);
+        while (mask) {
+          uint8_t p = pbyte & mask;
+          mask = mask >> 1;
+          drawPixel(ox++, y, p);
+          odx++;
+        }
+      }
+      ptr += bsw;
+      y++;
+    }
+  }
+#endif // if ESP32 check
+}
+
+
+/***************************************************************************************
+** Function name:           setWindow
+** Description:             Set the bounds of a window in the sprite
+***************************************************************************************/
+// Intentionally not constrained to viewport area, does not manage 1bpp rotations
+void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  if (x0 > x1) transpose(x0, x1);
+  if (y0 > y1) transpose(y0, y1);
+  
+  int32_t w = width();
+  int32_t h = height();
+
+  if ((x0 >= w) || (x1 < 0) || (y0 >= h) || (y1 < 0))
+  { // Point to that extra "off screen" pixel
+    _xs = 0;
+    _ys = _dheight;
+    _xe = 0;
+    _ye = _dheight;
+  }
+  else
+  {
+    if (x0 < 0) x0 = 0;
+    if (x1 >= w) x1 = w - 1;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= h) y1 = h - 1;
+
+    _xs = x0;
+    _ys = y0;
+    _xe = x1;
+    _ye = y1;
+  }
+
+  _xptr = _xs;
+  _yptr = _ys;
+}
+
+
+/***************************************************************************************
+** Function name:           pushColor
+** Description:             Send a new pixel to the set window
+***************************************************************************************/
+void TFT_eSprite::pushColor(uint16_t color)
+{
+  if (!_created ) return;
+
+  // Write the colour to RAM in set window
+  if (_bpp == 16)
+    _img [_xptr + _yptr * _iwidth] = (uint16_t) (color >> 8) | (color << 8);
+
+  else  if (_bpp == 8)
+    _img8[_xptr + _yptr * _iwidth] = pixel8(color);
+
+  else if (_bpp == 4)
+  {
+    uint8_t c = (uint8_t)color & 0x0F;
+    if ((_xptr & 0x01) == 0) {
+      _img4[(_xptr + _yptr * _iwidth)>>1] = (c << 4) | (_img4[(_xptr + _yptr * _iwidth)>>1] & 0x0F);  // new color is in bits 7 .. 4
+    }
+    else {
+      _img4[(_xptr + _yptr * _iwidth)>>1] = (_img4[(_xptr + _yptr * _iwidth)>>1] & 0xF0) | c; // new color is the low bits
+    }
+  }
+
+  else if (_bpp == 2)
+  {
+    uint8_t shift = 6 - ((_xptr & 3) << 1);
+    uint8_t *ptr = _img8 + ((_xptr + _yptr * _iwidth)>>2);
+    *ptr = (*ptr & ~(0x03 << shift)) | ((color & 0x03) << shift);
+  }
+
+  else drawPixel(_xptr, _yptr, color);
+
+  // Increment x
+  _xptr++;
+
+  // Wrap on x and y to start, increment y if needed
+  if (_xptr > _xe)
+  {
+    _xptr = _xs;
+    _yptr++;
+    if (_yptr > _ye) _yptr = _ys;
+  }
+
+}
+
+
+/***************************************************************************************
+** Function name:           pushColor
+** Description:             Send a "len" new pixels to the set window
+***************************************************************************************/
+void TFT_eSprite::pushColor(uint16_t color, uint32_t len)
+{
+  if (!_created ) return;
+
+  uint16_t pixelColor;
+
+  if (_bpp == 16)
+    pixelColor = (uint16_t) (color >> 8) | (color << 8);
+
+  else  if (_bpp == 8)
+    pixelColor = pixel8(color);
+
+  else pixelColor = (uint16_t) color; // for 1bpp, 2bpp or 4bpp
+
+  while(len--) writeColor(pixelColor);
+}
+
+
+/***************************************************************************************
+** Function name:           writeColor
+** Description:             Write a pixel with pre-formatted colour to the set window
+***************************************************************************************/
+void TFT_eSprite::writeColor(uint16_t color)
+{
+  if (!_created ) return;
+
+  // Write 16-bit RGB 565 encoded colour to RAM
+  if (_bpp == 16) _img [_xptr + _yptr * _iwidth] = color;
+
+  // Write 8-bit RGB 332 encoded colour to RAM
+  else if (_bpp == 8) _img8[_xptr + _yptr * _iwidth] = (uint8_t) color;
+
+  else if (_bpp == 4)
+  {
+    uint8_t c = (uint8_t)color & 0x0F;
+    if ((_xptr & 0x01) == 0)
+      _img4[(_xptr + _yptr * _iwidth)>>1] = (c << 4) | (_img4[(_xptr + _yptr * _iwidth)>>1] & 0x0F);  // new color is in bits 7 .. 4
+    else
+      _img4[(_xptr + _yptr * _iwidth)>>1] = (_img4[(_xptr + _yptr * _iwidth)>>1] & 0xF0) | c; // new color is the low bits (x is odd)
+  }
+
+  else if (_bpp == 2)
+  {
+    uint8_t shift = 6 - ((_xptr & 3) << 1);
+    uint8_t *ptr = _img8 + ((_xptr + _yptr * _iwidth)>>2);
+    *ptr = (*ptr & ~(0x03 << shift)) | ((color & 0x03) << shift);
+  }
+
+  else drawPixel(_xptr, _yptr, color);
+
+  // Increment x
+  _xptr++;
+
+  // Wrap on x and y to start, increment y if needed
+  if (_xptr > _xe)
+  {
+    _xptr = _xs;
+    _yptr++;
+    if (_yptr > _ye) _yptr = _ys;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           setScrollRect
+** Description:             Set scroll area within the sprite and the gap fill colour
+***************************************************************************************/
+// Intentionally not constrained to viewport area
+void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if ((x >= _iwidth) || (y >= _iheight) || !_created ) return;
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+
+  if ((x + w) > _iwidth ) w = _iwidth  - x;
+  if ((y + h) > _iheight) h = _iheight - y;
+
+  if ( w < 1 || h < 1) return;
+
+  _sx = x;
+  _sy = y;
+  _sw = w;
+  _sh = h;
+
+  _scolor = color;
+}
+
+
+/***************************************************************************************
+** Function name:           scroll
+** Description:             Scroll dx,dy pixels, positive right,down, negative left,up
+***************************************************************************************/
+void TFT_eSprite::scroll(int16_t dx, int16_t dy)
+{
+  if (abs(dx) >= _sw || abs(dy) >= _sh)
+  {
+    fillRect (_sx, _sy, _sw, _sh, _scolor);
+    return;
+  }
+
+  // Fetch the scroll area width and height set by setScrollRect()
+  uint32_t w  = _sw - abs(dx); // line width to copy
+  uint32_t h  = _sh - abs(dy); // lines to copy
+  int32_t iw  = _iwidth;       // rounded up width of sprite
+
+  // Fetch the x,y origin set by setScrollRect()
+  uint32_t tx = _sx; // to x
+  uint32_t fx = _sx; // from x
+  uint32_t ty = _sy; // to y
+  uint32_t fy = _sy; // from y
+
+  // Adjust for x delta
+  if (dx <= 0) fx -= dx;
+  else tx += dx;
+
+  // Adjust for y delta
+  if (dy <= 0) fy -= dy;
+  else
+  { // Scrolling down so start copy from bottom
+    ty = ty + _sh - 1; // "To" pointer
+    iw = -iw;          // Pointer moves backwards
+    fy = ty - dy;      // "From" pointer
+  }
+
+  // Calculate "from y" and "to y" pointers in RAM
+  uint32_t fyp = fx + fy * _iwidth;
+  uint32_t typ = tx + ty * _iwidth;
+
+  // Now move the pixels in RAM
+  if (_bpp == 16)
+  {
+    while (h--)
+    { // move pixel lines (to, from, byte count)
+      memmove( _img + typ, _img + fyp, w<<1);
+      typ += iw;
+      fyp += iw;
+    }
+  }
+  else if (_bpp == 8)
+  {
+    while (h--)
+    { // move pixel lines (to, from, byte count)
+      memmove( _img8 + typ, _img8 + fyp, w);
+      typ += iw;
+      fyp += iw;
+    }
+  }
+  else if (_bpp == 4)
+  {
+    // could optimize for scrolling by even # pixels using memove (later)
+    if (dx >  0) { tx += w; fx += w; } // Start from right edge
+    while (h--)
+    { // move pixels one by one
+      for (uint16_t xp = 0; xp < w; xp++)
+      {
+        if (dx <= 0) drawPixel(tx + xp, ty, readPixelValue(fx + xp, fy));
+        if (dx >  0) drawPixel(tx - xp, ty, readPixelValue(fx - xp, fy));
+      }
+      if (dy <= 0)  { ty++; fy++; }
+      else  { ty--; fy--; }
+    }
+  }
+  else if (_bpp == 2)
+  {
+    int32_t bw = _iwidth >> 2;        // Bytes per line
+    if (dy > 0) bw = -bw;
+    uint8_t* to   = _img8 + ty * (_iwidth >> 2);
+    uint8_t* from = _img8 + fy * (_iwidth >> 2);
+    uint8_t  line[(_iwidth >> 2) + 1]; // Copy via a buffer when moving pixels along a line
+    while (h--)
+    {
+      if (dy != 0) packedCopy(to, tx, from, fx, w);
+      else {
+        packedCopy(line, fx & 3, from, fx, w);
+        packedCopy(to, tx, line, fx & 3, w);
+      }
+      to   += bw;
+      from += bw;
+    }
+  }
+  else if (_bpp == 1 )
+  {
+    if (dx >  0) { tx += w; fx += w; } // Start from right edge
+    while (h--)
+    { // move pixels one by one
+      for (uint16_t xp = 0; xp < w; xp++)
+      {
+        if (dx <= 0) drawPixel(tx + xp, ty, readPixelValue(fx + xp, fy));
+        if (dx >  0) drawPixel(tx - xp, ty, readPixelValue(fx - xp, fy));
+      }
+      if (dy <= 0)  { ty++; fy++; }
+      else  { ty--; fy--; }
+    }
+  }
+  else return; // Not 1, 2, 4, 8 or 16 bpp
+
+  // Fill the gap left by the scrolling
+  if (dx > 0) fillRect(_sx, _sy, dx, _sh, _scolor);
+  if (dx < 0) fillRect(_sx + _sw + dx, _sy, -dx, _sh, _scolor);
+  if (dy > 0) fillRect(_sx, _sy, _sw, dy, _scolor);
+  if (dy < 0) fillRect(_sx, _sy + _sh + dy, _sw, -dy, _scolor);
+}
+
+
+/***************************************************************************************
+** Function name:           fillSprite
+** Description:             Fill the whole sprite with defined colour
+***************************************************************************************/
+void TFT_eSprite::fillSprite(uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  // Use memset if possible as it is super fast
+  if(_xDatum == 0 && _yDatum == 0  &&  _xWidth == width())
+  {
+    if(_bpp == 16) {
+      if ( (uint8_t)color == (uint8_t)(color>>8) ) {
+        memset(_img,  (uint8_t)color, _iwidth * _yHeight * 2);
+      }
+      else fillRect(_vpX, _vpY, _xWidth, _yHeight, color);
+    }
+    else if (_bpp == 8)
+    {
+      color = pixel8(color);
+      memset(_img8, (uint8_t)color, _iwidth * _yHeight);
+    }
+    else if (_bpp == 4)
+    {
+      uint8_t c = ((color & 0x0F) | (((color & 0x0F) << 4) & 0xF0));
+      memset(_img4, c, (_iwidth * _yHeight) >> 1);
+    }
+    else if (_bpp == 2)
+    {
+      memset(_img8, (color & 0x03) * 0x55, (_iwidth * _yHeight) >> 2);
+    }
+    else if (_bpp == 1)
+    {
+      if(color) memset(_img8, 0xFF, (_bitwidth>>3) * _dheight + 1);
+      else      memset(_img8, 0x00, (_bitwidth>>3) * _dheight + 1);
+    }
+  }
+  else fillRect(_vpX - _xDatum, _vpY - _yDatum, _xWidth, _yHeight, color);
+}
+
+
+/***************************************************************************************
+** Function name:           width
+** Description:             Return the width of sprite
+***************************************************************************************/
+// Return the size of the sprite
+int16_t TFT_eSprite::width(void)
+{
+  if (!_created ) return 0;
+
+  if (_bpp > 1) {
+    if (_vpDatum) return _xWidth;
+    return _dwidth;
+  }
+
+  if (rotation & 1) {
+    if (_vpDatum) return _xWidth;
+    return _dheight;
+  }
+
+  if (_vpDatum) return _xWidth;
+  return _dwidth;
+}
+
+
+/***************************************************************************************
+** Function name:           height
+** Description:             Return the height of sprite
+***************************************************************************************/
+int16_t TFT_eSprite::height(void)
+{
+  if (!_created ) return 0;
+
+  if (_bpp > 1) {
+    if (_vpDatum) return _yHeight;
+    return _dheight;
+  }
+
+  if (rotation & 1) {
+    if (_vpDatum) return _yHeight;
+    return _dwidth;
+  }
+
+  if (_vpDatum) return _yHeight;
+  return _dheight;
+}
+
+
+/***************************************************************************************
+** Function name:           setRotation
+** Description:             Rotate coordinate frame for 1bpp sprite
+***************************************************************************************/
+// Does nothing for 2, 4, 8 and 16 bpp sprites.
+void TFT_eSprite::setRotation(uint8_t r)
+{
+  if (_bpp != 1) return;
+
+  rotation = r;
+  
+  if (rotation&1) {
+    resetViewport();
+  }
+  else {
+    resetViewport();
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           getRotation
+** Description:             Get rotation for 1bpp sprite
+***************************************************************************************/
+uint8_t TFT_eSprite::getRotation(void)
+{
+  return rotation;
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixel
+** Description:             push a single pixel at an arbitrary position
+***************************************************************************************/
+void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Range checking
+  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
+
+  if (_bpp == 16)
+  {
+    color = (color >> 8) | (color << 8);
+    _img[x+y*_iwidth] = (uint16_t) color;
+  }
+  else if (_bpp == 8)
+  {
+    _img8[x+y*_iwidth] = pixel8(color);
+  }
+  else if (_bpp == 4)
+  {
+    uint8_t c = color & 0x0F;
+    int index = (x+y*_iwidth)>>1;;
+    if ((x & 0x01) == 0) {
+      _img4[index] = (uint8_t)((c << 4) | (_img4[index] & 0x0F));
+    }
+    else {
+      _img4[index] =  (uint8_t)(c | (_img4[index] & 0xF0));
+    }
+  }
+  else if (_bpp == 2)
+  {
+    uint8_t shift = 6 - ((x & 3) << 1);
+    int index = (x+y*_iwidth)>>2;
+    _img8[index] = (uint8_t)((_img8[index] & ~(0x03 << shift)) | ((color & 0x03) << shift));
+  }
+  else // 1 bpp
+  {
+    if (rotation == 1)
+    {
+      uint16_t tx = x;
+      x = _dwidth - y - 1;
+      y = tx;
+    }
+    else if (rotation == 2)
+    {
+      x = _dwidth - x - 1;
+      y = _dheight - y - 1;
+    }
+    else if (rotation == 3)
+    {
+      uint16_t tx = x;
+      x = y;
+      y = _dheight - tx - 1;
+    }
+
+    if (color) _img8[(x + y * _bitwidth)>>3] |=  (0x80 >> (x & 0x7));
+    else       _img8[(x + y * _bitwidth)>>3] &= ~(0x80 >> (x & 0x7));
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             plot n points held as x,y pairs in xy[], each with own colour
+***************************************************************************************/
+void TFT_eSprite::drawPixels(const int16_t* xy, const uint16_t* colors, size_t n)
+{
+  if (!xy || !colors) return;
+  drawPixelBatch(xy, colors, 0, n);
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             plot n points held as x,y pairs in xy[], all the same colour
+***************************************************************************************/
+void TFT_eSprite::drawPixels(const int16_t* xy, size_t n, uint32_t color)
+{
+  if (!xy) return;
+  drawPixelBatch(xy, nullptr, color, n);
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixelBatch
+** Description:             write a batch of points directly into the Sprite buffer
+***************************************************************************************/
+// If colors is nullptr then all points are plotted in "color"
+void TFT_eSprite::drawPixelBatch(const int16_t* xy, const uint16_t* colors, uint32_t color, size_t n)
+{
+  if (!_created || _vpOoB) return;
+
+  if (_bpp == 16)
+  {
+    uint16_t c = (color >> 8) | (color << 8);
+    for (size_t i = 0; i < n; i++, xy += 2) {
+      int32_t x = xy[0] + _xDatum;
+      int32_t y = xy[1] + _yDatum;
+      if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) continue;
+      if (colors) c = (colors[i] >> 8) | (colors[i] << 8);
+      _img[x + y * _iwidth] = c;
+    }
+  }
+  else if (_bpp == 8)
+  {
+    uint8_t c = pixel8(color);
+    for (size_t i = 0; i < n; i++, xy += 2) {
+      int32_t x = xy[0] + _xDatum;
+      int32_t y = xy[1] + _yDatum;
+      if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) continue;
+      if (colors) c = pixel8(colors[i]);
+      _img8[x + y * _iwidth] = c;
+    }
+  }
+  else if (_bpp == 4)
+  {
+    uint8_t c = color & 0x0F;
+    for (size_t i = 0; i < n; i++, xy += 2) {
+      int32_t x = xy[0] + _xDatum;
+      int32_t y = xy[1] + _yDatum;
+      if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) continue;
+      if (colors) c = colors[i] & 0x0F;
+      int32_t index = (x + y * _iwidth) >> 1;
+      if ((x & 0x01) == 0) _img4[index] = (uint8_t)((c << 4) | (_img4[index] & 0x0F));
+      else                 _img4[index] = (uint8_t)(c | (_img4[index] & 0xF0));
+    }
+  }
+  else if (_bpp == 2)
+  {
+    uint8_t c = color & 0x03;
+    for (size_t i = 0; i < n; i++, xy += 2) {
+      int32_t x = xy[0] + _xDatum;
+      int32_t y = xy[1] + _yDatum;
+      if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) continue;
+      if (colors) c = colors[i] & 0x03;
+      uint8_t shift = 6 - ((x & 3) << 1);
+      int32_t index = (x + y * _iwidth) >> 2;
+      _img8[index] = (uint8_t)((_img8[index] & ~(0x03 << shift)) | (c << shift));
+    }
+  }
+  else // 1 bpp, coordinate rotation is handled by drawPixel
+  {
+    for (size_t i = 0; i < n; i++, xy += 2) {
+      TFT_eSprite::drawPixel(xy[0], xy[1], colors ? colors[i] : color);
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawLine
+** Description:             draw a line between 2 arbitrary points
+***************************************************************************************/
+void TFT_eSprite::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  //_xDatum and _yDatum Not added here, it is added by drawPixel & drawFastxLine
+
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    transpose(x0, y0);
+    transpose(x1, y1);
+  }
+
+  if (x0 > x1) {
+    transpose(x0, x1);
+    transpose(y0, y1);
+  }
+
+  int32_t dx = x1 - x0, dy = abs(y1 - y0);;
+
+  int32_t err = dx >> 1, ystep = -1, xs = x0, dlen = 0;
+
+  if (y0 < y1) ystep = 1;
+
+  // Split into steep and not steep for FastH/V separation
+  if (steep) {
+    for (; x0 <= x1; x0++) {
+      dlen++;
+      err -= dy;
+      if (err < 0) {
+        err += dx;
+        if (dlen == 1) drawPixel(y0, xs, color);
+        else drawFastVLine(y0, xs, dlen, color);
+        dlen = 0; y0 += ystep; xs = x0 + 1;
+      }
+    }
+    if (dlen) drawFastVLine(y0, xs, dlen, color);
+  }
+  else
+  {
+    for (; x0 <= x1; x0++) {
+      dlen++;
+      err -= dy;
+      if (err < 0) {
+        err += dx;
+        if (dlen == 1) drawPixel(xs, y0, color);
+        else drawFastHLine(xs, y0, dlen, color);
+        dlen = 0; y0 += ystep; xs = x0 + 1;
+      }
+    }
+    if (dlen) drawFastHLine(xs, y0, dlen, color);
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawFastVLine
+** Description:             draw a vertical line
+***************************************************************************************/
+void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x < _vpX) || (x >= _vpW) || (y >= _vpH)) return;
+
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if (h < 1) return;
+
+  if (_bpp == 16)
+  {
+    color = (color >> 8) | (color << 8);
+    int32_t yp = x + _iwidth * y;
+    while (h--) {_img[yp] = (uint16_t) color; yp += _iwidth;}
+  }
+  else if (_bpp == 8)
+  {
+    color = pixel8(color);
+    while (h--) _img8[x + _iwidth * y++] = (uint8_t) color;
+  }
+  else if (_bpp == 4)
+  {
+    if ((x & 0x01) == 0)
+    {
+      uint8_t c = (uint8_t) (color & 0xF) << 4;
+      while (h--) {
+        _img4[(x + _iwidth * y)>>1] = (uint8_t) (c | (_img4[(x + _iwidth * y)>>1] & 0x0F));
+        y++;
+      }
+    }
+    else {
+      uint8_t c = (uint8_t)color & 0xF;
+      while (h--) {
+        _img4[(x + _iwidth * y)>>1] = (uint8_t) (c | (_img4[(x + _iwidth * y)>>1] & 0xF0)); // x is odd; new color goes into the low bits.
+        y++;
+      }
+    }
+  }
+  else if (_bpp == 2)
+  {
+    uint8_t  shift = 6 - ((x & 3) << 1);
+    uint8_t  mask  = ~(0x03 << shift);
+    uint8_t  c     = (color & 0x03) << shift;
+    uint8_t* ptr   = _img8 + ((x + _iwidth * y)>>2);
+    while (h--) { *ptr = (*ptr & mask) | c; ptr += (_iwidth>>2); }
+  }
+  else
+  {
+    x -= _xDatum; // Remove any offset as it will be added by drawPixel
+    y -= _yDatum;
+    while (h--)
+    {
+      drawPixel(x, y++, color);
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           drawFastHLine
+** Description:             draw a horizontal line
+***************************************************************************************/
+void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+
+  if (w < 1) return;
+
+  if (_bpp == 16)
+  {
+    color = (color >> 8) | (color << 8);
+    while (w--) _img[_iwidth * y + x++] = (uint16_t) color;
+  }
+  else if (_bpp == 8)
+  {
+    color = pixel8(color);
+    memset(_img8+_iwidth * y + x, (uint8_t)color, w);
+  }
+  else if (_bpp == 4)
+  {
+    uint8_t c = (uint8_t)color & 0x0F;
+    uint8_t c2 = (c | ((c << 4) & 0xF0));
+    if ((x & 0x01) == 1)
+    {
+      drawPixel(x - _xDatum, y - _yDatum, color);
+      x++; w--;
+      if (w < 1)
+        return;
+    }
+
+    if (((w + x) & 0x01) == 1)
+    {
+      // handle the extra one at the other end
+      drawPixel(x - _xDatum + w - 1, y - _yDatum, color);
+      w--;
+      if (w < 1) return;
+    }
+    memset(_img4 + ((_iwidth * y + x) >> 1), c2, (w >> 1));
+  }
+  else if (_bpp == 2)
+  {
+    packedFill(_img8 + y * (_iwidth >> 2), x, w, color);
+  }
+  else {
+    x -= _xDatum; // Remove any offset as it will be added by drawPixel
+    y -= _yDatum;
+
+    while (w--)
+    {
+      drawPixel(x++, y, color);
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           fillRect
+** Description:             draw a filled rectangle
+***************************************************************************************/
+void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  int32_t yp = _iwidth * y + x;
+
+  if (_bpp == 16)
+  {
+    color = (color >> 8) | (color << 8);
+    uint32_t iw = w;
+    int32_t ys = yp;
+    if(h--)  {while (iw--) _img[yp++] = (uint16_t) color;}
+    yp = ys;
+    while (h--)
+    {
+      yp += _iwidth;
+      memcpy( _img+yp, _img+ys, w<<1);
+    }
+  }
+  else if (_bpp == 8)
+  {
+    color = pixel8(color);
+    while (h--)
+    {
+      memset(_img8 + yp, (uint8_t)color, w);
+      yp += _iwidth;
+    }
+  }
+  else if (_bpp == 4)
+  {
+    uint8_t c1 = (uint8_t)color & 0x0F;
+    uint8_t c2 = c1 | ((c1 << 4) & 0xF0);
+    if ((x & 0x01) == 0 && (w & 0x01) == 0)
+    {
+      yp = (yp >> 1);
+      while (h--)
+      {
+        memset(_img4 + yp, c2, (w>>1));
+        yp += (_iwidth >> 1);
+      }
+    }
+    else if ((x & 0x01) == 0)
+    {
+
+      // same as above but you have a hangover on the right.
+      yp = (yp >> 1);
+      while (h--)
+      {
+        if (w > 1)
+          memset(_img4 + yp, c2, (w-1)>>1);
+        // handle the rightmost pixel by calling drawPixel
+        drawPixel(x+w-1-_xDatum, y+h-_yDatum, c1);
+        yp += (_iwidth >> 1);
+      }
+    }
+    else if ((w & 0x01) == 1)
+    {
+      yp = (yp + 1) >> 1;
+      while (h--) {
+        drawPixel(x-_xDatum, y+h-_yDatum, color & 0x0F);
+        if (w > 1)
+          memset(_img4 + yp, c2, (w-1)>>1);
+        // same as above but you have a hangover on the left instead
+        yp += (_iwidth >> 1);
+      }
+    }
+    else
+    {
+      yp = (yp + 1) >> 1;
+      while (h--) {
+        drawPixel(x-_xDatum, y+h-_yDatum, color & 0x0F);
+        if (w > 1) drawPixel(x+w-1-_xDatum, y+h-_yDatum, color & 0x0F);
+        if (w > 2)
+          memset(_img4 + yp, c2, (w-2)>>1);
+        // maximal hacking, single pixels on left and right.
+        yp += (_iwidth >> 1);
+      }
+    }
+  }
+  else if (_bpp == 2)
+  {
+    uint8_t* row = _img8 + y * (_iwidth >> 2);
+    while (h--)
+    {
+      packedFill(row, x, w, color);
+      row += (_iwidth >> 2);
+    }
+  }
+  else
+  {
+    x -= _xDatum;
+    y -= _yDatum;
+    while (h--)
+    {
+      int32_t ww = w;
+      int32_t xx = x;
+      while (ww--) drawPixel(xx++, y, color);
+      y++;
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           fillGradient
+** Description:             render a gradient into the clipped area x,y,w,h
+***************************************************************************************/
+// Coordinates have the datum and clipping already applied. 4 and 2 bpp Sprites take the
+// nearest palette colour and 1 bpp Sprites the nearer bitmap colour. With dither these
+// are dithered at RGB332 levels, or at one level per channel for 1 bpp.
+void TFT_eSprite::fillGradient(gradient_t* g, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  if (!_created) return;
+
+  if (_bpp == 16)
+  {
+    // Dither to RGB565 levels
+    g->dr = 3; g->dg = 2; g->db = 3;
+    for (int32_t yp = y; yp < y + h; yp++) {
+      uint16_t* ptr = _img + x + yp * _iwidth;
+      gradientLine(g, ptr, x, yp, w);
+      for (int32_t i = 0; i < w; i++) ptr[i] = (ptr[i] >> 8) | (ptr[i] << 8);
+    }
+  }
+  else if (_bpp == 8)
+  {
+    // Dither to RGB332 levels
+    g->dr = 5; g->dg = 5; g->db = 6;
+    uint16_t lineBuf[w];
+    for (int32_t yp = y; yp < y + h; yp++) {
+      uint8_t* ptr = _img8 + x + yp * _iwidth;
+      gradientLine(g, lineBuf, x, yp, w);
+      for (int32_t i = 0; i < w; i++) {
+        uint16_t color = lineBuf[i];
+        ptr[i] = pixel8(color);
+      }
+    }
+  }
+  else
+  {
+    if (!g->dither)    { g->dr = 3; g->dg = 2; g->db = 3; }
+    else if (_bpp > 1) { g->dr = 5; g->dg = 5; g->db = 6; }
+    else               { g->dr = 7; g->dg = 7; g->db = 7; }
+    uint16_t lineBuf[w];
+    uint16_t lastColor = 0;
+    uint8_t  lastIndex = nearestIndex(0);
+    for (int32_t yp = y; yp < y + h; yp++) {
+      gradientLine(g, lineBuf, x, yp, w);
+      for (int32_t i = 0; i < w; i++) {
+        uint16_t color = lineBuf[i];
+        if (color != lastColor) { lastColor = color; lastIndex = nearestIndex(color); }
+        lineBuf[i] = lastIndex;
+      }
+      writeValues(lineBuf, x, yp, w, nullptr, 0);
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushAlphaImage
+** Description:             Blend a coverage image in colour fg into the Sprite
+***************************************************************************************/
+void TFT_eSprite::pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *alpha, uint8_t bits,
+                                 uint16_t fg, uint32_t bg)
+{
+  if (!_created || alpha == nullptr || (bits != 8 && bits != 4)) return;
+
+  PI_CLIP;
+
+  uint32_t stride = (bits == 8) ? w : (w + 1) >> 1;
+  alpha += dy * stride;
+
+  // Opaque blends use a table, otherwise the Sprite pixels are the background
+  bool opaque = (bg != 0x00FFFFFF);
+  uint16_t lut[256];
+  if (opaque) alphaTable(lut, bits, fg, bg);
+
+  uint16_t lineBuf[dw];
+  uint8_t  valueBuf[(_bpp < 8) ? dw : 1]; // Pixel values for 4, 2 and 1 bpp
+
+  uint16_t lastColor = 0;
+  uint8_t  lastIndex = nearestIndex(0);
+
+  while (dh--)
+  {
+    if (_bpp == 16)
+    {
+      uint16_t* ptr = _img + x + y * _iwidth;
+      if (!opaque) for (int32_t i = 0; i < dw; i++) lineBuf[i] = ptr[i] >> 8 | ptr[i] << 8;
+      alphaLine(lineBuf, alpha, dx, dw, bits, fg, opaque ? lut : nullptr);
+      for (int32_t i = 0; i < dw; i++) ptr[i] = lineBuf[i] >> 8 | lineBuf[i] << 8;
+    }
+    else if (_bpp == 8)
+    {
+      // RGB332 or palette colours to 565 and back are lossless so uncovered pixels are unchanged
+      uint8_t* ptr = _img8 + x + y * _iwidth;
+      if (!opaque) for (int32_t i = 0; i < dw; i++) lineBuf[i] = color8(ptr[i]);
+      alphaLine(lineBuf, alpha, dx, dw, bits, fg, opaque ? lut : nullptr);
+      for (int32_t i = 0; i < dw; i++) {
+        uint16_t color = lineBuf[i];
+        ptr[i] = pixel8(color);
+      }
+    }
+    else // 4, 2 and 1 bpp
+    {
+      // Find the pixel values, 0xFF marks pixels left unchanged
+      for (int32_t i = 0; i < dw; i++)
       {
-        if (dx <= 0) drawPixel(tx + xp, ty, readPixelValue(fx + xp, fy));
-        if (dx >  0) drawPixel(tx - xp, ty, readPixelValue(fx - xp, fy));
+        uint8_t a = alphaValue(alpha, dx + i, bits);
+        valueBuf[i] = 0xFF;
+
+        if (_bpp != 1)
+        {
+          if (!opaque && a == 0) continue;
+          uint16_t color;
+          // readPixel applies the datum so remove it
+          if (opaque) color = lut[bits == 8 ? a : a / 17];
+          else        color = (a == 255) ? fg : fastBlend(a, fg, readPixel(x + i - _xDatum, y - _yDatum));
+          if (color != lastColor) { lastColor = color; lastIndex = nearestIndex(color); }
+          valueBuf[i] = lastIndex;
+        }
+        else if (a >= 128) valueBuf[i] = (fg != 0);
+        else if (opaque)   valueBuf[i] = (bg != 0);
+      }
+
+      // Write runs of one value
+      int32_t i = 0;
+      while (i < dw) {
+        if (valueBuf[i] == 0xFF) { i++; continue; }
+        int32_t j = i + 1;
+        while (j < dw && valueBuf[j] == valueBuf[i]) j++;
+        if (_bpp == 1 && rotation) {
+          // drawPixel applies the datum so remove it
+          for (int32_t k = i; k < j; k++) drawPixel(x + k - _xDatum, y - _yDatum, valueBuf[i]);
+        }
+        else fillRun(x + i, x + j - 1, y, valueBuf[i]);
+        i = j;
       }
-      if (dy <= 0)  { ty++; fy++; }
-      else  { ty--; fy--; }
     }
-  }
-  else return; // Not 1, 4, 8 or 16 bpp
 
-  // Fill the gap left by the scrolling
-  if (dx > 0) fillRect(_sx, _sy, dx, _sh, _scolor);
-  if (dx < 0) fillRect(_sx + _sw + dx, _sy, -dx, _sh, _scolor);
-  if (dy > 0) fillRect(_sx, _sy, _sw, dy, _scolor);
-  if (dy < 0) fillRect(_sx, _sy + _sh + dy, _sw, -dy, _scolor);
+    y++;
+    alpha += stride;
+  }
 }
 
 
 /***************************************************************************************
-** Function name:           fillSprite
-** Description:             Fill the whole sprite with defined colour
+** Function name:           pushAtlasRect
+** Description:             Write an area of an image atlas into the Sprite
 ***************************************************************************************/
-void TFT_eSprite::fillSprite(uint32_t color)
+void TFT_eSprite::pushAtlasRect(int32_t x, int32_t y, const imageAtlas_t *atlas, int32_t sx, int32_t sy,
+                                int32_t w, int32_t h, bool useTransp, uint16_t transp)
 {
-  if (!_created || _vpOoB) return;
+  if (!_created) return;
 
-  // Use memset if possible as it is super fast
-  if(_xDatum == 0 && _yDatum == 0  &&  _xWidth == width())
+  PI_CLIP;
+
+  sx += dx;
+  sy += dy;
+
+  uint16_t lineBuf[dw];
+  uint8_t  valueBuf[(_bpp < 8) ? dw : 1]; // Pixel values for 4, 2 and 1 bpp
+
+  // A 4 bpp atlas is assumed to share the palette of a 4 bpp Sprite so indexes are copied
+  bool copyIndex = (_bpp == 4) && (atlas->bpp == 4);
+  uint32_t stride = ((uint32_t)atlas->width * atlas->bpp + 7) >> 3;
+
+  uint16_t lastColor = 0;
+  uint8_t  lastIndex = nearestIndex(0);
+
+  while (dh--)
   {
-    if(_bpp == 16) {
-      if ( (uint8_t)color == (uint8_t)(color>>8) ) {
-        memset(_img,  (uint8_t)color, _iwidth * _yHeight * 2);
+    atlasLine(atlas, sx, sy, dw, lineBuf);
+
+    if (_bpp == 16)
+    {
+      uint16_t* ptr = _img + x + y * _iwidth;
+      for (int32_t i = 0; i < dw; i++) {
+        uint16_t color = lineBuf[i];
+        if (!useTransp || color != transp) ptr[i] = color >> 8 | color << 8;
       }
-      else fillRect(_vpX, _vpY, _xWidth, _yHeight, color);
     }
     else if (_bpp == 8)
     {
-      color = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
-      memset(_img8, (uint8_t)color, _iwidth * _yHeight);
-    }
-    else if (_bpp == 4)
-    {
-      uint8_t c = ((color & 0x0F) | (((color & 0x0F) << 4) & 0xF0));
-      memset(_img4, c, (_iwidth * _yHeight) >> 1);
+      uint8_t* ptr = _img8 + x + y * _iwidth;
+      for (int32_t i = 0; i < dw; i++) {
+        uint16_t color = lineBuf[i];
+        if (!useTransp || color != transp) ptr[i] = pixel8(color);
+      }
     }
-    else if (_bpp == 1)
+    else // 4, 2 and 1 bpp
     {
-      if(color) memset(_img8, 0xFF, (_bitwidth>>3) * _dheight + 1);
-      else      memset(_img8, 0x00, (_bitwidth>>3) * _dheight + 1);
+      const uint8_t* row = (const uint8_t*)atlas->data + sy * stride;
+      for (int32_t i = 0; i < dw; i++) {
+        uint16_t color = lineBuf[i];
+        if (useTransp && color == transp) continue;
+
+        if (copyIndex) {
+          uint8_t colors = pgm_read_byte(row + ((sx + i) >> 1));
+          valueBuf[i] = ((sx + i) & 1) ? (colors & 0x0F) : (colors >> 4);
+        }
+        else if (_bpp != 1) {
+          if (color != lastColor) { lastColor = color; lastIndex = nearestIndex(color); }
+          valueBuf[i] = lastIndex;
+        }
+        else valueBuf[i] = (color != 0);
+      }
+
+      // Write runs of one value, transparent pixels end a run
+      int32_t i = 0;
+      while (i < dw) {
+        if (useTransp && lineBuf[i] == transp) { i++; continue; }
+        int32_t j = i + 1;
+        while (j < dw && valueBuf[j] == valueBuf[i] && !(useTransp && lineBuf[j] == transp)) j++;
+        if (_bpp == 1 && rotation) {
+          // drawPixel applies the datum so remove it
+          for (int32_t k = i; k < j; k++) drawPixel(x + k - _xDatum, y - _yDatum, valueBuf[i]);
+        }
+        else fillRun(x + i, x + j - 1, y, valueBuf[i]);
+        i = j;
+      }
     }
+
+    y++;
+    sy++;
   }
-  else fillRect(_vpX - _xDatum, _vpY - _yDatum, _xWidth, _yHeight, color);
 }
 
 
 /***************************************************************************************
-** Function name:           width
-** Description:             Return the width of sprite
+** Function name:           drawBitmapRuns
+** Description:             draw a 1bpp bitmap as runs written directly to the Sprite
 ***************************************************************************************/
-// Return the size of the sprite
-int16_t TFT_eSprite::width(void)
+void TFT_eSprite::drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h,
+                                 uint16_t fgcolor, uint16_t bgcolor, bool xbm, bool opaque)
 {
-  if (!_created ) return 0;
-
-  if (_bpp > 1) {
-    if (_vpDatum) return _xWidth;
-    return _dwidth;
-  }
-
-  if (rotation & 1) {
-    if (_vpDatum) return _xWidth;
-    return _dheight;
-  }
+  if (!_created || _vpOoB || w < 1 || h < 1) return;
 
-  if (_vpDatum) return _xWidth;
-  return _dwidth;
-}
+  int32_t byteWidth = (w + 7) >> 3;
 
+  x+= _xDatum;
+  y+= _yDatum;
 
-/***************************************************************************************
-** Function name:           height
-** Description:             Return the height of sprite
-***************************************************************************************/
-int16_t TFT_eSprite::height(void)
-{
-  if (!_created ) return 0;
+  // Clip to the viewport, i0 to i1 and j0 to j1 are the visible bitmap columns and rows
+  int32_t i0 = 0, i1 = w, j0 = 0, j1 = h;
+  if (x < _vpX) i0 = _vpX - x;
+  if (y < _vpY) j0 = _vpY - y;
+  if (x + w > _vpW) i1 = _vpW - x;
+  if (y + h > _vpH) j1 = _vpH - y;
+  if (i0 >= i1 || j0 >= j1) return;
 
-  if (_bpp > 1) {
-    if (_vpDatum) return _yHeight;
-    return _dheight;
+  // Colours in the Sprite pixel format
+  uint16_t fg = fgcolor, bg = bgcolor;
+  if (_bpp == 16)
+  {
+    fg = (fg >> 8) | (fg << 8);
+    bg = (bg >> 8) | (bg << 8);
   }
-
-  if (rotation & 1) {
-    if (_vpDatum) return _yHeight;
-    return _dwidth;
+  else if (_bpp == 8)
+  {
+    fg = pixel8(fg);
+    bg = pixel8(bg);
   }
 
-  if (_vpDatum) return _yHeight;
-  return _dheight;
+  for (int32_t j = j0; j < j1; j++) {
+    const uint8_t *row = bitmap + j * byteWidth;
+    for (int32_t i = i0; i < i1; ) {
+      bool set;
+      int32_t run = bitmapRun(row, i, i1, xbm, &set);
+      if (set || opaque) {
+        if (_bpp == 16) {
+          uint16_t* ptr = _img + x + i + (y + j) * _iwidth;
+          uint16_t  color = set ? fg : bg;
+          for (int32_t n = run; n > 0; n--) *ptr++ = color;
+        }
+        else if (_bpp == 8) memset(_img8 + x + i + (y + j) * _iwidth, (uint8_t)(set ? fg : bg), run);
+        else drawFastHLine(x + i - _xDatum, y + j - _yDatum, run, set ? fgcolor : bgcolor);
+      }
+      i += run;
+    }
+  }
 }
 
 
 /***************************************************************************************
-** Function name:           setRotation
-** Description:             Rotate coordinate frame for 1bpp sprite
+** Function name:           floodFill
+** Description:             fill the area connected to x,y that matches the x,y colour
 ***************************************************************************************/
-// Does nothing for 4, 8 and 16 bpp sprites.
-void TFT_eSprite::setRotation(uint8_t r)
+bool TFT_eSprite::floodFill(int32_t x, int32_t y, uint32_t color, void* scratch, size_t bytes)
 {
-  if (_bpp != 1) return;
-
-  rotation = r;
-  
-  if (rotation&1) {
-    resetViewport();
-  }
-  else {
-    resetViewport();
-  }
+  return floodFillRegion(x, y, color, 0, scratch, bytes);
 }
 
 
 /***************************************************************************************
-** Function name:           getRotation
-** Description:             Get rotation for 1bpp sprite
+** Function name:           floodFillTolerance
+** Description:             fill the connected area with colours close to the x,y colour
 ***************************************************************************************/
-uint8_t TFT_eSprite::getRotation(void)
+bool TFT_eSprite::floodFillTolerance(int32_t x, int32_t y, uint32_t color, uint8_t tolerance,
+                                     void* scratch, size_t bytes)
 {
-  return rotation;
+  return floodFillRegion(x, y, color, tolerance, scratch, bytes);
 }
 
 
 /***************************************************************************************
-** Function name:           drawPixel
-** Description:             push a single pixel at an arbitrary position
+** Function name:           floodFillRegion
+** Description:             scanline flood fill using a bounded stack of filled spans
 ***************************************************************************************/
-void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
+// Spans are filled as they are found and then pushed so the rows above and below get
+// searched, there is no recursion and no heap use. If the stack overflows the fill
+// continues but may be incomplete and false is returned.
+constexpr uint16_t FloodFillSpans = 64; // Span stack depth used when no scratch is supplied
+
+bool TFT_eSprite::floodFillRegion(int32_t x, int32_t y, uint32_t color, uint8_t tolerance,
+                                  void* scratch, size_t bytes)
 {
-  if (!_created || _vpOoB) return;
+  if (!_created || _vpOoB) return false;
 
   x+= _xDatum;
   y+= _yDatum;
 
-  // Range checking
-  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
+  if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return true;
 
-  if (_bpp == 16)
-  {
-    color = (color >> 8) | (color << 8);
-    _img[x+y*_iwidth] = (uint16_t) color;
-  }
-  else if (_bpp == 8)
-  {
-    _img8[x+y*_iwidth] = (uint8_t)((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3);
-  }
-  else if (_bpp == 4)
-  {
-    uint8_t c = color & 0x0F;
-    int index = (x+y*_iwidth)>>1;;
-    if ((x & 0x01) == 0) {
-      _img4[index] = (uint8_t)((c << 4) | (_img4[index] & 0x0F));
-    }
-    else {
-      _img4[index] =  (uint8_t)(c | (_img4[index] & 0xF0));
-    }
-  }
-  else // 1 bpp
+  floodFill_t f;
+
+  // Viewport in Sprite memory coordinates, only 1bpp Sprites have coordinate rotation
+  f.x0 = _vpX; f.x1 = _vpW;
+  f.y0 = _vpY; f.y1 = _vpH;
+
+  if (_bpp == 1 && rotation)
   {
+    int32_t tx = x;
     if (rotation == 1)
     {
-      uint16_t tx = x;
       x = _dwidth - y - 1;
       y = tx;
+      f.x0 = _dwidth - _vpH; f.x1 = _dwidth - _vpY;
+      f.y0 = _vpX;           f.y1 = _vpW;
     }
     else if (rotation == 2)
     {
       x = _dwidth - x - 1;
       y = _dheight - y - 1;
+      f.x0 = _dwidth  - _vpW; f.x1 = _dwidth  - _vpX;
+      f.y0 = _dheight - _vpH; f.y1 = _dheight - _vpY;
     }
-    else if (rotation == 3)
+    else
     {
-      uint16_t tx = x;
       x = y;
       y = _dheight - tx - 1;
+      f.x0 = _vpY;            f.x1 = _vpH;
+      f.y0 = _dheight - _vpW; f.y1 = _dheight - _vpX;
     }
-
-    if (color) _img8[(x + y * _bitwidth)>>3] |=  (0x80 >> (x & 0x7));
-    else       _img8[(x + y * _bitwidth)>>3] &= ~(0x80 >> (x & 0x7));
   }
-}
-
-
-/***************************************************************************************
-** Function name:           drawLine
-** Description:             draw a line between 2 arbitrary points
-***************************************************************************************/
-void TFT_eSprite::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
-{
-  if (!_created || _vpOoB) return;
 
-  //_xDatum and _yDatum Not added here, it is added by drawPixel & drawFastxLine
+  if (f.x0 < 0) f.x0 = 0;
+  if (f.y0 < 0) f.y0 = 0;
+  if (f.x1 > _dwidth)  f.x1 = _dwidth;
+  if (f.y1 > _dheight) f.y1 = _dheight;
+  if ((x < f.x0) || (y < f.y0) ||(x >= f.x1) || (y >= f.y1)) return true;
 
-  bool steep = abs(y1 - y0) > abs(x1 - x0);
-  if (steep) {
-    transpose(x0, y0);
-    transpose(x1, y1);
+  // Seed and fill values in the Sprite pixel format
+  if (_bpp == 16)
+  {
+    f.target = _img[x + y * _iwidth];
+    f.fill = (uint16_t)((color >> 8) | (color << 8));
   }
-
-  if (x0 > x1) {
-    transpose(x0, x1);
-    transpose(y0, y1);
+  else if (_bpp == 8)
+  {
+    f.target = _img8[x + y * _iwidth];
+    f.fill = pixel8(color);
   }
-
-  int32_t dx = x1 - x0, dy = abs(y1 - y0);;
-
-  int32_t err = dx >> 1, ystep = -1, xs = x0, dlen = 0;
-
-  if (y0 < y1) ystep = 1;
-
-  // Split into steep and not steep for FastH/V separation
-  if (steep) {
-    for (; x0 <= x1; x0++) {
-      dlen++;
-      err -= dy;
-      if (err < 0) {
-        err += dx;
-        if (dlen == 1) drawPixel(y0, xs, color);
-        else drawFastVLine(y0, xs, dlen, color);
-        dlen = 0; y0 += ystep; xs = x0 + 1;
-      }
-    }
-    if (dlen) drawFastVLine(y0, xs, dlen, color);
+  else if (_bpp == 4)
+  {
+    f.target = (_img4[(x + y * _iwidth)>>1] >> ((x & 1) ? 0 : 4)) & 0x0F;
+    f.fill = color & 0x0F;
+    if (!_colorMap) tolerance = 0;
+  }
+  else if (_bpp == 2)
+  {
+    f.target = (_img8[(x + y * _iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03;
+    f.fill = color & 0x03;
+    if (!_colorMap) tolerance = 0;
   }
   else
   {
-    for (; x0 <= x1; x0++) {
-      dlen++;
-      err -= dy;
-      if (err < 0) {
-        err += dx;
-        if (dlen == 1) drawPixel(xs, y0, color);
-        else drawFastHLine(xs, y0, dlen, color);
-        dlen = 0; y0 += ystep; xs = x0 + 1;
-      }
-    }
-    if (dlen) drawFastHLine(xs, y0, dlen, color);
+    f.target = (_img8[(x + y * _bitwidth)>>3] >> (7 - (x & 0x7))) & 0x01;
+    f.fill = color ? 1 : 0;
+    tolerance = 0; // Only two values so tolerance has no meaning
   }
-}
-
-
-/***************************************************************************************
-** Function name:           drawFastVLine
-** Description:             draw a vertical line
-***************************************************************************************/
-void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
-{
-  if (!_created || _vpOoB) return;
-
-  x+= _xDatum;
-  y+= _yDatum;
-
-  // Clipping
-  if ((x < _vpX) || (x >= _vpW) || (y >= _vpH)) return;
 
-  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+  // An exact fill with the colour already at x,y has nothing to do
+  if (!tolerance && f.target == f.fill) return true;
 
-  if ((y + h) > _vpH) h = _vpH - y;
+  f.tol = tolerance;
 
-  if (h < 1) return;
+  // Seed colour channels for tolerance tests, 8 bpp values expand as readPixel() does
+  uint16_t seed = f.target;
+  if (_bpp == 16) seed = (seed >> 8) | (seed << 8);
+  else if (_bpp == 8) seed = color8(seed);
+  else if ((_bpp == 4 || _bpp == 2) && tolerance) seed = _colorMap[seed];
+  f.tr = (seed >> 8) & 0xF8;
+  f.tg = (seed >> 3) & 0xFC;
+  f.tb = (seed << 3) & 0xF8;
 
-  if (_bpp == 16)
-  {
-    color = (color >> 8) | (color << 8);
-    int32_t yp = x + _iwidth * y;
-    while (h--) {_img[yp] = (uint16_t) color; yp += _iwidth;}
-  }
-  else if (_bpp == 8)
-  {
-    color = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
-    while (h--) _img8[x + _iwidth * y++] = (uint8_t) color;
-  }
-  else if (_bpp == 4)
-  {
-    if ((x & 0x01) == 0)
-    {
-      uint8_t c = (uint8_t) (color & 0xF) << 4;
-      while (h--) {
-        _img4[(x + _iwidth * y)>>1] = (uint8_t) (c | (_img4[(x + _iwidth * y)>>1] & 0x0F));
-        y++;
-      }
-    }
-    else {
-      uint8_t c = (uint8_t)color & 0xF;
-      while (h--) {
-        _img4[(x + _iwidth * y)>>1] = (uint8_t) (c | (_img4[(x + _iwidth * y)>>1] & 0xF0)); // x is odd; new color goes into the low bits.
-        y++;
+  // The set of matching 8, 4 and 2 bpp values is built once so a scan is a table look up
+  memset(f.lut, 0, sizeof(f.lut));
+  if (_bpp == 8 || _bpp == 4 || _bpp == 2)
+  {
+    if (!tolerance) f.lut[f.target >> 3] = 1 << (f.target & 7);
+    else
+    {
+      uint16_t n = 1 << _bpp;
+      for (uint16_t v = 0; v < n; v++)
+      {
+        if (v == f.fill) continue; // Filled pixels must not match again
+        uint16_t c = (_bpp != 8) ? _colorMap[v] : color8(v);
+        if (abs(((c >> 8) & 0xF8) - f.tr) > tolerance) continue;
+        if (abs(((c >> 3) & 0xFC) - f.tg) > tolerance) continue;
+        if (abs(((c << 3) & 0xF8) - f.tb) > tolerance) continue;
+        f.lut[v >> 3] |= 1 << (v & 7);
       }
     }
   }
-  else
+
+  // An exact fill into the seed colour, or a tolerance fill seeded on the fill colour
+  if (!floodMatch(&f, x, y)) return true;
+
+  // Span stack in the scratch memory (aligned for fillSpan_t) or a local array
+  fillSpan_t local[FloodFillSpans];
+  f.stack = local;
+  f.size  = FloodFillSpans;
+  f.sp    = 0;
+  f.ok    = true;
+  if (scratch)
   {
-    x -= _xDatum; // Remove any offset as it will be added by drawPixel
-    y -= _yDatum;
-    while (h--)
+    uintptr_t adr = ((uintptr_t)scratch + 1) & ~(uintptr_t)1;
+    if (bytes >= adr - (uintptr_t)scratch + sizeof(fillSpan_t))
     {
-      drawPixel(x, y++, color);
+      f.size  = (bytes - (adr - (uintptr_t)scratch)) / sizeof(fillSpan_t);
+      f.stack = (fillSpan_t*)adr;
+    }
+  }
+
+  // Fill the seed row and search both neighbour rows
+  int32_t l = floodScan(&f, x, y, f.x0, -1, true) + 1;
+  int32_t r = floodScan(&f, x, y, f.x1 - 1, 1, true) - 1;
+  fillRun(l, r, y, f.fill);
+  floodPush(&f, y, l, r,  1);
+  floodPush(&f, y, l, r, -1);
+
+  while (f.sp)
+  {
+    fillSpan_t* s = &f.stack[--f.sp];
+    int32_t dy = s->dy;
+    int32_t x1 = s->xl;
+    int32_t x2 = s->xr;
+    y = s->y + dy;
+
+    // A run that starts on the parent span may extend to the left of it
+    x = x1;
+    if (floodMatch(&f, x, y)) l = floodScan(&f, x - 1, y, f.x0, -1, true) + 1;
+    else l = x = floodScan(&f, x + 1, y, x2, 1, false);
+
+    while (x <= x2)
+    {
+      r = floodScan(&f, x, y, f.x1 - 1, 1, true) - 1;
+      fillRun(l, r, y, f.fill);
+      floodPush(&f, y, l, r, dy);
+      // Parts that overhang the parent span can leak back around corners
+      if (l < x1) floodPush(&f, y, l, x1 - 1, -dy);
+      if (r > x2) floodPush(&f, y, x2 + 1, r, -dy);
+      l = x = floodScan(&f, r + 2, y, x2, 1, false);
     }
   }
+
+  return f.ok;
 }
 
 
 /***************************************************************************************
-** Function name:           drawFastHLine
-** Description:             draw a horizontal line
+** Function name:           floodPush
+** Description:             push a filled span so that row y + dy gets searched
 ***************************************************************************************/
-void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+void TFT_eSprite::floodPush(floodFill_t* f, int32_t y, int32_t xl, int32_t xr, int32_t dy)
 {
-  if (!_created || _vpOoB) return;
+  if (y + dy < f->y0 || y + dy >= f->y1) return;
 
-  x+= _xDatum;
-  y+= _yDatum;
+  if (f->sp >= f->size) { f->ok = false; return; }
 
-  // Clipping
-  if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) return;
+  fillSpan_t* s = &f->stack[f->sp++];
+  s->y  = y;
+  s->xl = xl;
+  s->xr = xr;
+  s->dy = dy;
+}
 
-  if (x < _vpX) { w += x - _vpX; x = _vpX; }
 
-  if ((x + w) > _vpW) w = _vpW - x;
+/***************************************************************************************
+** Function name:           floodMatch
+** Description:             test if a pixel in Sprite memory belongs to the fill region
+***************************************************************************************/
+bool TFT_eSprite::floodMatch(floodFill_t* f, int32_t x, int32_t y)
+{
+  if (_bpp == 16)
+  {
+    uint16_t v = _img[x + y * _iwidth];
+    if (!f->tol) return v == f->target;
+    if (v == f->fill) return false;
+    v = (v >> 8) | (v << 8);
+    return (abs(((v >> 8) & 0xF8) - f->tr) <= f->tol) &&
+           (abs(((v >> 3) & 0xFC) - f->tg) <= f->tol) &&
+           (abs(((v << 3) & 0xF8) - f->tb) <= f->tol);
+  }
+  if (_bpp == 8)
+  {
+    uint8_t v = _img8[x + y * _iwidth];
+    return (f->lut[v >> 3] >> (v & 7)) & 1;
+  }
+  if (_bpp == 4)
+  {
+    uint8_t v = (_img4[(x + y * _iwidth)>>1] >> ((x & 1) ? 0 : 4)) & 0x0F;
+    return (f->lut[v >> 3] >> (v & 7)) & 1;
+  }
+  if (_bpp == 2)
+  {
+    uint8_t v = (_img8[(x + y * _iwidth)>>2] >> (6 - ((x & 3) << 1))) & 0x03;
+    return (f->lut[0] >> v) & 1;
+  }
+  return ((_img8[(x + y * _bitwidth)>>3] >> (7 - (x & 0x7))) & 0x01) == f->target;
+}
 
-  if (w < 1) return;
 
-  if (_bpp == 16)
+/***************************************************************************************
+** Function name:           floodScan
+** Description:             step from x towards lim while pixels do (or do not) match
+***************************************************************************************/
+// Returns the first x that differs, or lim + dir. Packed 4, 2 and 1 bpp rows are tested a
+// byte at a time where the byte lies wholly inside the scan.
+int32_t TFT_eSprite::floodScan(floodFill_t* f, int32_t x, int32_t y, int32_t lim, int32_t dir, bool match)
+{
+  if (_bpp == 16 && !f->tol)
   {
-    color = (color >> 8) | (color << 8);
-    while (w--) _img[_iwidth * y + x++] = (uint16_t) color;
+    uint16_t* ptr = _img + y * _iwidth;
+    while ((dir > 0 ? x <= lim : x >= lim) && ((ptr[x] == f->target) == match)) x += dir;
+    return x;
   }
-  else if (_bpp == 8)
+
+  if (_bpp == 8)
   {
-    color = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
-    memset(_img8+_iwidth * y + x, (uint8_t)color, w);
+    uint8_t* ptr = _img8 + y * _iwidth;
+    while ((dir > 0 ? x <= lim : x >= lim) && (((f->lut[ptr[x] >> 3] >> (ptr[x] & 7)) & 1) == match)) x += dir;
+    return x;
   }
-  else if (_bpp == 4)
+
+  if (_bpp == 4)
   {
-    uint8_t c = (uint8_t)color & 0x0F;
-    uint8_t c2 = (c | ((c << 4) & 0xF0));
-    if ((x & 0x01) == 1)
+    uint8_t* ptr = _img4 + ((y * _iwidth)>>1);
+    uint16_t lut = f->lut[0] | (f->lut[1] << 8);
+    while (dir > 0 ? x <= lim : x >= lim)
     {
-      drawPixel(x - _xDatum, y - _yDatum, color);
-      x++; w--;
-      if (w < 1)
-        return;
+      uint8_t b = ptr[x>>1];
+      bool hi = (lut >> (b >> 4)) & 1;
+      bool lo = (lut >> (b & 0x0F)) & 1;
+      // Step over both pixels when entering a byte from its near end
+      if (hi == match && lo == match && (dir > 0 ? !(x & 1) && x < lim : (x & 1) && x > lim))
+      {
+        x += dir * 2;
+        continue;
+      }
+      if (((x & 1) ? lo : hi) != match) break;
+      x += dir;
     }
+    return x;
+  }
 
-    if (((w + x) & 0x01) == 1)
+  if (_bpp == 2)
+  {
+    uint8_t* ptr = _img8 + ((y * _iwidth)>>2);
+    uint8_t  lut = f->lut[0];
+    // Byte values where all 4 pixels match (or do not) can be stepped over
+    uint8_t  skip = match ? lut : (~lut & 0x0F);
+    while (dir > 0 ? x <= lim : x >= lim)
     {
-      // handle the extra one at the other end
-      drawPixel(x - _xDatum + w - 1, y - _yDatum, color);
-      w--;
-      if (w < 1) return;
+      if (dir > 0 ? !(x & 3) && x + 3 <= lim : (x & 3) == 3 && x - 3 >= lim)
+      {
+        uint8_t b = ptr[x>>2];
+        if (((skip >> (b >> 6)) & (skip >> ((b >> 4) & 3)) & (skip >> ((b >> 2) & 3)) & (skip >> (b & 3))) & 1)
+        {
+          x += dir * 4;
+          continue;
+        }
+      }
+      if (((lut >> ((ptr[x>>2] >> (6 - ((x & 3) << 1))) & 0x03)) & 1) != match) break;
+      x += dir;
     }
-    memset(_img4 + ((_iwidth * y + x) >> 1), c2, (w >> 1));
+    return x;
   }
-  else {
-    x -= _xDatum; // Remove any offset as it will be added by drawPixel
-    y -= _yDatum;
 
-    while (w--)
+  if (_bpp == 1)
+  {
+    uint8_t* ptr  = _img8 + y * (_bitwidth>>3);
+    uint8_t  bit  = match ? f->target : !f->target; // Bit value to step over
+    uint8_t  skip = bit ? 0xFF : 0x00;
+    while (dir > 0 ? x <= lim : x >= lim)
     {
-      drawPixel(x++, y, color);
+      if (dir > 0 ? !(x & 7) && x + 7 <= lim : (x & 7) == 7 && x - 7 >= lim)
+      {
+        if (ptr[x>>3] == skip) { x += dir * 8; continue; }
+      }
+      if (((ptr[x>>3] >> (7 - (x & 0x7))) & 0x01) != bit) break;
+      x += dir;
     }
+    return x;
   }
+
+  // 16 bpp with tolerance
+  while ((dir > 0 ? x <= lim : x >= lim) && (floodMatch(f, x, y) == match)) x += dir;
+  return x;
 }
 
 
 /***************************************************************************************
-** Function name:           fillRect
-** Description:             draw a filled rectangle
+** Function name:           fillRun
+** Description:             write a pixel value to pixels xl to xr inclusive on row y
 ***************************************************************************************/
-void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+// The value is in the Sprite pixel format and the coordinates are Sprite memory coordinates
+void TFT_eSprite::fillRun(int32_t xl, int32_t xr, int32_t y, uint32_t value)
 {
-  if (!_created || _vpOoB) return;
-
-  x+= _xDatum;
-  y+= _yDatum;
-
-  // Clipping
-  if ((x >= _vpW) || (y >= _vpH)) return;
-
-  if (x < _vpX) { w += x - _vpX; x = _vpX; }
-  if (y < _vpY) { h += y - _vpY; y = _vpY; }
-
-  if ((x + w) > _vpW) w = _vpW - x;
-  if ((y + h) > _vpH) h = _vpH - y;
-
-  if ((w < 1) || (h < 1)) return;
-
-  int32_t yp = _iwidth * y + x;
+  if (xr < xl) return;
 
   if (_bpp == 16)
   {
-    color = (color >> 8) | (color << 8);
-    uint32_t iw = w;
-    int32_t ys = yp;
-    if(h--)  {while (iw--) _img[yp++] = (uint16_t) color;}
-    yp = ys;
-    while (h--)
-    {
-      yp += _iwidth;
-      memcpy( _img+yp, _img+ys, w<<1);
-    }
+    uint16_t* ptr = _img + xl + y * _iwidth;
+    for (int32_t x = xl; x <= xr; x++) *ptr++ = (uint16_t)value;
   }
   else if (_bpp == 8)
   {
-    color = (color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3;
-    while (h--)
-    {
-      memset(_img8 + yp, (uint8_t)color, w);
-      yp += _iwidth;
-    }
+    memset(_img8 + xl + y * _iwidth, (uint8_t)value, xr - xl + 1);
   }
   else if (_bpp == 4)
   {
-    uint8_t c1 = (uint8_t)color & 0x0F;
-    uint8_t c2 = c1 | ((c1 << 4) & 0xF0);
-    if ((x & 0x01) == 0 && (w & 0x01) == 0)
-    {
-      yp = (yp >> 1);
-      while (h--)
-      {
-        memset(_img4 + yp, c2, (w>>1));
-        yp += (_iwidth >> 1);
-      }
-    }
-    else if ((x & 0x01) == 0)
-    {
-
-      // same as above but you have a hangover on the right.
-      yp = (yp >> 1);
-      while (h--)
-      {
-        if (w > 1)
-          memset(_img4 + yp, c2, (w-1)>>1);
-        // handle the rightmost pixel by calling drawPixel
-        drawPixel(x+w-1-_xDatum, y+h-_yDatum, c1);
-        yp += (_iwidth >> 1);
-      }
-    }
-    else if ((w & 0x01) == 1)
-    {
-      yp = (yp + 1) >> 1;
-      while (h--) {
-        drawPixel(x-_xDatum, y+h-_yDatum, color & 0x0F);
-        if (w > 1)
-          memset(_img4 + yp, c2, (w-1)>>1);
-        // same as above but you have a hangover on the left instead
-        yp += (_iwidth >> 1);
-      }
-    }
-    else
-    {
-      yp = (yp + 1) >> 1;
-      while (h--) {
-        drawPixel(x-_xDatum, y+h-_yDatum, color & 0x0F);
-        if (w > 1) drawPixel(x+w-1-_xDatum, y+h-_yDatum, color & 0x0F);
-        if (w > 2)
-          memset(_img4 + yp, c2, (w-2)>>1);
-        // maximal hacking, single pixels on left and right.
-        yp += (_iwidth >> 1);
-      }
-    }
+    uint8_t* ptr = _img4 + ((y * _iwidth)>>1);
+    uint8_t  c = (uint8_t)value;
+    if (xl & 1) { ptr[xl>>1] = (ptr[xl>>1] & 0xF0) | c; xl++; }
+    if (!(xr & 1) && xr >= xl) { ptr[xr>>1] = (ptr[xr>>1] & 0x0F) | (c << 4); xr--; }
+    if (xr > xl) memset(ptr + (xl>>1), (c << 4) | c, (xr - xl + 1)>>1);
+  }
+  else if (_bpp == 2)
+  {
+    packedFill(_img8 + ((y * _iwidth)>>2), xl, xr - xl + 1, (uint8_t)value);
   }
   else
   {
-    x -= _xDatum;
-    y -= _yDatum;
-    while (h--)
-    {
-      int32_t ww = w;
-      int32_t xx = x;
-      while (ww--) drawPixel(xx++, y, color);
-      y++;
-    }
+    uint8_t* ptr = _img8 + y * (_bitwidth>>3);
+    int32_t  bl = xl>>3, br = xr>>3;
+    uint8_t  ml = 0xFF >> (xl & 7);
+    uint8_t  mr = 0xFF << (7 - (xr & 7));
+    if (bl == br) ml &= mr;
+    if (value) ptr[bl] |= ml; else ptr[bl] &= ~ml;
+    if (bl == br) return;
+    if (br > bl + 1) memset(ptr + bl + 1, value ? 0xFF : 0x00, br - bl - 1);
+    if (value) ptr[br] |= mr; else ptr[br] &= ~mr;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           fillValue
+** Description:             write a pixel value to a rectangle clipped to the viewport
+***************************************************************************************/
+// x,y include the datum and are Sprite memory coordinates, so not for rotated 1 bpp Sprites
+void TFT_eSprite::fillValue(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t value)
+{
+  int32_t x1 = x + w, y1 = y + h;
+  if (x < _vpX) x = _vpX;
+  if (y < _vpY) y = _vpY;
+  if (x1 > _vpW) x1 = _vpW;
+  if (y1 > _vpH) y1 = _vpH;
+  if (x >= x1 || y >= y1) return;
+
+  fillRun(x, x1 - 1, y, value);
+
+  // 16 bpp rows are copied, other depths are filled with memset()
+  for (int32_t yp = y + 1; yp < y1; yp++) {
+    if (_bpp == 16) memcpy(_img + x + yp * _iwidth, _img + x + y * _iwidth, (x1 - x) << 1);
+    else fillRun(x, x1 - 1, yp, value);
   }
 }
 
 
+/***************************************************************************************
+** Function name:           pixelValue
+** Description:             Convert a 565 colour to a pixel value in the Sprite format
+***************************************************************************************/
+uint32_t TFT_eSprite::pixelValue(uint32_t color)
+{
+  if (_bpp == 16) return (uint16_t)((color >> 8) | (color << 8));
+  if (_bpp == 8)  return pixel8(color);
+  if (_bpp == 4)  return color & 0x0F;
+  if (_bpp == 2)  return color & 0x03;
+  return color ? 1 : 0;
+}
+
+
 /***************************************************************************************
 ** Function name:           drawChar
 ** Description:             draw a single character in the Adafruit GLCD or freefont
@@ -2077,46 +4094,13 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
       int8_t   xo = pgm_read_byte(&glyph->xOffset),
                yo = pgm_read_byte(&glyph->yOffset);
 
-      if (((x + xo + w * size - 1) < (_vpX - _xDatum)) || // Clip left
-          ((y + yo + h * size - 1) < (_vpY - _yDatum)))   // Clip top
+      if (((x + (xo + w) * size - 1) < (_vpX - _xDatum)) || // Clip left
+          ((y + (yo + h) * size - 1) < (_vpY - _yDatum)))   // Clip top
         return;
 
       uint8_t  *bitmap = (uint8_t *)pgm_read_dword(&gfxFont->bitmap);
-      uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
 
-      uint8_t  xx, yy, bits=0, bit=0;
-      //uint8_t  xa = pgm_read_byte(&glyph->xAdvance);
-      int16_t  xo16 = 0, yo16 = 0;
-
-      if(size > 1) {
-        xo16 = xo;
-        yo16 = yo;
-      }
-
-      uint16_t hpc = 0; // Horizontal foreground pixel count
-      for(yy=0; yy<h; yy++) {
-        for(xx=0; xx<w; xx++) {
-          if(bit == 0) {
-            bits = pgm_read_byte(&bitmap[bo++]);
-            bit  = 0x80;
-          }
-          if(bits & bit) hpc++;
-          else {
-            if (hpc) {
-              if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-              else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
-              hpc=0;
-            }
-          }
-          bit >>= 1;
-        }
-        // Draw pixels for this line as we are about to increment yy
-        if (hpc) {
-          if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-          else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
-          hpc=0;
-        }
-      }
+      drawGfxGlyph(x, y, glyph, bitmap, color, size);
     }
 #endif
 
@@ -2136,6 +4120,48 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
 }
 
 
+#ifdef LOAD_GFXFF
+/***************************************************************************************
+** Function name:           drawGfxGlyph
+** Description:             draw a GFX font glyph as runs of pixels in Sprite memory
+***************************************************************************************/
+// The colour is converted once and each run is written straight into the Sprite, with
+// identical rows filled together. Rotated 1 bpp Sprites are drawn with fillRect()
+void TFT_eSprite::drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap,
+                               uint32_t color, uint8_t size)
+{
+  if (_bpp == 1 && rotation) { TFT_eSPI::drawGfxGlyph(x, y, glyph, bitmap, color, size); return; }
+
+  uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t  w  = pgm_read_byte(&glyph->width),
+           h  = pgm_read_byte(&glyph->height);
+  int8_t   xo = pgm_read_byte(&glyph->xOffset),
+           yo = pgm_read_byte(&glyph->yOffset);
+
+  uint32_t value = pixelValue(color);
+
+  // Glyph top left in Sprite coordinates
+  x += _xDatum + xo * size;
+  y += _yDatum + yo * size;
+
+  uint8_t  row[32];
+  uint32_t bit = bo * 8;
+
+  for (int32_t yy = 0; yy < h; ) {
+    int32_t n = gfxGlyphRows(bitmap, bit, w, h - yy, row);
+    for (int32_t xx = 0; xx < w; ) {
+      bool set;
+      int32_t run = bitmapRun(row, xx, w, false, &set);
+      if (set) fillValue(x + xx * size, y + yy * size, run * size, n * size, value);
+      xx += run;
+    }
+    yy  += n;
+    bit += n * w;
+  }
+}
+#endif
+
+
 /***************************************************************************************
 ** Function name:           drawChar
 ** Description:             draw a Unicode glyph into the sprite
@@ -2220,47 +4246,41 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
   if ((xd + width * textsize < _vpX || xd >= _vpW) && (yd + height * textsize < _vpY || yd >= _vpH)) return width * textsize ;
 
   int32_t w = width;
-  int32_t pX      = 0;
   int32_t pY      = y;
   uint8_t line = 0;
-  bool clip = xd < _vpX || xd + width  * textsize >= _vpW || yd < _vpY || yd + height * textsize >= _vpH;
+
+  // Runs of pixels are written straight into Sprite memory, background runs only if the
+  // text is opaque. Rotated 1 bpp Sprites are drawn with fillRect()
+  bool     opaque = (textcolor != textbgcolor);
+  bool     direct = !(_bpp == 1 && rotation);
+  uint32_t fg = pixelValue(textcolor);
+  uint32_t bg = pixelValue(textbgcolor);
 
 #ifdef LOAD_FONT2 // chop out code if we do not need it
   if (font == 2) {
     w = w + 6; // Should be + 7 but we need to compensate for width increment
     w = w / 8;
 
+    // Each row is drawn as runs of set and clear bits. The width includes a blank column
+    // that may be past the last byte of the row
+    int32_t end = (width > w * 8) ? width : w * 8;
+
     for (int32_t i = 0; i < height; i++)
     {
-      if (textcolor != textbgcolor) fillRect(x, pY, width * textsize, textsize, textbgcolor);
-
-      for (int32_t k = 0; k < w; k++)
-      {
-        line = pgm_read_byte((uint8_t *)flash_address + w * i + k);
-        if (line) {
-          if (textsize == 1) {
-            pX = x + k * 8;
-            if (line & 0x80) drawPixel(pX, pY, textcolor);
-            if (line & 0x40) drawPixel(pX + 1, pY, textcolor);
-            if (line & 0x20) drawPixel(pX + 2, pY, textcolor);
-            if (line & 0x10) drawPixel(pX + 3, pY, textcolor);
-            if (line & 0x08) drawPixel(pX + 4, pY, textcolor);
-            if (line & 0x04) drawPixel(pX + 5, pY, textcolor);
-            if (line & 0x02) drawPixel(pX + 6, pY, textcolor);
-            if (line & 0x01) drawPixel(pX + 7, pY, textcolor);
-          }
-          else {
-            pX = x + k * 8 * textsize;
-            if (line & 0x80) fillRect(pX, pY, textsize, textsize, textcolor);
-            if (line & 0x40) fillRect(pX + textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x20) fillRect(pX + 2 * textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x10) fillRect(pX + 3 * textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x08) fillRect(pX + 4 * textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x04) fillRect(pX + 5 * textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x02) fillRect(pX + 6 * textsize, pY, textsize, textsize, textcolor);
-            if (line & 0x01) fillRect(pX + 7 * textsize, pY, textsize, textsize, textcolor);
-          }
+      const uint8_t* row = (const uint8_t*)flash_address + w * i;
+      uint8_t bits[8] = { 0 };
+      for (int32_t k = 0; k < w && k < 8; k++) bits[k] = pgm_read_byte(row + k);
+
+      for (int32_t px = 0; px < end; ) {
+        bool set;
+        int32_t run = bitmapRun(bits, px, end, false, &set);
+        // Set bits are drawn to the end of the byte, the background only to the character width
+        int32_t n = (set || px + run <= width) ? run : width - px;
+        if ((set || opaque) && n > 0) {
+          if (direct) fillValue(xd + px * textsize, yd + i * textsize, n * textsize, textsize, set ? fg : bg);
+          else fillRect(x + px * textsize, pY, n * textsize, textsize, set ? textcolor : textbgcolor);
         }
+        px += run;
       }
       pY += textsize;
     }
@@ -2271,121 +4291,31 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
   #endif
 #endif  //FONT2
 
-#ifdef LOAD_RLE  //674 bytes of code
+#ifdef LOAD_RLE
   // Font is not 2 and hence is RLE encoded
   {
     w *= height; // Now w is total number of pixels in the character
-    int16_t color = textcolor;
-    if (_bpp == 16) color = (textcolor >> 8) | (textcolor << 8);
-    else if (_bpp == 8) color = ((textcolor & 0xE000)>>8 | (textcolor & 0x0700)>>6 | (textcolor & 0x0018)>>3);
-
-    int16_t bgcolor = textbgcolor;
-    if (_bpp == 16) bgcolor = (textbgcolor >> 8) | (textbgcolor << 8);
-    else if (_bpp == 8) bgcolor = ((textbgcolor & 0xE000)>>8 | (textbgcolor & 0x0700)>>6 | (textbgcolor & 0x0018)>>3);
-
-    if (textcolor == textbgcolor && !clip && _bpp != 1) {
-      int32_t px = 0, py = pY; // To hold character block start and end column and row values
-      int32_t pc = 0; // Pixel count
-      uint8_t np = textsize * textsize; // Number of pixels in a drawn pixel
-
-      uint8_t tnp = 0; // Temporary copy of np for while loop
-      uint8_t ts = textsize - 1; // Temporary copy of textsize
-      // 16-bit pixel count so maximum font size is equivalent to 180x180 pixels in area
-      // w is total number of pixels to plot to fill character block
-      while (pc < w) {
-        line = pgm_read_byte((uint8_t *)flash_address);
-        flash_address++;
-        if (line & 0x80) {
-          line &= 0x7F;
-          line++;
-          if (ts) {
-            px = xd + textsize * (pc % width); // Keep these px and py calculations outside the loop as they are slow
-            py = yd + textsize * (pc / width);
-          }
-          else {
-            px = xd + pc % width; // Keep these px and py calculations outside the loop as they are slow
-            py = yd + pc / width;
-          }
-          while (line--) { // In this case the while(line--) is faster
-            pc++; // This is faster than putting pc+=line before while()?
-            setWindow(px, py, px + ts, py + ts);
-
-            if (ts) {
-              tnp = np;
-              while (tnp--) writeColor(color);
-            }
-            else writeColor(color);
-
-            px += textsize;
-
-            if (px >= (xd + width * textsize)) {
-              px = xd;
-              py += textsize;
-            }
-          }
-        }
-        else {
-          line++;
-          pc += line;
-        }
-      }
-    }
-    else {
-      // Text colour != background and textsize = 1 and character is within viewport area
-      // so use faster drawing of characters and background using block write
-      if (textcolor != textbgcolor && textsize == 1 && !clip && _bpp != 1)
-      {
-        setWindow(xd, yd, xd + width - 1, yd + height - 1);
-
-        // Maximum font size is equivalent to 180x180 pixels in area
-        while (w > 0) {
-          line = pgm_read_byte((uint8_t *)flash_address++); // 8 bytes smaller when incrementing here
-          if (line & 0x80) {
-            line &= 0x7F;
-            line++; w -= line;
-            while (line--) writeColor(color);
-          }
-          else {
-            line++; w -= line;
-            while (line--) writeColor(bgcolor);
-          }
-        }
-      }
-      else
-      {
-        int32_t px = 0, py = 0;  // To hold character pixel coords
-        int32_t tx = 0, ty = 0;  // To hold character TFT pixel coords
-        int32_t pc = 0;          // Pixel count
-        int32_t pl = 0;          // Pixel line length
-        uint16_t pcol = 0;       // Pixel color
-        bool     pf = true;      // Flag for plotting
-        while (pc < w) {
-          line = pgm_read_byte((uint8_t *)flash_address);
-          flash_address++;
-          if (line & 0x80) { pcol = textcolor; line &= 0x7F; pf = true;}
-          else { pcol = textbgcolor; if (textcolor == textbgcolor) pf = false;}
-          line++;
-          px = pc % width;
-          tx = x + textsize * px;
-          py = pc / width;
-          ty = y + textsize * py;
-
-          pl = 0;
-          pc += line;
-          while (line--) {
-            pl++;
-            if ((px+pl) >= width) {
-              if (pf) fillRect(tx, ty, pl * textsize, textsize, pcol);
-              pl = 0;
-              px = 0;
-              tx = x;
-              py ++;
-              ty += textsize;
-            }
-          }
-          if (pl && pf) fillRect(tx, ty, pl * textsize, textsize, pcol);
+    int32_t pc = 0; // Pixel count
+
+    while (pc < w) {
+      line = pgm_read_byte((uint8_t *)flash_address++);
+      bool    set = line & 0x80;
+      int32_t n   = (line & 0x7F) + 1;
+
+      if (set || opaque) {
+        // A run can continue onto the next rows of the character
+        int32_t px = pc % width, py = pc / width;
+        for (int32_t left = n; left > 0; ) {
+          int32_t len = width - px;
+          if (len > left) len = left;
+          if (direct) fillValue(xd + px * textsize, yd + py * textsize, len * textsize, textsize, set ? fg : bg);
+          else fillRect(x + px * textsize, y + py * textsize, len * textsize, textsize, set ? textcolor : textbgcolor);
+          left -= len;
+          px = 0;
+          py++;
         }
       }
+      pc += n;
     }
   }
   // End of RLE font rendering
@@ -2395,10 +4325,12 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
   // Stop warnings
   flash_address = flash_address;
   w = w;
-  pX = pX;
   pY = pY;
   line = line;
-  clip = clip;
+  opaque = opaque;
+  direct = direct;
+  fg = fg;
+  bg = bg;
 #endif
 
   return width * textsize;    // x +
@@ -2476,14 +4408,27 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     }
 
     uint8_t* pbuffer = nullptr;
-    const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
+    const uint8_t* gPtr = nullptr;
 
 #ifdef FONT_FS_AVAILABLE
     if (fs_font) {
-      fontFile.seek(gBitmap[gNum], fs::SeekSet); // This is slow for a significant position shift!
-      pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
+      // Whole bitmap from the glyph cache, otherwise read row by row
+      gPtr = cachedGlyph(gNum);
+      if (!gPtr) {
+        fontFile.seek(gBitmap[gNum], fs::SeekSet); // This is slow for a significant position shift!
+        if (gAlphaBits < 8) {
+          // Run length coded rows vary in length so read the whole bitmap
+          uint32_t bytes = glyphBytes(gNum);
+          pbuffer = (uint8_t*)malloc(bytes);
+          if (pbuffer) fontFile.read(pbuffer, bytes);
+          gPtr = pbuffer;
+        }
+        else pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
+      }
     }
+    else
 #endif
+    gPtr = (const uint8_t*) gFont.gArray + gBitmap[gNum];
 
     int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
     int16_t cx = cursor_x + gdX[gNum];
@@ -2525,21 +4470,20 @@ void TFT_eSprite::drawGlyph(uint16_t code)
       }
     }
 
+    if (gAlphaBits < 8) drawGlyphRuns(gPtr, gNum, cx, cy, bx, fg, bg, getBG, false);
+    else
     for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (pbuffer) {
         fontFile.read(pbuffer, gWidth[gNum]);
       }
 #endif
 
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
-#ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
-        else
-#endif
-        pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
+        if (pbuffer) pixel = pbuffer[x];
+        else pixel = pgm_read_byte(gPtr + x + gWidth[gNum] * y);
 
         if (pixel)
         {
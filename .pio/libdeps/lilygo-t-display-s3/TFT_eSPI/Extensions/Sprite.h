@@ -5,7 +5,7 @@
 // graphics are written to the Sprite rather than the TFT.
 ***************************************************************************************/
 
-class TFT_eSprite : public TFT_eSPI {
+class TFT_eSprite : public TFT_eSPI { friend class TFT_eSaveUnder; friend class TFT_eAlphaSprite; // Save-under class copies Sprite memory, alpha Sprites use allocSprite()
 
  public:
 
@@ -16,8 +16,9 @@ class TFT_eSprite : public TFT_eSPI {
            // Sketch can cast returned value to (uint16_t*) for 16-bit depth if needed
            // RAM required is:
            //  - 1 bit per pixel for 1 bit colour depth
+           //  - 2 bits per pixel for 2-bit colour (with 4 colour palette table)
            //  - 1 nibble per pixel for 4-bit colour (with palette table)
-           //  - 1 byte per pixel for 8-bit colour (332 RGB format)
+           //  - 1 byte per pixel for 8-bit colour (332 RGB format, or palette index with a palette)
            //  - 2 bytes per pixel for 16-bit color depth (565 RGB format)
   void*    createSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
@@ -30,18 +31,38 @@ class TFT_eSprite : public TFT_eSPI {
            // Delete the sprite to free up the RAM
   void     deleteSprite(void);
 
+           // Compress a single frame 16 or 8 bpp Sprite into runs of pixels (per row) and free the
+           // Sprite memory. A frozen Sprite can only be pushed to the TFT with pushSprite(x, y) or
+           // pushSprite(x, y, transparent), the runs are sent to the TFT without decompression.
+           // The frozen copy is taken from allocator, or the heap/PSRAM if nullptr, never from the
+           // Sprite allocator, so the Sprite memory goes back to a pool or arena while frozen
+  bool     freeze(TFT_eSpriteAllocator *allocator = nullptr);
+           // Decompress a frozen Sprite back into Sprite memory so it can be drawn in again
+  bool     thaw(void);
+           // Returns true if the Sprite is frozen
+  bool     frozen(void);
+           // Returns the Sprite memory size divided by the frozen size, 0 if not frozen
+  float    compressionRatio(void);
+
+           // Take Sprite memory from an arena or pool instead of the heap, nullptr restores the heap.
+           // Must be set before createSprite(), returns false if the Sprite has already been created
+  bool     setAllocator(TFT_eSpriteAllocator *allocator);
+  TFT_eSpriteAllocator* getAllocator(void);
+
            // Select the frame buffer for graphics write (for 2 colour ePaper and DMA toggle buffer)
            // Returns a pointer to the Sprite frame buffer
   void*    frameBuffer(int8_t f);
   
-           // Set or get the colour depth to 1, 4, 8 or 16 bits. Can be used to change depth an existing
+           // Set or get the colour depth to 1, 2, 4, 8 or 16 bits. Can be used to change depth an existing
            // sprite, but clears it to black, returns a new pointer if sprite is re-created.
   void*    setColorDepth(int8_t b);
   int8_t   getColorDepth(void);
 
-           // Set the palette for a 4-bit depth sprite.  Only the first 16 colours in the map are used.
-  void     createPalette(uint16_t *palette = nullptr, uint8_t colors = 16);       // Palette in RAM
-  void     createPalette(const uint16_t *palette = nullptr, uint8_t colors = 16); // Palette in FLASH
+           // Set the palette for a 4 or 2-bit depth sprite.  Only the first 16 (or 4) colours in the map are used.
+           // An 8-bit sprite with a palette of up to 256 colours holds palette indexes instead of RGB332,
+           // drawing colours map to the nearest palette colour. A nullptr palette gives the RGB332 colours
+  void     createPalette(uint16_t *palette = nullptr, uint16_t colors = 16);       // Palette in RAM
+  void     createPalette(const uint16_t *palette = nullptr, uint16_t colors = 16); // Palette in FLASH
 
            // Set a single palette index to the given color
   void     setPaletteColor(uint8_t index, uint16_t color);
@@ -55,6 +76,10 @@ class TFT_eSprite : public TFT_eSPI {
            // Draw a single pixel at x,y
   void     drawPixel(int32_t x, int32_t y, uint32_t color);
 
+           // Plot n points held as x,y coordinate pairs in xy[], written directly to the Sprite buffer
+  void     drawPixels(const int16_t* xy, const uint16_t* colors, size_t n),
+           drawPixels(const int16_t* xy, size_t n, uint32_t color);
+
            // Draw a single character in the GLCD or GFXFF font
   void     drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size),
 
@@ -87,6 +112,15 @@ class TFT_eSprite : public TFT_eSPI {
            // Fill a rectangular area with a color (aka draw a filled rectangle)
            fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
 
+           // Flood fill the area connected to x,y that has the same colour as the pixel at x,y
+           // floodFillTolerance also fills neighbours within tolerance (max difference per
+           // 8-bit colour channel) of the seed colour, pixels already in the fill colour are borders
+           // scratch is optional working memory for the span stack (8 bytes per span), if not
+           // provided a small stack is used. Returns false if the span stack overflowed
+  bool     floodFill(int32_t x, int32_t y, uint32_t color, void* scratch = nullptr, size_t bytes = 0),
+           floodFillTolerance(int32_t x, int32_t y, uint32_t color, uint8_t tolerance,
+                              void* scratch = nullptr, size_t bytes = 0);
+
            // Set the coordinate rotation of the Sprite (for 1bpp Sprites only)
            // Note: this uses coordinate rotation and is primarily for ePaper which does not support
            // CGRAM rotation (like TFT drivers do) within the displays internal hardware
@@ -96,8 +130,19 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a rotated copy of Sprite to TFT with optional transparent colour
   bool     pushRotated(int16_t angle, uint32_t transp = 0x00FFFFFF);
            // Push a rotated copy of Sprite to another different Sprite with optional transparent colour
+           // The destination must be 16 or 8 bpp, or the same 4 or 2 bpp depth (palette indexes copied)
   bool     pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp = 0x00FFFFFF);
 
+           // Push a copy of the Sprite transformed by the affine matrix m to the TFT or another Sprite
+           // m maps Sprite x,y to destination x' = m[0]*x + m[1]*y + m[2], y' = m[3]*x + m[4]*y + m[5]
+           // so can rotate, scale and shear. filter is SAMPLE_NEAREST or SAMPLE_BILINEAR
+  bool     pushTransformed(const float m[6], uint8_t filter = SAMPLE_NEAREST, uint32_t transp = 0x00FFFFFF);
+  bool     pushTransformed(TFT_eSprite *spr, const float m[6], uint8_t filter = SAMPLE_NEAREST,
+                           uint32_t transp = 0x00FFFFFF);
+           // Set m to scale the Sprite by sx,sy and rotate by angle (degrees) about the Sprite
+           // pivot, then move the pivot to x,y
+  void     getTransform(float m[6], float angle, float sx, float sy, float x, float y);
+
            // Get the TFT bounding box for a rotated copy of this Sprite
   bool     getRotatedBounds(int16_t angle, int16_t *min_x, int16_t *min_y, int16_t *max_x, int16_t *max_y);
            // Get the destination Sprite bounding box for a rotated copy of this Sprite
@@ -111,13 +156,19 @@ class TFT_eSprite : public TFT_eSPI {
   uint16_t readPixel(int32_t x0, int32_t y0);
 
            // return the numerical value of the pixel at x,y (used when scrolling)
-           // 16bpp = colour, 8bpp = byte, 4bpp = colour index, 1bpp = 1 or 0
+           // 16bpp = colour, 8bpp = byte, 4bpp and 2bpp = colour index, 1bpp = 1 or 0
   uint16_t readPixelValue(int32_t x, int32_t y);
 
            // Write an image (colour bitmap) to the sprite.
   void     pushImage(int32_t x0, int32_t y0, int32_t w, int32_t h, uint16_t *data, uint8_t sbpp = 0);
   void     pushImage(int32_t x0, int32_t y0, int32_t w, int32_t h, const uint16_t *data);
 
+           // Write a coverage (alpha) image in colour fg blended with bg, or the Sprite pixels if bg is
+           // 0x00FFFFFF. 16 and 8 bpp Sprites are written directly, 4 and 2 bpp pixels take the nearest palette
+           // colour and 1 bpp pixels with coverage of 50% or more are set to fg (otherwise bg)
+  void     pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *alpha, uint8_t bits,
+                          uint16_t fg, uint32_t bg = 0x00FFFFFF);
+
            // Push the sprite to the TFT screen, this fn calls pushImage() in the TFT class.
            // Optionally a "transparent" colour can be defined, pixels of that colour will not be rendered
   void     pushSprite(int32_t x, int32_t y);
@@ -126,7 +177,8 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a windowed area of the sprite to the TFT at tx, ty
   bool     pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
 
-           // Push the sprite to another sprite at x,y. This fn calls pushImage() in the destination sprite (dspr) class.
+           // Push the sprite to another sprite at x,y. Any combination of 1, 2, 4, 8 and 16 bpp Sprites
+           // is supported, see Sprite.cpp for how colours are converted between depths
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y);
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transparent);
 
@@ -141,6 +193,9 @@ class TFT_eSprite : public TFT_eSPI {
            // Functions associated with anti-aliased fonts
            // Draw a single Unicode character using the loaded font
   void     drawGlyph(uint16_t code);
+           // Overrides TFT_eSPI::drawTextLine() so opaque text is drawn glyph by glyph in a
+           // Sprite: composing scanlines only saves bus traffic, which a Sprite does not have
+  bool     drawTextLine(const char * /*string*/, uint16_t /*len*/, uint8_t /*padding*/, int32_t /*cwidth*/) { return false; }
            // Print string to sprite using loaded font at cursor position
   void     printToSprite(String string);
            // Print char array to sprite using loaded font at cursor position
@@ -154,21 +209,123 @@ class TFT_eSprite : public TFT_eSPI {
 
            // Reserve memory for the Sprite and return a pointer
   void*    callocSprite(int16_t width, int16_t height, uint8_t frames = 1);
+           // Get zeroed memory from allocator (heap, or PSRAM if psram and fitted, if nullptr) and return it,
+           // for Sprite, frozen and alpha Sprite data
+  static void* allocSprite(size_t bytes, TFT_eSpriteAllocator *allocator, bool psram);
+  static void  freeSprite(void* ptr, TFT_eSpriteAllocator *allocator);
+
+           // Write a batch of points to the Sprite, colors may be nullptr to plot all in color
+  void     drawPixelBatch(const int16_t* xy, const uint16_t* colors, uint32_t color, size_t n);
+
+           // Encode row y of the Sprite to out (count only if nullptr), returns bytes needed
+  uint32_t freezeRow(int32_t y, uint8_t *out);
+           // Push the frozen Sprite to the TFT at x,y, skipping transp pixels if useTransp
+  void     pushFrozen(int32_t x, int32_t y, bool useTransp, uint16_t transp);
+
+           // Push the w x h area at sx,sy of a 2 bpp Sprite to the TFT at x,y, skipping transp indexes if useTransp
+  void     pushPacked(int32_t x, int32_t y, int32_t sx, int32_t sy, int32_t w, int32_t h, bool useTransp, uint8_t transp);
+           // 2 bpp row kernels: set n pixels from x to index c, copy n pixels (areas must not overlap)
+  void     packedFill(uint8_t *row, int32_t x, int32_t n, uint8_t c);
+  void     packedCopy(uint8_t *dst, int32_t dx, const uint8_t *src, int32_t sx, int32_t n);
 
            // Override the non-inlined TFT_eSPI functions
   void     begin_nin_write(void) { ; }
   void     end_nin_write(void) { ; }
 
+           // Write gradient lines directly to the Sprite buffer, mapped to the palette or bitmap colours below 8 bpp
+  void     fillGradient(gradient_t* g, int32_t x, int32_t y, int32_t w, int32_t h);
+
+           // Render transformed Sprite rows clipped to x0,y0 to x1,y1 (inclusive) to spr, or TFT if nullptr
+  void     transformRows(TFT_eSprite *spr, const float m[6], int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                         uint8_t filter, uint32_t transp);
+           // Narrow xl to xr to the x values where 0 <= p + dp * x < lim, false if none
+  static bool transformSpan(float p, float dp, float lim, float *xl, float *xr);
+           // Fill lut with the byte swapped 565 colour of each 1, 2, 4 or 8 bpp pixel value
+  void     sampleTable(uint16_t *lut);
+           // Read the 565 colour of the pixel at x,y in Sprite memory, or rotated 1 bpp coordinates
+  uint16_t readTexel(int32_t x, int32_t y, const uint16_t *lut);
+           // Map rotated 1 bpp Sprite coordinates to Sprite memory coordinates
+  void     rotatedXY(int32_t *x, int32_t *y);
+           // Sample n pixels stepping Q16 source coordinates xs,ys by dx,dy, output is byte swapped 565
+  void     sampleLine(uint16_t *buf, const uint16_t *lut, int32_t xs, int32_t ys, int32_t dx, int32_t dy, int32_t n);
+           // Push a sampled line to spr, or the TFT if nullptr, skipping tpcolor pixels if useTransp
+  void     pushSampled(TFT_eSprite *spr, int32_t x, int32_t y, uint16_t *buf, int32_t n, bool useTransp, uint16_t tpcolor);
+
+           // Copy this Sprite to dspr at x,y converting between any colour depths
+  bool     spriteToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, bool useTransp, uint16_t transp);
+           // Read or write n raw pixel values in Sprite memory (see spriteToSprite)
+  void     readValues(uint16_t *buf, int32_t x, int32_t y, int32_t n);
+  void     writeValues(const uint16_t *val, int32_t x, int32_t y, int32_t n, const uint16_t *src, uint16_t tv);
+           // Return the 8, 4 or 2 bpp palette index of the nearest colour, or the 1 bpp bit
+  uint8_t  nearestIndex(uint16_t color);
+           // Convert a 565 colour to an 8 bpp pixel value (RGB332 or cached palette index) and back
+  uint8_t  pixel8(uint16_t color);
+  uint16_t color8(uint8_t value);
+           // Allocate the color map if needed, returns the number of palette entries
+  uint16_t allocPalette(void);
+
+           // Write an atlas area directly to the Sprite buffer (via drawPixel for 4, 2 and 1 bpp)
+  void     pushAtlasRect(int32_t x, int32_t y, const imageAtlas_t *atlas, int32_t sx, int32_t sy,
+                         int32_t w, int32_t h, bool useTransp, uint16_t transp);
+
+           // Write 1bpp bitmap runs directly to the Sprite buffer (via drawFastHLine for 4, 2 and 1 bpp)
+  void     drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h,
+                          uint16_t fgcolor, uint16_t bgcolor, bool xbm, bool opaque);
+
+#ifdef LOAD_GFXFF
+           // Write GFX font glyph runs directly to the Sprite buffer (via fillRect for rotated 1 bpp)
+  void     drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap,
+                        uint32_t color, uint8_t size);
+#endif
+
+  typedef struct {
+    int16_t  y, xl, xr;        // Span already filled on row y
+    int16_t  dy;               // Direction (+/-1) of the row to search next
+  } fillSpan_t;
+
+  typedef struct {
+    uint32_t fill;             // Fill colour in Sprite pixel format
+    uint16_t target;           // Seed pixel value in Sprite pixel format
+    uint8_t  tol;              // Colour tolerance, 0 = exact match
+    uint8_t  tr, tg, tb;       // Seed colour channels (16 bpp tolerance test)
+    uint8_t  lut[32];          // Bit set of matching pixel values (8, 4 and 2 bpp)
+    int32_t  x0, y0, x1, y1;   // Fill bounds in Sprite memory coordinates, x1,y1 exclusive
+    fillSpan_t* stack;         // Span stack
+    int32_t  sp, size;         // Stack pointer and capacity in spans
+    bool     ok;               // false if a span was lost because the stack was full
+  } floodFill_t;
+
+           // Flood fill helpers, coordinates are Sprite memory coordinates
+  bool     floodFillRegion(int32_t x, int32_t y, uint32_t color, uint8_t tolerance, void* scratch, size_t bytes);
+  bool     floodMatch(floodFill_t* f, int32_t x, int32_t y);
+  int32_t  floodScan(floodFill_t* f, int32_t x, int32_t y, int32_t lim, int32_t dir, bool match);
+  void     floodPush(floodFill_t* f, int32_t y, int32_t xl, int32_t xr, int32_t dy);
+
+           // Write a pixel value in the Sprite format to pixels xl to xr of row y in Sprite memory
+  void     fillRun(int32_t xl, int32_t xr, int32_t y, uint32_t value);
+           // Write a pixel value to a rectangle in Sprite memory clipped to the viewport
+  void     fillValue(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t value);
+           // Convert a 565 colour to a pixel value in the Sprite format
+  uint32_t pixelValue(uint32_t color);
+
  protected:
 
-  uint8_t  _bpp;     // bits per pixel (1, 4, 8 or 16)
+  uint8_t  _bpp;     // bits per pixel (1, 2, 4, 8 or 16)
   uint16_t *_img;    // pointer to 16-bit sprite
-  uint8_t  *_img8;   // pointer to  1 and 8-bit sprite frame 1 or frame 2
+  uint8_t  *_img8;   // pointer to  1, 2 and 8-bit sprite frame 1 or frame 2
   uint8_t  *_img4;   // pointer to  4-bit sprite (uses color map)
   uint8_t  *_img8_1; // pointer to frame 1
   uint8_t  *_img8_2; // pointer to frame 2
 
-  uint16_t *_colorMap; // color map pointer: 16 entries, used with 4-bit color map.
+  uint16_t *_colorMap; // color map pointer: 16 entries, used with 4-bit and (first 4) 2-bit color map.
+                       // 256 entries and an index cache for an 8-bit sprite with a palette.
+
+  TFT_eSpriteAllocator *_allocator; // Sprite memory allocator, nullptr for heap
+
+  uint8_t  *_frozen;     // Frozen Sprite: row offset table then runs, nullptr if not frozen
+  uint32_t _frozenSize;  // Frozen Sprite size in bytes
+  bool     _frozenVpOoB; // Viewport out of bounds flag to restore on thaw()
+  TFT_eSpriteAllocator *_frozenAllocator; // Allocator of the frozen copy, nullptr for heap
 
   int32_t  _sinra;   // Sine of rotation angle in fixed point
   int32_t  _cosra;   // Cosine of rotation angle in fixed point
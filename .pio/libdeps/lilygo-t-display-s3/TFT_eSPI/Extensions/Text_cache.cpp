@@ -0,0 +1,409 @@
+/***************************************************************************************
+** Code for the text cache class
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           TFT_eTextCache
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eTextCache::TFT_eTextCache(TFT_eSPI *tft)
+{
+  _tft       = tft;
+  _head      = nullptr;
+  _tail      = nullptr;
+  _pending   = nullptr;
+  _string    = nullptr;
+  _x = _y    = 0;
+  _hash      = 0;
+  _bytes     = 0;
+  _used      = 0;
+  _entries   = 0;
+  _count     = 0;
+  _policy    = TEXT_CACHE_LRU;
+  _psram     = false;
+  _hits = _misses = _evictions = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eTextCache
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eTextCache::~TFT_eTextCache(void)
+{
+  end();
+}
+
+
+/***************************************************************************************
+** Function name:           begin
+** Description:             Set the cache limits and start using the cache
+***************************************************************************************/
+bool TFT_eTextCache::begin(size_t bytes, uint16_t entries, bool psram)
+{
+  end();
+  if (bytes == 0 || entries == 0) return false;
+
+  _bytes   = bytes;
+  _entries = entries;
+  _psram   = psram;
+  _tft->textCache = this;
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           end
+** Description:             Free all strings and stop using the cache
+***************************************************************************************/
+void TFT_eTextCache::end(void)
+{
+  clear();
+  if (_tft->textCache == this) _tft->textCache = nullptr;
+  _bytes   = 0;
+  _entries = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           clear
+** Description:             Free all strings
+***************************************************************************************/
+void TFT_eTextCache::clear(void)
+{
+  while (_head) {
+    textEntry_t* e = _head;
+    unlink(e);
+    free(e);
+  }
+  _used  = 0;
+  _count = 0;
+  _string = nullptr;
+}
+
+
+/***************************************************************************************
+** Function name:           draw
+** Description:             Push a cached copy of a string, false if it is not cached
+***************************************************************************************/
+bool TFT_eTextCache::draw(const char *string, int32_t x, int32_t y, int16_t *width)
+{
+  TFT_eSPI* tft = _tft;
+  _string = nullptr;
+
+  // Only array and in-place fonts are drawn by drawTextLine()
+  if (tft->gFont.gArray == nullptr || tft->getColor) return false;
+#ifdef FONT_FS_AVAILABLE
+  if (tft->fs_font) return false;
+#endif
+
+  uint16_t len  = strlen(string);
+  uint32_t hash = hashString(string, len);
+
+  textEntry_t* e = _head;
+  for (; e != nullptr; e = e->next)
+  {
+    if (e->hash != hash || e->len != len || e->font != tft->gFont.gArray) continue;
+    if (e->gCount != tft->gFont.gCount || e->yAdvance != tft->gFont.yAdvance) continue;
+    if (e->fg != (uint16_t)tft->textcolor || e->bg != (uint16_t)tft->textbgcolor) continue;
+    if (e->datum != tft->textdatum || e->padX != tft->padX) continue;
+    if (((x + e->tx) == 0) != e->atZero) continue;
+    if (memcmp(e + 1, string, len)) continue;
+    break;
+  }
+
+  if (e != nullptr)
+  {
+    int32_t tx = x + e->tx;
+    int32_t ty = y + e->ty;
+
+    // Text drawTextLine() would not draw, it wraps or continues the background of earlier
+    // text, is drawn in the normal way. So is text starting left of x = 0, as a glyph that
+    // lands on x = 0 is moved by its dX
+    bool fresh = ((tft->last_cursor_x != tx) || (tft->bg_cursor_x == tx)) && (tx >= 0);
+    bool wrap  = (e->right != INT16_MIN) && ((tft->textwrapX && (x + e->right > tft->width())) ||
+                 (tft->textwrapY && (ty + tft->gFont.yAdvance >= tft->height())));
+
+    if (fresh && !wrap)
+    {
+      pushEntry(e, x + e->x, y + e->y);
+
+      tft->cursor_x      = x + e->cursor;
+      tft->bg_cursor_x   = tft->cursor_x;
+      tft->last_cursor_x = tft->cursor_x;
+      tft->cursor_y      = ty;
+
+      if (_policy == TEXT_CACHE_LRU && e != _head) { unlink(e); insert(e); }
+      _hits++;
+      *width = e->width;
+      return true;
+    }
+  }
+
+  // Keep the details so drawTextLine() can add the string
+  _misses++;
+  _string = string;
+  _x      = x;
+  _y      = y;
+  _hash   = hash;
+
+  return false;
+}
+
+
+/***************************************************************************************
+** Function name:           newEntry
+** Description:             Take a pixel buffer for a string that was not cached
+***************************************************************************************/
+uint16_t* TFT_eTextCache::newEntry(const char *string, int32_t w, int32_t h)
+{
+  if (string != _string) return nullptr;
+  _string = nullptr;
+
+  if (w <= 0 || h <= 0 || w > INT16_MAX || h > INT16_MAX) return nullptr;
+
+  uint16_t len  = strlen(string);
+  size_t   size = sizeof(textEntry_t) + ((len + 4) & ~3) + (size_t)w * h * 2;
+  if (size > _bytes) return nullptr;
+
+  // Nothing can be dropped to make room
+  if (_policy == TEXT_CACHE_KEEP && (_count >= _entries || _used + size > _bytes)) return nullptr;
+
+  textEntry_t* e = (textEntry_t*)allocate(size);
+  if (e == nullptr) return nullptr;
+
+  e->size = size;
+  e->len  = len;
+  e->w    = w;
+  e->h    = h;
+  memcpy(e + 1, string, len + 1);
+
+  _pending = e;
+  return pixels(e);
+}
+
+
+/***************************************************************************************
+** Function name:           addEntry
+** Description:             Add the rendered string to the cache and draw it
+***************************************************************************************/
+void TFT_eTextCache::addEntry(int32_t x, int32_t y, int32_t tx, int32_t ty, int32_t cursor, int32_t right, int32_t width)
+{
+  TFT_eSPI* tft = _tft;
+  textEntry_t* e = _pending;
+  _pending = nullptr;
+  if (e == nullptr) return;
+
+  e->hash     = _hash;
+  e->font     = tft->gFont.gArray;
+  e->gCount   = tft->gFont.gCount;
+  e->yAdvance = tft->gFont.yAdvance;
+  e->fg       = tft->textcolor;
+  e->bg       = tft->textbgcolor;
+  e->padX     = tft->padX;
+  e->datum    = tft->textdatum;
+  e->atZero   = (tx == 0);
+  e->x        = x - _x;
+  e->y        = y - _y;
+  e->tx       = tx - _x;
+  e->ty       = ty - _y;
+  e->cursor   = cursor - _x;
+  e->right    = (right == INT16_MIN) ? INT16_MIN : right - _x;
+  e->width    = width;
+  e->runs     = false;
+  e->data     = (uint32_t)e->w * e->h;
+
+  // Keep runs of one colour if that is smaller, text is mostly background
+  uint16_t* data  = pixels(e);
+  uint32_t  runs  = 0;
+  for (uint32_t i = 0; i < e->data; runs++) {
+    uint32_t j = i + 1;
+    while (j < e->data && data[j] == data[i] && j - i < 0xFFFF) j++;
+    i = j;
+  }
+
+  if (runs * 2 < e->data)
+  {
+    size_t size = (uint8_t*)data - (uint8_t*)e + runs * 4;
+    textEntry_t* r = (textEntry_t*)allocate(size);
+    if (r != nullptr)
+    {
+      memcpy(r, e, (uint8_t*)data - (uint8_t*)e);
+      r->size = size;
+      r->runs = true;
+      r->data = runs * 2;
+      uint16_t* out = pixels(r);
+      for (uint32_t i = 0; i < e->data; ) {
+        uint32_t j = i + 1;
+        while (j < e->data && data[j] == data[i] && j - i < 0xFFFF) j++;
+        *out++ = j - i;
+        *out++ = data[i];
+        i = j;
+      }
+      free(e);
+      e = r;
+    }
+  }
+
+  // Make room, the least recently used or added string is at the tail
+  if (_policy != TEXT_CACHE_KEEP) {
+    while (_tail && (_count >= _entries || _used + e->size > _bytes)) {
+      remove(_tail);
+      _evictions++;
+    }
+  }
+
+  pushEntry(e, _x + e->x, _y + e->y);
+
+  if (_count < _entries && _used + e->size <= _bytes) {
+    insert(e);
+    _used += e->size;
+    _count++;
+  }
+  else free(e);
+}
+
+
+/***************************************************************************************
+** Function name:           dropEntry
+** Description:             Free the pixel buffer of a string that cannot be cached
+***************************************************************************************/
+void TFT_eTextCache::dropEntry(void)
+{
+  if (_pending) free(_pending);
+  _pending = nullptr;
+}
+
+
+/***************************************************************************************
+** Function name:           pushEntry
+** Description:             Push the pixels of a cached string
+***************************************************************************************/
+void TFT_eTextCache::pushEntry(textEntry_t *e, int32_t x, int32_t y)
+{
+  TFT_eSPI* tft = _tft;
+  if (tft->_vpOoB) return;
+
+  uint16_t* data = pixels(e);
+  int32_t   w  = e->w;
+  int32_t   h  = e->h;
+  int32_t   xs = x + tft->_xDatum;
+  int32_t   ys = y + tft->_yDatum;
+
+  // Clip to the viewport
+  int32_t x0 = (xs > tft->_vpX) ? xs : tft->_vpX;
+  int32_t y0 = (ys > tft->_vpY) ? ys : tft->_vpY;
+  int32_t x1 = (xs + w < tft->_vpW) ? xs + w : tft->_vpW;
+  int32_t y1 = (ys + h < tft->_vpH) ? ys + h : tft->_vpH;
+  if (x1 <= x0 || y1 <= y0) return;
+
+  bool swap = tft->_swapBytes; tft->_swapBytes = true; // Pixels are native 565 colours
+
+  tft->begin_tft_write();
+  tft->inTransaction = true;
+
+  // The visible part of the text box in one window
+  tft->setWindow(x0, y0, x1 - 1, y1 - 1);
+
+  if (x1 - x0 == w && y1 - y0 == h)
+  {
+    if (e->runs) for (uint32_t i = 0; i < e->data; i += 2) tft->pushBlock(data[i + 1], data[i]);
+    else tft->pushPixels(data, w * h);
+  }
+  else if (!e->runs)
+  {
+    for (int32_t yp = y0; yp < y1; yp++) tft->pushPixels(data + (yp - ys) * w + (x0 - xs), x1 - x0);
+  }
+  else
+  {
+    // Decode the runs a line at a time
+    uint16_t line[w];
+    uint32_t i = 0, n = 0;
+    uint16_t color = 0;
+    for (int32_t yp = ys; yp < y1; yp++) {
+      for (int32_t xp = 0; xp < w; xp++) {
+        if (n == 0) { n = data[i]; color = data[i + 1]; i += 2; }
+        line[xp] = color;
+        n--;
+      }
+      if (yp >= y0) tft->pushPixels(line + (x0 - xs), x1 - x0);
+    }
+  }
+
+  tft->inTransaction = tft->lockTransaction;
+  tft->end_tft_write();
+
+  tft->_swapBytes = swap;
+}
+
+
+/***************************************************************************************
+** Function name:           unlink
+** Description:             Take an entry out of the list
+***************************************************************************************/
+void TFT_eTextCache::unlink(textEntry_t *e)
+{
+  if (e->prev) e->prev->next = e->next;
+  else _head = e->next;
+  if (e->next) e->next->prev = e->prev;
+  else _tail = e->prev;
+}
+
+
+/***************************************************************************************
+** Function name:           remove
+** Description:             Free a cached string
+***************************************************************************************/
+void TFT_eTextCache::remove(textEntry_t *e)
+{
+  unlink(e);
+  _used -= e->size;
+  _count--;
+  free(e);
+}
+
+
+/***************************************************************************************
+** Function name:           insert
+** Description:             Put an entry at the head of the list
+***************************************************************************************/
+void TFT_eTextCache::insert(textEntry_t *e)
+{
+  e->prev = nullptr;
+  e->next = _head;
+  if (_head) _head->prev = e;
+  else _tail = e;
+  _head = e;
+}
+
+
+/***************************************************************************************
+** Function name:           allocate
+** Description:             Allocate memory for an entry, in PSRAM if requested and fitted
+***************************************************************************************/
+void* TFT_eTextCache::allocate(size_t bytes)
+{
+  void* ptr = nullptr;
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( _psram && psramFound() ) ptr = ps_malloc(bytes);
+#endif
+  if (ptr == nullptr) ptr = malloc(bytes);
+  if (ptr) memset(ptr, 0, sizeof(textEntry_t));
+  return ptr;
+}
+
+
+/***************************************************************************************
+** Function name:           hashString
+** Description:             FNV-1a hash of a string
+***************************************************************************************/
+uint32_t TFT_eTextCache::hashString(const char *string, uint16_t len)
+{
+  uint32_t hash = 2166136261UL;
+  while (len--) {
+    hash ^= (uint8_t)*string++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
@@ -0,0 +1,99 @@
+/***************************************************************************************
+// The following class keeps rendered copies of opaque smooth font strings drawn on the
+// TFT by drawString(), e.g. the labels and values of a dashboard that are redrawn every
+// frame. A string drawn again in the same font, colours, datum and padding is then sent
+// in one window from the copy. Each copy is kept as 16 bit pixels, or as runs of one
+// colour when that is smaller. Text is opaque if the background fill or padding is set.
+***************************************************************************************/
+
+// Which string is dropped when a new one does not fit
+#define TEXT_CACHE_LRU  0 // Least recently drawn (default)
+#define TEXT_CACHE_FIFO 1 // Least recently added
+#define TEXT_CACHE_KEEP 2 // None, new strings are not cached until clear() is called
+
+class TFT_eTextCache { friend class TFT_eSPI;
+
+ public:
+
+  explicit TFT_eTextCache(TFT_eSPI *tft);
+  ~TFT_eTextCache(void);
+
+           // Use up to bytes of memory for up to entries strings, drawString() then uses the cache
+  bool     begin(size_t bytes, uint16_t entries = 32, bool psram = false);
+           // Free all strings and stop using the cache
+  void     end(void);
+           // Free all strings
+  void     clear(void);
+
+           // Set the eviction policy: TEXT_CACHE_LRU, TEXT_CACHE_FIFO or TEXT_CACHE_KEEP
+  void     setEviction(uint8_t policy) { _policy = policy; }
+
+           // Strings drawn from the cache, strings rendered and cached strings dropped to make room
+  uint32_t hits(void) { return _hits; }
+  uint32_t misses(void) { return _misses; }
+  uint32_t evictions(void) { return _evictions; }
+  void     resetStats(void) { _hits = _misses = _evictions = 0; }
+
+           // Strings cached, bytes in use and the byte limit
+  uint16_t count(void) { return _count; }
+  size_t   used(void) { return _used; }
+  size_t   capacity(void) { return _bytes; }
+
+ private:
+
+  typedef struct textEntry_t {
+    textEntry_t*   prev;         // More recently used
+    textEntry_t*   next;         // Less recently used
+    uint32_t       size;         // Bytes allocated
+    uint32_t       hash;         // String hash
+    const uint8_t* font;         // Font array, glyph count and line advance
+    uint16_t       gCount, yAdvance;
+    uint16_t       fg, bg;       // Text colours
+    int16_t        padX;         // Padding width
+    uint8_t        datum;        // Text datum
+    bool           atZero;       // Line started at x = 0, drawGlyph() moves the first glyph
+    bool           runs;         // Pixels are runs of colour
+    uint16_t       len;          // String length, the string and pixels follow the entry
+    int16_t        x, y, w, h;   // Text box, relative to the drawString() x,y
+    int16_t        tx, ty;       // Text position after the datum is applied, relative to x,y
+    int16_t        cursor;       // Cursor x after the text, relative to x
+    int16_t        right;        // Right edge of the glyphs relative to x, INT16_MIN if none
+    int16_t        width;        // Value returned by drawString()
+    uint32_t       data;         // Pixels (w * h) or runs (count and colour pairs) in 16 bit words
+  } textEntry_t;
+
+           // Called by drawString(), push a cached copy of the string at x,y and return true
+  bool     draw(const char *string, int32_t x, int32_t y, int16_t *width);
+
+           // Called by drawTextLine() after a miss: take a w x h pixel buffer for the text box,
+           // then add the rendered copy and draw it, or drop it if not all pixels were drawn
+  uint16_t* newEntry(const char *string, int32_t w, int32_t h);
+  void     addEntry(int32_t x, int32_t y, int32_t tx, int32_t ty, int32_t cursor, int32_t right, int32_t width);
+  void     dropEntry(void);
+
+           // Push the pixels of an entry with the text box top left at x,y
+  void     pushEntry(textEntry_t *e, int32_t x, int32_t y);
+           // Unlink an entry, free it or put it at the head of the list
+  void     unlink(textEntry_t *e);
+  void     remove(textEntry_t *e);
+  void     insert(textEntry_t *e);
+  void*    allocate(size_t bytes);
+
+  static uint32_t hashString(const char *string, uint16_t len);
+  static uint16_t* pixels(textEntry_t *e) { return (uint16_t*)((uint8_t*)(e + 1) + ((e->len + 4) & ~3)); }
+
+  TFT_eSPI    *_tft;
+  textEntry_t *_head;          // Most recently used
+  textEntry_t *_tail;          // Least recently used
+  textEntry_t *_pending;       // Entry being rendered
+  const char  *_string;        // String of the last miss and where drawString() drew it
+  int32_t      _x, _y;
+  uint32_t     _hash;
+  size_t       _bytes;         // Byte limit
+  size_t       _used;          // Bytes allocated
+  uint16_t     _entries;       // Entry limit
+  uint16_t     _count;         // Entries cached
+  uint8_t      _policy;
+  bool         _psram;
+  uint32_t     _hits, _misses, _evictions;
+};
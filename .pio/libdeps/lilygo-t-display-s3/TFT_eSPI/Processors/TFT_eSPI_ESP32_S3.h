@@ -153,6 +153,8 @@ SPI3_HOST = 2
   #include <FS.h>
   #include "SPIFFS.h" // ESP32 only
   #define FONT_FS_AVAILABLE
+  // In-place fonts can be used from a memory mapped data partition
+  #define FONT_PARTITION_AVAILABLE
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -1633,7 +1633,25 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8
   // Line buffer makes plotting faster
   uint16_t  lineBuf[dw];
 
-  if (bpp8)
+  if (bpp8 && cmap != nullptr) // 8bpp indexed with a 256 entry color map
+  {
+    _swapBytes = true;
+
+    data += dx + dy * w;
+    while (dh--) {
+      uint32_t len = dw;
+      uint8_t* ptr = (uint8_t*)data;
+      uint16_t* linePtr = lineBuf;
+
+      while(len--) *linePtr++ = cmap[pgm_read_byte(ptr++)];
+
+      pushPixels(lineBuf, dw);
+
+      data += w;
+    }
+    _swapBytes = swap; // Restore old value
+  }
+  else if (bpp8)
   {
     _swapBytes = false;
 
@@ -1766,7 +1784,25 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
   // Line buffer makes plotting faster
   uint16_t  lineBuf[dw];
 
-  if (bpp8)
+  if (bpp8 && cmap != nullptr) // 8bpp indexed with a 256 entry color map
+  {
+    _swapBytes = true;
+
+    data += dx + dy * w;
+    while (dh--) {
+      uint32_t len = dw;
+      uint8_t* ptr = data;
+      uint16_t* linePtr = lineBuf;
+
+      while(len--) *linePtr++ = cmap[*ptr++];
+
+      pushPixels(lineBuf, dw);
+
+      data += w;
+    }
+    _swapBytes = swap; // Restore old value
+  }
+  else if (bpp8)
   {
     _swapBytes = false;
 
@@ -1898,7 +1934,42 @@ void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t *da
   // Line buffer makes plotting faster
   uint16_t  lineBuf[dw];
 
-  if (bpp8) { // 8 bits per pixel
+  if (bpp8 && cmap != nullptr) { // 8bpp indexed with a 256 entry color map
+    _swapBytes = true;
+
+    data += dx + dy * w;
+
+    while (dh--) {
+      int32_t len = dw;
+      uint8_t* ptr = data;
+
+      int32_t px = x, sx = x;
+      bool move = true;
+      uint16_t np = 0;
+
+      while (len--) {
+        if (transp != *ptr) {
+          if (move) { move = false; sx = px; }
+          lineBuf[np++] = cmap[*ptr];
+        }
+        else {
+          move = true;
+          if (np) {
+            setWindow(sx, y, sx + np - 1, y);
+            pushPixels(lineBuf, np);
+            np = 0;
+          }
+        }
+        px++;
+        ptr++;
+      }
+
+      if (np) { setWindow(sx, y, sx + np - 1, y); pushPixels(lineBuf, np); }
+      y++;
+      data += w;
+    }
+  }
+  else if (bpp8) { // 8 bits per pixel
     _swapBytes = false;
 
     data += dx + dy * w;
@@ -2102,77 +2173,273 @@ void TFT_eSPI::pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint1
   begin_tft_write();
   inTransaction = true;
 
-  uint8_t  *mptr = mask;
-  uint8_t  *eptr = mask + ((w + 7) >> 3);
-  uint16_t *iptr = img;
-  uint32_t setCount = 0;
+  int32_t byteWidth = (w + 7) >> 3;
 
-  // For each line in the image
+  // For each line in the image render the runs of set mask bits
   while (h--) {
-    uint32_t xp = 0;
-    uint32_t clearCount = 0;
-    uint8_t  mbyte= *mptr++;
-    uint32_t bits  = 8;
-    // Scan through each byte of the bitmap and determine run lengths
-    do {
-      setCount = 0;
-
-      //Get run length for clear bits to determine x offset
-      while ((mbyte & 0x80) == 0x00) {
-        // Check if remaining bits in byte are clear (reduce shifts)
-        if (mbyte == 0) {
-          clearCount += bits;      // bits not always 8 here
-          if (mptr >= eptr) break; // end of line
-          mbyte = *mptr++;
-          bits  = 8;
-          continue;
-        }
-        mbyte = mbyte << 1; // 0's shifted in
-        clearCount ++;
-        if (--bits) continue;;
-        if (mptr >= eptr) break;
-        mbyte = *mptr++;
-        bits  = 8;
-      }
+    for (int32_t xp = 0; xp < w; ) {
+      bool set;
+      int32_t run = bitmapRun(mask, xp, w, false, &set);
+      if (set) pushImage(x + xp, y, run, 1, img + xp); // pushImage handles clipping
+      xp += run;
+    }
 
-      //Get run length for set bits to determine render width
-      while ((mbyte & 0x80) == 0x80) {
-        // Check if all bits are set (reduces shifts)
-        if (mbyte == 0xFF) {
-          setCount += bits;
-          if (mptr >= eptr) break;
-          mbyte = *mptr++;
-          //bits  = 8; // NR, bits always 8 here unless 1's shifted in
-          continue;
+    y++;
+    img  += w;
+    mask += byteWidth;
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           pushAtlasImage
+** Description:             Render one image of an image atlas
+***************************************************************************************/
+void TFT_eSPI::pushAtlasImage(const imageAtlas_t *atlas, uint16_t id, int32_t x, int32_t y)
+{
+  if (atlas == nullptr || id >= atlas->count) return;
+
+  // Rectangle table may be in FLASH
+  const atlasRect_t* r = atlas->rect + id;
+  pushAtlasRect(x, y, atlas, pgm_read_word(&r->x), pgm_read_word(&r->y),
+                pgm_read_word(&r->w), pgm_read_word(&r->h), false, 0);
+}
+
+
+/***************************************************************************************
+** Function name:           pushAtlasImage
+** Description:             Render one image of an image atlas with a transparent colour
+***************************************************************************************/
+void TFT_eSPI::pushAtlasImage(const imageAtlas_t *atlas, uint16_t id, int32_t x, int32_t y, uint16_t transp)
+{
+  if (atlas == nullptr || id >= atlas->count) return;
+
+  const atlasRect_t* r = atlas->rect + id;
+  pushAtlasRect(x, y, atlas, pgm_read_word(&r->x), pgm_read_word(&r->y),
+                pgm_read_word(&r->w), pgm_read_word(&r->h), true, transp);
+}
+
+
+/***************************************************************************************
+** Function name:           pushAtlasRect
+** Description:             Render an area of an image atlas to the TFT
+***************************************************************************************/
+void TFT_eSPI::pushAtlasRect(int32_t x, int32_t y, const imageAtlas_t *atlas, int32_t sx, int32_t sy,
+                             int32_t w, int32_t h, bool useTransp, uint16_t transp)
+{
+  PI_CLIP;
+
+  sx += dx;
+  sy += dy;
+
+  begin_tft_write();
+  inTransaction = true;
+
+  // Line buffer holds RGB565 colours so must be swapped when pushed
+  bool swap = _swapBytes;
+  _swapBytes = true;
+
+  uint16_t lineBuf[dw];
+
+  if (!useTransp) setWindow(x, y, x + dw - 1, y + dh - 1);
+
+  while (dh--)
+  {
+    atlasLine(atlas, sx, sy++, dw, lineBuf);
+
+    if (!useTransp) pushPixels(lineBuf, dw);
+    else
+    {
+      // Push the runs of opaque pixels
+      int32_t xp = 0;
+      while (xp < dw)
+      {
+        while (xp < dw && lineBuf[xp] == transp) xp++;
+        int32_t xs = xp;
+        while (xp < dw && lineBuf[xp] != transp) xp++;
+        if (xp > xs)
+        {
+          setWindow(x + xs, y, x + xp - 1, y);
+          pushPixels(lineBuf + xs, xp - xs);
         }
-        mbyte = mbyte << 1; //or mbyte += mbyte + 1 to shift in 1's
-        setCount ++;
-        if (--bits) continue;
-        if (mptr >= eptr) break;
-        mbyte = *mptr++;
-        bits  = 8;
       }
+    }
+    y++;
+  }
 
-      // A mask boundary or mask end has been found, so render the pixel line
-      if (setCount) {
-        xp += clearCount;
-        clearCount = 0;
-        pushImage(x + xp, y, setCount, 1, iptr + xp);      // pushImage handles clipping
-        if (mptr >= eptr) break;
-        xp += setCount;
-      }
-    } while (setCount || mptr < eptr);
+  _swapBytes = swap; // Restore old value
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
 
-    y++;
-    iptr += w;
-    eptr += ((w + 7) >> 3);
+
+/***************************************************************************************
+** Function name:           atlasLine
+** Description:             Read a line of atlas pixels as RGB565 colours
+***************************************************************************************/
+void TFT_eSPI::atlasLine(const imageAtlas_t *atlas, int32_t x, int32_t y, int32_t n, uint16_t *buf)
+{
+  // Pixels are read in place using the atlas row stride, the array may be in FLASH
+  uint32_t stride = ((uint32_t)atlas->width * atlas->bpp + 7) >> 3;
+  const uint8_t* row = (const uint8_t*)atlas->data + y * stride;
+
+  if (atlas->bpp == 16)
+  {
+    const uint16_t* ptr = (const uint16_t*)row + x;
+    while (n--) *buf++ = pgm_read_word(ptr++);
+  }
+  else if (atlas->bpp == 8)
+  {
+    const uint8_t* ptr = row + x;
+    while (n--) *buf++ = color8to16(pgm_read_byte(ptr++));
+  }
+  else // Must be 4bpp
+  {
+    uint16_t cmap[16];
+    for (uint8_t i = 0; i < 16; i++) cmap[i] = pgm_read_word(atlas->palette + i);
+
+    const uint8_t* ptr = row + (x >> 1);
+
+    // Odd start pixel is in the low nibble
+    if (x & 1) { *buf++ = cmap[pgm_read_byte(ptr++) & 0x0F]; n--; }
+
+    while (n > 1)
+    {
+      uint8_t colors = pgm_read_byte(ptr++);
+      *buf++ = cmap[colors >> 4];
+      *buf++ = cmap[colors & 0x0F];
+      n -= 2;
+    }
+
+    if (n > 0) *buf = cmap[pgm_read_byte(ptr) >> 4];
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushAlphaImage
+** Description:             Render a coverage image in colour fg on colour bg or the screen
+***************************************************************************************/
+void TFT_eSPI::pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *alpha, uint8_t bits,
+                              uint16_t fg, uint32_t bg)
+{
+  if (alpha == nullptr || (bits != 8 && bits != 4)) return;
+
+  PI_CLIP;
+
+  uint32_t stride = (bits == 8) ? w : (w + 1) >> 1;
+  alpha += dy * stride;
+
+  begin_tft_write();
+  inTransaction = true;
+
+  // Line buffer holds RGB565 colours so must be swapped when pushed
+  bool swap = _swapBytes;
+  _swapBytes = true;
+
+  uint16_t lineBuf[dw];
+
+  if (bg != 0x00FFFFFF)
+  {
+    // Opaque: one window, colour of each alpha level from a table
+    uint16_t lut[256];
+    alphaTable(lut, bits, fg, bg);
+
+    setWindow(x, y, x + dw - 1, y + dh - 1);
+
+    while (dh--)
+    {
+      alphaLine(lineBuf, alpha, dx, dw, bits, fg, lut);
+      pushPixels(lineBuf, dw);
+      alpha += stride;
+    }
+  }
+  else
+  {
+    // Transparent: blend each run of covered pixels with the pixels read from the screen
+    while (dh--)
+    {
+      int32_t xp = 0;
+      while (xp < dw)
+      {
+        while (xp < dw && alphaValue(alpha, dx + xp, bits) == 0) xp++;
+        int32_t xs = xp;
+        while (xp < dw && alphaValue(alpha, dx + xp, bits) != 0) xp++;
+        if (xp == xs) break;
+
+        for (int32_t i = xs; i < xp; i++) lineBuf[i] = readPixel(x + i - _xDatum, y - _yDatum);
+        alphaLine(lineBuf + xs, alpha, dx + xs, xp - xs, bits, fg, nullptr);
+
+        setWindow(x + xs, y, x + xp - 1, y);
+        pushPixels(lineBuf + xs, xp - xs);
+      }
+      y++;
+      alpha += stride;
+    }
   }
 
+  _swapBytes = swap; // Restore old value
   inTransaction = lockTransaction;
   end_tft_write();
 }
 
 
+/***************************************************************************************
+** Function name:           alphaTable
+** Description:             Fill a table with the colour of each alpha level
+***************************************************************************************/
+void TFT_eSPI::alphaTable(uint16_t *lut, uint8_t bits, uint16_t fg, uint16_t bg)
+{
+  // fastBlend() is not exact at full coverage so the end values are set
+  uint16_t levels = (bits == 4) ? 16 : 256;
+  uint8_t  scale  = (bits == 4) ? 17 : 1;
+
+  lut[0] = bg;
+  for (uint16_t i = 1; i < levels - 1; i++) lut[i] = fastBlend(i * scale, fg, bg);
+  lut[levels - 1] = fg;
+}
+
+
+/***************************************************************************************
+** Function name:           alphaLine
+** Description:             Blend a line of coverage values with fg
+***************************************************************************************/
+void TFT_eSPI::alphaLine(uint16_t *buf, const uint8_t *row, int32_t x, int32_t n, uint8_t bits,
+                         uint16_t fg, const uint16_t *lut)
+{
+  if (lut)
+  {
+    if (bits == 8) {
+      row += x;
+      while (n--) *buf++ = lut[*row++];
+    }
+    else {
+      // Odd start pixel is in the low nibble
+      const uint8_t* ptr = row + (x >> 1);
+      if (x & 1) { *buf++ = lut[*ptr++ & 0x0F]; n--; }
+      while (n > 1) {
+        *buf++ = lut[*ptr >> 4];
+        *buf++ = lut[*ptr++ & 0x0F];
+        n -= 2;
+      }
+      if (n > 0) *buf = lut[*ptr >> 4];
+    }
+    return;
+  }
+
+  while (n--)
+  {
+    uint8_t a = alphaValue(row, x++, bits);
+    if (a == 255) *buf = fg;
+    else if (a) *buf = fastBlend(a, fg, *buf);
+    buf++;
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           setSwapBytes
 ** Description:             Used by 16-bit pushImage() to swap byte order in colours
@@ -2761,21 +3028,7 @@ void TFT_eSPI::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, in
 ***************************************************************************************/
 void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
-
-  int32_t i, j, byteWidth = (w + 7) / 8;
-
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7))) {
-        drawPixel(x + i, y + j, color);
-      }
-    }
-  }
-
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  drawBitmapRuns(x, y, bitmap, w, h, color, color, false, false);
 }
 
 
@@ -2785,21 +3038,7 @@ void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w
 ***************************************************************************************/
 void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
-
-  int32_t i, j, byteWidth = (w + 7) / 8;
-
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7)))
-           drawPixel(x + i, y + j, fgcolor);
-      else drawPixel(x + i, y + j, bgcolor);
-    }
-  }
-
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  drawBitmapRuns(x, y, bitmap, w, h, fgcolor, bgcolor, false, true);
 }
 
 /***************************************************************************************
@@ -2808,45 +3047,112 @@ void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w
 ***************************************************************************************/
 void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  drawBitmapRuns(x, y, bitmap, w, h, color, color, true, false);
+}
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7))) {
-        drawPixel(x + i, y + j, color);
+/***************************************************************************************
+** Function name:           drawXBitmap
+** Description:             Draw an XBM image with foreground and background colors
+***************************************************************************************/
+void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bgcolor)
+{
+  drawBitmapRuns(x, y, bitmap, w, h, color, bgcolor, true, true);
+}
+
+
+/***************************************************************************************
+** Function name:           drawBitmapRuns
+** Description:             Draw a 1bpp bitmap as runs of foreground/background pixels
+***************************************************************************************/
+// Opaque bitmaps are streamed through a single window, transparent bitmaps get a
+// window per run of set bits. Bitmap lines are padded to an integer number of bytes.
+void TFT_eSPI::drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h,
+                              uint16_t fgcolor, uint16_t bgcolor, bool xbm, bool opaque)
+{
+  if (_vpOoB || w < 1 || h < 1) return;
+
+  int32_t byteWidth = (w + 7) >> 3;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clip to the viewport, i0 to i1 and j0 to j1 are the visible bitmap columns and rows
+  int32_t i0 = 0, i1 = w, j0 = 0, j1 = h;
+  if (x < _vpX) i0 = _vpX - x;
+  if (y < _vpY) j0 = _vpY - y;
+  if (x + w > _vpW) i1 = _vpW - x;
+  if (y + h > _vpH) j1 = _vpH - y;
+  if (i0 >= i1 || j0 >= j1) return;
+
+  begin_tft_write();
+  inTransaction = true;
+
+  if (opaque) setWindow(x + i0, y + j0, x + i1 - 1, y + j1 - 1);
+
+  for (int32_t j = j0; j < j1; j++) {
+    const uint8_t *row = bitmap + j * byteWidth;
+    for (int32_t i = i0; i < i1; ) {
+      bool set;
+      int32_t run = bitmapRun(row, i, i1, xbm, &set);
+      if (opaque) pushBlock(set ? fgcolor : bgcolor, run);
+      else if (set) {
+        setWindow(x + i, y + j, x + i + run - 1, y + j);
+        pushBlock(fgcolor, run);
       }
+      i += run;
     }
   }
 
   inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  end_tft_write();
 }
 
 
 /***************************************************************************************
-** Function name:           drawXBitmap
-** Description:             Draw an XBM image with foreground and background colors
+** Function name:           bitmapRun
+** Description:             Return length of the run of bits equal to bit i in a bitmap row
 ***************************************************************************************/
-void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bgcolor)
+// Up to 32 bits are loaded at a time, aligned so bit i is at the word end. The word is
+// inverted if bit i is set so the run length is a count of leading (MSB first bitmap)
+// or trailing (XBM) zeros. set returns the value of bit i. Bits at w and above are
+// not read so w can be a clip edge.
+int32_t TFT_eSPI::bitmapRun(const uint8_t *row, int32_t i, int32_t w, bool xbm, bool *set)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  int32_t  start = i;
+  int32_t  lastByte = (w - 1) >> 3;
+  uint32_t inv = 0;
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  while (i < w) {
+    const uint8_t *ptr = row + (i >> 3);
+    int32_t  bytes = lastByte - (i >> 3) + 1;
+    if (bytes > 4) bytes = 4;
+    int32_t  bits = (bytes << 3) - (i & 7); // Valid bits in word
+    uint32_t word = 0;
+    int32_t  run;
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i & 7)))
-           drawPixel(x + i, y + j,   color);
-      else drawPixel(x + i, y + j, bgcolor);
+    if (xbm) {
+      for (int32_t b = 0; b < bytes; b++) word |= (uint32_t)pgm_read_byte(ptr + b) << (b << 3);
+      word >>= (i & 7);
+      if (i == start) inv = (word & 1) ? 0xFFFFFFFF : 0;
+      word ^= inv;
+      run = word ? __builtin_ctz(word) : 32;
     }
+    else {
+      for (int32_t b = 0; b < bytes; b++) word |= (uint32_t)pgm_read_byte(ptr + b) << (24 - (b << 3));
+      word <<= (i & 7);
+      if (i == start) inv = (word & 0x80000000) ? 0xFFFFFFFF : 0;
+      word ^= inv;
+      run = word ? __builtin_clz(word) : 32;
+    }
+
+    if (run < bits) { i += run; break; }
+    i += bits;
   }
 
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  *set = inv;
+  if (i > w) i = w;
+  return i - start;
 }
 
 
@@ -3272,45 +3578,7 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
       GFXglyph *glyph  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c]);
       uint8_t  *bitmap = (uint8_t *)pgm_read_dword(&gfxFont->bitmap);
 
-      uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
-      uint8_t  w  = pgm_read_byte(&glyph->width),
-               h  = pgm_read_byte(&glyph->height);
-               //xa = pgm_read_byte(&glyph->xAdvance);
-      int8_t   xo = pgm_read_byte(&glyph->xOffset),
-               yo = pgm_read_byte(&glyph->yOffset);
-      uint8_t  xx, yy, bits=0, bit=0;
-      int16_t  xo16 = 0, yo16 = 0;
-
-      if(size > 1) {
-        xo16 = xo;
-        yo16 = yo;
-      }
-
-      // GFXFF rendering speed up
-      uint16_t hpc = 0; // Horizontal foreground pixel count
-      for(yy=0; yy<h; yy++) {
-        for(xx=0; xx<w; xx++) {
-          if(bit == 0) {
-            bits = pgm_read_byte(&bitmap[bo++]);
-            bit  = 0x80;
-          }
-          if(bits & bit) hpc++;
-          else {
-           if (hpc) {
-              if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-              else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
-              hpc=0;
-            }
-          }
-          bit >>= 1;
-        }
-        // Draw pixels for this line as we are about to increment yy
-        if (hpc) {
-          if(size == 1) drawFastHLine(x+xo+xx-hpc, y+yo+yy, hpc, color);
-          else fillRect(x+(xo16+xx-hpc)*size, y+(yo16+yy)*size, size*hpc, size, color);
-          hpc=0;
-        }
-      }
+      drawGfxGlyph(x, y, glyph, bitmap, color, size);
 
       inTransaction = lockTransaction;
       end_tft_write();              // Does nothing if Sprite class uses this function
@@ -3335,6 +3603,73 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
 }
 
 
+#ifdef LOAD_GFXFF
+/***************************************************************************************
+** Function name:           drawGfxGlyph
+** Description:             draw a GFX font glyph as runs of pixels
+***************************************************************************************/
+// Identical rows, e.g. the stems of digits, are drawn as one rectangle so fewer windows
+// are set, the saving is largest when the text is scaled
+void TFT_eSPI::drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap,
+                            uint32_t color, uint8_t size)
+{
+  uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t  w  = pgm_read_byte(&glyph->width),
+           h  = pgm_read_byte(&glyph->height);
+  int8_t   xo = pgm_read_byte(&glyph->xOffset),
+           yo = pgm_read_byte(&glyph->yOffset);
+
+  uint8_t  row[32];
+  uint32_t bit = bo * 8;
+
+  for (int32_t yy = 0; yy < h; ) {
+    int32_t n = gfxGlyphRows(bitmap, bit, w, h - yy, row);
+    for (int32_t xx = 0; xx < w; ) {
+      bool set;
+      int32_t run = bitmapRun(row, xx, w, false, &set);
+      if (set) {
+        if (size == 1 && n == 1) drawFastHLine(x + xo + xx, y + yo + yy, run, color);
+        else fillRect(x + (xo + xx) * size, y + (yo + yy) * size, run * size, n * size, color);
+      }
+      xx += run;
+    }
+    yy  += n;
+    bit += n * w;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           gfxGlyphRows
+** Description:             Read a GFX glyph row and count the identical rows
+***************************************************************************************/
+// Glyph rows are packed with no padding, so the row is shifted into byte alignment for
+// bitmapRun(). Returns the number of rows from bit that are the same, 1 to h.
+int32_t TFT_eSPI::gfxGlyphRows(const uint8_t *bitmap, uint32_t bit, int32_t w, int32_t h, uint8_t *row)
+{
+  uint8_t next[32];
+  int32_t bytes = (w + 7) >> 3;
+  int32_t n = 0;
+
+  for ( ; n < h; n++, bit += w) {
+    uint8_t* dst = n ? next : row;
+    const uint8_t* src = bitmap + (bit >> 3);
+    uint8_t  shift = bit & 7;
+    for (int32_t i = 0; i < bytes; i++) {
+      uint8_t v = pgm_read_byte(src + i) << shift;
+      // Only read the next byte if the row has bits in it, it may be past the end of the bitmap
+      if (shift && (i << 3) + 8 - shift < w) v |= pgm_read_byte(src + i + 1) >> (8 - shift);
+      dst[i] = v;
+    }
+    if (w & 7) dst[bytes - 1] &= 0xFF << (8 - (w & 7));
+    if (n && memcmp(next, row, bytes)) break;
+  }
+
+  return n;
+}
+#endif
+
+
 /***************************************************************************************
 ** Function name:           setAddrWindow
 ** Description:             define an area to receive a stream of pixels
@@ -3747,40 +4082,143 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
       addr_col = x;
     }
 
-    // No need to send y if it has not changed (speeds things up)
-    if (addr_row != y) {
-      DC_C; tft_Write_8(TFT_PASET);
-      DC_D; tft_Write_16(y | (y << 8));
-      addr_row = y;
-    }
-  #else
-    // No need to send x if it has not changed (speeds things up)
-    if (addr_col != x) {
-      DC_C; tft_Write_8(TFT_CASET);
-      DC_D; tft_Write_32D(x);
-      addr_col = x;
-    }
+    // No need to send y if it has not changed (speeds things up)
+    if (addr_row != y) {
+      DC_C; tft_Write_8(TFT_PASET);
+      DC_D; tft_Write_16(y | (y << 8));
+      addr_row = y;
+    }
+  #else
+    // No need to send x if it has not changed (speeds things up)
+    if (addr_col != x) {
+      DC_C; tft_Write_8(TFT_CASET);
+      DC_D; tft_Write_32D(x);
+      addr_col = x;
+    }
+
+    // No need to send y if it has not changed (speeds things up)
+    if (addr_row != y) {
+      DC_C; tft_Write_8(TFT_PASET);
+      DC_D; tft_Write_32D(y);
+      addr_row = y;
+    }
+  #endif
+
+  DC_C; tft_Write_8(TFT_RAMWR);
+
+  #if defined(TFT_PARALLEL_8_BIT) || defined(TFT_PARALLEL_16_BIT) || !defined(ESP32)
+    DC_D; tft_Write_16(color);
+  #else
+    DC_D; tft_Write_16N(color);
+  #endif
+#endif
+
+  end_tft_write();
+}
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             plot n points held as x,y pairs in xy[], each with own colour
+***************************************************************************************/
+void TFT_eSPI::drawPixels(const int16_t* xy, const uint16_t* colors, size_t n)
+{
+  if (!xy || !colors) return;
+  drawPixelBatch(xy, colors, 0, n);
+}
+
+/***************************************************************************************
+** Function name:           drawPixels
+** Description:             plot n points held as x,y pairs in xy[], all the same colour
+***************************************************************************************/
+void TFT_eSPI::drawPixels(const int16_t* xy, size_t n, uint32_t color)
+{
+  if (!xy) return;
+  drawPixelBatch(xy, nullptr, color, n);
+}
+
+/***************************************************************************************
+** Function name:           drawPixelBatch
+** Description:             clip, sort by row and merge points into runs, then send them
+***************************************************************************************/
+// Points are processed in batches held on the stack, each batch is sorted into raster
+// order so horizontally adjacent points can be sent as one window. If colors is nullptr
+// then all points are plotted in "color". Where a point is repeated the last one wins.
+constexpr uint16_t PixelBatchSize = 64;
+
+void TFT_eSPI::drawPixelBatch(const int16_t* xy, const uint16_t* colors, uint32_t color, size_t n)
+{
+  if (_vpOoB || !n) return;
+
+  uint32_t key[PixelBatchSize];  // Sort key: y in top 16 bits, x in bottom 16 bits
+  uint16_t src[PixelBatchSize];  // Index of point within batch (to fetch colour)
+  uint16_t run[PixelBatchSize];  // Colours of the run being assembled
+
+  bool swap = _swapBytes; _swapBytes = true; // Colours are in native 565 format
+
+  begin_tft_write();
+  inTransaction = true;
+
+  while (n) {
+    uint16_t count = 0;
+    uint16_t batch = (n > PixelBatchSize) ? PixelBatchSize : n;
+    n -= batch;
 
-    // No need to send y if it has not changed (speeds things up)
-    if (addr_row != y) {
-      DC_C; tft_Write_8(TFT_PASET);
-      DC_D; tft_Write_32D(y);
-      addr_row = y;
+    // Clip the batch in bulk and build the sort keys
+    for (uint16_t i = 0; i < batch; i++) {
+      int32_t x = xy[2 * i]     + _xDatum;
+      int32_t y = xy[2 * i + 1] + _yDatum;
+      if ((x < _vpX) || (y < _vpY) || (x >= _vpW) || (y >= _vpH)) continue;
+
+      uint32_t k = ((uint32_t)y << 16) | (uint32_t)x;
+
+      // Insertion sort, stable so later duplicates follow earlier ones
+      uint16_t j = count++;
+      while (j && key[j - 1] > k) { key[j] = key[j - 1]; src[j] = src[j - 1]; j--; }
+      key[j] = k;
+      src[j] = i;
     }
-  #endif
 
-  DC_C; tft_Write_8(TFT_RAMWR);
+    // Merge horizontally adjacent points into runs and send each run
+    uint16_t i = 0;
+    while (i < count) {
+      uint32_t k = key[i];
+      uint16_t len = 0;
+      if (colors) run[len] = colors[src[i]];
+      len++;
+      i++;
+
+      while (i < count) {
+        if (key[i] == k) {        // Repeated point, keep latest colour
+          if (colors) run[len - 1] = colors[src[i]];
+        }
+        else if (key[i] == k + 1) { // Next pixel along the same row
+          if (colors) run[len] = colors[src[i]];
+          len++;
+          k++;
+        }
+        else break;
+        i++;
+      }
 
-  #if defined(TFT_PARALLEL_8_BIT) || defined(TFT_PARALLEL_16_BIT) || !defined(ESP32)
-    DC_D; tft_Write_16(color);
-  #else
-    DC_D; tft_Write_16N(color);
-  #endif
-#endif
+      int32_t y  = k >> 16;
+      int32_t x1 = k & 0xFFFF;
+      setWindow(x1 - len + 1, y, x1, y);
 
+      if (colors) pushPixels(run, len);
+      else pushBlock(color, len);
+    }
+
+    xy     += 2 * batch;
+    if (colors) colors += batch;
+  }
+
+  inTransaction = lockTransaction;
   end_tft_write();
+
+  _swapBytes = swap;
 }
 
+
 /***************************************************************************************
 ** Function name:           pushColor
 ** Description:             push a single pixel
@@ -4590,6 +5028,327 @@ inline float TFT_eSPI::wedgeLineDistance(float xpax, float ypay, float bax, floa
 }
 
 
+/***************************************************************************************
+** Function name:           drawPolyline
+** Description:             draw connected lines through n points held as x,y pairs
+***************************************************************************************/
+// Point i is read from xy[i * stride] and xy[i * stride + 1] so a buffer of records can
+// be drawn without copying. Shared vertices are only plotted once.
+void TFT_eSPI::drawPolyline(const int16_t* xy, size_t n, uint32_t color, size_t stride)
+{
+  if (_vpOoB || !xy || (n < 2) || (stride < 2)) return;
+
+  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
+  inTransaction = true;
+
+  for (size_t k = 1; k < n; k++) {
+    int32_t x0 = xy[(k - 1) * stride], y0 = xy[(k - 1) * stride + 1];
+    int32_t x1 = xy[k * stride],       y1 = xy[k * stride + 1];
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      transpose(x0, y0);
+      transpose(x1, y1);
+    }
+
+    // Drawn from the low x end as drawLine() does, so the pixels are the same
+    bool swap = (x0 > x1);
+    if (swap) {
+      transpose(x0, x1);
+      transpose(y0, y1);
+    }
+
+    int32_t dx = x1 - x0, dy = abs(y1 - y0);
+    int32_t err = dx >> 1, ystep = (y0 < y1) ? 1 : -1, xs = x0, dlen = 0;
+
+    // The segment start pixel was plotted as the last pixel of the previous segment,
+    // it is the first pixel here or, if drawn backwards, the last
+    bool skip = (k > 1) && !swap;
+    int32_t xe = ((k > 1) && swap) ? x1 - 1 : x1;
+
+    for (; x0 <= xe; x0++) {
+      if (skip) { skip = false; xs = x0 + 1; }
+      else dlen++;
+      err -= dy;
+      if (err < 0) {
+        if (dlen) {
+          if (steep) { if (dlen == 1) drawPixel(y0, xs, color); else drawFastVLine(y0, xs, dlen, color); }
+          else       { if (dlen == 1) drawPixel(xs, y0, color); else drawFastHLine(xs, y0, dlen, color); }
+        }
+        dlen = 0;
+        y0 += ystep; xs = x0 + 1;
+        err += dx;
+      }
+    }
+    if (dlen) {
+      if (steep) { if (dlen == 1) drawPixel(y0, xs, color); else drawFastVLine(y0, xs, dlen, color); }
+      else       { if (dlen == 1) drawPixel(xs, y0, color); else drawFastHLine(xs, y0, dlen, color); }
+    }
+  }
+
+  inTransaction = lockTransaction;
+  end_tft_write();              // Does nothing if Sprite class uses this function
+}
+
+
+/***************************************************************************************
+** Function name:           drawWidePolyline - background colour specified or pixel read
+** Description:             draw anti-aliased wide connected lines through n points
+***************************************************************************************/
+// The path is rendered segment by segment inside one transaction. Where consecutive
+// segments meet, a pixel is plotted once, by the segment (including its end join) that is
+// nearest, so the anti-aliased edges at joins are seamless. Only neighbouring segments are
+// compared, so where a path crosses itself the crossing pixels are blended twice.
+// Point i is read from xy[i * stride] and xy[i * stride + 1].
+constexpr float PolylineMiterLimit = 4.0; // Longest miter as a multiple of half line width
+
+void TFT_eSPI::drawWidePolyline(const int16_t* xy, size_t n, float wd, uint32_t fg_color, uint32_t bg_color, uint8_t join, size_t stride)
+{
+  if (_vpOoB || !xy || (n < 2) || (stride < 2) || (wd <= 0.0)) return;
+
+  float r = wd / 2.0;
+  uint16_t bg = bg_color;
+
+  polySeg_t seg[3]; // Previous, current and next segment
+  polylineSegment(&seg[1], xy, n, stride, 0, r, join);
+  if (n > 2) polylineSegment(&seg[2], xy, n, stride, 1, r, join);
+
+  begin_nin_write();
+  inTransaction = true;
+
+  for (size_t k = 0; k < n - 1; k++) {
+    polySeg_t* sp = (k > 0)     ? &seg[0] : nullptr;
+    polySeg_t* sc = &seg[1];
+    polySeg_t* sn = (k + 2 < n) ? &seg[2] : nullptr;
+
+    int32_t y0 = (sc->y0 < _vpY) ? _vpY : sc->y0;
+    int32_t y1 = (sc->y1 >= _vpH) ? _vpH - 1 : sc->y1;
+
+    for (int32_t yp = y0; yp <= y1; yp++) {
+      int32_t xs, xe;
+      if (!polylineSpan(sc, yp, r, &xs, &xe)) continue;
+      if (xs < _vpX) xs = _vpX;
+      if (xe >= _vpW) xe = _vpW - 1;
+
+      bool swin = true;  // Flag to start new window area
+      for (int32_t xp = xs; xp <= xe; xp++) {
+        float dist  = polylineDistance(sc, xp, yp, r, join);
+        float alpha = (join == ROUND_JOIN) ? r + 0.5f - sqrtf(dist) : 0.5f - dist;
+        if (alpha <= LoAlphaTheshold) { swin = true; continue; }
+
+        // Leave the pixel to a neighbouring segment if that is nearer, the distances
+        // compare the same way as the coverage so no square root is needed
+        if (sp && polylineDistance(sp, xp, yp, r, join) <= dist) { swin = true; continue; }
+        if (sn && polylineDistance(sn, xp, yp, r, join) <  dist) { swin = true; continue; }
+
+        if (alpha > HiAlphaTheshold) {
+          #ifdef GC9A01_DRIVER
+            drawPixel(xp - _xDatum, yp - _yDatum, fg_color);
+          #else
+            if (swin) { setWindow(xp, yp, xe, yp); swin = false; }
+            pushColor(fg_color);
+          #endif
+          continue;
+        }
+        //Blend colour with background and plot
+        if (bg_color == 0x00FFFFFF) {
+          bg = readPixel(xp - _xDatum, yp - _yDatum); swin = true;
+        }
+        #ifdef GC9A01_DRIVER
+          drawPixel(xp - _xDatum, yp - _yDatum, fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
+        #else
+          if (swin) { setWindow(xp, yp, xe, yp); swin = false; }
+          pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
+        #endif
+      }
+    }
+
+    // Move the segment window along the path
+    seg[0] = seg[1];
+    seg[1] = seg[2];
+    if (k + 3 < n) polylineSegment(&seg[2], xy, n, stride, k + 2, r, join);
+  }
+
+  inTransaction = lockTransaction;
+  end_nin_write();
+}
+
+
+/***************************************************************************************
+** Function name:           polylineSegment - private helper function for drawWidePolyline
+** Description:             set up the geometry of segment k and the join at its end
+***************************************************************************************/
+void TFT_eSPI::polylineSegment(polySeg_t* s, const int16_t* xy, size_t n, size_t stride, size_t k, float r, uint8_t join)
+{
+  float ax = xy[k * stride]           + _xDatum, ay = xy[k * stride + 1]           + _yDatum;
+  float bx = xy[(k + 1) * stride]     + _xDatum, by = xy[(k + 1) * stride + 1]     + _yDatum;
+
+  float dx = bx - ax, dy = by - ay;
+  float len = sqrtf(dx * dx + dy * dy);
+
+  s->ax = ax;
+  s->ay = ay;
+  if (len < 0.01f) { s->dx = 1.0; s->dy = 0.0; s->len = 0.0; }
+  else { s->dx = dx / len; s->dy = dy / len; s->len = len; }
+
+  // Body bounding box, one pixel larger all round for the anti-aliased edge
+  s->x0 = (int32_t)floorf(fminf(ax, bx) - r - 1.0f);
+  s->x1 = (int32_t) ceilf(fmaxf(ax, bx) + r + 1.0f);
+  s->y0 = (int32_t)floorf(fminf(ay, by) - r - 1.0f);
+  s->y1 = (int32_t) ceilf(fmaxf(ay, by) + r + 1.0f);
+
+  s->jn = 0;
+
+  // Round joins are given by the rounded segment ends, there is nothing to add
+  if ((join == ROUND_JOIN) || (k + 2 >= n) || (s->len == 0.0)) return;
+
+  float cx = xy[(k + 2) * stride]     + _xDatum - bx;
+  float cy = xy[(k + 2) * stride + 1] + _yDatum - by;
+  float clen = sqrtf(cx * cx + cy * cy);
+  if (clen < 0.01f) return;
+  cx /= clen;
+  cy /= clen;
+
+  float cross = s->dx * cy - s->dy * cx;
+  if (fabsf(cross) < 0.001f) return; // Straight on, ends abut
+
+  // Offset to the outside of the turn, normals are direction rotated by 90 degrees
+  float sr  = (cross > 0.0f) ? -r : r;
+  float dot = s->dx * cx + s->dy * cy;
+
+  float px[4], py[4];
+  uint8_t pn = 0;
+  px[pn] = bx;              py[pn++] = by;
+  px[pn] = bx - sr * s->dy; py[pn++] = by + sr * s->dx;
+
+  // Miter point is at (n1 + n2) / (1 + n1.n2) from the vertex, length limited
+  if ((join == MITER_JOIN) && ((1.0f + dot) * PolylineMiterLimit * PolylineMiterLimit > 2.0f)) {
+    float f = sr / (1.0f + dot);
+    px[pn] = bx - f * (s->dy + cy); py[pn++] = by + f * (s->dx + cx);
+  }
+
+  px[pn] = bx - sr * cy;    py[pn++] = by + sr * cx;
+
+  // Describe the convex join polygon as a set of half planes
+  float mx = 0, my = 0;
+  for (uint8_t i = 0; i < pn; i++) { mx += px[i]; my += py[i]; }
+  mx /= pn;
+  my /= pn;
+
+  s->jx0 = s->jx1 = (int32_t)bx;
+  s->jy0 = s->jy1 = (int32_t)by;
+  for (uint8_t i = 0; i < pn; i++) {
+    uint8_t j = (i + 1) % pn;
+    float nx = py[j] - py[i], ny = px[i] - px[j];
+    float nl = sqrtf(nx * nx + ny * ny);
+    if (nl < 0.001f) continue;
+    nx /= nl;
+    ny /= nl;
+    // Normals must point out of the polygon
+    if (nx * (mx - px[i]) + ny * (my - py[i]) > 0.0f) { nx = -nx; ny = -ny; }
+    s->jnx[s->jn] = nx;
+    s->jny[s->jn] = ny;
+    s->jc[s->jn]  = nx * px[i] + ny * py[i];
+    // Edges from the vertex are shared with the segment ends, move them one pixel into
+    // the segments so the anti-aliased edges do not leave a visible seam
+    if ((i == 0) || (j == 0)) s->jc[s->jn] += 1.0f;
+    s->jn++;
+
+    if (px[i] < s->jx0) s->jx0 = floorf(px[i]);
+    if (px[i] > s->jx1) s->jx1 = ceilf(px[i]);
+    if (py[i] < s->jy0) s->jy0 = floorf(py[i]);
+    if (py[i] > s->jy1) s->jy1 = ceilf(py[i]);
+  }
+
+  s->jx0--; s->jy0--; s->jx1++; s->jy1++;
+
+  if (s->jx0 < s->x0) s->x0 = s->jx0;
+  if (s->jx1 > s->x1) s->x1 = s->jx1;
+  if (s->jy0 < s->y0) s->y0 = s->jy0;
+  if (s->jy1 > s->y1) s->y1 = s->jy1;
+}
+
+
+/***************************************************************************************
+** Function name:           polylineSpan - private helper function for drawWidePolyline
+** Description:             find the x extent of segment s on row y, false if none
+***************************************************************************************/
+bool TFT_eSPI::polylineSpan(const polySeg_t* s, int32_t y, float r, int32_t* xs, int32_t* xe)
+{
+  float lo = s->x0, hi = s->x1;
+  float rr = r + 1.0f;
+  float ypay = y - s->ay;
+  bool body = true;
+
+  // Distance across the line must be within rr
+  if (fabsf(s->dy) > 0.0001f) {
+    float xa = s->ax + (ypay * s->dx - rr) / s->dy;
+    float xb = s->ax + (ypay * s->dx + rr) / s->dy;
+    lo = fmaxf(lo, fminf(xa, xb));
+    hi = fminf(hi, fmaxf(xa, xb));
+  }
+  else if (fabsf(ypay) > rr) body = false;
+
+  // Distance along the line must be between -rr and len + rr
+  if (fabsf(s->dx) > 0.0001f) {
+    float xa = s->ax + (-rr - ypay * s->dy) / s->dx;
+    float xb = s->ax + (s->len + rr - ypay * s->dy) / s->dx;
+    lo = fmaxf(lo, fminf(xa, xb));
+    hi = fminf(hi, fmaxf(xa, xb));
+  }
+  else if ((ypay * s->dy < -rr) || (ypay * s->dy > s->len + rr)) body = false;
+
+  if (lo > hi) body = false;
+
+  // Add in the join, the span may then include a few uncovered pixels
+  if (s->jn && (y >= s->jy0) && (y <= s->jy1)) {
+    if (body) { lo = fminf(lo, s->jx0); hi = fmaxf(hi, s->jx1); }
+    else { lo = s->jx0; hi = s->jx1; body = true; }
+  }
+
+  if (!body) return false;
+
+  *xs = (int32_t)floorf(lo);
+  *xe = (int32_t) ceilf(hi);
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           polylineDistance - private helper function for drawWidePolyline
+** Description:             returns distance of pixel x,y from segment s and its end join
+***************************************************************************************/
+// For round joins this is the square of the distance from the segment centre line, the
+// coverage is then r + 0.5 - sqrt(distance). For other joins it is the signed distance
+// outside the segment rectangle or join polygon, the coverage is then 0.5 - distance.
+float TFT_eSPI::polylineDistance(const polySeg_t* s, int32_t x, int32_t y, float r, uint8_t join)
+{
+  if ((x < s->x0) || (x > s->x1) || (y < s->y0) || (y > s->y1)) return 1.0e9f; // No coverage
+
+  float xpax = x - s->ax, ypay = y - s->ay;
+  float u = xpax * s->dx + ypay * s->dy; // Distance along the segment
+  float v = ypay * s->dx - xpax * s->dy; // Distance across the segment
+
+  if (join == ROUND_JOIN) {
+    float h = fmaxf(fminf(u, s->len), 0.0f);
+    float dx = xpax - s->dx * h, dy = ypay - s->dy * h;
+    return dx * dx + dy * dy;
+  }
+
+  // Square ended segment
+  float dist = fmaxf(fabsf(v) - r, fmaxf(-u, u - s->len));
+
+  // Join polygon
+  if (s->jn) {
+    float d = s->jnx[0] * x + s->jny[0] * y - s->jc[0];
+    for (uint8_t i = 1; i < s->jn; i++) d = fmaxf(d, s->jnx[i] * x + s->jny[i] * y - s->jc[i]);
+    dist = fminf(dist, d);
+  }
+
+  return dist;
+}
+
+
 /***************************************************************************************
 ** Function name:           drawFastVLine
 ** Description:             draw a vertical line
@@ -4767,6 +5526,232 @@ void TFT_eSPI::fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, uin
 }
 
 
+/***************************************************************************************
+** Function name:           fillRectLinearGradient
+** Description:             fill a rectangle with a multi-stop gradient at any angle
+***************************************************************************************/
+// angle is in degrees clockwise, 0 = left to right, 90 = top to bottom. The gradient is
+// scaled so stop position 0 is at one corner of the rectangle and 255 at the opposite one.
+void TFT_eSPI::fillRectLinearGradient(int32_t x, int32_t y, int32_t w, int32_t h, int16_t angle,
+                                      const gradientStop_t* stops, uint8_t n, bool dither)
+{
+  if (_vpOoB || !stops || !n || (w < 1) || (h < 1)) return;
+
+  gradient_t g;
+  g.radial = false;
+
+  // Direction and projected length of the rectangle in the gradient direction
+  float ca = cosf(angle * deg2rad);
+  float sa = sinf(angle * deg2rad);
+  float len = fabsf((w - 1) * ca) + fabsf((h - 1) * sa);
+  if (len < 1.0) len = 1.0;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Position (Q16) at rectangle top left pixel and increments in x and y
+  g.dtx = (int32_t)(ca * 65536.0 / len);
+  g.dty = (int32_t)(sa * 65536.0 / len);
+  g.t0  = (int32_t)(32768.0 - ((w - 1) * ca + (h - 1) * sa) * 32768.0 / len);
+  g.x0  = x;
+  g.y0  = y;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  gradientTable(&g, stops, n, dither);
+  fillGradient(&g, x, y, w, h);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRectRadialGradient
+** Description:             fill a rectangle with a multi-stop radial gradient
+***************************************************************************************/
+// Stop position 0 is at the centre cx,cy and 255 is at radius r, beyond that the last
+// stop colour is used
+void TFT_eSPI::fillRectRadialGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy, int32_t r,
+                                      const gradientStop_t* stops, uint8_t n, bool dither)
+{
+  if (_vpOoB || !stops || !n || (r < 1)) return;
+
+  gradient_t g;
+  g.radial = true;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  g.x0 = cx + _xDatum;
+  g.y0 = cy + _yDatum;
+  g.rs = (4096 << 8) / r; // Scales distance (Q4) to position (Q16), scaled by 256
+  g.rq = r << 4;          // Radius (Q4)
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  gradientTable(&g, stops, n, dither);
+  fillGradient(&g, x, y, w, h);
+}
+
+
+/***************************************************************************************
+** Function name:           fillGradient
+** Description:             render a gradient into the clipped area x,y,w,h
+***************************************************************************************/
+// Coordinates have the datum and clipping already applied
+void TFT_eSPI::fillGradient(gradient_t* g, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  // Dither to RGB565 levels
+  g->dr = 3; g->dg = 2; g->db = 3;
+
+  // Line buffer, each line is calculated then pushed in one burst
+  uint16_t lineBuf[w];
+
+  begin_tft_write();
+  inTransaction = true;
+
+  bool swap = _swapBytes; _swapBytes = true; // Line buffer holds native 565 colours
+
+  setWindow(x, y, x + w - 1, y + h - 1);
+
+  for (int32_t yp = y; yp < y + h; yp++) {
+    gradientLine(g, lineBuf, x, yp, w);
+    pushPixels(lineBuf, w);
+  }
+
+  _swapBytes = swap;
+
+  inTransaction = lockTransaction;
+  end_tft_write();
+}
+
+
+/***************************************************************************************
+** Function name:           gradientTable
+** Description:             build the 256 entry RGB888 colour table for a gradient
+***************************************************************************************/
+void TFT_eSPI::gradientTable(gradient_t* g, const gradientStop_t* stops, uint8_t n, bool dither)
+{
+  g->dither = dither;
+
+  uint8_t s = 0; // Index of the stop at or after the current position
+  for (uint16_t i = 0; i < 256; i++) {
+    while ((s < n) && (stops[s].pos < i)) s++;
+
+    uint16_t c0, c1;
+    int32_t di = 0, dp = 1; // Position from c0 and distance from c0 to c1
+    if (s == 0)      { c0 = c1 = stops[0].color; }
+    else if (s == n) { c0 = c1 = stops[n - 1].color; }
+    else {
+      c0 = stops[s - 1].color;
+      c1 = stops[s].color;
+      di = i - stops[s - 1].pos;
+      dp = stops[s].pos - stops[s - 1].pos;
+    }
+
+    // Expand the 565 colours to 8 bits per channel and interpolate, rounding to the
+    // nearest step (offset by 255 so only positive values are divided)
+    int32_t r0 = ((c0 >> 8) & 0xF8) | (c0 >> 13), r1 = ((c1 >> 8) & 0xF8) | (c1 >> 13);
+    int32_t g0 = ((c0 >> 3) & 0xFC) | ((c0 >> 9) & 0x03), g1 = ((c1 >> 3) & 0xFC) | ((c1 >> 9) & 0x03);
+    int32_t b0 = ((c0 << 3) & 0xF8) | ((c0 >> 2) & 0x07), b1 = ((c1 << 3) & 0xF8) | ((c1 >> 2) & 0x07);
+
+    uint32_t r = r0 - 255 + ((r1 - r0) * di * 2 + 511 * dp) / (2 * dp);
+    uint32_t gc = g0 - 255 + ((g1 - g0) * di * 2 + 511 * dp) / (2 * dp);
+    uint32_t b = b0 - 255 + ((b1 - b0) * di * 2 + 511 * dp) / (2 * dp);
+
+    g->lut[i] = (r << 16) | (gc << 8) | b;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           gradientLine
+** Description:             calculate w gradient pixels from x,y into buf as RGB565
+***************************************************************************************/
+// Position along the gradient is tracked in Q16 fixed point. For radial gradients the
+// distance (Q4) is updated incrementally from the previous pixel with a Newton step.
+// Each channel is scaled to the levels kept (8 less the bits dropped) and rounded to the
+// nearest level, with dither an ordered offset centred on zero is added before rounding.
+// The levels are expanded back to 8 bits so fewer than 565 levels read back exactly.
+void TFT_eSPI::gradientLine(gradient_t* g, uint16_t* buf, int32_t x, int32_t y, int32_t w)
+{
+  // 4x4 ordered dither (Bayer) matrix
+  static const uint8_t bayer[4][4] = { { 0,  8,  2, 10}, {12,  4, 14,  6},
+                                       { 3, 11,  1,  9}, {15,  7, 13,  5} };
+  const uint8_t* brow = bayer[y & 3];
+
+  // Highest level of each channel, scales from 8 bits to 1/32 levels (Q16) and back (Q16)
+  uint32_t mr = 255 >> g->dr, mg = 255 >> g->dg, mb = 255 >> g->db;
+  uint32_t kr = (mr << 21) / 255, kg = (mg << 21) / 255, kb = (mb << 21) / 255;
+  uint32_t er = ((255 << 16) + mr - 1) / mr, eg = ((255 << 16) + mg - 1) / mg, eb = ((255 << 16) + mb - 1) / mb;
+
+  int32_t t = 0, dt = 0;
+  int32_t ddx = 0, ddy = 0;
+  int32_t d2 = 0, d = 1;
+
+  if (g->radial) {
+    ddx = (x - g->x0) * 16;
+    ddy = (y - g->y0) * 16;
+    d2  = ddx * ddx + ddy * ddy;
+    d   = sqrtf(d2) + 1;
+  }
+  else {
+    t  = g->t0 + (x - g->x0) * g->dtx + (y - g->y0) * g->dty;
+    dt = g->dtx;
+  }
+
+  for (int32_t i = 0; i < w; i++) {
+    uint8_t idx;
+    if (g->radial) {
+      // Newton step from previous distance, then correct to the exact integer root
+      d = (d + d2 / d) >> 1;
+      while (d * d > d2) d--;
+      while ((d + 1) * (d + 1) <= d2) d++;
+      if (d >= g->rq) idx = 255;
+      else idx = (d * g->rs) >> 16;
+      if (d == 0) d = 1;
+      // Distance squared at next pixel
+      d2 += ddx * 32 + 256;
+      ddx += 16;
+    }
+    else {
+      if (t <= 0) idx = 0;
+      else if (t >= 0xFFFF) idx = 255;
+      else idx = t >> 8;
+      t += dt;
+    }
+
+    uint32_t c = g->lut[idx];
+
+    // Offset in 1/32 levels, -15 to +15 with dither, then 16 rounds to the nearest level
+    uint32_t o = 16;
+    if (g->dither) o += 2 * brow[(x + i) & 3] - 15;
+
+    uint32_t r  = (((((c >> 16) * kr) >> 16) + o) >> 5) * er >> 16;
+    uint32_t gc = (((((c >> 8) & 0xFF) * kg >> 16) + o) >> 5) * eg >> 16;
+    uint32_t b  = (((((c & 0xFF) * kb) >> 16) + o) >> 5) * eb >> 16;
+
+    buf[i] = ((r & 0xF8) << 8) | ((gc & 0xFC) << 3) | (b >> 3);
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           color565
 ** Description:             convert three 8-bit RGB levels to a 16-bit colour value
@@ -5501,6 +6486,14 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY)
 // With font number. Note: font number is over-ridden if a smooth font is loaded
 int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8_t font)
 {
+#ifdef SMOOTH_FONT
+  // Opaque text drawn before in the same font, colours and layout is pushed from the cache
+  if (textCache && fontLoaded && (_fillbg || padX)) {
+    int16_t width;
+    if (textCache->draw(string, poX, poY, &width)) return width;
+  }
+#endif
+
   int16_t sumX = 0;
   uint8_t padding = 1, baseline = 0;
   uint16_t cwidth = textWidth(string, font); // Find the pixel width of the string in the font
@@ -5626,6 +6619,7 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
 
   uint16_t len = strlen(string);
   uint16_t n = 0;
+  bool padded = false; // true if the padding was filled with the text
 
 #ifdef SMOOTH_FONT
   if(fontLoaded) {
@@ -5635,6 +6629,9 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
     // If padding is requested then fill the text background
     if (padX && !_fillbg) _fillbg = true;
 
+    // Opaque text, with the padding, is drawn a scanline at a time if possible
+    if (_fillbg && drawTextLine(string, len, padding, cwidth)) padded = true;
+    else
     while (n < len) {
       uint16_t uniCode = decodeUTF8((uint8_t*)string, &n, len - n);
       drawGlyph(uniCode);
@@ -5659,7 +6656,7 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
 #ifndef PADDING_DEBUG
 //^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ DEBUG ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 
-  if((padX>cwidth) && (textcolor!=textbgcolor)) {
+  if((padX>cwidth) && (textcolor!=textbgcolor) && !padded) {
     int16_t padXc = poX+cwidth+xo;
 #ifdef LOAD_GFXFF
     if (freeFont) {
@@ -6139,10 +7136,18 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
 
 #include "Extensions/Button.cpp"
 
+#include "Extensions/Allocator.cpp"
+
 #include "Extensions/Sprite.cpp"
 
+#include "Extensions/Alpha_sprite.cpp"
+
+#include "Extensions/Save_under.cpp"
+
 #ifdef SMOOTH_FONT
   #include "Extensions/Smooth_font.cpp"
+  #include "Extensions/Font_handle.cpp"
+  #include "Extensions/Text_cache.cpp"
 #endif
 
 #ifdef AA_GRAPHICS
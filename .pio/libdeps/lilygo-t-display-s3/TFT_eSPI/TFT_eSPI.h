@@ -298,6 +298,15 @@ const PROGMEM fontinfo fontdata [] = {
 #define C_BASELINE 10 // Centre character baseline
 #define R_BASELINE 11 // Right character baseline
 
+// Line join styles for drawWidePolyline()
+#define ROUND_JOIN 0 // Round joins and round line ends
+#define BEVEL_JOIN 1 // Bevelled (cut off) joins and square line ends
+#define MITER_JOIN 2 // Pointed joins (bevelled if very sharp) and square line ends
+
+// Pixel sampling filters for Sprite pushTransformed()
+#define SAMPLE_NEAREST  0 // Nearest pixel, fastest
+#define SAMPLE_BILINEAR 1 // Weighted average of 4 nearest pixels, smooth when scaled or rotated
+
 /***************************************************************************************
 **                         Section 6: Colour enumeration
 ***************************************************************************************/
@@ -352,6 +361,14 @@ static const uint16_t default_4bit_palette[] PROGMEM = {
   TFT_PINK      // 15
 };
 
+// Default palette for 2-bit colour sprites (grey scale)
+static const uint16_t default_2bit_palette[] PROGMEM = {
+  TFT_BLACK,    //  0
+  TFT_DARKGREY, //  1
+  TFT_LIGHTGREY,//  2
+  TFT_WHITE     //  3
+};
+
 /***************************************************************************************
 **                         Section 7: Diagnostic support
 ***************************************************************************************/
@@ -423,8 +440,37 @@ int16_t tch_spi_freq;// Touch controller read/write SPI frequency
 // Callback prototype for smooth font pixel colour read
 typedef uint16_t (*getColorCallback)(uint16_t x, uint16_t y);
 
+// Colour stop for gradient fills, pos is the position along the gradient 0-255
+typedef struct {
+  uint8_t  pos;
+  uint16_t color;
+} gradientStop_t;
+
+// Position and size of one image in an image atlas
+typedef struct {
+  uint16_t x, y, w, h;
+} atlasRect_t;
+
+// Image atlas: many images packed in one pixel array (RAM or FLASH) with a rectangle table,
+// Tools/image_atlas creates these. Rows are width pixels long, 4 bpp rows are padded to a
+// whole byte with the even x pixel in the high nibble. 16 bpp pixels are RGB565 colour
+// values, 8 bpp pixels are RGB332 and 4 bpp pixels index the RGB565 palette.
+typedef struct {
+  const void*        data;     // Pixel array
+  const atlasRect_t* rect;     // Rectangle of each image
+  const uint16_t*    palette;  // 16 entry colour palette for 4 bpp, otherwise nullptr
+  uint16_t           width;    // Atlas width and height in pixels
+  uint16_t           height;
+  uint16_t           count;    // Number of images
+  uint8_t            bpp;      // Bits per pixel: 16, 8 or 4
+} imageAtlas_t;
+
+// Smooth font handle and text cache classes, see Extensions/Font_handle.h and Text_cache.h
+class TFT_eSmoothFont;
+class TFT_eTextCache;
+
 // Class functions and variables
-class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has access to protected members
+class TFT_eSPI : public Print { friend class TFT_eSprite; friend class TFT_eSaveUnder; friend class TFT_eSmoothFont; friend class TFT_eTextCache; // Sprite, save-under, font handle and text cache classes have access to protected members
 
  //--------------------------------------- public ------------------------------------//
  public:
@@ -518,9 +564,23 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color),
            fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color);
 
+           // Plot n points held as x,y coordinate pairs in xy[] (so xy[] holds 2*n values)
+           // Points are clipped, sorted by row and merged into runs, then sent in one transaction
+  virtual void drawPixels(const int16_t* xy, const uint16_t* colors, size_t n), // Colour per point
+               drawPixels(const int16_t* xy, size_t n, uint32_t color);         // Same colour for all
+
   void     fillRectVGradient(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t color1, uint32_t color2);
   void     fillRectHGradient(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t color1, uint32_t color2);
 
+           // Fill a rectangle with a gradient defined by n colour stops (in increasing position order)
+           // Linear gradient angle is in degrees clockwise, 0 = left to right, 90 = top to bottom
+           // Radial gradient is centred on cx,cy and reaches the last stop at radius r
+           // If dither is true a 4x4 ordered dither is applied to hide colour banding
+  void     fillRectLinearGradient(int32_t x, int32_t y, int32_t w, int32_t h, int16_t angle,
+                                  const gradientStop_t* stops, uint8_t n, bool dither = false);
+  void     fillRectRadialGradient(int32_t x, int32_t y, int32_t w, int32_t h, int32_t cx, int32_t cy, int32_t r,
+                                  const gradientStop_t* stops, uint8_t n, bool dither = false);
+
   void     drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color),
            drawCircleHelper(int32_t x, int32_t y, int32_t r, uint8_t cornername, uint32_t color),
            fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color),
@@ -579,6 +639,16 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            // If bg_color is not included the background pixel colour will be read from TFT or sprite
   void     drawWedgeLine(float ax, float ay, float bx, float by, float aw, float bw, uint32_t fg_color, uint32_t bg_color = 0x00FFFFFF);
 
+           // Draw lines joining n points, point i is at xy[i * stride], xy[i * stride + 1] so records can be used
+  void     drawPolyline(const int16_t* xy, size_t n, uint32_t color, size_t stride = 2);
+
+           // Draw anti-aliased wide lines of width wd joining n points, with ROUND_JOIN, BEVEL_JOIN or MITER_JOIN joins
+           // The path is drawn in one transaction and pixels at the joins are only plotted once
+           // Pixels where the path crosses itself are blended once for each segment
+           // If bg_color is not included the background pixel colour will be read from TFT or sprite
+  void     drawWidePolyline(const int16_t* xy, size_t n, float wd, uint32_t fg_color, uint32_t bg_color = 0x00FFFFFF,
+                            uint8_t join = ROUND_JOIN, size_t stride = 2);
+
 
   // Image rendering
            // Swap the byte order for pushImage() and pushPixels() - corrects endianness
@@ -614,6 +684,7 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            // These are used by Sprite class pushSprite() member function for 1, 4 and 8 bits per pixel (bpp) colours
            // They are not intended to be used with user sketches (but could be)
            // Set bpp8 true for 8bpp sprites, false otherwise. The cmap pointer must be specified for 4bpp
+           // With bpp8 true a cmap of 256 entries expands indexed 8bpp pixels, else RGB332 is assumed
   void     pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t  *data, bool bpp8 = true, uint16_t *cmap = nullptr);
   void     pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t  *data, uint8_t  transparent, bool bpp8 = true, uint16_t *cmap = nullptr);
            // FLASH version
@@ -622,6 +693,17 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            // Render a 16-bit colour image with a 1bpp mask
   void     pushMaskedImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *img, uint8_t *mask);
 
+           // Render image id of an atlas, pixels are read in place from the atlas array
+  void     pushAtlasImage(const imageAtlas_t *atlas, uint16_t id, int32_t x, int32_t y);
+           // As above, pixels with the RGB565 transparent colour are not drawn
+  void     pushAtlasImage(const imageAtlas_t *atlas, uint16_t id, int32_t x, int32_t y, uint16_t transparent);
+
+           // Render a coverage (alpha) image of 8 or 4 bits per pixel in colour fg blended with colour bg.
+           // 4 bit rows are padded to a whole byte with the even x pixel in the high nibble. If bg is
+           // 0x00FFFFFF the existing pixels are read and used as the background (TFT must support reads)
+  virtual void pushAlphaImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t *alpha, uint8_t bits,
+                              uint16_t fg, uint32_t bg = 0x00FFFFFF);
+
            // This next function has been used successfully to dump the TFT screen to a PC for documentation purposes
            // It reads a screen area and returns the 3 RGB 8-bit colour values of each pixel in the buffer
            // Set w and h to 1 to read 1 pixel's colour. The data buffer must be at least w * h * 3 bytes
@@ -873,12 +955,31 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            // Single GPIO input/output direction control
   void     gpioMode(uint8_t gpio, uint8_t mode);
 
+           // Batched point plotting helper, colors may be nullptr to plot all points in color
+  void     drawPixelBatch(const int16_t* xy, const uint16_t* colors, uint32_t color, size_t n);
+
            // Smooth graphics helper
   uint8_t  sqrt_fraction(uint32_t num);
 
            // Helper function: calculate distance of a point from a finite length line between two points
   float    wedgeLineDistance(float pax, float pay, float bax, float bay, float dr);
 
+           // Wide polyline segment geometry
+  typedef struct {
+    float    ax, ay;             // Segment start
+    float    dx, dy;             // Unit vector along segment
+    float    len;                // Segment length
+    int32_t  x0, y0, x1, y1;     // Bounding box of segment and join
+    int32_t  jx0, jy0, jx1, jy1; // Bounding box of join
+    uint8_t  jn;                 // Number of join polygon edges, 0 if there is no join
+    float    jnx[4], jny[4], jc[4]; // Join polygon edges as half planes jnx * x + jny * y <= jc
+  } polySeg_t;
+
+           // Helper functions for drawWidePolyline
+  void     polylineSegment(polySeg_t* s, const int16_t* xy, size_t n, size_t stride, size_t k, float r, uint8_t join);
+  bool     polylineSpan(const polySeg_t* s, int32_t y, float r, int32_t* xs, int32_t* xe);
+  float    polylineDistance(const polySeg_t* s, int32_t x, int32_t y, float r, uint8_t join);
+
            // Display variant settings
   uint8_t  tabcolor,                   // ST7735 screen protector "tab" colour (now invalid)
            colstart = 0, rowstart = 0; // Screen display area to CGRAM area coordinate offsets
@@ -954,8 +1055,62 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
 
 #ifdef LOAD_GFXFF
   GFXfont  *gfxFont;
+
+           // Draw a GFX font glyph at cursor x,y scaled by size as runs of pixels, identical
+           // rows are drawn together. The Sprite class overrides this
+  virtual void drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap,
+                            uint32_t color, uint8_t size);
+           // Read the glyph row starting at bit into row (MSB first), return the number of
+           // rows from there that are the same, at most h
+  static int32_t gfxGlyphRows(const uint8_t *bitmap, uint32_t bit, int32_t w, int32_t h, uint8_t *row);
 #endif
 
+           // Gradient fill parameters
+  typedef struct {
+    bool     radial;     // true for radial gradient
+    bool     dither;     // true for ordered dither
+    uint8_t  dr, dg, db; // Bits dropped from each 8-bit colour channel (sets the levels kept)
+    int32_t  x0, y0;     // Linear: rectangle top left, Radial: centre (screen coordinates)
+    int32_t  t0;         // Linear: position (Q16) at x0,y0
+    int32_t  dtx, dty;   // Linear: position (Q16) increment per pixel in x and y
+    int32_t  rs;         // Radial: scale from distance (Q4) to position (Q16), x 256
+    int32_t  rq;         // Radial: radius (Q4)
+    uint32_t lut[256];   // RGB888 colour at each position
+  } gradient_t;
+
+           // Fill the clipped area (datum applied) with the gradient, Sprite class overrides this
+  virtual void fillGradient(gradient_t* g, int32_t x, int32_t y, int32_t w, int32_t h);
+           // Gradient helpers: build colour table, calculate a line of RGB565 pixels
+  void     gradientTable(gradient_t* g, const gradientStop_t* stops, uint8_t n, bool dither);
+  void     gradientLine(gradient_t* g, uint16_t* buf, int32_t x, int32_t y, int32_t w);
+
+           // Draw a 1bpp bitmap (MSB first, or LSB first for XBM) as runs of pixels, clear bits
+           // are drawn in bgcolor if opaque is true. The Sprite class overrides this
+  virtual void drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h,
+                              uint16_t fgcolor, uint16_t bgcolor, bool xbm, bool opaque);
+           // Return the length of the run of bits equal to bit i in a bitmap row ending at bit w
+  static int32_t bitmapRun(const uint8_t *row, int32_t i, int32_t w, bool xbm, bool *set);
+
+           // Draw the w x h area at sx,sy of an atlas, skipping transp pixels if useTransp.
+           // The Sprite class overrides this
+  virtual void pushAtlasRect(int32_t x, int32_t y, const imageAtlas_t *atlas, int32_t sx, int32_t sy,
+                             int32_t w, int32_t h, bool useTransp, uint16_t transp);
+           // Read n atlas pixels from x,y as RGB565 colours
+  void     atlasLine(const imageAtlas_t *atlas, int32_t x, int32_t y, int32_t n, uint16_t *buf);
+
+           // Fill lut with fg blended on bg for each alpha level, 16 levels (4 bit) or 256 (8 bit)
+  static void alphaTable(uint16_t *lut, uint8_t bits, uint16_t fg, uint16_t bg);
+           // Blend n coverage values from x in an alpha image row with fg. Background colours
+           // are read from buf, or taken from lut if not nullptr. Result is written to buf
+  static void alphaLine(uint16_t *buf, const uint8_t *row, int32_t x, int32_t n, uint8_t bits,
+                        uint16_t fg, const uint16_t *lut);
+           // Return the coverage at x in an alpha image row scaled to 0-255
+  static inline uint8_t alphaValue(const uint8_t *row, int32_t x, uint8_t bits) {
+    if (bits == 8) return row[x];
+    uint8_t a = (x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4);
+    return a * 17;
+  }
+
 /***************************************************************************************
 **                         Section 9: TFT_eSPI class conditional extensions
 ***************************************************************************************/
@@ -1005,7 +1160,22 @@ fastBlend(A alpha, F fgc, B bgc)
 // Load the Button Class
 #include "Extensions/Button.h"
 
+// Load the Sprite memory allocator classes
+#include "Extensions/Allocator.h"
+
 // Load the Sprite Class
 #include "Extensions/Sprite.h"
 
+// Load the alpha (coverage) Sprite Class
+#include "Extensions/Alpha_sprite.h"
+
+// Load the save-under Class
+#include "Extensions/Save_under.h"
+
+// Load the smooth font handle and text cache Classes
+#ifdef SMOOTH_FONT
+  #include "Extensions/Font_handle.h"
+  #include "Extensions/Text_cache.h"
+#endif
+
 #endif // ends #ifndef _TFT_eSPIH_
@@ -0,0 +1,600 @@
+/*
+
+    font_compiler converts a smooth font .vlw file, or an Adafruit GFX font
+    header, into a smooth font holding only the characters a sketch uses.
+    The characters are given as a list, as code ranges, or are found by
+    scanning the string literals in the sketch source files.
+
+    The glyphs are written in character code order, so loadFont() finds
+    them with a binary search and does not build a sorted index in RAM.
+    The output is a .vlw font, the run length coded variant or the in-place
+    layout made by Tools/vlw_compress, see vlw_compress.py for the formats.
+
+    The output is a font file for SPIFFS, LittleFS or SD, a binary for a data
+    partition (in-place fonts), or a C header with the font as a PROGMEM
+    array if the output file name ends in .h
+
+    build: g++ -std=c++17 -O2 -o font_compiler font_compiler.cpp
+
+    usage: font_compiler [-v] font.vlw|font.h [-o out.vlw] [-f vlw|rle|inplace]
+                         [-b 8|4|2] [-c chars] [-r first-last] [-s source]
+
+    -c, -r and -s can be repeated and are combined. With none of them all
+    the glyphs of the input font are kept.
+
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static bool debug = false;
+
+struct Glyph {
+  uint32_t code;
+  int32_t  height, width, xAdvance, dY, dX; // As in the vlw metrics
+  std::vector<uint8_t> alpha;               // 8 bit alpha values, width * height
+  std::vector<uint8_t> coded;               // Bitmap as written to the output
+};
+
+struct Font {
+  uint32_t size    = 0;                     // vlw header values
+  uint32_t mboxY   = 0;
+  uint32_t ascent  = 0;
+  uint32_t descent = 0;
+  uint32_t spaceWidth = 0;                  // Space advance for in-place fonts, 0 to use the vlw guess
+  std::vector<Glyph>   glyphs;
+  std::vector<uint8_t> names;               // Font names after the vlw bitmaps
+};
+
+static void fail(const std::string& s)
+{
+  fprintf(stderr, "%s\n", s.c_str());
+  exit(1);
+}
+
+static bool readFile(const std::string& name, std::vector<uint8_t>& data)
+{
+  FILE* f = fopen(name.c_str(), "rb");
+  if (!f) return false;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+static bool endsWith(const std::string& s, const std::string& end)
+{
+  return s.size() >= end.size() && s.compare(s.size() - end.size(), end.size(), end) == 0;
+}
+
+// -------------------------------------------------------------------------
+// Input, a .vlw font
+// -------------------------------------------------------------------------
+static uint32_t be32(const std::vector<uint8_t>& d, size_t p)
+{
+  if (p + 4 > d.size()) fail("The vlw font is truncated");
+  return (uint32_t)d[p] << 24 | (uint32_t)d[p + 1] << 16 | (uint32_t)d[p + 2] << 8 | d[p + 3];
+}
+
+static void readVlw(const std::string& name, Font& font)
+{
+  std::vector<uint8_t> vlw;
+  if (!readFile(name, vlw)) fail("Cannot read " + name);
+
+  uint32_t count   = be32(vlw, 0);
+  uint32_t version = be32(vlw, 4);
+  if (version != 11) fail(name + " is not an uncompressed vlw font");
+
+  font.size    = be32(vlw, 8);
+  font.mboxY   = be32(vlw, 12);
+  font.ascent  = be32(vlw, 16);
+  font.descent = be32(vlw, 20);
+
+  // Glyph metrics, 7 values per glyph after the 24 byte header, then the bitmaps in glyph order
+  size_t ptr = 24 + 28 * (size_t)count;
+  for (uint32_t n = 0; n < count; n++) {
+    size_t m = 24 + 28 * (size_t)n;
+    Glyph g;
+    g.code     = be32(vlw, m);
+    g.height   = (int32_t)be32(vlw, m + 4);
+    g.width    = (int32_t)be32(vlw, m + 8);
+    g.xAdvance = (int32_t)be32(vlw, m + 12);
+    g.dY       = (int32_t)be32(vlw, m + 16);
+    g.dX       = (int32_t)be32(vlw, m + 20);
+    size_t bytes = (size_t)g.width * g.height;
+    if (ptr + bytes > vlw.size()) fail("The vlw font is truncated");
+    g.alpha.assign(vlw.begin() + ptr, vlw.begin() + ptr + bytes);
+    ptr += bytes;
+    font.glyphs.push_back(g);
+  }
+
+  font.names.assign(vlw.begin() + ptr, vlw.end());
+}
+
+// -------------------------------------------------------------------------
+// Input, a GFXfont header made by fontconvert
+// -------------------------------------------------------------------------
+
+// Remove comments, the glyph table has comments like // 0x7B '{'
+static std::string stripComments(const std::string& s)
+{
+  std::string out;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '/' && i + 1 < s.size() && s[i + 1] == '/') {
+      while (i < s.size() && s[i] != '\n') i++;
+      out += '\n';
+    }
+    else if (s[i] == '/' && i + 1 < s.size() && s[i + 1] == '*') {
+      i += 2;
+      while (i + 1 < s.size() && !(s[i] == '*' && s[i + 1] == '/')) i++;
+      i++;
+      out += ' ';
+    }
+    else out += s[i];
+  }
+  return out;
+}
+
+// The numbers between the braces that follow the declaration of a type, identifiers are skipped
+static bool declaration(const std::string& s, const std::string& type, std::vector<long>& values)
+{
+  size_t p = 0;
+  while ((p = s.find(type, p)) != std::string::npos) {
+    char before = p ? s[p - 1] : ' ';
+    char after  = s[p + type.size()];
+    bool word   = !(isalnum((uint8_t)before) || before == '_' || isalnum((uint8_t)after) || after == '_');
+    // A declaration with an initialiser, not a cast such as (GFXglyph *)
+    if (word && before != '(' && s.find('=', p) < s.find(';', p)) break;
+    p += type.size();
+  }
+  if (p == std::string::npos) return false;
+
+  size_t i = s.find('{', p);
+  if (i == std::string::npos) return false;
+
+  int depth = 0;
+  for (; i < s.size(); i++) {
+    char c = s[i];
+    if (c == '{') depth++;
+    else if (c == '}') { if (--depth == 0) return true; }
+    else if (isalpha((uint8_t)c) || c == '_') {
+      while (i + 1 < s.size() && (isalnum((uint8_t)s[i + 1]) || s[i + 1] == '_')) i++;
+    }
+    else if (isdigit((uint8_t)c) || (c == '-' && isdigit((uint8_t)s[i + 1]))) {
+      char* end;
+      values.push_back(strtol(s.c_str() + i, &end, 0));
+      i = end - s.c_str() - 1;
+    }
+  }
+  return false;
+}
+
+static void readGfx(const std::string& name, Font& font)
+{
+  std::vector<uint8_t> text;
+  if (!readFile(name, text)) fail("Cannot read " + name);
+  std::string s = stripComments(std::string(text.begin(), text.end()));
+
+  std::vector<long> bitmaps, glyphs, header;
+  if (!declaration(s, "uint8_t", bitmaps) || !declaration(s, "GFXglyph", glyphs) ||
+      !declaration(s, "GFXfont", header) || header.size() < 3 || glyphs.size() % 6)
+    fail(name + " is not a GFXfont header");
+
+  uint32_t first    = header[0];
+  uint32_t last     = header[1];
+  uint32_t yAdvance = header[2];
+  if (glyphs.size() / 6 < last - first + 1) fail(name + " has fewer glyphs than the font range");
+
+  int32_t ascent = 0, descent = 0;
+
+  for (uint32_t n = 0; n <= last - first; n++) {
+    const long* v = &glyphs[n * 6]; // bitmapOffset, width, height, xAdvance, xOffset, yOffset
+    Glyph g;
+    g.code     = first + n;
+    g.width    = v[1];
+    g.height   = v[2];
+    g.xAdvance = v[3];
+    g.dX       = v[4];
+    g.dY       = -v[5];
+
+    // Bits are packed most significant first with no padding at the end of a row
+    uint32_t bit = v[0] * 8;
+    for (int32_t p = 0; p < g.width * g.height; p++, bit++) {
+      uint8_t byte = (bit / 8 < bitmaps.size()) ? bitmaps[bit / 8] : 0;
+      g.alpha.push_back((byte << (bit & 7)) & 0x80 ? 255 : 0);
+    }
+
+    if (g.code == 0x20) font.spaceWidth = g.xAdvance;
+    if (g.width && g.height) {
+      ascent  = std::max(ascent, g.dY);
+      descent = std::max(descent, g.height - g.dY);
+    }
+    font.glyphs.push_back(g);
+  }
+
+  font.size    = yAdvance;
+  font.ascent  = ascent;
+  font.descent = descent;
+
+  // Font names and the anti-aliased flag, not read by loadFont()
+  std::string base = fs::path(name).stem().string();
+  for (int i = 0; i < 2; i++) {
+    font.names.push_back((uint8_t)base.size());
+    font.names.insert(font.names.end(), base.begin(), base.end());
+    font.names.push_back(0);
+  }
+  font.names.push_back(0);
+}
+
+// -------------------------------------------------------------------------
+// Characters to keep
+// -------------------------------------------------------------------------
+
+// Decode UTF-8, invalid bytes are taken as Latin-1
+static void addUtf8(const std::string& s, std::set<uint32_t>& codes)
+{
+  for (size_t i = 0; i < s.size(); ) {
+    uint8_t  c = s[i];
+    uint32_t code = c;
+    size_t   n = 0;
+    if      ((c & 0xE0) == 0xC0) { code = c & 0x1F; n = 1; }
+    else if ((c & 0xF0) == 0xE0) { code = c & 0x0F; n = 2; }
+    else if ((c & 0xF8) == 0xF0) { code = c & 0x07; n = 3; }
+    bool ok = (i + n < s.size());
+    for (size_t k = 1; ok && k <= n; k++) {
+      if ((s[i + k] & 0xC0) != 0x80) ok = false;
+      else code = code << 6 | (s[i + k] & 0x3F);
+    }
+    if (!ok) { code = c; n = 0; }
+    if (code >= 0x20) codes.insert(code);
+    i += n + 1;
+  }
+}
+
+// Add the characters of the string literals in a source file
+static void scanSource(const std::string& name, std::set<uint32_t>& codes)
+{
+  std::vector<uint8_t> text;
+  if (!readFile(name, text)) fail("Cannot read " + name);
+  std::string s(text.begin(), text.end());
+
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s.compare(i, 2, "//") == 0) { while (i < s.size() && s[i] != '\n') i++; continue; }
+    if (s.compare(i, 2, "/*") == 0) { i = s.find("*/", i + 2); if (i == std::string::npos) break; i++; continue; }
+    if (s[i] != '"' && s[i] != '\'') continue;
+
+    // A literal, only the characters are kept so escapes other than quotes and \x are dropped
+    char quote = s[i];
+    std::string lit;
+    for (i++; i < s.size() && s[i] != quote && s[i] != '\n'; i++) {
+      if (s[i] != '\\') { lit += s[i]; continue; }
+      if (++i >= s.size()) break;
+      if (s[i] == '\\' || s[i] == '"' || s[i] == '\'') lit += s[i];
+      else if (s[i] == 'x') {
+        char* end;
+        long v = strtol(s.c_str() + i + 1, &end, 16);
+        if (end > s.c_str() + i + 1) { lit += (char)v; i = end - s.c_str() - 1; }
+      }
+    }
+    addUtf8(lit, codes);
+  }
+}
+
+static void scanPath(const std::string& name, std::set<uint32_t>& codes)
+{
+  if (!fs::is_directory(name)) {
+    scanSource(name, codes);
+    return;
+  }
+  for (auto& entry : fs::recursive_directory_iterator(name)) {
+    std::string ext = entry.path().extension().string();
+    if (entry.is_regular_file() && (ext == ".ino" || ext == ".cpp" || ext == ".c" || ext == ".h" || ext == ".hpp")) {
+      if (debug) printf("scanning %s\n", entry.path().string().c_str());
+      scanSource(entry.path().string(), codes);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------
+// Bitmap coding, as in vlw_compress.py
+// -------------------------------------------------------------------------
+static uint32_t bits = 4;
+
+static std::vector<uint8_t> codeGlyph(const Glyph& g)
+{
+  if (bits == 8) return g.alpha;
+
+  uint32_t top = (1 << bits) - 1;
+
+  // Values 0 and top start a run and are followed by the run length - 1
+  std::vector<uint8_t> values;
+  for (int32_t y = 0; y < g.height; y++) {
+    std::vector<uint8_t> row;
+    for (int32_t x = 0; x < g.width; x++) row.push_back((g.alpha[y * g.width + x] * top + 127) / 255);
+    for (int32_t x = 0; x < g.width; ) {
+      uint8_t v = row[x];
+      if (v == 0 || v == top) {
+        int32_t n = 1;
+        while (x + n < g.width && n <= (int32_t)top && row[x + n] == v) n++;
+        values.push_back(v);
+        values.push_back(n - 1);
+        x += n;
+      }
+      else { values.push_back(v); x++; }
+    }
+  }
+
+  // Most significant bits first, padded to a whole byte
+  std::vector<uint8_t> out;
+  uint32_t acc = 0, used = 0;
+  for (uint8_t v : values) {
+    acc = (acc << bits) | v;
+    used += bits;
+    if (used == 8) { out.push_back(acc); acc = used = 0; }
+  }
+  if (used) out.push_back(acc << (8 - used));
+  return out;
+}
+
+// -------------------------------------------------------------------------
+// Output
+// -------------------------------------------------------------------------
+static void put32be(std::vector<uint8_t>& d, uint32_t v)
+{
+  for (int s = 24; s >= 0; s -= 8) d.push_back(v >> s);
+}
+
+static void put16le(std::vector<uint8_t>& d, uint32_t v)
+{
+  d.push_back(v);
+  d.push_back(v >> 8);
+}
+
+static void put32le(std::vector<uint8_t>& d, uint32_t v)
+{
+  for (int s = 0; s < 32; s += 8) d.push_back(v >> s);
+}
+
+static std::vector<uint8_t> vlwFont(const Font& font, bool rle)
+{
+  // Header, metrics with the byte count in place of the padding value if coded, bitmaps, names
+  std::vector<uint8_t> out;
+  put32be(out, font.glyphs.size());
+  put32be(out, rle ? 0x524C4500 | bits : 11);
+  put32be(out, font.size);
+  put32be(out, font.mboxY);
+  put32be(out, font.ascent);
+  put32be(out, font.descent);
+  for (const Glyph& g : font.glyphs) {
+    put32be(out, g.code);
+    put32be(out, g.height);
+    put32be(out, g.width);
+    put32be(out, g.xAdvance);
+    put32be(out, g.dY);
+    put32be(out, g.dX);
+    put32be(out, rle ? g.coded.size() : 0);
+  }
+  for (const Glyph& g : font.glyphs) out.insert(out.end(), g.coded.begin(), g.coded.end());
+  out.insert(out.end(), font.names.begin(), font.names.end());
+  return out;
+}
+
+static std::vector<uint8_t> inPlaceFont(const Font& font)
+{
+  // The values loadFont() would calculate from a vlw font
+  uint32_t count      = font.glyphs.size();
+  uint16_t ascent     = font.ascent;
+  uint16_t descent    = font.descent;
+  uint16_t maxDescent = descent;
+  for (const Glyph& g : font.glyphs) {
+    uint16_t code = g.code;
+    int16_t  dY   = g.dY;
+    if ((uint8_t)g.height - dY > maxDescent)
+      if ((code > 0x20 && code < 0xA0 && code != 0x7F) || code > 0xFF) maxDescent = (uint8_t)g.height - dY;
+  }
+  uint16_t maxAscent  = ascent;
+  uint16_t yAdvance   = maxAscent + maxDescent;
+  uint16_t spaceWidth = font.spaceWidth ? font.spaceWidth : (ascent + descent) * 2 / 7;
+
+  // Metric arrays, each padded to 4 bytes
+  const uint32_t headerSize = 56;
+  std::vector<uint8_t> body;
+  std::vector<uint32_t> offsets;
+  auto pad = [&]() { while (body.size() & 3) body.push_back(0); };
+
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) put16le(body, g.code);
+  pad();
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) body.push_back(g.height);
+  pad();
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) body.push_back(g.width);
+  pad();
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) body.push_back(g.xAdvance);
+  pad();
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) put16le(body, g.dY);
+  pad();
+  offsets.push_back(headerSize + body.size());
+  for (const Glyph& g : font.glyphs) body.push_back(g.dX);
+  pad();
+
+  uint32_t bitmapOffsets = headerSize + body.size();
+  uint32_t latin1Offset  = bitmapOffsets + 4 * count;
+  uint32_t pos           = latin1Offset + 512;
+
+  for (const Glyph& g : font.glyphs) { put32le(body, pos); pos += g.coded.size(); }
+  uint32_t bitmapEnd = pos;
+
+  std::vector<uint16_t> latin1(256, 0xFFFF);
+  for (uint32_t i = 0; i < count; i++) if (font.glyphs[i].code < 256) latin1[font.glyphs[i].code] = i;
+  for (uint16_t i : latin1) put16le(body, i);
+
+  for (const Glyph& g : font.glyphs) body.insert(body.end(), g.coded.begin(), g.coded.end());
+
+  std::vector<uint8_t> out;
+  put32le(out, 0x49574C56); // INPLACE_FONT_MAGIC
+  out.push_back(bits);
+  out.push_back(1);         // Sorted
+  put16le(out, count);
+  put16le(out, yAdvance);
+  put16le(out, spaceWidth);
+  put16le(out, ascent);
+  put16le(out, descent);
+  put16le(out, maxAscent);
+  put16le(out, maxDescent);
+  for (uint32_t o : offsets) put32le(out, o);
+  put32le(out, bitmapOffsets);
+  put32le(out, latin1Offset);
+  put32le(out, bitmapEnd);
+  out.insert(out.end(), body.begin(), body.end());
+  return out;
+}
+
+static void writeHeader(const std::string& output, const std::string& input, const std::string& kind,
+                        const std::vector<uint8_t>& font)
+{
+  std::string name = fs::path(output).stem().string();
+  for (char& c : name) if (!isalnum((uint8_t)c)) c = '_';
+  if (isdigit((uint8_t)name[0])) name = "_" + name;
+
+  FILE* f = fopen(output.c_str(), "w");
+  if (!f) fail("Cannot write " + output);
+  fprintf(f, "// %s smooth font generated by font_compiler from %s\n", kind.c_str(), fs::path(input).filename().string().c_str());
+  fprintf(f, "// Load with tft.loadFont(%s)\n\n", name.c_str());
+  fprintf(f, "#include <pgmspace.h>\n\n");
+  // In-place fonts are read as arrays of 16 and 32 bit values
+  fprintf(f, "alignas(4) const uint8_t %s[] PROGMEM = {\n", name.c_str());
+  for (size_t p = 0; p < font.size(); p += 16) {
+    fprintf(f, " ");
+    for (size_t i = p; i < p + 16 && i < font.size(); i++) fprintf(f, " 0x%02X,", font[i]);
+    fprintf(f, "\n");
+  }
+  fprintf(f, "};\n");
+  fclose(f);
+}
+
+static void usage(void)
+{
+  printf("usage: font_compiler [-v] font.vlw|font.h [-o out.vlw] [-f vlw|rle|inplace] [-b 8|4|2]\n"
+         "                     [-c chars] [-r first-last] [-s source]\n\n"
+         "  -o  output file, .h for a C header, default is the input name with _subset added\n"
+         "  -f  output format: vlw (default), rle (run length coded vlw) or inplace\n"
+         "  -b  bits of alpha per pixel: 8 (vlw default, inplace), 4 (rle default) or 2\n"
+         "  -c  characters to keep, UTF-8 encoded\n"
+         "  -r  range of character codes to keep, e.g. 0x30-0x39\n"
+         "  -s  keep the characters in the string literals of a source file, or of the\n"
+         "      .ino, .c, .cpp, .h and .hpp files in a directory and its sub-directories\n"
+         "  -v  list the glyphs written\n");
+}
+
+int main(int argc, char* argv[])
+{
+  std::string input, output, format = "vlw";
+  std::set<uint32_t> codes;
+  std::vector<std::pair<uint32_t, uint32_t>> ranges; // Kept as ranges, a range can span all of Unicode
+  bool subset = false;
+  int  bitsArg = 0;
+
+  // look at arguments
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    bool more = (i + 1 < argc);
+    if (a == "-v" || a == "--verbose") debug = true;
+    else if (a == "-h" || a == "--help") { usage(); return 0; }
+    else if (a == "-o" && more) output = argv[++i];
+    else if (a == "-f" && more) format = argv[++i];
+    else if (a == "-b" && more) bitsArg = atoi(argv[++i]);
+    else if (a == "-c" && more) { addUtf8(argv[++i], codes); subset = true; }
+    else if (a == "-s" && more) { scanPath(argv[++i], codes); subset = true; }
+    else if (a == "-r" && more) {
+      char* end;
+      uint32_t first = strtoul(argv[++i], &end, 0);
+      uint32_t last  = (*end == '-') ? strtoul(end + 1, &end, 0) : first;
+      if (*end || last < first || last > 0x10FFFF) fail(std::string("Bad range ") + argv[i]);
+      ranges.push_back({ first, last });
+      subset = true;
+    }
+    else if (a[0] != '-' && input.empty()) input = a;
+    else { usage(); return 1; }
+  }
+
+  if (input.empty()) { usage(); return 1; }
+  if (format != "vlw" && format != "rle" && format != "inplace") fail("The format must be vlw, rle or inplace");
+
+  bits = bitsArg ? bitsArg : (format == "rle" ? 4 : 8);
+  if (bits != 8 && bits != 4 && bits != 2) fail("The bits of alpha must be 8, 4 or 2");
+  if (format == "vlw" && bits != 8) fail("Use -f rle for 4 or 2 bit alpha");
+  if (format == "rle" && bits == 8) fail("Run length coded fonts have 4 or 2 bit alpha");
+
+  if (output.empty()) {
+    fs::path p(input);
+    output = (p.parent_path() / (p.stem().string() + "_subset")).string() + (format == "inplace" ? ".bin" : ".vlw");
+  }
+
+  Font font;
+  bool gfx = endsWith(input, ".h");
+  if (gfx) readGfx(input, font);
+  else     readVlw(input, font);
+  size_t inputCount = font.glyphs.size();
+
+  // Keep the requested glyphs, the first of a duplicated code, and sort into code order
+  std::vector<Glyph> kept;
+  std::set<uint32_t> found;
+  for (Glyph& g : font.glyphs) {
+    if (g.code > 0xFFFF || found.count(g.code)) continue; // The library uses 16 bit codes
+    bool inRange = false;
+    for (auto& r : ranges) if (g.code >= r.first && g.code <= r.second) inRange = true;
+    if (subset && !inRange && !codes.count(g.code)) continue;
+    found.insert(g.code);
+    kept.push_back(g);
+  }
+  std::stable_sort(kept.begin(), kept.end(), [](const Glyph& a, const Glyph& b) { return a.code < b.code; });
+  font.glyphs.swap(kept);
+
+  // Characters listed or found in the source that the font does not have
+  std::string missing;
+  for (uint32_t c : codes) {
+    if (found.count(c) || c == 0x20) continue; // vlw fonts often have no space, it is drawn without a glyph
+    char s[16];
+    snprintf(s, sizeof(s), " 0x%04X", c);
+    missing += s;
+  }
+  if (!missing.empty()) printf("Not in the font:%s\n", missing.c_str());
+  if (font.glyphs.empty()) fail("No glyphs to write");
+
+  size_t glyphBytes = 0;
+  for (Glyph& g : font.glyphs) {
+    g.coded = codeGlyph(g);
+    glyphBytes += g.coded.size();
+    if (debug) printf("glyph 0x%04X %dx%d %zu bytes\n", g.code, g.width, g.height, g.coded.size());
+  }
+
+  std::vector<uint8_t> out = (format == "inplace") ? inPlaceFont(font) : vlwFont(font, format == "rle");
+
+  if (endsWith(output, ".h")) {
+    writeHeader(output, input, format == "vlw" ? "Subset" : (format == "rle" ? "Run length coded" : "In-place"), out);
+  }
+  else {
+    FILE* f = fopen(output.c_str(), "wb");
+    if (!f || fwrite(out.data(), 1, out.size(), f) != out.size()) fail("Cannot write " + output);
+    fclose(f);
+  }
+
+  printf("Wrote %zu of %zu glyphs with %u bit alpha to %s, %zu bytes (%zu bytes of bitmaps)\n",
+         font.glyphs.size(), inputCount, bits, output.c_str(), out.size(), glyphBytes);
+
+  return 0;
+}
@@ -0,0 +1,290 @@
+/*
+  Replay of a Sprite allocation trace against the arena and pool allocators.
+
+  The trace is a run of screen changes, as a menu driven sketch makes:
+  each screen creates its Sprites, may open and close a pop up, then
+  deletes its Sprites in any order when the next screen is shown. The
+  same trace is followed by a model of each allocator, and every
+  createSprite() is checked against the offset, reuse, usage and
+  exhaustion the model predicts.
+
+  A recording allocator also checks that spriteSize() gives the bytes
+  createSprite() asks for.
+
+  A pool block freed twice must be returned once, so later allocations
+  get distinct blocks. An arena allocation freed below the top stays in
+  use until the top above it is freed and release() passes it.
+*/
+
+#include "host_test.h"
+
+// Passes requests to the heap and records the last size asked for
+class RecordingAllocator : public TFT_eSpriteAllocator {
+ public:
+  size_t last = 0;
+  void* allocate(size_t bytes) { last = bytes; return calloc(bytes, 1); }
+  void  deallocate(void* ptr)  { free(ptr); }
+};
+
+struct SpriteSpec { int16_t w, h; uint8_t bpp, frames; };
+
+static SpriteSpec randomSpec(void)
+{
+  static const uint8_t depths[] = { 16, 8, 4, 2, 1 };
+  SpriteSpec s;
+  s.w = 1 + rand() % 120;
+  s.h = 1 + rand() % 80;
+  s.bpp = depths[rand() % 5];
+  s.frames = (s.bpp == 1 && rand() % 4 == 0) ? 2 : 1;
+  return s;
+}
+
+static void* create(TFT_eSprite* spr, TFT_eSpriteAllocator* a, const SpriteSpec& s)
+{
+  spr->setColorDepth(s.bpp);
+  spr->setAllocator(a);
+  return spr->createSprite(s.w, s.h, s.frames);
+}
+
+static void checkSpriteSize(TFT_eSPI& tft)
+{
+  RecordingAllocator rec;
+  for (int i = 0; i < 2000; i++) {
+    SpriteSpec s = randomSpec();
+    TFT_eSprite spr(&tft);
+    create(&spr, &rec, s);
+    size_t want = TFT_eSpriteAllocator::spriteSize(s.w, s.h, s.bpp, s.frames);
+    CHECK(rec.last == want, "spriteSize(%d, %d, %d, %d) = %zu, createSprite() asked for %zu",
+          s.w, s.h, s.bpp, s.frames, want, rec.last);
+  }
+}
+
+// Model of the arena: each allocation is a 4 byte size word then the rounded Sprite size
+struct ArenaModel {
+  size_t size, top = 0, peak = 0;
+  std::vector<size_t> starts; // Offsets of live allocations in order, for unwinding
+
+  size_t available(void) { return (size - top < 4) ? 0 : (size - top - 4) & ~(size_t)3; }
+
+  // Offset of the Sprite memory, or -1 if the arena is exhausted
+  long allocate(size_t bytes) {
+    size_t r = (bytes + 3) & ~(size_t)3;
+    if (r > available()) return -1;
+    long off = top + 4;
+    top += r + 4;
+    if (top > peak) peak = top;
+    return off;
+  }
+
+  // Only the top allocation is freed at once
+  void deallocate(long off, size_t bytes) {
+    if (off + ((bytes + 3) & ~(size_t)3) == top) top = off - 4;
+  }
+};
+
+static void replayArena(TFT_eSPI& tft, size_t arenaSize, int screens, unsigned seed)
+{
+  std::vector<uint8_t> block(arenaSize);
+  TFT_eSpriteArena arena;
+  arena.begin(block.data(), block.size());
+  ArenaModel model;
+  model.size = arenaSize;
+
+  struct Live { TFT_eSprite* spr; long off; size_t bytes; };
+  int failed = 0, created = 0;
+  srand(seed);
+
+  auto make = [&](std::vector<Live>& live) {
+    SpriteSpec s = randomSpec();
+    size_t bytes = TFT_eSpriteAllocator::spriteSize(s.w, s.h, s.bpp, s.frames);
+    TFT_eSprite* spr = new TFT_eSprite(&tft);
+    uint8_t* ptr = (uint8_t*)create(spr, &arena, s);
+    long want = model.allocate(bytes);
+    if (want < 0) {
+      CHECK(ptr == nullptr && !spr->created(), "arena gave %zu bytes with %zu available", bytes, arena.available());
+      failed++;
+      delete spr;
+      return;
+    }
+    CHECK(ptr != nullptr, "arena refused %zu bytes with %zu available", bytes, arena.available());
+    if (!ptr) { delete spr; return; }
+    CHECK(ptr - block.data() == want, "Sprite at offset %ld, expected %ld", (long)(ptr - block.data()), want);
+    bool zero = true;
+    for (size_t i = 0; i < bytes; i++) zero &= (ptr[i] == 0);
+    CHECK(zero, "arena memory is not cleared");
+    spr->fillSprite(TFT_WHITE); // Dirty the memory so reuse must clear it
+    live.push_back({ spr, want, bytes });
+    created++;
+  };
+
+  auto remove = [&](std::vector<Live>& live, size_t k) {
+    delete live[k].spr;
+    model.deallocate(live[k].off, live[k].bytes);
+    live.erase(live.begin() + k);
+  };
+
+  for (int screen = 0; screen < screens; screen++) {
+    size_t mark = arena.mark();
+    CHECK(mark == model.top, "mark %zu, expected %zu", mark, model.top);
+
+    std::vector<Live> live;
+    int n = 1 + rand() % 6;
+    for (int i = 0; i < n; i++) make(live);
+
+    // A pop up is created and deleted straight away, so the arena unwinds
+    if (rand() % 2) {
+      size_t before = arena.used(), count = live.size();
+      make(live);
+      if (live.size() > count) {
+        remove(live, live.size() - 1);
+        CHECK(arena.used() == before, "pop up not unwound, used %zu expected %zu", arena.used(), before);
+      }
+    }
+
+    CHECK(arena.used() == model.top, "used %zu, expected %zu", arena.used(), model.top);
+    CHECK(arena.peak() == model.peak, "peak %zu, expected %zu", arena.peak(), model.peak);
+
+    // Leave the screen, Sprites are deleted in any order then the screen is released
+    while (!live.empty()) remove(live, rand() % live.size());
+    arena.release(mark);
+    model.top = mark;
+    CHECK(arena.used() == mark, "release to %zu left %zu used", mark, arena.used());
+  }
+
+  CHECK(arena.used() == 0, "%zu bytes still used at the end", arena.used());
+  printf("arena %6zu bytes: %4d screens, %4d Sprites created, %3d refused, peak %zu\n",
+         arenaSize, screens, created, failed, arena.peak());
+}
+
+// Model of the pool: a free list of block indexes, the last freed block is used first
+static void replayPool(TFT_eSPI& tft, uint16_t count, int steps, unsigned seed)
+{
+  SpriteSpec full = { 64, 40, 16, 1 };
+  size_t bytes = TFT_eSpriteAllocator::spriteSize(full.w, full.h, full.bpp);
+
+  TFT_eSpritePool pool;
+  pool.begin(bytes, count);
+  size_t blockSize = pool.blockSize();
+  CHECK(blockSize >= bytes && blockSize % sizeof(void*) == 0, "block size %zu for %zu bytes", blockSize, bytes);
+
+  std::vector<int> freeList;
+  for (int i = count - 1; i >= 0; i--) freeList.push_back(i);
+
+  struct Live { TFT_eSprite* spr; int block; };
+  std::vector<Live> live;
+  uint8_t* base = nullptr;
+  size_t peak = 0;
+  int refused = 0;
+  srand(seed);
+
+  for (int step = 0; step < steps; step++) {
+    if (rand() % 2) {
+      // Sprites smaller than a block also fit, larger ones must be refused
+      SpriteSpec s = full;
+      int kind = rand() % 8;
+      if (kind == 0) s.w = 80;
+      else if (kind == 1) { s.w = 20; s.bpp = 8; }
+
+      TFT_eSprite* spr = new TFT_eSprite(&tft);
+      uint8_t* ptr = (uint8_t*)create(spr, &pool, s);
+
+      if (kind == 0 || freeList.empty()) {
+        CHECK(ptr == nullptr, "pool gave a block for %s", kind == 0 ? "an oversize Sprite" : "a full pool");
+        refused++;
+        delete spr;
+        continue;
+      }
+      CHECK(ptr != nullptr, "pool refused a Sprite with %d blocks free", pool.available());
+      if (!ptr) { delete spr; continue; }
+
+      int block = freeList.back();
+      freeList.pop_back();
+      if (!base) base = ptr - block * blockSize;
+      CHECK(ptr == base + block * blockSize, "Sprite in block %ld, expected block %d",
+            (long)((ptr - base) / (long)blockSize), block);
+      CHECK(ptr[0] == 0 && ptr[bytes / 2] == 0, "pool block is not cleared");
+      spr->fillSprite(TFT_RED);
+      live.push_back({ spr, block });
+    }
+    else if (!live.empty()) {
+      size_t k = rand() % live.size();
+      delete live[k].spr;
+      freeList.push_back(live[k].block);
+      live.erase(live.begin() + k);
+    }
+
+    peak = max(peak, live.size() * blockSize);
+    CHECK(pool.used() == live.size() * blockSize, "used %zu, expected %zu", pool.used(), live.size() * blockSize);
+    CHECK(pool.available() == freeList.size(), "%d blocks free, expected %zu", pool.available(), freeList.size());
+  }
+
+  CHECK(pool.peak() == peak, "peak %zu, expected %zu", pool.peak(), peak);
+  for (auto& l : live) delete l.spr;
+  CHECK(pool.used() == 0 && pool.available() == count, "blocks not returned");
+  printf("pool  %6zu bytes: %4d steps, %d blocks of %zu, %3d refused, peak %zu\n",
+         count * blockSize, steps, count, blockSize, refused, pool.peak());
+}
+
+static void checkRepeatFree(void)
+{
+  TFT_eSpritePool pool;
+  pool.begin(64, 4);
+  void* a = pool.allocate(64);
+  void* b = pool.allocate(64);
+  pool.deallocate(a);
+  pool.deallocate(a);
+  CHECK(pool.available() == 3 && pool.used() == 64, "double free: %d blocks free, %zu used", pool.available(), pool.used());
+
+  void* c = pool.allocate(64);
+  void* d = pool.allocate(64);
+  void* e = pool.allocate(64);
+  CHECK(c && d && e && c != d && c != e && d != e && c != b && d != b && e != b,
+        "double free: blocks handed out twice %p %p %p %p", b, c, d, e);
+  CHECK(pool.allocate(64) == nullptr && pool.available() == 0, "double free: pool not full");
+
+  // Freeing a free block, in the middle of the free list, changes nothing
+  pool.deallocate(c);
+  pool.deallocate(d);
+  pool.deallocate(c);
+  CHECK(pool.available() == 2, "double free: %d blocks free, expected 2", pool.available());
+
+  TFT_eSpriteArena arena;
+  arena.begin(1024);
+  size_t mark = arena.mark();
+  void* p = arena.allocate(100);
+  void* q = arena.allocate(100);
+  size_t used = arena.used();
+  arena.deallocate(p);
+  CHECK(arena.used() == used, "arena reclaimed an allocation below the top");
+  arena.deallocate(q);
+  arena.deallocate(q);
+  CHECK(arena.used() == 104, "arena used %zu after freeing the top, expected 104", arena.used());
+  arena.release(mark);
+  CHECK(arena.used() == 0, "arena used %zu after release", arena.used());
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  checkSpriteSize(tft);
+  checkRepeatFree();
+
+  // A large arena never runs out, a small one is exhausted by some screens
+  replayArena(tft, 256 * 1024, 500, 1);
+  replayArena(tft, 12 * 1024,  500, 2);
+  replayArena(tft, 4096,       500, 3);
+
+  replayPool(tft, 8, 5000, 4);
+  replayPool(tft, 1, 500,  5);
+
+  // Arena and pool with no store refuse everything
+  TFT_eSpriteArena arena;
+  TFT_eSpritePool  pool;
+  TFT_eSprite spr(&tft);
+  CHECK(create(&spr, &arena, { 10, 10, 16, 1 }) == nullptr, "empty arena gave memory");
+  CHECK(create(&spr, &pool,  { 10, 10, 16, 1 }) == nullptr, "empty pool gave memory");
+
+  return testResult();
+}
@@ -0,0 +1,205 @@
+/*
+  TFT_eAlphaSprite and pushAlphaImage() checked against a pixel by pixel
+  reference.
+
+  Random 8 and 4 bit alpha Sprites are drawn with drawPixel() and
+  fillSprite() and each pixel must read back as drawn, rounded to the
+  nearest of 16 levels for 4 bits. Sprites made with createFromImage()
+  and createFromSprite() must hold the position of each colour between
+  the background and foreground colours, worked out here.
+
+  The alpha Sprites are pushed with pushTinted(), which calls
+  pushAlphaImage(), to the TFT and to 16 and 8 bpp Sprites, opaque on a
+  background colour and blended with the pixels already there, at random
+  positions, some partly or wholly off the edges, in and out of random
+  viewports. The reference reads each pixel, blends it as the coverage
+  says and draws it with drawPixel(). The pixels must match.
+
+  The alpha Sprite memory must come from the allocator set with
+  setAllocator() and go back to it on deleteSprite().
+*/
+
+#include "host_test.h"
+
+// Passes requests to the heap and counts the allocations still held
+class CountingAllocator : public TFT_eSpriteAllocator {
+ public:
+  int    live = 0;
+  size_t last = 0;
+  void* allocate(size_t bytes) { live++; last = bytes; return calloc(bytes, 1); }
+  void  deallocate(void* ptr)  { if (ptr) live--; free(ptr); }
+};
+
+// Coverage 0-255 stored for alpha a in a Sprite of bits per pixel
+static uint8_t stored(uint8_t a, int bits) { return (bits == 8) ? a : (a * 15 + 127) / 255 * 17; }
+
+// Position of colour c between bg and fg, channels as 6 bits
+static uint8_t coverage(uint16_t c, uint16_t fg, uint16_t bg)
+{
+  int f[3] = { (fg >> 11) * 2, (fg >> 5) & 0x3F, (fg & 0x1F) * 2 };
+  int b[3] = { (bg >> 11) * 2, (bg >> 5) & 0x3F, (bg & 0x1F) * 2 };
+  int p[3] = { (c >> 11) * 2,  (c >> 5) & 0x3F,  (c & 0x1F) * 2 };
+  int len = 0, dot = 0;
+  for (int i = 0; i < 3; i++) { len += (f[i] - b[i]) * (f[i] - b[i]); dot += (p[i] - b[i]) * (f[i] - b[i]); }
+  if (len == 0) return (c == fg) ? 255 : 0;
+  if (dot <= 0) return 0;
+  if (dot >= len) return 255;
+  return (dot * 255 + len / 2) / len;
+}
+
+// Colour of a pixel of coverage a blended on background colour under
+static uint16_t blend(uint8_t a, uint16_t fg, uint16_t under)
+{
+  return (a == 255) ? fg : (a == 0) ? under : fastBlend(a, fg, under);
+}
+
+static void randomAlpha(TFT_eAlphaSprite& as)
+{
+  uint8_t levels[4] = { 0, 255, (uint8_t)rand(), (uint8_t)rand() };
+  for (int y = 0; y < as.height(); y++)
+    for (int x = 0; x < as.width(); x++) as.drawPixel(x, y, rand() % 3 ? levels[rand() % 4] : rand());
+}
+
+static void checkPixels(TFT_eSPI& tft)
+{
+  int bad = 0;
+  for (int n = 0; n < 400; n++) {
+    int bits = (n & 1) ? 4 : 8;
+    TFT_eAlphaSprite as(&tft);
+    int w = 1 + rand() % 40, h = 1 + rand() % 40;
+    CHECK(as.createSprite(w, h, bits) && as.getAlphaDepth() == bits, "createSprite(%d, %d, %d) failed", w, h, bits);
+
+    uint8_t fill = rand();
+    as.fillSprite(fill);
+    std::vector<uint8_t> want(w * h, stored(fill, bits));
+    for (int i = rand() % 200; i > 0; i--) {
+      int x = rand() % (w + 4) - 2, y = rand() % (h + 4) - 2;
+      uint8_t a = rand();
+      as.drawPixel(x, y, a);
+      if (x >= 0 && y >= 0 && x < w && y < h) want[x + y * w] = stored(a, bits);
+    }
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++)
+        if (as.readPixel(x, y) != want[x + y * w] && bad++ < 10)
+          CHECK(false, "case %d %d bit %dx%d: pixel %d,%d is %d, expected %d", n, bits, w, h, x, y, as.readPixel(x, y), want[x + y * w]);
+
+    // From 16 bpp artwork and from a Sprite of the same pixels
+    uint16_t fg = rand(), bg = rand();
+    std::vector<uint16_t> image(w * h);
+    for (uint16_t& c : image) c = rand() % 2 ? (rand() % 2 ? fg : bg) : rand();
+    TFT_eSprite spr(&tft);
+    spr.createSprite(w, h);
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++) spr.drawPixel(x, y, image[x + y * w]);
+
+    for (int from = 0; from < 2; from++) {
+      TFT_eAlphaSprite made(&tft);
+      bool ok = from ? made.createFromSprite(&spr, bits, fg, bg) : made.createFromImage(image.data(), w, h, bits, fg, bg);
+      CHECK(ok, "case %d: create from %s failed", n, from ? "Sprite" : "image");
+      for (int i = 0; i < w * h; i++)
+        if (made.readPixel(i % w, i / w) != stored(coverage(image[i], fg, bg), bits) && bad++ < 10)
+          CHECK(false, "case %d %d bit from %s: colour %04X between %04X and %04X is %d, expected %d", n, bits,
+                from ? "Sprite" : "image", image[i], bg, fg, made.readPixel(i % w, i / w), stored(coverage(image[i], fg, bg), bits));
+    }
+  }
+  CHECK(bad == 0, "%d alpha Sprite pixels wrong", bad);
+}
+
+// Push alpha Sprites to the TFT (bpp 0) or a Sprite and compare with the reference
+static void checkPush(TFT_eSPI& tft, int bpp)
+{
+  TFT_eSprite dst(&tft);
+  if (bpp) { dst.setColorDepth(bpp); dst.createSprite(100, 80); }
+  TFT_eSPI& t = bpp ? (TFT_eSPI&)dst : tft;
+  int tw = bpp ? 100 : tft.width(), th = bpp ? 80 : tft.height();
+
+  int bad = 0;
+  for (int n = 0; n < 600; n++) {
+    int bits = (n & 1) ? 4 : 8;
+    TFT_eAlphaSprite as(&tft);
+    as.createSprite(1 + rand() % 50, 1 + rand() % 50, bits);
+    randomAlpha(as);
+
+    int32_t x = rand() % (tw + 40) - 40, y = rand() % (th + 40) - 40;
+    uint16_t fg = rand(), under = rand();
+    bool opaque = rand() % 2, vp = rand() % 2, datum = rand() % 2;
+    uint32_t bg = opaque ? (uint32_t)(uint16_t)rand() : 0x00FFFFFF;
+    int32_t vx = rand() % tw - 10, vy = rand() % th - 10, vw = 1 + rand() % tw, vh = 1 + rand() % th;
+
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      // A background of random pixels so blends read the right pixel
+      srand(n);
+      t.fillRect(0, 0, tw, th, under);
+      for (int i = 0; i < 300; i++) t.drawPixel(rand() % tw, rand() % th, rand());
+      if (vp) t.setViewport(vx, vy, vw, vh, datum);
+      if (pass) {
+        for (int j = 0; j < as.height(); j++)
+          for (int i = 0; i < as.width(); i++) {
+            uint8_t a = as.readPixel(i, j);
+            if (!opaque && a == 0) continue;
+            t.drawPixel(x + i, y + j, blend(a, fg, opaque ? bg : t.readPixel(x + i, y + j)));
+          }
+      }
+      else if (bpp) as.pushTinted(&dst, x, y, fg, bg);
+      else as.pushTinted(x, y, fg, bg);
+      t.resetViewport();
+      for (int j = 0; j < th; j++)
+        for (int i = 0; i < tw; i++) out[pass].push_back(bpp ? dst.readPixel(i, j) : panel.fb[i + j * HostPanel::W]);
+    }
+    srand(n + 1000);
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "%s case %d %d bit %dx%d at %d,%d opaque %d viewport %d datum %d differs", bpp ? "Sprite" : "TFT",
+            n, bits, as.width(), as.height(), x, y, opaque, vp, datum);
+  }
+  CHECK(bad == 0, "%s %d bpp: %d of 600 pushes differ", bpp ? "Sprite" : "TFT", bpp ? bpp : 16, bad);
+}
+
+static void checkAllocator(TFT_eSPI& tft)
+{
+  CountingAllocator count;
+  TFT_eAlphaSprite as(&tft);
+  CHECK(as.setAllocator(&count) && as.getAllocator() == &count, "setAllocator() refused");
+  CHECK(as.createSprite(33, 10, 4) && count.live == 1 && count.last == 17 * 10, "4 bit alpha Sprite not taken from the allocator");
+  CHECK(!as.setAllocator(nullptr), "allocator changed while created");
+  as.deleteSprite();
+  CHECK(count.live == 0, "alpha Sprite not returned to the allocator");
+  CHECK(as.createFromSprite(nullptr) == false && count.live == 0, "allocation for a missing Sprite");
+
+  // Alpha Sprites and Sprites share an arena and unwind it in turn
+  TFT_eSpriteArena arena;
+  arena.begin(4096);
+  TFT_eAlphaSprite a1(&tft), a2(&tft);
+  a1.setAllocator(&arena);
+  a2.setAllocator(&arena);
+  uint8_t* p1 = (uint8_t*)a1.createSprite(20, 10);
+  CHECK(arena.used() == 4 + 200, "arena used %zu for an 8 bit 20x10 alpha Sprite", arena.used());
+  a1.fillSprite(200);
+  a2.createSprite(7, 3, 4);
+  CHECK(arena.used() == 204 + 4 + 12, "arena used %zu for a 4 bit 7x3 alpha Sprite", arena.used());
+  a2.deleteSprite();
+  a1.deleteSprite();
+  CHECK(arena.used() == 0, "arena not unwound, %zu used", arena.used());
+
+  // Memory from the arena is cleared
+  uint8_t* p2 = (uint8_t*)a1.createSprite(20, 10);
+  bool zero = true;
+  for (int i = 0; i < 200; i++) zero &= (p2[i] == 0);
+  CHECK(p1 == p2 && zero, "arena memory not reused and cleared");
+  a1.deleteSprite();
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  srand(1);
+  checkPixels(tft);
+  checkPush(tft, 0);
+  checkPush(tft, 16);
+  checkPush(tft, 8);
+  checkAllocator(tft);
+
+  return testResult();
+}
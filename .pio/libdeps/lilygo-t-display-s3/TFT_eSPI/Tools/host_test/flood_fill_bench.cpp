@@ -0,0 +1,182 @@
+/*
+  Benchmark and check of the Sprite flood fill on a 320 x 170 maze.
+
+  A random maze is drawn at each colour depth, and at each rotation for
+  1 bpp, then the area connected to a corner cell is filled. The result
+  is checked against a breadth first search done with readPixel(), then
+  floodFill() is timed against the same search done with drawPixel(),
+  which is how a sketch would fill a region without the library.
+*/
+
+#include "host_test.h"
+
+#define WIDTH  320
+#define HEIGHT 170
+#define CELL   6
+
+static uint8_t spanStack[16 * 1024];
+
+// A perfect maze of CELL pixel cells, so the paths form one winding region
+static void drawMaze(TFT_eSprite& spr, uint32_t wall, uint32_t path, unsigned seed)
+{
+  int32_t cw = (spr.width() - 1) / CELL, ch = (spr.height() - 1) / CELL;
+  std::vector<bool> visited(cw * ch);
+  std::vector<int32_t> stack;
+
+  srand(seed);
+  spr.fillSprite(wall);
+  stack.push_back(0);
+  visited[0] = true;
+
+  while (!stack.empty()) {
+    int32_t c = stack.back(), cx = c % cw, cy = c / cw;
+    spr.fillRect(cx * CELL + 1, cy * CELL + 1, CELL - 1, CELL - 1, path);
+
+    int32_t next[4], n = 0;
+    if (cx > 0      && !visited[c - 1])  next[n++] = c - 1;
+    if (cx < cw - 1 && !visited[c + 1])  next[n++] = c + 1;
+    if (cy > 0      && !visited[c - cw]) next[n++] = c - cw;
+    if (cy < ch - 1 && !visited[c + cw]) next[n++] = c + cw;
+    if (n == 0) { stack.pop_back(); continue; }
+
+    // Open the wall between this cell and a random unvisited neighbour
+    int32_t d = next[rand() % n], dx = d % cw, dy = d / cw;
+    spr.fillRect(min(cx, dx) * CELL + 1, min(cy, dy) * CELL + 1,
+                 (cx != dx) ? 2 * CELL - 1 : CELL - 1, (cy != dy) ? 2 * CELL - 1 : CELL - 1, path);
+    visited[d] = true;
+    stack.push_back(d);
+  }
+}
+
+// Speckle the paths with a colour close to the path colour, only a tolerance fill crosses it
+static void addNoise(TFT_eSprite& spr, uint16_t path, uint16_t speck)
+{
+  for (int i = 0; i < 2000; i++) {
+    int32_t x = rand() % spr.width(), y = rand() % spr.height();
+    if (spr.readPixel(x, y) == path) spr.drawPixel(x, y, speck);
+  }
+}
+
+// Pixels connected to x, y whose colour is accepted by match()
+template <typename Match> static std::vector<bool> reachable(TFT_eSprite& spr, int32_t x, int32_t y, Match match)
+{
+  int32_t w = spr.width(), h = spr.height();
+  std::vector<bool> seen(w * h);
+  std::queue<int32_t> q;
+  q.push(y * w + x);
+  seen[y * w + x] = true;
+  while (!q.empty()) {
+    int32_t p = q.front(); q.pop();
+    int32_t px = p % w, py = p / w;
+    const int32_t nb[4][2] = { {px + 1, py}, {px - 1, py}, {px, py + 1}, {px, py - 1} };
+    for (auto& n : nb) {
+      if (n[0] < 0 || n[1] < 0 || n[0] >= w || n[1] >= h) continue;
+      int32_t k = n[1] * w + n[0];
+      if (!seen[k] && match(spr.readPixel(n[0], n[1]))) { seen[k] = true; q.push(k); }
+    }
+  }
+  return seen;
+}
+
+// Flood fill written the way a sketch would do it, a queue of pixels
+static void pixelFill(TFT_eSprite& spr, int32_t x, int32_t y, uint32_t color)
+{
+  uint16_t seed = spr.readPixel(x, y);
+  int32_t w = spr.width(), h = spr.height();
+  std::queue<int32_t> q;
+  q.push(y * w + x);
+  spr.drawPixel(x, y, color);
+  while (!q.empty()) {
+    int32_t p = q.front(); q.pop();
+    int32_t px = p % w, py = p / w;
+    const int32_t nb[4][2] = { {px + 1, py}, {px - 1, py}, {px, py + 1}, {px, py - 1} };
+    for (auto& n : nb) {
+      if (n[0] < 0 || n[1] < 0 || n[0] >= w || n[1] >= h) continue;
+      if (spr.readPixel(n[0], n[1]) != seed) continue;
+      spr.drawPixel(n[0], n[1], color);
+      q.push(n[1] * w + n[0]);
+    }
+  }
+}
+
+static void run(TFT_eSPI& tft, uint8_t depth, uint8_t rotation, bool noise)
+{
+  TFT_eSprite spr(&tft);
+  spr.setColorDepth(depth);
+  // readPixel() of a rotated 1 bpp Sprite is only right when it is square
+  spr.createSprite(rotation ? HEIGHT : WIDTH, HEIGHT);
+
+  // Colours are palette indexes at 4 bpp and 0 or 1 at 1 bpp
+  uint32_t wall = TFT_WHITE, path = TFT_BLACK, fill = TFT_RED;
+  if (depth == 4) { spr.createPalette(default_4bit_palette); wall = 15; path = 0; fill = 2; }
+  if (depth == 1) { spr.setBitmapColor(TFT_WHITE, TFT_BLACK); spr.setRotation(rotation); wall = 1; path = 0; fill = 1; }
+
+  unsigned seed = depth * 4 + rotation;
+  int32_t sx = CELL / 2, sy = CELL / 2;
+
+  auto draw = [&]() { drawMaze(spr, wall, path, seed); if (noise) addNoise(spr, TFT_BLACK, 0x2104); };
+
+  // Check against the reference search
+  draw();
+  uint16_t seedColor = spr.readPixel(sx, sy);
+  auto near = [&](uint16_t c) {
+    if (!noise) return c == seedColor;
+    uint8_t a[3], b[3];
+    a[0] = (c >> 8) & 0xF8; a[1] = (c >> 3) & 0xFC; a[2] = (c << 3) & 0xF8;
+    b[0] = (seedColor >> 8) & 0xF8; b[1] = (seedColor >> 3) & 0xFC; b[2] = (seedColor << 3) & 0xF8;
+    for (int i = 0; i < 3; i++) if (abs(a[i] - b[i]) > 40) return false;
+    return true;
+  };
+  std::vector<bool> want = reachable(spr, sx, sy, near);
+  int32_t w = spr.width(), h = spr.height();
+  std::vector<uint16_t> before(w * h);
+  for (int32_t y = 0; y < h; y++) for (int32_t x = 0; x < w; x++) before[y * w + x] = spr.readPixel(x, y);
+
+  bool ok = noise ? spr.floodFillTolerance(sx, sy, fill, 40, spanStack, sizeof(spanStack))
+                  : spr.floodFill(sx, sy, fill, spanStack, sizeof(spanStack));
+  CHECK(ok, "%d bpp: span stack overflow", depth);
+
+  uint16_t filled = spr.readPixel(sx, sy);
+  int32_t bad = 0, count = 0;
+  for (int32_t y = 0; y < h; y++) for (int32_t x = 0; x < w; x++) {
+    bool in = want[y * w + x];
+    count += in;
+    if (spr.readPixel(x, y) != (in ? filled : before[y * w + x])) bad++;
+  }
+  CHECK(bad == 0, "%d bpp rotation %d: %d pixels differ from the reference fill", depth, rotation, bad);
+
+  // Time the fills, the maze is restored from a copy before each one
+  draw();
+  size_t bytes = (depth == 1) ? ((w + 7) / 8) * h : (size_t)w * h * depth / 8;
+  std::vector<uint8_t> maze((uint8_t*)spr.getPointer(), (uint8_t*)spr.getPointer() + bytes);
+  auto restore = [&]() { memcpy(spr.getPointer(), maze.data(), bytes); };
+
+  double tCopy  = timeIt(restore, 50);
+  double tFill  = timeIt([&]() {
+    restore();
+    if (noise) spr.floodFillTolerance(sx, sy, fill, 40, spanStack, sizeof(spanStack));
+    else       spr.floodFill(sx, sy, fill, spanStack, sizeof(spanStack));
+  }, 50) - tCopy;
+  double tPixel = noise ? 0 : timeIt([&]() { restore(); pixelFill(spr, sx, sy, fill); }, 10) - tCopy;
+
+  printf("%2d bpp %-11s %3d x %3d, %5d pixels filled: floodFill %7.1f us", depth,
+         noise ? "tolerance" : (rotation ? (std::string("rotation ") + std::to_string(rotation)).c_str() : ""),
+         w, h, count, tFill * 1e6);
+  if (!noise) printf("  pixel queue %8.1f us", tPixel * 1e6);
+  printf("\n");
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  run(tft, 16, 0, false);
+  run(tft, 16, 0, true);
+  run(tft, 8,  0, false);
+  run(tft, 8,  0, true);
+  run(tft, 4,  0, false);
+  for (uint8_t r = 0; r < 4; r++) run(tft, 1, r, false);
+
+  return testResult();
+}
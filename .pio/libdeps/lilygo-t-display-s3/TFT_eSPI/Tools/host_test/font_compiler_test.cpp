@@ -0,0 +1,192 @@
+/*
+  Tools/font_compiler checked against Tools/vlw_compress/vlw_compress.py
+  and against the fonts it is given. font_compiler is built here with g++
+  and python3 is needed for vlw_compress.py.
+
+  Whole example fonts converted by both tools to run length coded and
+  in-place fonts, at each alpha depth, must be byte identical, and the
+  vlw output of font_compiler must be the input font.
+
+  Subset fonts, kept with a character list and with a code range, must
+  hold only those glyphs and draw text the same as the whole font, on
+  the TFT in each format. A range that does not fit Unicode is refused.
+
+  GFX font headers converted to smooth fonts must draw the same pixels
+  with loadFont() as the GFX font does with setFreeFont().
+*/
+
+#include <string>
+#include <sys/stat.h>
+#include "host_test.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+static std::string dir = "/tmp/tft_font_compiler_test";
+
+static bytes_t readFile(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  return bytes_t(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static bool run(const std::string& cmd)
+{
+  return system((cmd + " > /dev/null").c_str()) == 0;
+}
+
+static bool compile(const std::string& in, const std::string& out, const std::string& options)
+{
+  return run(dir + "/font_compiler \"" + in + "\" -o " + out + " " + options);
+}
+
+static const char* text[] = {
+  "Hello World 0123456789",
+  "The quick brown fox jumps over the lazy dog",
+  "{}~ 25\xC2\xB0 \xC3\xA9\xC3\xA8\xC3\xA0 \xE3\x81\x82\xE3\x81\x84",
+};
+
+// Text drawn with the font loaded, transparent and with the background filled
+static std::vector<uint16_t> draw(TFT_eSPI& tft, const uint8_t* font)
+{
+  tft.loadFont(font);
+  tft.fillScreen(TFT_DARKGREEN);
+  for (int t = 0; t < 3; t++) {
+    tft.setTextColor(TFT_YELLOW, TFT_NAVY, t == 1);
+    tft.drawString(text[t], 5, 5 + t * tft.fontHeight());
+  }
+  tft.unloadFont();
+  return std::vector<uint16_t>(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+}
+
+static void checkWhole(const char* path, const char* name)
+{
+  struct { const char* format; int bits; } outputs[] = {
+    { "vlw", 4 }, { "vlw", 2 }, { "inplace", 8 }, { "inplace", 4 }, { "inplace", 2 },
+  };
+  for (auto& o : outputs) {
+    char options[64];
+    snprintf(options, sizeof(options), "-f %s -b %d", o.format, o.bits);
+    bool py = run("python3 Tools/vlw_compress/vlw_compress.py \"" + std::string(path) + "\" -o " + dir + "/py.bin " + options);
+
+    // font_compiler calls the run length coded vlw format rle
+    snprintf(options, sizeof(options), "-f %s -b %d", strcmp(o.format, "vlw") ? o.format : "rle", o.bits);
+    bool fc = compile(path, dir + "/fc.bin", options);
+
+    CHECK(py && fc, "%s %s %d bit: conversion failed", name, o.format, o.bits);
+    CHECK(readFile(dir + "/py.bin") == readFile(dir + "/fc.bin"), "%s %s %d bit: font_compiler output differs from vlw_compress.py",
+          name, o.format, o.bits);
+  }
+
+  CHECK(compile(path, dir + "/fc.vlw", "") && readFile(dir + "/fc.vlw") == readFile(path),
+        "%s: vlw output differs from the input font", name);
+}
+
+static void checkSubset(TFT_eSPI& tft, const char* path, const char* name)
+{
+  std::string chars;
+  for (const char* t : text) chars += t;
+
+  struct { const char* options; const char* python; } formats[] = {
+    { "-f vlw",             nullptr },
+    { "-f rle -b 4",        "-b 4" },
+    { "-f inplace -b 8",    "-f inplace -b 8" },
+    { "-f inplace -b 2",    "-f inplace -b 2" },
+  };
+
+  for (auto& f : formats) {
+    // The whole font in the same format
+    std::string whole = path;
+    if (f.python) {
+      whole = dir + "/whole.bin";
+      run("python3 Tools/vlw_compress/vlw_compress.py \"" + std::string(path) + "\" -o " + whole + " " + f.python);
+    }
+    bytes_t full = readFile(whole);
+    std::vector<uint16_t> ref = draw(tft, full.data());
+
+    CHECK(compile(path, dir + "/subset.bin", std::string(f.options) + " -c \"" + chars + "\""), "%s %s: subset failed", name, f.options);
+    bytes_t subset = readFile(dir + "/subset.bin");
+    CHECK(draw(tft, subset.data()) == ref, "%s %s: subset text differs from the whole font", name, f.options);
+
+    // Only the glyphs of the text are kept
+    tft.loadFont(subset.data());
+    uint16_t count = tft.gFont.gCount;
+    tft.loadFont(full.data());
+    int want = 0;
+    for (uint32_t c = 0x20; c < 0x10000; c++) {
+      uint16_t g;
+      if (!tft.getUnicodeIndex(c, &g)) continue;
+      bool used = false;
+      for (const char* t : text) {
+        uint16_t n = 0, len = strlen(t);
+        while (n < len) if (tft.decodeUTF8((uint8_t*)t, &n, len - n) == c) used = true;
+      }
+      if (used) want++;
+    }
+    tft.unloadFont();
+    CHECK(count == want, "%s %s: subset has %u glyphs, the text uses %d", name, f.options, count, want);
+
+    // A range up to the end of Unicode keeps every glyph
+    CHECK(compile(path, dir + "/range.bin", std::string(f.options) + " -r 0x0-0x10FFFF") && readFile(dir + "/range.bin") == full,
+          "%s %s: whole range differs from the whole font", name, f.options);
+  }
+
+  CHECK(!compile(path, dir + "/range.bin", "-r 0x20-0xFFFFFFFF 2> /dev/null"), "%s: range past 0x10FFFF accepted", name);
+}
+
+// The vlw formats draw a space at the width the library calculates, only in-place fonts keep
+// the GFX space width
+static const char* gfxText[] = { "Hello,World!", "jumpy{Qz}~01", "Hello World" };
+
+static void checkGfx(TFT_eSPI& tft, const char* header, const GFXfont* gfx)
+{
+  const char* name = strrchr(header, '/') + 1;
+  for (const char* options : { "-f vlw", "-f inplace -b 8", "-f rle -b 2" }) {
+    CHECK(compile(header, dir + "/gfx.bin", options), "%s %s: conversion failed", name, options);
+    bytes_t font = readFile(dir + "/gfx.bin");
+
+    for (int t = 0; t < (strstr(options, "inplace") ? 3 : 2); t++) {
+      tft.fillScreen(TFT_DARKGREEN);
+      tft.setFreeFont(gfx);
+      tft.setTextColor(TFT_YELLOW);
+      tft.drawString(gfxText[t], 5, 40);
+      std::vector<uint16_t> ref(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+      tft.setFreeFont(nullptr);
+
+      tft.fillScreen(TFT_DARKGREEN);
+      tft.loadFont(font.data());
+      tft.drawString(gfxText[t], 5, 40);
+      tft.unloadFont();
+      CHECK(memcmp(ref.data(), panel.fb, ref.size() * 2) == 0, "%s %s: \"%s\" differs from setFreeFont()", name, options, gfxText[t]);
+    }
+  }
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  mkdir(dir.c_str(), 0755);
+  if (!run("g++ -std=c++17 -O2 -o " + dir + "/font_compiler Tools/font_compiler/font_compiler.cpp")) {
+    CHECK(false, "font_compiler did not build");
+    return testResult();
+  }
+
+  const char* fonts[] = {
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold15.vlw",
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold36.vlw",
+    "examples/Smooth Fonts/SPIFFS/Unicode_test/data/Latin-Hiragana-24.vlw",
+  };
+
+  for (const char* path : fonts) {
+    const char* name = strrchr(path, '/') + 1;
+    checkWhole(path, name);
+    checkSubset(tft, path, name);
+  }
+
+  checkGfx(tft, "Fonts/GFXFF/FreeSans12pt7b.h", &FreeSans12pt7b);
+  checkGfx(tft, "Fonts/GFXFF/FreeSerifBoldItalic18pt7b.h", &FreeSerifBoldItalic18pt7b);
+  checkGfx(tft, "Fonts/GFXFF/FreeMono9pt7b.h", &FreeMono9pt7b);
+
+  return testResult();
+}
@@ -0,0 +1,207 @@
+/*
+  Checks of Sprite freeze() and thaw() with the heap, an arena and a pool.
+
+  Random 16 and 8 bpp Sprites of flat areas and noise are frozen, pushed
+  to the TFT and thawed. The pushed pixels must match those pushed before
+  freezing and the thawed Sprite memory must match the original.
+
+  The frozen copy must come from the allocator passed to freeze(), or
+  the heap, and go back to it: a counting allocator checks every
+  allocate() has a matching deallocate(). The Sprite memory must go back
+  to its arena or pool while frozen, so the arena unwinds to where it was
+  before the Sprite was created and a pool of one block per Sprite has
+  every block free once all its Sprites are frozen.
+*/
+
+#include <vector>
+#include "host_test.h"
+
+// Passes requests to the heap and counts the allocations still held
+class CountingAllocator : public TFT_eSpriteAllocator {
+ public:
+  int    live = 0;
+  size_t last = 0;
+  void* allocate(size_t bytes) { live++; last = bytes; return calloc(bytes, 1); }
+  void  deallocate(void* ptr)  { if (ptr) live--; free(ptr); }
+};
+
+// Draw flat areas, lines and a patch of noise so rows have both runs and literals
+static void drawContent(TFT_eSprite& spr, int w, int h)
+{
+  spr.fillSprite(rand() & 0xFFFF);
+  for (int i = rand() % 6; i > 0; i--)
+    spr.fillRect(rand() % w, rand() % h, 1 + rand() % w, 1 + rand() % h, rand() & 0xFFFF);
+  for (int i = rand() % 6; i > 0; i--)
+    spr.drawLine(rand() % w, rand() % h, rand() % w, rand() % h, rand() & 0xFFFF);
+  int nx = rand() % w, ny = rand() % h, nw = rand() % 40, nh = rand() % 20;
+  for (int y = ny; y < ny + nh && y < h; y++)
+    for (int x = nx; x < nx + nw && x < w; x++) spr.drawPixel(x, y, rand() & 0xFFFF);
+}
+
+static std::vector<uint8_t> spriteBytes(TFT_eSprite& spr, int bpp)
+{
+  uint8_t* p = (uint8_t*)spr.getPointer();
+  size_t n = (size_t)spr.width() * spr.height() * (bpp / 8);
+  return std::vector<uint8_t>(p, p + n);
+}
+
+static std::vector<uint16_t> panelArea(int x, int y, int w, int h)
+{
+  std::vector<uint16_t> v;
+  for (int j = y; j < y + h; j++)
+    for (int i = x; i < x + w; i++) v.push_back(panel.pixel(i, j));
+  return v;
+}
+
+// Freeze, push and thaw one random Sprite and compare with the unfrozen Sprite
+static void checkRoundTrip(TFT_eSPI& tft, TFT_eSpriteAllocator* a, int seed, TFT_eSpriteAllocator* f = nullptr)
+{
+  srand(seed);
+  int bpp = (rand() & 1) ? 16 : 8;
+  int w = 1 + rand() % 200, h = 1 + rand() % 150;
+  bool transparent = rand() % 3 == 0;
+  uint16_t transp = rand() & 0xFFFF;
+
+  TFT_eSprite spr(&tft);
+  spr.setColorDepth(bpp);
+  spr.setAllocator(a);
+  if (!spr.createSprite(w, h)) { CHECK(false, "seed %d: createSprite(%d, %d) failed", seed, w, h); return; }
+  drawContent(spr, w, h);
+  if (transparent) transp = spr.readPixel(rand() % w, rand() % h);
+
+  std::vector<uint8_t> before = spriteBytes(spr, bpp);
+  tft.fillScreen(TFT_BLACK);
+  if (transparent) spr.pushSprite(0, 0, transp); else spr.pushSprite(0, 0);
+  std::vector<uint16_t> pushed = panelArea(0, 0, w, h);
+
+  if (!spr.freeze(f)) { CHECK(false, "seed %d: freeze failed", seed); return; }
+  CHECK(spr.setAllocator(nullptr) == false, "seed %d: allocator changed while frozen", seed);
+
+  tft.fillScreen(TFT_BLACK);
+  if (transparent) spr.pushSprite(0, 0, transp); else spr.pushSprite(0, 0);
+  CHECK(panelArea(0, 0, w, h) == pushed, "seed %d: frozen %d bpp %dx%d Sprite pushed differently", seed, bpp, w, h);
+
+  CHECK(spr.thaw(), "seed %d: thaw failed", seed);
+  CHECK(spriteBytes(spr, bpp) == before, "seed %d: thawed %d bpp %dx%d Sprite differs", seed, bpp, w, h);
+  spr.deleteSprite();
+}
+
+static void checkCounting(TFT_eSPI& tft)
+{
+  // Frozen copies from the allocator passed to freeze(), Sprite memory from another
+  CountingAllocator sprites, frozen;
+  for (int seed = 1; seed <= 300; seed++) checkRoundTrip(tft, (seed & 1) ? &sprites : nullptr, seed, &frozen);
+  CHECK(sprites.live == 0 && frozen.live == 0, "%d Sprite and %d frozen allocations not returned", sprites.live, frozen.live);
+
+  // The Sprite memory is returned on freeze(), the frozen copy on deleteSprite() without a thaw
+  TFT_eSprite spr(&tft);
+  spr.setAllocator(&sprites);
+  spr.createSprite(50, 40);
+  spr.fillSprite(TFT_RED);
+  CHECK(spr.freeze(&frozen), "freeze of a flat Sprite failed");
+  CHECK(sprites.live == 0, "Sprite memory held while frozen");
+  CHECK(frozen.live == 1 && frozen.last == 40 * sizeof(uint32_t) + 40 * 4,
+        "frozen copy not taken from the freeze() allocator (%d live, last %zu bytes)", frozen.live, frozen.last);
+  spr.deleteSprite();
+  CHECK(frozen.live == 0, "frozen copy not returned on deleteSprite()");
+
+  // With no allocator passed the frozen copy is not taken from the Sprite allocator
+  spr.createSprite(50, 40);
+  CHECK(spr.freeze() && sprites.live == 0, "frozen copy taken from the Sprite allocator");
+  CHECK(spr.thaw() && sprites.live == 1, "thawed Sprite not taken from the Sprite allocator");
+  spr.deleteSprite();
+  CHECK(sprites.live == 0, "Sprite memory not returned");
+}
+
+static void checkArena(TFT_eSPI& tft)
+{
+  TFT_eSpriteArena arena;
+  arena.begin(400000);
+  size_t mark = arena.mark();
+  for (int seed = 301; seed <= 400; seed++) {
+    checkRoundTrip(tft, &arena, seed);
+    CHECK(arena.used() == mark, "seed %d: arena used %zu, expected %zu", seed, arena.used(), mark);
+  }
+
+  // Screens of Sprites frozen in turn: each freeze unwinds the top Sprite, so the arena
+  // empties, and the frozen copies are packed in a second arena
+  TFT_eSpriteArena frozenArena;
+  frozenArena.begin(100000);
+  TFT_eSprite spr[5] = { TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft) };
+  size_t sprites = 0;
+  for (TFT_eSprite& s : spr) {
+    s.setAllocator(&arena);
+    s.createSprite(100, 20);
+    s.fillSprite(TFT_BLUE);
+    sprites = arena.used();
+  }
+  for (int i = 4; i >= 0; i--) {
+    CHECK(spr[i].freeze(&frozenArena), "arena freeze failed");
+    CHECK(arena.used() == mark + i * (sprites - mark) / 5, "arena used %zu after %d freezes", arena.used(), 5 - i);
+  }
+  CHECK(arena.used() == mark && frozenArena.used() == 5 * (4 + 20 * 4 + 20 * 4),
+        "arena used %zu of %zu, frozen arena %zu", arena.used(), sprites, frozenArena.used());
+  printf("Arena: 5 Sprites use %zu bytes, frozen %zu bytes\n", sprites - mark, frozenArena.used());
+
+  // Thawed in the same order the arena holds them as before, frozen copies unwind too
+  for (int i = 0; i < 5; i++) CHECK(spr[i].thaw() && spr[i].readPixel(99, 19) == TFT_BLUE, "arena thaw failed");
+  CHECK(arena.used() == sprites && frozenArena.used() == 0, "after thaw arena used %zu, frozen arena %zu",
+        arena.used(), frozenArena.used());
+  for (int i = 4; i >= 0; i--) spr[i].deleteSprite();
+  CHECK(arena.used() == mark, "arena not unwound");
+  arena.end();
+}
+
+static void checkPool(TFT_eSPI& tft)
+{
+  size_t block = TFT_eSpriteAllocator::spriteSize(120, 60, 16);
+
+  // A pool of 4 blocks holding 4 Sprites has them all free once the Sprites are frozen
+  TFT_eSpritePool pool;
+  pool.begin(block, 4);
+  TFT_eSprite spr[4] = { TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft) };
+  std::vector<uint8_t> before[4];
+  for (int i = 0; i < 4; i++) {
+    spr[i].setAllocator(&pool);
+    spr[i].createSprite(120, 60);
+    spr[i].fillSprite(TFT_GREEN);
+    spr[i].fillRect(10 * i, 10, 30, 30, TFT_YELLOW);
+    before[i] = spriteBytes(spr[i], 16);
+  }
+  CHECK(pool.available() == 0, "pool has %d blocks free, expected 0", pool.available());
+  for (int i = 0; i < 4; i++) CHECK(spr[i].freeze(), "pool freeze failed with no spare block");
+  CHECK(pool.available() == 4 && pool.used() == 0, "pool has %d blocks free while frozen, expected 4", pool.available());
+  printf("Pool: 4 Sprites use %zu bytes, none while frozen\n", 4 * pool.blockSize());
+
+  // A block taken while frozen leaves one Sprite that cannot thaw until it is returned
+  TFT_eSprite other(&tft);
+  other.setAllocator(&pool);
+  other.createSprite(120, 60);
+  for (int i = 0; i < 3; i++) CHECK(spr[i].thaw() && spriteBytes(spr[i], 16) == before[i], "pool thaw differs");
+  CHECK(!spr[3].thaw() && spr[3].frozen(), "thaw with the pool full succeeded");
+  other.deleteSprite();
+  CHECK(spr[3].thaw() && spriteBytes(spr[3], 16) == before[3], "pool thaw differs");
+  for (TFT_eSprite& s : spr) s.deleteSprite();
+  CHECK(pool.available() == 4, "pool blocks not all returned");
+  pool.end();
+
+  for (int seed = 401; seed <= 500; seed++) {
+    pool.begin(TFT_eSpriteAllocator::spriteSize(200, 150, 16), 1);
+    checkRoundTrip(tft, &pool, seed);
+    CHECK(pool.available() == 1, "seed %d: pool block not returned", seed);
+    pool.end();
+  }
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  for (int seed = 1; seed <= 300; seed++) checkRoundTrip(tft, nullptr, seed);
+  checkCounting(tft);
+  checkArena(tft);
+  checkPool(tft);
+
+  return testResult();
+}
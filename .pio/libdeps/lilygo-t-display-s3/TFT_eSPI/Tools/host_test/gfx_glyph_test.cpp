@@ -0,0 +1,194 @@
+/*
+  GFX free font glyphs drawn as merged runs, checked against the bit by
+  bit walk drawGfxGlyph() replaced.
+
+  OldTFT and OldSprite override drawGfxGlyph() with the old walk, which
+  draws each run of set bits in a row with drawFastHLine() at size 1 and
+  with fillRect() when scaled. Random characters of several fonts are
+  drawn by drawChar() with random colours, sizes and positions, some off
+  screen, on the TFT and in Sprites of each colour depth, rotated 1 bpp
+  Sprites included, in and out of viewports with and without the datum
+  moved. Each draw must give the same pixels as the old walk.
+
+  The windows set on the TFT for "12.8" in FreeSansBold24pt7b at sizes 1
+  to 3 and the time to draw it in a 16 bpp Sprite at size 3 are printed
+  for both.
+*/
+
+#include "host_test.h"
+
+// The glyph drawing before runs were merged, one call per run per row
+static void oldGlyph(TFT_eSPI& t, int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap,
+                     uint32_t color, uint8_t size)
+{
+  uint32_t bo = glyph->bitmapOffset;
+  uint8_t  w = glyph->width, h = glyph->height;
+  int8_t   xo = glyph->xOffset, yo = glyph->yOffset;
+  uint8_t  xx, yy, bits = 0, bit = 0;
+  int16_t  xo16 = 0, yo16 = 0;
+  if (size > 1) { xo16 = xo; yo16 = yo; }
+
+  uint16_t hpc = 0; // Horizontal foreground pixel count
+  for (yy = 0; yy < h; yy++) {
+    for (xx = 0; xx < w; xx++) {
+      if (bit == 0) {
+        bits = bitmap[bo++];
+        bit  = 0x80;
+      }
+      if (bits & bit) hpc++;
+      else if (hpc) {
+        if (size == 1) t.drawFastHLine(x + xo + xx - hpc, y + yo + yy, hpc, color);
+        else t.fillRect(x + (xo16 + xx - hpc) * size, y + (yo16 + yy) * size, size * hpc, size, color);
+        hpc = 0;
+      }
+      bit >>= 1;
+    }
+    if (hpc) {
+      if (size == 1) t.drawFastHLine(x + xo + xx - hpc, y + yo + yy, hpc, color);
+      else t.fillRect(x + (xo16 + xx - hpc) * size, y + (yo16 + yy) * size, size * hpc, size, color);
+      hpc = 0;
+    }
+  }
+}
+
+class OldTFT : public TFT_eSPI {
+  void drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint32_t color, uint8_t size)
+  { oldGlyph(*this, x, y, glyph, bitmap, color, size); }
+};
+
+class OldSprite : public TFT_eSprite {
+ public:
+  OldSprite(TFT_eSPI *tft) : TFT_eSprite(tft) {}
+ private:
+  void drawGfxGlyph(int32_t x, int32_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint32_t color, uint8_t size)
+  { oldGlyph(*this, x, y, glyph, bitmap, color, size); }
+};
+
+static const GFXfont* fonts[] = { &FreeSans9pt7b, &FreeSansBold24pt7b, &FreeSerifItalic12pt7b,
+                                  &FreeMonoBold18pt7b, &TomThumb };
+
+// A random character drawn the same way, in a random viewport half the time
+struct Draw {
+  const GFXfont* font;
+  uint16_t c;
+  int32_t  x, y, vx, vy, vw, vh;
+  uint8_t  size;
+  bool     vp, datum;
+  uint32_t color;
+
+  Draw(int w, int h, int bpp)
+  {
+    font  = fonts[rand() % 5];
+    c     = 0x20 + rand() % 96;
+    size  = 1 + rand() % 4;
+    x     = rand() % (w + 60) - 50;
+    y     = rand() % (h + 60) - 10;
+    vp    = rand() % 2;
+    datum = rand() % 2;
+    vx    = rand() % w - 10;
+    vy    = rand() % h - 10;
+    vw    = 1 + rand() % w;
+    vh    = 1 + rand() % h;
+    color = (bpp == 4) ? rand() % 16 : (bpp == 1) ? rand() % 2 : rand() & 0xFFFF;
+  }
+
+  void operator()(TFT_eSPI& t) const
+  {
+    t.setFreeFont(font);
+    if (vp) t.setViewport(vx, vy, vw, vh, datum);
+    t.drawChar(x, y, c, color, color, size);
+    t.resetViewport();
+  }
+};
+
+static void checkTFT(TFT_eSPI& tft, TFT_eSPI& ref)
+{
+  int bad = 0;
+  for (int n = 0; n < 3000; n++) {
+    Draw d(HostPanel::W, HostPanel::H, 16);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      TFT_eSPI& t = pass ? ref : tft;
+      t.fillScreen(TFT_DARKGREEN);
+      d(t);
+      out[pass].assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "TFT case %d: '%c' size %d at %d,%d viewport %d datum %d differs", n, d.c, d.size, d.x, d.y, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "TFT: %d of 3000 characters differ", bad);
+}
+
+static void checkSprite(TFT_eSPI& tft, int bpp, uint8_t rotation)
+{
+  TFT_eSprite spr(&tft);
+  OldSprite   ref(&tft);
+  for (TFT_eSprite* s : { &spr, (TFT_eSprite*)&ref }) {
+    s->setColorDepth(bpp);
+    s->createSprite(120, 120);
+    s->setRotation(rotation);
+  }
+
+  int bad = 0;
+  for (int n = 0; n < 2000; n++) {
+    Draw d(120, 120, bpp);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      TFT_eSprite& s = pass ? (TFT_eSprite&)ref : spr;
+      s.fillSprite(bpp == 1 ? 0 : TFT_DARKGREEN);
+      d(s);
+      for (int y = 0; y < 120; y++)
+        for (int x = 0; x < 120; x++) out[pass].push_back(s.readPixel(x, y));
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "%d bpp rotation %d case %d: '%c' size %d at %d,%d viewport %d datum %d differs",
+            bpp, rotation, n, d.c, d.size, d.x, d.y, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "%d bpp rotation %d: %d of 2000 characters differ", bpp, rotation, bad);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  OldTFT   ref;
+  tft.init();
+
+  srand(1);
+  checkTFT(tft, ref);
+  for (int bpp : { 16, 8, 4, 1 }) checkSprite(tft, bpp, 0);
+  checkSprite(tft, 1, 1);
+
+  // Windows set on the TFT for a reading at each size
+  long windows[2] = { 0, 0 };
+  for (int pass = 0; pass < 2; pass++) {
+    TFT_eSPI& t = pass ? ref : tft;
+    t.setFreeFont(&FreeSansBold24pt7b);
+    t.setTextColor(TFT_WHITE);
+    for (uint8_t size = 1; size <= 3; size++) {
+      t.fillScreen(TFT_BLACK);
+      t.setTextSize(size);
+      long w = panel.windows;
+      t.drawString("12.8", 0, 0);
+      windows[pass] += panel.windows - w;
+      printf("\"12.8\" FreeSansBold24pt7b size %d: %-8s %3ld windows\n", size, pass ? "old walk" : "runs", panel.windows - w);
+    }
+    t.setTextSize(1);
+  }
+  CHECK(windows[0] < windows[1], "runs set %ld windows, the old walk %ld", windows[0], windows[1]);
+  printf("Sizes 1 to 3: %ld windows with runs, %ld with the old walk\n", windows[0], windows[1]);
+
+  TFT_eSprite spr(&tft);
+  OldSprite   old(&tft);
+  for (TFT_eSprite* s : { &spr, (TFT_eSprite*)&old }) {
+    s->setColorDepth(16);
+    s->createSprite(240, 120);
+    s->setFreeFont(&FreeSansBold24pt7b);
+    s->setTextColor(TFT_WHITE);
+    s->setTextSize(3);
+  }
+  double tNew = timeIt([&] { for (int i = 0; i < 1000; i++) spr.drawString("12.8", 0, 0); }) / 1000;
+  double tOld = timeIt([&] { for (int i = 0; i < 1000; i++) old.drawString("12.8", 0, 0); }) / 1000;
+  printf("\"12.8\" size 3 in a 16 bpp Sprite: %.2f us with runs, %.2f us with the old walk\n", tNew * 1e6, tOld * 1e6);
+
+  return testResult();
+}
@@ -0,0 +1,241 @@
+/*
+  Checks of the smooth font glyph cache against a model of a least
+  recently used cache, with fonts read from vlw files through the fs::FS
+  stand-in.
+
+  Random glyphs are read into the cache with prefetchGlyphs(). After each
+  the model gives the glyphs that must be cached, the most and least
+  recently used, and whether the font file must be read. Cached bitmaps
+  are compared with the file. Some reads are made to fail: the glyph is
+  then not cached and, if the cache was full, the least recently used slot
+  is left empty to be reused first.
+
+  Text drawn with a failed cache read must fall back to reading the glyph
+  row by row and look the same as text drawn without the cache.
+
+  Two font handles are then selected in turn. Selecting the same font again
+  must keep the cache, handles with their own caches must keep their
+  glyphs while the other font is selected, and handles sharing the TFT
+  cache must read their glyphs again after each switch. The text must look
+  the same in all cases.
+*/
+
+#include <list>
+#include <string>
+#include "host_test.h"
+
+static std::string utf8(uint16_t c)
+{
+  std::string s;
+  if (c < 0x80) s += char(c);
+  else if (c < 0x800) { s += char(0xC0 | c >> 6); s += char(0x80 | (c & 0x3F)); }
+  else { s += char(0xE0 | c >> 12); s += char(0x80 | ((c >> 6) & 0x3F)); s += char(0x80 | (c & 0x3F)); }
+  return s;
+}
+
+// Bitmap bytes of a glyph read directly from the font file
+static std::vector<uint8_t> fileBitmap(const std::string& path, uint32_t pos, size_t bytes)
+{
+  std::vector<uint8_t> b(bytes);
+  std::ifstream f(path, std::ios::binary);
+  f.seekg(pos);
+  f.read((char*)b.data(), bytes);
+  return b;
+}
+
+// Cache contents in use order, -1 for a slot left empty by a failed read
+typedef std::list<int> lruModel;
+
+static void checkModel(TFT_eSPI& tft, const std::string& path, const lruModel& m, const char* name, int step)
+{
+  int cached = 0;
+  for (uint16_t i = 0; i < tft.gFont.gCount; i++) if (tft.gCache->slotOf[i]) cached++;
+  int expected = 0;
+  for (int g : m) if (g >= 0) expected++;
+  CHECK(cached == expected, "%s step %d: %d glyphs cached, model has %d", name, step, cached, expected);
+
+  for (int g : m) {
+    if (g < 0) continue;
+    CHECK(tft.gCache->slotOf[g] != 0, "%s step %d: glyph %d not cached", name, step, g);
+    if (!tft.gCache->slotOf[g]) continue;
+    const uint8_t* p = tft.gCache->bits + (tft.gCache->slotOf[g] - 1) * tft.gCache->slotSize;
+    size_t bytes = tft.gWidth[g] * tft.gHeight[g];
+    CHECK(memcmp(p, fileBitmap(path, tft.gBitmap[g], bytes).data(), bytes) == 0,
+          "%s step %d: cached bitmap of glyph %d differs from the file", name, step, g);
+  }
+
+  if (m.empty()) return;
+  uint16_t mru = tft.gCache->slot[tft.gCache->mru].glyph, lru = tft.gCache->slot[tft.gCache->lru].glyph;
+  CHECK(mru == (uint16_t)m.front() && lru == (uint16_t)m.back(),
+        "%s step %d: most/least recently used glyphs %d/%d, model %d/%d", name, step,
+        mru == 0xFFFF ? -1 : mru, lru == 0xFFFF ? -1 : lru, m.front(), m.back());
+}
+
+static void checkLRU(TFT_eSPI& tft, const char* dir, const char* font, size_t cacheBytes, uint32_t seed)
+{
+  srand(seed);
+  std::string path = std::string(dir) + "/" + font + ".vlw";
+  char name[64];
+  snprintf(name, sizeof(name), "%s cache %zu", font, cacheBytes);
+
+  SPIFFS.root = dir;
+  tft.setGlyphCache(cacheBytes);
+  tft.loadFont(font);
+  CHECK(tft.fontLoaded, "%s: font not loaded", name);
+  if (!tft.fontLoaded) return;
+
+  size_t slots = tft.gCache->slots;
+  lruModel m;
+
+  for (int step = 0; step < 3000; step++) {
+    // Favour a few glyphs so there are hits at all cache sizes
+    uint16_t g = (rand() % 3 == 0) ? rand() % 8 : rand() % tft.gFont.gCount;
+    uint16_t code = tft.gUnicode[g];
+    if (code < 0x21) continue;
+    tft.getUnicodeIndex(code, &g); // First glyph of a duplicated code
+
+    bool hit = false;
+    for (int x : m) if (x == g) hit = true;
+    bool fail = !hit && rand() % 10 == 0;
+    bool blank = tft.gWidth[g] * tft.gHeight[g] == 0;
+
+    long reads = SPIFFS.count.reads;
+    SPIFFS.count.failRead = fail ? reads + 1 : 0;
+    tft.prefetchGlyphs(utf8(code).c_str());
+    SPIFFS.count.failRead = 0;
+
+    // Without a cache prefetchGlyphs() does nothing
+    long wantReads = (slots == 0 || hit || blank) ? 0 : 1;
+    CHECK(SPIFFS.count.reads - reads == wantReads, "%s step %d: glyph %u read %ld times, expected %ld",
+          name, step, g, SPIFFS.count.reads - reads, wantReads);
+
+    if (slots == 0) continue;
+    if (fail && !blank) {
+      // A full cache loses its least recently used glyph and the slot is reused next
+      if (m.size() == slots) m.back() = -1;
+    }
+    else {
+      if (hit) m.remove(g);
+      else if (m.size() == slots) m.pop_back();
+      m.push_front(g);
+    }
+    checkModel(tft, path, m, name, step);
+  }
+
+  tft.unloadFont();
+  tft.setGlyphCache(0);
+}
+
+// Draw text with the cache, failing the read of the first glyph, and without the cache
+static void checkFallback(TFT_eSPI& tft, const char* dir, const char* font, const char* text)
+{
+  SPIFFS.root = dir;
+  std::vector<uint16_t> ref;
+
+  for (int pass = 0; pass < 2; pass++) {
+    tft.setGlyphCache(pass ? 20000 : 0);
+    tft.loadFont(font);
+    tft.fillScreen(TFT_NAVY);
+    tft.setTextColor(TFT_YELLOW, TFT_NAVY);
+
+    uint16_t first = 0;
+    tft.getUnicodeIndex((uint8_t)text[0], &first);
+    long reads = SPIFFS.count.reads;
+    if (pass) SPIFFS.count.failRead = reads + 1;
+    tft.drawString(text, 10, 20);
+    SPIFFS.count.failRead = 0;
+
+    if (pass == 0) ref.assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    else {
+      CHECK(memcmp(ref.data(), panel.fb, ref.size() * 2) == 0, "%s: text with a failed cache read differs", font);
+      CHECK(tft.gCache->slotOf[first] == 0, "%s: glyph with a failed read was cached", font);
+      // The glyph was drawn from rows read one at a time
+      CHECK(SPIFFS.count.reads - reads > (long)strlen(text), "%s: failed cache read did not fall back to rows", font);
+
+      // It is cached when next drawn
+      reads = SPIFFS.count.reads;
+      tft.drawString(text, 10, 60);
+      CHECK(tft.gCache->slotOf[first] != 0, "%s: glyph not cached after a failed read", font);
+      CHECK(SPIFFS.count.reads - reads == 1, "%s: %ld reads to draw after a failed read, expected 1",
+            font, SPIFFS.count.reads - reads);
+    }
+    tft.unloadFont();
+  }
+  tft.setGlyphCache(0);
+}
+
+// Draw with two font handles in turn, returning the file reads made after the first round
+static long alternate(TFT_eSPI& tft, const char* dir, bool own, std::vector<uint16_t>& pixels)
+{
+  SPIFFS.root = dir;
+  TFT_eSmoothFont a(&tft), b(&tft);
+  a.load("NotoSansBold15");
+  b.load("NotoSansBold36");
+  tft.setFont(nullptr);
+  tft.setGlyphCache(20000);
+  if (own) { a.setGlyphCache(20000); b.setGlyphCache(40000); }
+
+  long reads = 0;
+  for (int round = 0; round < 4; round++) {
+    if (round == 1) reads = SPIFFS.count.reads;
+    tft.fillScreen(TFT_NAVY);
+    tft.setTextColor(TFT_YELLOW, TFT_NAVY);
+
+    tft.setFont(&a);
+    tft.drawString("Hello World", 10, 20);
+    tft.setFont(&a);
+    uint32_t layout = tft.gCache->font;
+    tft.drawString("Hello again", 10, 40);
+    CHECK(tft.gCache->font == layout, "selecting the same font again laid the cache out");
+
+    tft.setFont(&b);
+    tft.drawString("Quick brown fox", 10, 60);
+  }
+  reads = SPIFFS.count.reads - reads;
+  pixels.assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+
+  tft.setFont(nullptr);
+  tft.setGlyphCache(0);
+  return reads;
+}
+
+static void checkHandles(const char* dir)
+{
+  TFT_eSPI tft;
+  tft.init();
+  std::vector<uint16_t> shared, own;
+  long sharedReads = alternate(tft, dir, false, shared);
+  long ownReads    = alternate(tft, dir, true, own);
+
+  CHECK(shared == own, "text drawn with font handle caches differs");
+  CHECK(ownReads == 0, "%ld reads with font handle caches after the first round, expected 0", ownReads);
+  // Both fonts are read again after each switch: 7 glyphs in "Hello World", 4 more in
+  // "Hello again" and 12 in "Quick brown fox"
+  CHECK(sharedReads == 3 * (7 + 4 + 12), "%ld reads with a shared cache after the first round, expected %d",
+        sharedReads, 3 * (7 + 4 + 12));
+  printf("Three rounds of two font handles: %ld file reads sharing the TFT cache, %ld with their own caches\n",
+         sharedReads, ownReads);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  const char* demo    = "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data";
+  const char* unicode = "examples/Smooth Fonts/SPIFFS/Unicode_test/data";
+
+  uint32_t seed = 1;
+  for (size_t bytes : { 0, 64, 300, 2000, 5000, 100000 }) {
+    checkLRU(tft, demo, "NotoSansBold15", bytes, seed++);
+    checkLRU(tft, demo, "NotoSansBold36", bytes * 4, seed++);
+    checkLRU(tft, unicode, "Latin-Hiragana-24", bytes * 2, seed++);
+  }
+
+  checkFallback(tft, demo, "NotoSansBold15", "Hello World");
+  checkFallback(tft, demo, "NotoSansBold36", "Quick brown fox");
+
+  checkHandles(demo);
+
+  return testResult();
+}
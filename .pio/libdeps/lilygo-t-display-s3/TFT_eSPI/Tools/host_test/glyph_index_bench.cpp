@@ -0,0 +1,111 @@
+/*
+  Smooth font glyph look up with the index built by loadFont(), checked
+  against a linear search of gUnicode[] and timed against it.
+
+  A vlw font of 7095 glyphs (ASCII, Latin-1 and 7000 CJK codes) is made
+  in memory with the glyphs in code order, shuffled, and shuffled with
+  duplicated codes. getUnicodeIndex() must give the same glyph as the
+  linear search, the first of a duplicated code, for every 16 bit code.
+
+  textWidth() of random CJK text is then timed in glyphs per second with
+  the index, and with the tables removed so the linear search is used,
+  as it is when loadFont() cannot allocate them.
+*/
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include "host_test.h"
+
+static void put32(std::vector<uint8_t>& v, uint32_t x)
+{
+  v.push_back(x >> 24); v.push_back(x >> 16); v.push_back(x >> 8); v.push_back(x);
+}
+
+// A vlw font with a 2 x 2 glyph for each code
+static std::vector<uint8_t> makeFont(const std::vector<uint16_t>& codes)
+{
+  std::vector<uint8_t> v;
+  put32(v, codes.size()); put32(v, 11); put32(v, 20); put32(v, 0); put32(v, 15); put32(v, 4);
+  for (uint16_t c : codes) { put32(v, c); put32(v, 2); put32(v, 2); put32(v, 3); put32(v, 2); put32(v, 0); put32(v, 0); }
+  for (size_t i = 0; i < codes.size() * 4; i++) v.push_back(255);
+  for (int k = 0; k < 5; k++) v.push_back(k == 4);
+  return v;
+}
+
+static bool linearIndex(TFT_eSPI& tft, uint16_t code, uint16_t* index)
+{
+  for (uint16_t i = 0; i < tft.gFont.gCount; i++)
+    if (tft.gUnicode[i] == code) { *index = i; return true; }
+  return false;
+}
+
+static void checkIndex(TFT_eSPI& tft, const char* name)
+{
+  for (uint32_t code = 0; code < 0x10000; code++) {
+    uint16_t a = 0xEEEE, b = 0xEEEE;
+    bool fa = tft.getUnicodeIndex(code, &a), fb = linearIndex(tft, code, &b);
+    CHECK(fa == fb && (!fa || a == b), "%s font: code 0x%04X gives %d/%u, linear search %d/%u", name, code, fa, a, fb, b);
+  }
+}
+
+// textWidth() of the text in glyphs per second
+static double glyphRate(TFT_eSPI& tft, const std::string& text, int glyphs, int runs)
+{
+  volatile int16_t w = 0;
+  double t = timeIt([&] { for (int i = 0; i < runs; i++) w = w + tft.textWidth(text.c_str()); });
+  return glyphs * runs / t;
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+  std::mt19937 rng(1);
+
+  std::vector<uint16_t> codes;
+  for (uint16_t c = 0x20; c < 0x7F; c++) codes.push_back(c);
+  for (uint16_t c = 0xA0; c < 0x100; c++) codes.push_back(c);
+  for (uint16_t c = 0x4E00; c < 0x4E00 + 7000; c++) codes.push_back(c);
+
+  std::vector<uint16_t> shuffled = codes;
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+  std::vector<uint16_t> duplicated = codes;
+  for (int k = 0; k < 300; k++) duplicated.push_back(codes[rng() % codes.size()]);
+  std::shuffle(duplicated.begin(), duplicated.end(), rng);
+
+  const char* names[] = { "sorted", "shuffled", "duplicated" };
+  std::vector<uint16_t>* sets[] = { &codes, &shuffled, &duplicated };
+
+  // 1000 random CJK glyphs as UTF-8
+  std::string text;
+  for (int i = 0; i < 1000; i++) {
+    uint16_t c = 0x4E00 + rng() % 7000;
+    text += char(0xE0 | c >> 12); text += char(0x80 | ((c >> 6) & 0x3F)); text += char(0x80 | (c & 0x3F));
+  }
+
+  for (int n = 0; n < 3; n++) {
+    std::vector<uint8_t> font = makeFont(*sets[n]);
+    tft.loadFont(font.data());
+    CHECK(tft.gLatin1 != NULL && (tft.gSorted || tft.gOrder != NULL), "%s font: glyph tables not built", names[n]);
+    checkIndex(tft, names[n]);
+
+    double indexed = glyphRate(tft, text, 1000, 200);
+
+    // Remove the tables as when they cannot be allocated
+    uint16_t* latin1 = tft.gLatin1;
+    uint16_t* order  = tft.gOrder;
+    bool      sorted = tft.gSorted;
+    tft.gLatin1 = NULL; tft.gOrder = NULL; tft.gSorted = false;
+    double linear = glyphRate(tft, text, 1000, 5);
+    tft.gLatin1 = latin1; tft.gOrder = order; tft.gSorted = sorted;
+
+    printf("%-10s %5u glyphs: textWidth() indexed %6.2fM glyphs/s  linear search %6.2fM glyphs/s\n",
+           names[n], tft.gFont.gCount, indexed / 1e6, linear / 1e6);
+    tft.unloadFont();
+  }
+
+  return testResult();
+}
@@ -0,0 +1,269 @@
+/*
+  Gradient colour table, line maths and Sprite depths.
+
+  The 256 entry table built from random stops is checked against the
+  colours interpolated in double precision, rounded to 8 bits.
+
+  For each 8 bit channel value and each number of levels a gradient line
+  keeps (565, 332 and one bit), a flat line is rounded to the nearest
+  level without dither, and with dither the mean level over the 4x4 matrix
+  must be within 1/16 of a level of the exact value, so the dither neither
+  brightens nor darkens. A flat gradient of a 565 colour must give that
+  colour without dither and stay within a level of it with dither.
+
+  Random linear and radial gradients, with and without dither, are filled
+  on the TFT and in 16, 8, 4, 2 and 1 bpp Sprites, rotated 1 bpp included,
+  in random viewports. The TFT must match the 16 bpp Sprite. Without
+  dither each 4 and 2 bpp pixel must be the nearest palette colour of the
+  16 bpp pixel and each 1 bpp pixel the nearer bitmap colour. A dithered
+  black to white gradient in a 1 bpp Sprite must set the share of bits in
+  each 4x4 block the grey level asks for.
+*/
+
+#include <cmath>
+#include "host_test.h"
+
+class GradTFT : public TFT_eSPI {
+ public:
+  using TFT_eSPI::gradient_t;
+  using TFT_eSPI::gradientTable;
+  using TFT_eSPI::gradientLine;
+};
+
+// 565 channel expanded to 8 bits, as gradientTable() does it
+static int expand(uint16_t c, int ch)
+{
+  if (ch == 0) return ((c >> 8) & 0xF8) | (c >> 13);
+  if (ch == 1) return ((c >> 3) & 0xFC) | ((c >> 9) & 0x03);
+  return ((c << 3) & 0xF8) | ((c >> 2) & 0x07);
+}
+
+static void checkTable(GradTFT& tft)
+{
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    uint8_t count = 1 + rand() % 5;
+    gradientStop_t stops[5];
+    for (int i = 0; i < count; i++) { stops[i].pos = rand(); stops[i].color = rand(); }
+    for (int i = 1; i < count; i++)
+      for (int j = i; j > 0 && stops[j].pos < stops[j - 1].pos; j--) std::swap(stops[j], stops[j - 1]);
+
+    GradTFT::gradient_t g;
+    tft.gradientTable(&g, stops, count, false);
+
+    for (int i = 0; i < 256; i++) {
+      int s = 0;
+      while (s < count && stops[s].pos < i) s++;
+      for (int ch = 0; ch < 3; ch++) {
+        double want;
+        if (s == 0) want = expand(stops[0].color, ch);
+        else if (s == count) want = expand(stops[count - 1].color, ch);
+        else {
+          double f = (double)(i - stops[s - 1].pos) / (stops[s].pos - stops[s - 1].pos);
+          want = expand(stops[s - 1].color, ch) + (expand(stops[s].color, ch) - expand(stops[s - 1].color, ch)) * f;
+        }
+        int got = (g.lut[i] >> (16 - 8 * ch)) & 0xFF;
+        if (fabs(got - want) > 0.501 && bad++ < 10)
+          CHECK(false, "table case %d entry %d channel %d: %d, want %.4f", n, i, ch, got, want);
+      }
+    }
+  }
+  CHECK(bad == 0, "table: %d entries are not rounded to the nearest step", bad);
+}
+
+// Level of a channel in a 565 colour for a gradient keeping 8 - d bits
+static int level(uint16_t c, int ch, int d)
+{
+  if (ch == 0) return (c >> 11) >> (5 - (8 - d));
+  if (ch == 1) return ((c >> 5) & 0x3F) >> (6 - (8 - d));
+  return (c & 0x1F) >> (5 - (8 - d));
+}
+
+static void checkLine(GradTFT& tft)
+{
+  GradTFT::gradient_t g;
+  g.radial = false;
+  g.x0 = g.y0 = 0;
+  g.t0 = 0x8000;
+  g.dtx = g.dty = 0; // Every pixel reads lut[128]
+
+  int bad = 0;
+  double worst = 0;
+  const uint8_t drop[][3] = { { 3, 2, 3 }, { 5, 5, 6 }, { 7, 7, 7 } };
+  for (auto& d : drop) {
+    g.dr = d[0]; g.dg = d[1]; g.db = d[2];
+    for (int c = 0; c < 256; c++) {
+      g.lut[128] = c << 16 | c << 8 | c;
+      for (int dither = 0; dither < 2; dither++) {
+        g.dither = dither;
+        double sum[3] = { 0, 0, 0 };
+        for (int y = 0; y < 4; y++) {
+          uint16_t buf[4];
+          tft.gradientLine(&g, buf, 0, y, 4);
+          for (int i = 0; i < 4; i++)
+            for (int ch = 0; ch < 3; ch++) {
+              int lv = level(buf[i], ch, d[ch]);
+              sum[ch] += lv;
+              double exact = c * (255 >> d[ch]) / 255.0;
+              if (!dither && fabs(lv - exact) > 0.5 + 1e-9 && bad++ < 10)
+                CHECK(false, "line %d,%d,%d bits dropped, channel %d value %d: level %d, want %.3f", d[0], d[1], d[2], ch, c, lv, exact);
+            }
+        }
+        for (int ch = 0; ch < 3; ch++) {
+          double err = sum[ch] / 16 - c * (255 >> d[ch]) / 255.0;
+          if (dither) worst = max(worst, fabs(err));
+          if (dither && fabs(err) > 1.0 / 16 && bad++ < 10)
+            CHECK(false, "dither %d,%d,%d bits dropped, channel %d value %d: mean level off by %.3f", d[0], d[1], d[2], ch, c, err);
+        }
+      }
+    }
+  }
+
+  // A flat 565 colour is kept, or dithered to the levels either side
+  g.dr = 3; g.dg = 2; g.db = 3;
+  for (int n = 0; n < 1000; n++) {
+    gradientStop_t stop = { 0, (uint16_t)rand() };
+    tft.gradientTable(&g, &stop, 1, n & 1);
+    g.t0 = rand() % 0x10000;
+    uint16_t buf[8];
+    for (int y = 0; y < 4; y++) {
+      tft.gradientLine(&g, buf, 0, y, 8);
+      for (int i = 0; i < 8; i++)
+        for (int ch = 0; ch < 3; ch++) {
+          int diff = abs(level(buf[i], ch, ch == 1 ? 2 : 3) - level(stop.color, ch, ch == 1 ? 2 : 3));
+          if ((diff > (n & 1)) && bad++ < 10) CHECK(false, "flat colour %04X dither %d: %04X", stop.color, n & 1, buf[i]);
+        }
+    }
+  }
+
+  CHECK(bad == 0, "line: %d levels or colours wrong", bad);
+  printf("Dithered mean level at most %.4f from the exact level\n", worst);
+}
+
+// Distinct random colours
+static std::vector<uint16_t> palette(int n)
+{
+  std::vector<uint16_t> p;
+  while ((int)p.size() < n) {
+    uint16_t c = rand();
+    bool dup = false;
+    for (uint16_t q : p) dup |= (q == c);
+    if (!dup) p.push_back(c);
+  }
+  return p;
+}
+
+// Index of the nearest colour, as the Sprite class picks it
+static uint8_t nearest(const std::vector<uint16_t>& pal, uint16_t color)
+{
+  int32_t  r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+  uint32_t best = 0xFFFFFFFF;
+  uint8_t  index = 0;
+  for (size_t i = 0; i < pal.size(); i++) {
+    int32_t  dr = (pal[i] >> 11) - r, dg = ((pal[i] >> 5) & 0x3F) - g, db = (pal[i] & 0x1F) - b;
+    uint32_t d = 4 * dr * dr + dg * dg + 4 * db * db;
+    if (d < best) { best = d; index = i; }
+  }
+  return index;
+}
+
+struct Fill {
+  bool     radial, dither, vp, datum;
+  int32_t  x, y, w, h, cx, cy, r, vx, vy, vw, vh;
+  int16_t  angle;
+  uint8_t  n;
+  gradientStop_t stops[4];
+
+  Fill(bool dither) : dither(dither)
+  {
+    radial = rand() % 2;
+    x  = rand() % 100 - 20; y = rand() % 100 - 20;
+    w  = 1 + rand() % 100;  h = 1 + rand() % 100;
+    cx = rand() % 80;       cy = rand() % 80; r = 1 + rand() % 80;
+    angle = rand() % 360;
+    n  = 1 + rand() % 4;
+    for (int i = 0; i < n; i++) { stops[i].pos = i * 255 / max(n - 1, 1); stops[i].color = rand(); }
+    vp = rand() % 2; datum = rand() % 2;
+    vx = rand() % 80 - 10; vy = rand() % 80 - 10; vw = 1 + rand() % 80; vh = 1 + rand() % 80;
+  }
+
+  void operator()(TFT_eSPI& t) const
+  {
+    if (vp) t.setViewport(vx, vy, vw, vh, datum);
+    if (radial) t.fillRectRadialGradient(x, y, w, h, cx, cy, r, stops, n, dither);
+    else t.fillRectLinearGradient(x, y, w, h, angle, stops, n, dither);
+    t.resetViewport();
+  }
+};
+
+static void checkDepths(TFT_eSPI& tft)
+{
+  TFT_eSprite s16(&tft), s8(&tft), s4(&tft), s2(&tft), s1(&tft), r1(&tft);
+  TFT_eSprite* all[] = { &s16, &s8, &s4, &s2, &s1, &r1 };
+  const int depth[] = { 16, 8, 4, 2, 1, 1 };
+  for (int i = 0; i < 6; i++) { all[i]->setColorDepth(depth[i]); all[i]->createSprite(80, 80); }
+  std::vector<uint16_t> p4 = palette(16), p2 = palette(4);
+  s4.createPalette(p4.data(), 16);
+  s2.createPalette(p2.data(), 4);
+  r1.setRotation(1);
+  std::vector<uint16_t> bits = { TFT_NAVY, TFT_ORANGE };
+  s1.setBitmapColor(bits[1], bits[0]);
+
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    Fill f(false);
+    for (TFT_eSprite* s : all) { s->fillSprite(0); f(*s); }
+    tft.fillScreen(TFT_BLACK);
+    f(tft);
+
+    int wrong[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int y = 0; y < 80; y++)
+      for (int x = 0; x < 80; x++) {
+        uint16_t c = s16.readPixel(x, y);
+        bool filled = (c != 0) || panel.fb[x + y * HostPanel::W] != 0;
+        if (panel.fb[x + y * HostPanel::W] != c) wrong[0]++;
+        if (!filled) continue;
+        if (s4.readPixelValue(x, y) != nearest(p4, c)) wrong[2]++;
+        if (s2.readPixelValue(x, y) != nearest(p2, c)) wrong[3]++;
+        if (s1.readPixelValue(x, y) != nearest(bits, c)) wrong[4]++;
+        if (r1.readPixelValue(x, y) != nearest(bits, c)) wrong[5]++;
+      }
+    for (int i = 0; i < 6; i++)
+      if (wrong[i] && bad++ < 10)
+        CHECK(false, "case %d %s: %d pixels differ (radial %d viewport %d datum %d)", n,
+              i ? (i == 5 ? "rotated 1 bpp" : "Sprite") : "TFT", wrong[i], f.radial, f.vp, f.datum);
+  }
+  CHECK(bad == 0, "depths: %d fills differ", bad);
+
+  // Dithered grey ramp in 1 bpp: the share of set bits in each 4x4 block follows the grey level
+  gradientStop_t ramp[2] = { { 0, TFT_BLACK }, { 255, TFT_WHITE } };
+  s1.setBitmapColor(TFT_WHITE, TFT_BLACK);
+  s1.fillSprite(0);
+  s1.fillRectLinearGradient(0, 0, 80, 80, 0, ramp, 2, true);
+  s16.fillRectLinearGradient(0, 0, 80, 80, 0, ramp, 2, false);
+  double worst = 0;
+  for (int by = 0; by < 80; by += 4)
+    for (int bx = 0; bx < 80; bx += 4) {
+      double set = 0, grey = 0;
+      for (int y = by; y < by + 4; y++)
+        for (int x = bx; x < bx + 4; x++) {
+          set += s1.readPixelValue(x, y);
+          grey += (s16.readPixel(x, y) >> 5 & 0x3F) / 63.0;
+        }
+      worst = max(worst, fabs(set - grey) / 16);
+    }
+  CHECK(worst < 0.1, "1 bpp dither: a block is %.3f from its grey level", worst);
+}
+
+int main()
+{
+  GradTFT tft;
+  tft.init();
+
+  srand(1);
+  checkTable(tft);
+  checkLine(tft);
+  checkDepths(tft);
+
+  return testResult();
+}
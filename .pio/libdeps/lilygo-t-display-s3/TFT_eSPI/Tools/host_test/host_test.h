@@ -0,0 +1,43 @@
+// Common code for the host tests and benchmarks, include it in the test source file only.
+// It defines the stand-in objects and provides checks and a timer.
+#pragma once
+
+#include <TFT_eSPI.h>
+#include <chrono>
+
+HardwareSerial Serial;
+SPIClass       SPI;
+HostPanel      panel;
+fs::FS         SPIFFS;
+
+void hostDigitalWrite(int pin, int value) { if (pin == TFT_DC) panel.dc = value; }
+
+size_t Print::print(const String& s)   { return write(s.c_str()); }
+size_t Print::println(const String& s) { return print(s) + write("\n"); }
+size_t Print::print(long v, int)       { char b[24]; return write(ltoa(v, b, 10)); }
+size_t Print::println(long v, int)     { return print(v) + write("\n"); }
+
+// Count and report failed checks, main() returns the count so a failure stops a test run
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { if (failures++ < 20) { printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                              printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+static int testResult(void)
+{
+  printf(failures ? "%d checks failed\n" : "OK\n", failures);
+  return failures != 0;
+}
+
+// Seconds taken by f(), the best of a few runs
+template <typename Fn> static double timeIt(Fn f, int runs = 5)
+{
+  double best = 1e30;
+  for (int i = 0; i < runs; i++) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (t < best) best = t;
+  }
+  return best;
+}
@@ -0,0 +1,200 @@
+/*
+  In-place smooth fonts used from a memory mapped data partition, with the
+  partition stand-in in shim/esp_partition.h, checked against the vlw font
+  they were made from.
+
+  vlw_compress.py (python3 is needed) writes each example font as in-place
+  binaries with 8 and 4 bit alpha, and the 4 bit run length coded vlw font
+  they are compared with. A shuffled copy of a font with a duplicated code
+  checks the glyphs are put in code order with the first of a duplicated
+  code found.
+
+  loadFontPartition() must give the same font metrics, glyph look ups for
+  every 16 bit code, glyph metrics, text widths and pixels on the TFT and
+  in Sprites as the vlw font loaded from an array, and unloadFont() must
+  unmap the partition. A partition that is not an in-place font must be
+  refused and unmapped.
+
+  Loading and unloading the in-place font from an array is timed against
+  loading the vlw font.
+*/
+
+#include <string>
+#include <sys/stat.h>
+#include "esp_partition.h"
+#include "host_test.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+static bytes_t readFile(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  return bytes_t(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& path, const bytes_t& v)
+{
+  std::ofstream f(path, std::ios::binary);
+  f.write((const char*)v.data(), v.size());
+}
+
+static bool convert(const std::string& in, const std::string& out, const char* options)
+{
+  std::string cmd = "python3 Tools/vlw_compress/vlw_compress.py \"" + in + "\" -o " + out + " " + options + " > /dev/null";
+  return system(cmd.c_str()) == 0;
+}
+
+// A vlw font with its glyphs in reverse order and the last glyph repeated with a new bitmap
+static bytes_t shuffleFont(const bytes_t& vlw)
+{
+  uint32_t count = (uint32_t)vlw[0] << 24 | vlw[1] << 16 | vlw[2] << 8 | vlw[3];
+  std::vector<size_t> pos;
+  size_t p = 24 + 28 * count;
+  for (uint32_t n = 0; n < count; n++) {
+    const uint8_t* m = &vlw[24 + 28 * n];
+    pos.push_back(p);
+    p += (size_t)m[7] * m[11]; // height * width, both under 256
+  }
+
+  bytes_t font(vlw.begin(), vlw.begin() + 24);
+  font[3] = count + 1;
+  font[2] = (count + 1) >> 8;
+  for (int32_t n = count - 1; n >= 0; n--) font.insert(font.end(), &vlw[24 + 28 * n], &vlw[24 + 28 * n + 28]);
+  font.insert(font.end(), &vlw[24 + 28 * (count - 1)], &vlw[24 + 28 * count]);
+  for (int32_t n = count - 1; n >= 0; n--) {
+    size_t end = (n + 1 < (int32_t)count) ? pos[n + 1] : p;
+    font.insert(font.end(), vlw.begin() + pos[n], vlw.begin() + end);
+  }
+  // The repeated glyph is drawn in full so it shows if found in place of the first
+  for (size_t i = pos[count - 1]; i < p; i++) font.push_back(255);
+  font.insert(font.end(), vlw.begin() + p, vlw.end());
+  return font;
+}
+
+static const char* text[] = {
+  "Hello World 0123456789",
+  "The quick brown fox jumps over the lazy dog",
+  "\xC3\xA9\xC3\xA8\xC3\xA0 \xE3\x81\x82\xE3\x81\x84\xE3\x81\x86 abc {}~ 25\xC2\xB0",
+};
+
+// Metrics, look ups and text widths of the font loaded in tft, against the vlw font in ref
+static void compareFont(TFT_eSPI& tft, TFT_eSPI& ref, const char* name)
+{
+  CHECK(tft.gFont.gCount == ref.gFont.gCount && tft.gFont.yAdvance == ref.gFont.yAdvance &&
+        tft.gFont.spaceWidth == ref.gFont.spaceWidth && tft.gFont.ascent == ref.gFont.ascent &&
+        tft.gFont.descent == ref.gFont.descent && tft.gFont.maxAscent == ref.gFont.maxAscent &&
+        tft.gFont.maxDescent == ref.gFont.maxDescent, "%s: font metrics differ", name);
+
+  int bad = 0;
+  for (uint32_t code = 0; code < 0x10000; code++) {
+    uint16_t a = 0, b = 0;
+    bool fa = tft.getUnicodeIndex(code, &a), fb = ref.getUnicodeIndex(code, &b);
+    if (fa != fb) { bad++; continue; }
+    if (!fa) continue;
+    if (tft.gWidth[a] != ref.gWidth[b] || tft.gHeight[a] != ref.gHeight[b] || tft.gxAdvance[a] != ref.gxAdvance[b] ||
+        tft.gdX[a] != ref.gdX[b] || tft.gdY[a] != ref.gdY[b]) bad++;
+  }
+  CHECK(bad == 0, "%s: %d glyph look ups or metrics differ", name, bad);
+
+  for (int t = 0; t < 3; t++)
+    CHECK(tft.textWidth(text[t]) == ref.textWidth(text[t]), "%s: textWidth of line %d differs", name, t);
+}
+
+// Mode 0 is transparent text, mode 1 fills the background
+static void draw(TFT_eSPI& tft, int mode)
+{
+  tft.setTextColor(TFT_YELLOW, TFT_NAVY, mode == 1);
+  for (int t = 0; t < 3; t++) tft.drawString(text[t], 5, 5 + t * tft.fontHeight());
+}
+
+// Text on the TFT and in Sprites, which load the font from the partition or the array
+static std::vector<uint16_t> pixels(TFT_eSPI& tft, int mode, bool partition, const uint8_t* array)
+{
+  std::vector<uint16_t> out;
+  tft.fillScreen(TFT_DARKGREEN);
+  draw(tft, mode);
+  out.assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+
+  for (int bpp : { 16, 8 }) {
+    TFT_eSprite spr(&tft);
+    spr.setColorDepth(bpp);
+    spr.createSprite(230, 100);
+    spr.fillSprite(TFT_DARKGREEN);
+    if (partition) spr.loadFontPartition("font"); else spr.loadFont(array);
+    draw(spr, mode);
+    for (int y = 0; y < spr.height(); y++)
+      for (int x = 0; x < spr.width(); x++) out.push_back(spr.readPixel(x, y));
+    spr.unloadFont();
+  }
+  return out;
+}
+
+int main()
+{
+  TFT_eSPI tft, ref;
+  tft.init();
+
+  const char* dir = "/tmp/tft_inplace_font_test";
+  mkdir(dir, 0755);
+  std::string bin = std::string(dir) + "/font.bin";
+  hostPartitions.push_back({ "font", bin, 0 });
+
+  const char* fonts[] = {
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold15.vlw",
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold36.vlw",
+    "examples/Smooth Fonts/SPIFFS/Unicode_test/data/Latin-Hiragana-24.vlw",
+    "shuffled",
+  };
+
+  for (const char* path : fonts) {
+    std::string vlwPath = path;
+    if (vlwPath == "shuffled") {
+      vlwPath = std::string(dir) + "/shuffled.vlw";
+      writeFile(vlwPath, shuffleFont(readFile(fonts[0])));
+    }
+    const char* name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+    std::string rlePath = std::string(dir) + "/rle.vlw";
+    CHECK(convert(vlwPath, rlePath, "-b 4"), "%s: vlw_compress.py failed", name);
+
+    for (int bits : { 8, 4 }) {
+      char options[32];
+      snprintf(options, sizeof(options), "-f inplace -b %d", bits);
+      if (!convert(vlwPath, bin, options)) { CHECK(false, "%s: vlw_compress.py failed", name); continue; }
+
+      bytes_t vlw = readFile(bits == 8 ? vlwPath : rlePath);
+      ref.loadFont(vlw.data());
+
+      CHECK(tft.loadFontPartition("font"), "%s %d bit: partition not loaded", name, bits);
+      CHECK(tft.gInPlace && hostMappings == 1, "%s %d bit: font not used in place from the mapping", name, bits);
+      compareFont(tft, ref, name);
+
+      tft.unloadFont();
+
+      for (int mode = 0; mode < 2; mode++) {
+        tft.loadFontPartition("font");
+        std::vector<uint16_t> a = pixels(tft, mode, true, nullptr);
+        tft.unloadFont();
+        tft.loadFont(vlw.data());
+        CHECK(a == pixels(tft, mode, false, vlw.data()), "%s %d bit mode %d: text differs from the vlw font", name, bits, mode);
+        tft.unloadFont();
+      }
+      CHECK(hostMappings == 0, "%s %d bit: %d partition mappings left", name, bits, hostMappings);
+      ref.unloadFont();
+
+      if (bits == 4 && path == fonts[1]) {
+        bytes_t inplace = readFile(bin);
+        double tIn  = timeIt([&] { for (int i = 0; i < 1000; i++) { tft.loadFont(inplace.data()); tft.unloadFont(); } }) / 1000;
+        double tVlw = timeIt([&] { for (int i = 0; i < 1000; i++) { tft.loadFont(vlw.data()); tft.unloadFont(); } }) / 1000;
+        printf("%s 4 bit: load and unload %.3f us in place, %.3f us vlw array\n", name, tIn * 1e6, tVlw * 1e6);
+      }
+    }
+  }
+
+  // A partition holding a vlw font or a missing partition is refused
+  writeFile(bin, readFile(fonts[0]));
+  CHECK(!tft.loadFontPartition("font") && !tft.fontLoaded, "vlw font in a partition accepted");
+  CHECK(hostMappings == 0, "refused partition left mapped");
+  CHECK(!tft.loadFontPartition("other"), "missing partition accepted");
+
+  return testResult();
+}
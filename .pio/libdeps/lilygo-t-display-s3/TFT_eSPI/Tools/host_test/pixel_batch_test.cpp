@@ -0,0 +1,134 @@
+/*
+  drawPixels() checked against drawPixel() called for each point.
+
+  Random point sets of 1 to 300 points, so most cross the 64 point batch
+  size, are drawn with a colour per point and with one colour, on the TFT
+  and in 16, 8, 4, 2 and 1 bpp Sprites, rotated 1 bpp included. Points
+  are clustered so rows have runs of adjacent points, and repeated points
+  must leave the colour of the last one, also where the repeat falls in
+  a later batch. Some points are outside the screen or Sprite, and half
+  the draws are in a random viewport with or without the datum moved.
+
+  The windows set on the TFT are printed for 1000 clustered points drawn
+  both ways.
+*/
+
+#include "host_test.h"
+
+// Points in a few clusters, with repeats of earlier points
+static std::vector<int16_t> points(int n, int w, int h)
+{
+  std::vector<int16_t> xy;
+  int cx = 0, cy = 0;
+  for (int i = 0; i < n; i++) {
+    if (i % 20 == 0) { cx = rand() % (w + 40) - 20; cy = rand() % (h + 40) - 20; }
+    if (i > 0 && rand() % 8 == 0) {
+      int k = rand() % i;
+      xy.push_back(xy[2 * k]);
+      xy.push_back(xy[2 * k + 1]);
+      continue;
+    }
+    xy.push_back(cx + rand() % 12 - 6);
+    xy.push_back(cy + rand() % 4 - 2);
+  }
+  return xy;
+}
+
+struct Draw {
+  std::vector<int16_t>  xy;
+  std::vector<uint16_t> colors;
+  uint32_t color;
+  bool     each, vp, datum;
+  int32_t  vx, vy, vw, vh;
+
+  Draw(int w, int h, int bpp)
+  {
+    int n = 1 + rand() % 300;
+    xy = points(n, w, h);
+    for (int i = 0; i < n; i++) colors.push_back(bpp == 1 ? rand() % 2 : bpp == 2 ? rand() % 4 : bpp == 4 ? rand() % 16 : rand());
+    color = colors[0];
+    each  = rand() % 2;
+    vp    = rand() % 2;
+    datum = rand() % 2;
+    vx    = rand() % w - 10;
+    vy    = rand() % h - 10;
+    vw    = 1 + rand() % w;
+    vh    = 1 + rand() % h;
+  }
+
+  void operator()(TFT_eSPI& t, bool ref) const
+  {
+    if (vp) t.setViewport(vx, vy, vw, vh, datum);
+    size_t n = colors.size();
+    if (ref) for (size_t i = 0; i < n; i++) t.drawPixel(xy[2 * i], xy[2 * i + 1], each ? colors[i] : color);
+    else if (each) t.drawPixels(xy.data(), colors.data(), n);
+    else t.drawPixels(xy.data(), n, color);
+    t.resetViewport();
+  }
+};
+
+static void checkTFT(TFT_eSPI& tft)
+{
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    Draw d(HostPanel::W, HostPanel::H, 16);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      tft.fillScreen(TFT_DARKGREEN);
+      d(tft, pass);
+      out[pass].assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "TFT case %d: %zu points colour per point %d viewport %d datum %d differ", n, d.colors.size(), d.each, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "TFT: %d of 1000 point sets differ", bad);
+}
+
+static void checkSprite(TFT_eSPI& tft, int bpp, uint8_t rotation)
+{
+  TFT_eSprite spr(&tft);
+  spr.setColorDepth(bpp);
+  spr.createSprite(100, 100);
+  if (bpp == 4 || bpp == 2) spr.createPalette((const uint16_t*)nullptr, 1 << bpp);
+  spr.setRotation(rotation);
+
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    Draw d(100, 100, bpp);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      spr.fillSprite(bpp < 8 ? 1 : TFT_DARKGREEN);
+      d(spr, pass);
+      for (int y = 0; y < 100; y++)
+        for (int x = 0; x < 100; x++) out[pass].push_back(spr.readPixel(x, y));
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "%d bpp rotation %d case %d: %zu points colour per point %d viewport %d datum %d differ",
+            bpp, rotation, n, d.colors.size(), d.each, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "%d bpp rotation %d: %d of 1000 point sets differ", bpp, rotation, bad);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  srand(1);
+  checkTFT(tft);
+  for (int bpp : { 16, 8, 4, 2, 1 }) checkSprite(tft, bpp, 0);
+  checkSprite(tft, 1, 1);
+
+  std::vector<int16_t> xy = points(1000, HostPanel::W, HostPanel::H);
+  std::vector<uint16_t> colors(1000, TFT_WHITE);
+  long w = panel.windows;
+  tft.drawPixels(xy.data(), colors.data(), 1000);
+  long batched = panel.windows - w;
+  w = panel.windows;
+  for (int i = 0; i < 1000; i++) tft.drawPixel(xy[2 * i], xy[2 * i + 1], TFT_WHITE);
+  long single = panel.windows - w;
+  CHECK(batched < single, "drawPixels() set %ld windows, drawPixel() %ld", batched, single);
+  printf("1000 clustered points: %ld windows with drawPixels(), %ld with drawPixel()\n", batched, single);
+
+  return testResult();
+}
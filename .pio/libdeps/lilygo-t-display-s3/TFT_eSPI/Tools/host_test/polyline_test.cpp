@@ -0,0 +1,196 @@
+/*
+  drawPolyline() checked against drawLine() for each segment, and
+  drawWidePolyline() with round joins checked against a floating point
+  model of the coverage.
+
+  Random paths of 2 to 40 points, some off the edges, are drawn with
+  drawPolyline() and with drawLine() from each point to the next, on the
+  TFT and in 16, 8, 4 and 1 bpp Sprites, rotated 1 bpp included, in and
+  out of random viewports with and without the datum moved. The points
+  are read from records of three values to check the stride. The pixels
+  must match.
+
+  Wide paths with round joins and a background colour are drawn on the
+  TFT and in a 16 bpp Sprite. Each pixel is covered by r + 0.5 less its
+  distance from the nearest segment, worked out here in double
+  precision, and is blended as drawWideLine() blends. The paths do not
+  cross themselves, where each pixel is blended once. Pixels that
+  differ by more than rounding of the coverage fail the check.
+*/
+
+#include <cmath>
+#include "host_test.h"
+
+// Path points in records of x, y and an unused value
+static std::vector<int16_t> path(int n, int w, int h)
+{
+  std::vector<int16_t> p;
+  for (int i = 0; i < n; i++) {
+    p.push_back(rand() % (w + 60) - 30);
+    p.push_back(rand() % (h + 60) - 30);
+    p.push_back(rand());
+  }
+  return p;
+}
+
+struct Draw {
+  std::vector<int16_t> xy;
+  uint32_t color;
+  bool     vp, datum;
+  int32_t  vx, vy, vw, vh;
+
+  Draw(int w, int h, int bpp)
+  {
+    xy    = path(2 + rand() % 39, w, h);
+    color = (bpp == 1) ? 1 : (bpp == 4) ? 1 + rand() % 15 : rand();
+    vp    = rand() % 2;
+    datum = rand() % 2;
+    vx    = rand() % w - 10;
+    vy    = rand() % h - 10;
+    vw    = 1 + rand() % w;
+    vh    = 1 + rand() % h;
+  }
+
+  void operator()(TFT_eSPI& t, bool ref) const
+  {
+    if (vp) t.setViewport(vx, vy, vw, vh, datum);
+    size_t n = xy.size() / 3;
+    if (ref) for (size_t i = 1; i < n; i++) t.drawLine(xy[3 * i - 3], xy[3 * i - 2], xy[3 * i], xy[3 * i + 1], color);
+    else t.drawPolyline(xy.data(), n, color, 3);
+    t.resetViewport();
+  }
+};
+
+static void checkTFT(TFT_eSPI& tft)
+{
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    Draw d(HostPanel::W, HostPanel::H, 16);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      tft.fillScreen(TFT_DARKGREEN);
+      d(tft, pass);
+      out[pass].assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "TFT case %d: %zu point path viewport %d datum %d differs", n, d.xy.size() / 3, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "TFT: %d of 1000 paths differ", bad);
+}
+
+static void checkSprite(TFT_eSPI& tft, int bpp, uint8_t rotation)
+{
+  TFT_eSprite spr(&tft);
+  spr.setColorDepth(bpp);
+  spr.createSprite(100, 100);
+  spr.setRotation(rotation);
+
+  int bad = 0;
+  for (int n = 0; n < 1000; n++) {
+    Draw d(100, 100, bpp);
+    std::vector<uint16_t> out[2];
+    for (int pass = 0; pass < 2; pass++) {
+      spr.fillSprite(0);
+      d(spr, pass);
+      for (int y = 0; y < 100; y++)
+        for (int x = 0; x < 100; x++) out[pass].push_back(spr.readPixel(x, y));
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "%d bpp rotation %d case %d: %zu point path viewport %d datum %d differs",
+            bpp, rotation, n, d.xy.size() / 3, d.vp, d.datum);
+  }
+  CHECK(bad == 0, "%d bpp rotation %d: %d of 1000 paths differ", bpp, rotation, bad);
+}
+
+// Largest difference of the red, green and blue fields of two 565 colours
+static int colorDiff(uint16_t a, uint16_t b)
+{
+  int dr = abs((a >> 11) - (b >> 11)), dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)), db = abs((a & 0x1F) - (b & 0x1F));
+  return max(dr, max(dg, db));
+}
+
+// A path that does not cross itself: x steps on by more than the line width each point
+static std::vector<int16_t> widePath(int n, float wd, int w, int h)
+{
+  std::vector<int16_t> p;
+  int x = rand() % 40 - 20;
+  for (int i = 0; i < n; i++) {
+    p.push_back(x);
+    p.push_back(rand() % (h + 40) - 20);
+    p.push_back(0);
+    x += (int)(2 * wd) + 4 + rand() % (w / 4);
+  }
+  return p;
+}
+
+// Pixels of a wide path with round joins, in a 565 image of w x h
+static void wideModel(std::vector<uint16_t>& img, int w, int h, const std::vector<int16_t>& p, float wd, uint16_t fg, uint16_t bg)
+{
+  double r = wd / 2.0;
+  size_t n = p.size() / 3;
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) {
+      double best = 1e9;
+      for (size_t k = 0; k + 1 < n; k++) {
+        double ax = p[3 * k], ay = p[3 * k + 1], bx = p[3 * k + 3], by = p[3 * k + 4];
+        double dx = bx - ax, dy = by - ay, len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0;
+        t = t < 0 ? 0 : t > 1 ? 1 : t;
+        double ex = x - ax - t * dx, ey = y - ay - t * dy;
+        best = fmin(best, sqrt(ex * ex + ey * ey));
+      }
+      double alpha = r + 0.5 - best;
+      if (alpha <= 1.0 / 32.0) continue;
+      uint16_t& c = img[x + y * w];
+      c = (alpha > 1.0 - 1.0 / 32.0) ? fg : fastBlend((uint8_t)(alpha * 255.0), fg, bg);
+    }
+}
+
+static void checkWide(TFT_eSPI& tft)
+{
+  TFT_eSprite spr(&tft);
+  spr.createSprite(160, 120);
+
+  int bad = 0, close = 0;
+  for (int n = 0; n < 200; n++) {
+    bool onSprite = n & 1;
+    int  w = onSprite ? 160 : tft.width(), h = onSprite ? 120 : tft.height();
+    float wd = 1.0f + (rand() % 40) / 4.0f;
+    std::vector<int16_t> p = widePath(2 + rand() % 8, wd, w, h);
+    uint16_t fg = rand(), bg = rand();
+
+    std::vector<uint16_t> want(w * h, bg), got;
+    wideModel(want, w, h, p, wd, fg, bg);
+
+    TFT_eSPI& t = onSprite ? (TFT_eSPI&)spr : tft;
+    t.fillRect(0, 0, w, h, bg);
+    t.drawWidePolyline(p.data(), p.size() / 3, wd, fg, bg, ROUND_JOIN, 3);
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++) got.push_back(onSprite ? spr.readPixel(x, y) : panel.fb[x + y * HostPanel::W]);
+
+    int worst = 0;
+    for (int i = 0; i < w * h; i++) {
+      int d = colorDiff(got[i], want[i]);
+      if (d) close++;
+      worst = max(worst, d);
+    }
+    if (worst > 2 && bad++ < 10)
+      CHECK(false, "wide case %d %s: %zu points width %.2f differs by %d levels", n, onSprite ? "Sprite" : "TFT", p.size() / 3, wd, worst);
+  }
+  CHECK(bad == 0, "wide: %d of 200 paths differ from the model", bad);
+  printf("Wide paths: %d pixels within rounding of the model, the rest exact\n", close);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  srand(1);
+  checkTFT(tft);
+  for (int bpp : { 16, 8, 4, 1 }) checkSprite(tft, bpp, 0);
+  checkSprite(tft, 1, 1);
+  checkWide(tft);
+
+  return testResult();
+}
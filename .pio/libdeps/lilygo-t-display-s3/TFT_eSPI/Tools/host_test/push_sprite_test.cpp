@@ -0,0 +1,162 @@
+/*
+  pushToSprite() checked against a pixel by pixel reference.
+
+  Random Sprites of 16, 8 and 8 bpp with a palette, 4, 2 and 1 bpp are
+  pushed, opaque and with a transparent colour, at random positions, some
+  partly or wholly off the edges, into 100 x 100 Sprites of each of those
+  depths and a rotated 1 bpp Sprite, in and out of random viewports with
+  and without the datum moved. Palettes hold distinct random colours and
+  differ between source and destination.
+
+  The reference reads each source pixel with readPixel() and
+  readPixelValue(), skips it if its value matches the transparent colour
+  as pushToSprite() describes, and writes it with drawPixel(): the colour
+  for 16 and 8 bpp, the same index from a 4 or 2 bpp source of the same
+  depth or else the nearest palette colour, and for 1 bpp the bit or
+  whether the value is non-zero. The destination values must match.
+*/
+
+#include "host_test.h"
+
+// Distinct random colours
+static std::vector<uint16_t> palette(int n)
+{
+  std::vector<uint16_t> p;
+  while ((int)p.size() < n) {
+    uint16_t c = rand();
+    bool dup = false;
+    for (uint16_t q : p) dup |= (q == c);
+    if (!dup) p.push_back(c);
+  }
+  return p;
+}
+
+// Index of the nearest palette colour, as the Sprite class picks it
+static uint8_t nearest(const std::vector<uint16_t>& pal, uint16_t color)
+{
+  int32_t  r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+  uint32_t best = 0xFFFFFFFF;
+  uint8_t  index = 0;
+  for (size_t i = 0; i < pal.size(); i++) {
+    int32_t  dr = (pal[i] >> 11) - r, dg = ((pal[i] >> 5) & 0x3F) - g, db = (pal[i] & 0x1F) - b;
+    uint32_t d = 4 * dr * dr + dg * dg + 4 * db * db;
+    if (d < best) { best = d; index = i; }
+  }
+  return index;
+}
+
+// A Sprite with its palette, depth 9 is 8 bpp with a palette
+struct Spr {
+  TFT_eSprite s;
+  int bpp;
+  std::vector<uint16_t> pal;
+
+  Spr(TFT_eSPI* tft, int depth, int w, int h, uint8_t rotation = 0) : s(tft)
+  {
+    bpp = (depth == 9) ? 8 : depth;
+    s.setColorDepth(bpp);
+    s.createSprite(w, h);
+    if (depth == 9 || bpp == 4 || bpp == 2) {
+      pal = palette(depth == 9 ? 256 : 1 << bpp);
+      s.createPalette(pal.data(), pal.size());
+    }
+    s.setRotation(rotation);
+  }
+};
+
+// Random pixels from a few values so transparent pixels and runs occur
+static void fill(Spr& sp)
+{
+  uint16_t values[6];
+  for (uint16_t& v : values) v = (sp.bpp == 16) ? rand() : (sp.bpp == 8 && !sp.pal.size()) ? rand() : rand() % (sp.bpp == 8 ? 256 : 1 << sp.bpp);
+  for (int y = 0; y < sp.s.height(); y++)
+    for (int x = 0; x < sp.s.width(); x++) {
+      uint16_t v = values[rand() % 6];
+      // 8 bpp drawPixel() takes a colour, with a palette the colour of the index is drawn
+      if (sp.bpp == 8 && sp.pal.size()) v = sp.pal[v];
+      sp.s.drawPixel(x, y, v);
+    }
+}
+
+static bool transparent(Spr& src, uint16_t value, uint16_t transp, TFT_eSPI& tft)
+{
+  switch (src.bpp) {
+    case 16: return value == transp;
+    case 8:  return value == (src.pal.size() ? nearest(src.pal, transp) : (transp & 0xE000)>>8 | (transp & 0x0700)>>6 | (transp & 0x0018)>>3);
+    case 4:  return value == (transp & 0x0F);
+    case 2:  return value == (transp & 0x03);
+  }
+  if (transp == tft.bitmap_fg) return value == 1;
+  if (transp == tft.bitmap_bg) return value == 0;
+  return false;
+}
+
+static void reference(Spr& src, Spr& dst, int32_t x, int32_t y, bool useTransp, uint16_t transp, TFT_eSPI& tft)
+{
+  for (int j = 0; j < src.s.height(); j++)
+    for (int i = 0; i < src.s.width(); i++) {
+      uint16_t color = src.s.readPixel(i, j), value = src.s.readPixelValue(i, j);
+      if (useTransp && transparent(src, value, transp, tft)) continue;
+      uint16_t out = color;
+      if (dst.bpp == 8 && src.bpp == 8 && src.pal.size() && dst.pal.size()) out = dst.pal[value];
+      else if (dst.bpp == 4 || dst.bpp == 2) out = (src.bpp == dst.bpp) ? value : nearest(dst.pal, color);
+      else if (dst.bpp == 1) out = (src.bpp == 1) ? value : (value != 0);
+      dst.s.drawPixel(x + i, y + j, out);
+    }
+}
+
+static void check(TFT_eSPI& tft, int sd, int dd, uint8_t rotation)
+{
+  int bad = 0;
+  for (int n = 0; n < 300; n++) {
+    Spr src(&tft, sd, 1 + rand() % 60, 1 + rand() % 60);
+    fill(src);
+    int32_t x = rand() % 140 - 40, y = rand() % 140 - 40;
+    bool vp = rand() % 2, datum = rand() % 2, useTransp = rand() % 2;
+    int32_t vx = rand() % 100 - 10, vy = rand() % 100 - 10, vw = 1 + rand() % 100, vh = 1 + rand() % 100;
+
+    // Mostly the value of a source pixel
+    uint16_t transp = rand();
+    if (rand() % 4) {
+      int i = rand() % src.s.width(), j = rand() % src.s.height();
+      transp = (sd == 16) ? src.s.readPixel(i, j) : src.s.readPixelValue(i, j);
+      if (sd == 8 && src.pal.size()) transp = src.pal[transp];
+      else if (sd == 8) transp = src.s.readPixel(i, j);
+      else if (sd == 1) transp = transp ? tft.bitmap_fg : tft.bitmap_bg;
+    }
+
+    std::vector<uint16_t> out[2];
+    Spr dst(&tft, dd, 100, 100, rotation);
+    for (int pass = 0; pass < 2; pass++) {
+      dst.s.fillSprite(0);
+      if (dd == 9) dst.s.fillSprite(dst.pal[3]);
+      if (vp) dst.s.setViewport(vx, vy, vw, vh, datum);
+      if (pass) reference(src, dst, x, y, useTransp, transp, tft);
+      else if (useTransp) src.s.pushToSprite(&dst.s, x, y, transp);
+      else src.s.pushToSprite(&dst.s, x, y);
+      dst.s.resetViewport();
+      for (int j = 0; j < 100; j++)
+        for (int i = 0; i < 100; i++) out[pass].push_back(dst.s.readPixelValue(i, j));
+    }
+    if (out[0] != out[1] && bad++ < 10)
+      CHECK(false, "%d to %d bpp rotation %d case %d: %dx%d at %d,%d transparent %d viewport %d datum %d differs",
+            sd, dd, rotation, n, src.s.width(), src.s.height(), x, y, useTransp, vp, datum);
+  }
+  CHECK(bad == 0, "%d to %d bpp rotation %d: %d of 300 pushes differ", sd, dd, rotation, bad);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  srand(1);
+  const int depths[] = { 16, 8, 9, 4, 2, 1 };
+  for (int sd : depths) {
+    for (int dd : depths) if (dd != sd) check(tft, sd, dd, 0);
+    check(tft, sd, sd, 0);
+    check(tft, sd, 1, 1);
+  }
+
+  return testResult();
+}
@@ -0,0 +1,244 @@
+/*
+  Run length coded smooth fonts, see Tools/vlw_compress, checked against
+  the same fonts with their alpha quantized but not coded.
+
+  Each example vlw font is converted here, as vlw_compress.py does, to 4
+  and 2 bit alpha run length coded fonts, and to 8 bit vlw fonts holding
+  the same alpha values scaled back to 0-255. Text drawn with the two must
+  be identical on the TFT and in 16, 8 and 4 bpp Sprites, transparent,
+  with the background filled and with fg == bg so the Sprite background is
+  read back or taken from the getColor callback, from arrays and from
+  files with and without the glyph cache.
+
+  Partly transparent pixels of coded glyphs are drawn with drawPixels(),
+  so the TFT must be sent fewer windows and bytes than for the same text
+  in the quantized font, transparent and with the background filled.
+
+  The font sizes are printed, with the TFT bytes and the time to draw the
+  text in a 16 bpp Sprite. The two fonts are timed in turn, one drawing of
+  the text at a time, and the fastest of many is kept, as the speed of
+  the host varies.
+*/
+
+#include <string>
+#include <sys/stat.h>
+#include "host_test.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+static uint32_t get32(const bytes_t& v, size_t p)
+{
+  return (uint32_t)v[p] << 24 | v[p + 1] << 16 | v[p + 2] << 8 | v[p + 3];
+}
+
+static void set32(bytes_t& v, size_t p, uint32_t x)
+{
+  v[p] = x >> 24; v[p + 1] = x >> 16; v[p + 2] = x >> 8; v[p + 3] = x;
+}
+
+static bytes_t readFile(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  return bytes_t(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& path, const bytes_t& v)
+{
+  std::ofstream f(path, std::ios::binary);
+  f.write((const char*)v.data(), v.size());
+}
+
+// Values 0 and top start a run and are followed by the run length - 1
+static void codeRow(std::vector<uint8_t>& out, const uint8_t* row, int w, uint8_t top)
+{
+  int x = 0;
+  while (x < w) {
+    uint8_t v = row[x];
+    if (v == 0 || v == top) {
+      int n = 1;
+      while (x + n < w && n <= top && row[x + n] == v) n++;
+      out.push_back(v);
+      out.push_back(n - 1);
+      x += n;
+    }
+    else { out.push_back(v); x++; }
+  }
+}
+
+// Make the run length coded font (rle true) or the quantized 8 bit font from a vlw font
+static bytes_t convert(const bytes_t& vlw, int bits, bool rle)
+{
+  uint32_t count = get32(vlw, 0);
+  uint8_t  top = (1 << bits) - 1;
+
+  bytes_t font(vlw.begin(), vlw.begin() + 24 + 28 * count);
+  if (rle) set32(font, 4, 0x524C4500 | bits);
+
+  size_t ptr = 24 + 28 * count;
+  for (uint32_t n = 0; n < count; n++) {
+    size_t m = 24 + 28 * n;
+    int h = get32(vlw, m + 4), w = get32(vlw, m + 8);
+
+    std::vector<uint8_t> q(w * h);
+    for (int i = 0; i < w * h; i++) q[i] = (vlw[ptr + i] * top + 127) / 255;
+    ptr += w * h;
+
+    if (!rle) {
+      for (uint8_t v : q) font.push_back(v * (255 / top));
+      continue;
+    }
+
+    std::vector<uint8_t> values;
+    for (int y = 0; y < h; y++) codeRow(values, q.data() + y * w, w, top);
+
+    // Most significant bits first, padded to a whole byte
+    size_t start = font.size();
+    uint32_t acc = 0, used = 0;
+    for (uint8_t v : values) {
+      acc = (acc << bits) | v;
+      used += bits;
+      if (used == 8) { font.push_back(acc); acc = used = 0; }
+    }
+    if (used) font.push_back(acc << (8 - used));
+    set32(font, m + 24, font.size() - start);
+  }
+
+  font.insert(font.end(), vlw.begin() + ptr, vlw.end());
+  return font;
+}
+
+static const char* text[] = {
+  "Hello World 0123456789",
+  "The quick brown fox jumps over the lazy dog",
+  "MMMM WWWW iiii llll ||||",
+  "\xC3\xA9\xC3\xA8\xC3\xA0 \xE3\x81\x82\xE3\x81\x84\xE3\x81\x86 abc",
+};
+
+static uint16_t stripes(uint16_t x, uint16_t y) { return ((x + y) & 8) ? TFT_PINK : TFT_DARKCYAN; }
+
+// Draw all the text in one mode: 0 transparent, 1 background fill, 2 fg == bg, 3 getColor callback
+static void drawText(TFT_eSPI& tft, int mode)
+{
+  uint16_t fg = TFT_YELLOW, bg = (mode == 2) ? fg : TFT_NAVY;
+  tft.setTextColor(fg, bg, mode == 1);
+  tft.setCallback(mode == 3 ? stripes : nullptr);
+  for (int t = 0; t < 4; t++) {
+    tft.setCursor(3 + t, t * tft.fontHeight());
+    tft.print(text[t]);
+  }
+  tft.setCallback(nullptr);
+}
+
+// Load the font from an array or a file and draw the text on the TFT and in Sprites
+static std::vector<uint16_t> render(TFT_eSPI& tft, const bytes_t& font, const char* file, size_t cache, int mode)
+{
+  std::vector<uint16_t> out;
+
+  tft.setGlyphCache(cache);
+  if (file) tft.loadFont(file); else tft.loadFont(font.data());
+  tft.fillScreen(TFT_DARKGREEN);
+  tft.fillRect(40, 10, 60, 80, TFT_MAROON);
+  drawText(tft, mode);
+  out.assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+  tft.unloadFont();
+  tft.setGlyphCache(0);
+
+  for (int bpp : { 16, 8, 4 }) {
+    TFT_eSprite spr(&tft);
+    spr.setColorDepth(bpp);
+    spr.createSprite(230, 160);
+    spr.fillSprite(TFT_DARKGREEN);
+    spr.fillRect(40, 10, 60, 80, TFT_MAROON);
+    spr.setGlyphCache(cache);
+    if (file) spr.loadFont(file); else spr.loadFont(font.data());
+    drawText(spr, mode);
+    for (int y = 0; y < spr.height(); y++)
+      for (int x = 0; x < spr.width(); x++) out.push_back(spr.readPixel(x, y));
+    spr.unloadFont();
+  }
+  return out;
+}
+
+// Fastest time to draw the text in each mode in a 16 bpp Sprite, for the quantized and coded fonts
+static void spriteTimes(TFT_eSPI& tft, const bytes_t& quantized, const bytes_t& coded, double* best)
+{
+  TFT_eSprite spr[2] = { TFT_eSprite(&tft), TFT_eSprite(&tft) };
+  spr[0].createSprite(230, 160);
+  spr[1].createSprite(230, 160);
+  spr[0].loadFont(quantized.data());
+  spr[1].loadFont(coded.data());
+  best[0] = best[1] = 0;
+  for (int mode = 0; mode < 4; mode++) {
+    double t[2] = { 1e9, 1e9 };
+    for (int i = 0; i < 200; i++)
+      for (int k = 0; k < 2; k++) {
+        spr[k].fillSprite(TFT_DARKGREEN);
+        t[k] = min(t[k], timeIt([&] { drawText(spr[k], mode); }, 1));
+      }
+    best[0] += t[0];
+    best[1] += t[1];
+  }
+}
+
+// TFT windows and bytes to draw the text transparent and with the background filled
+static void tftCost(TFT_eSPI& tft, const bytes_t& font, long* windows, long* bytes)
+{
+  tft.loadFont(font.data());
+  tft.fillScreen(TFT_DARKGREEN);
+  long w = panel.windows, b = panel.bytes;
+  drawText(tft, 0);
+  drawText(tft, 1);
+  *windows = panel.windows - w;
+  *bytes = panel.bytes - b;
+  tft.unloadFont();
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  const char* dir = "/tmp/tft_rle_font_test";
+  mkdir(dir, 0755);
+  SPIFFS.root = dir;
+
+  const char* fonts[] = {
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold15.vlw",
+    "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/NotoSansBold36.vlw",
+    "examples/Smooth Fonts/SPIFFS/Unicode_test/data/Latin-Hiragana-24.vlw",
+  };
+
+  for (const char* path : fonts) {
+    bytes_t vlw = readFile(path);
+    CHECK(vlw.size() > 24, "%s not read", path);
+    if (vlw.size() <= 24) continue;
+    const char* name = strrchr(path, '/') + 1;
+
+    for (int bits : { 4, 2 }) {
+      bytes_t coded = convert(vlw, bits, true), quantized = convert(vlw, bits, false);
+      writeFile(std::string(dir) + "/coded.vlw", coded);
+      writeFile(std::string(dir) + "/quantized.vlw", quantized);
+
+      for (int mode = 0; mode < 4; mode++) {
+        std::vector<uint16_t> ref = render(tft, quantized, nullptr, 0, mode);
+        CHECK(render(tft, coded, nullptr, 0, mode) == ref, "%s %d bit mode %d: array font differs", name, bits, mode);
+        CHECK(render(tft, coded, "coded", 0, mode) == ref, "%s %d bit mode %d: file font differs", name, bits, mode);
+        CHECK(render(tft, coded, "coded", 3000, mode) == ref, "%s %d bit mode %d: small glyph cache differs", name, bits, mode);
+        CHECK(render(tft, coded, "coded", 60000, mode) == ref, "%s %d bit mode %d: glyph cache differs", name, bits, mode);
+      }
+
+      long windows[2], sent[2];
+      tftCost(tft, quantized, &windows[0], &sent[0]);
+      tftCost(tft, coded, &windows[1], &sent[1]);
+      CHECK(windows[1] < windows[0] && sent[1] < sent[0], "%s %d bit: coded font sent %ld windows %ld bytes, quantized %ld windows %ld bytes",
+            name, bits, windows[1], sent[1], windows[0], sent[0]);
+
+      double t[2];
+      spriteTimes(tft, quantized, coded, t);
+      printf("%-22s %d bit alpha: %6zu bytes vlw, %6zu coded, TFT %6ld bytes quantized, %6ld coded, Sprite %6.1f us quantized, %6.1f us coded\n",
+             name, bits, vlw.size(), coded.size(), sent[0], sent[1], t[0] * 1e6, t[1] * 1e6);
+    }
+  }
+
+  return testResult();
+}
@@ -0,0 +1,94 @@
+/*
+  Rotated 1 bpp Sprites read in rotated coordinates.
+
+  Random non-square 1 bpp Sprites are drawn at each rotation with
+  drawPixel(), and each pixel must read back with readPixel() and
+  readPixelValue() at the same coordinates.
+
+  Each rotated Sprite is copied into a 16 bpp Sprite with readPixel(), so
+  both hold the same picture. The two are pushed with pushToSprite() to
+  16, 8 and 1 bpp Sprites, with pushRotated() to the TFT and a 16 bpp
+  Sprite, and with pushTransformed() with nearest and bilinear sampling,
+  opaque and with the foreground colour transparent, at random positions
+  and angles. Each pair of pushes must give the same pixels.
+*/
+
+#include "host_test.h"
+
+static void readAll(TFT_eSprite& s, std::vector<uint16_t>& out)
+{
+  for (int y = 0; y < s.height(); y++)
+    for (int x = 0; x < s.width(); x++) out.push_back(s.readPixel(x, y));
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+  srand(1);
+
+  int badRead = 0, badPush = 0, pushes = 0;
+  for (int n = 0; n < 400; n++) {
+    uint8_t rotation = n % 4;
+    TFT_eSprite s1(&tft), s16(&tft);
+    s1.setColorDepth(1);
+    s1.createSprite(1 + rand() % 40, 1 + rand() % 40);
+    s1.setRotation(rotation);
+    s1.setBitmapColor(TFT_ORANGE, TFT_BLACK);
+
+    // Random bits, each checked as it is drawn
+    int w = s1.width(), h = s1.height();
+    s16.createSprite(w, h);
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++) {
+        int bit = rand() % 2;
+        s1.drawPixel(x, y, bit);
+        if ((s1.readPixelValue(x, y) != bit || s1.readPixel(x, y) != (bit ? TFT_ORANGE : TFT_BLACK)) && badRead++ < 10)
+          CHECK(false, "case %d rotation %d %dx%d: pixel %d,%d reads back wrong", n, rotation, w, h, x, y);
+      }
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++) s16.drawPixel(x, y, s1.readPixel(x, y));
+
+    s1.setPivot(rand() % w, rand() % h);
+    s16.setPivot(s1.getPivotX(), s1.getPivotY());
+    int32_t px = rand() % 60 - 10, py = rand() % 60 - 10;
+    int16_t angle = rand() % 360;
+    bool useTransp = rand() % 2;
+    uint32_t tp = useTransp ? TFT_ORANGE : 0x00FFFFFF;
+    float m[6];
+    s1.getTransform(m, angle, 0.5f + (rand() % 100) / 50.0f, 0.5f + (rand() % 100) / 50.0f, px, py);
+
+    for (int k = 0; k < 7; k++) {
+      std::vector<uint16_t> out[2];
+      for (int pass = 0; pass < 2; pass++) {
+        TFT_eSprite& src = pass ? s16 : s1;
+        TFT_eSprite  dst(&tft);
+        dst.setColorDepth(k == 1 ? 8 : k == 2 ? 1 : 16);
+        dst.createSprite(60, 60);
+        dst.setPivot(px, py);
+        tft.setPivot(px, py);
+        tft.fillScreen(TFT_DARKGREY);
+        switch (k) {
+          case 0:
+          case 1:
+          case 2: if (useTransp) src.pushToSprite(&dst, px, py, TFT_ORANGE); else src.pushToSprite(&dst, px, py); break;
+          case 3: src.pushRotated(angle, tp); break;
+          case 4: src.pushRotated(&dst, angle, tp); break;
+          case 5: src.pushTransformed(&dst, m, SAMPLE_NEAREST, tp); break;
+          case 6: src.pushTransformed(&dst, m, SAMPLE_BILINEAR, tp); break;
+        }
+        if (k == 3) for (int y = 0; y < 60; y++) for (int x = 0; x < 60; x++) out[pass].push_back(panel.fb[x + y * HostPanel::W]);
+        else readAll(dst, out[pass]);
+      }
+      pushes++;
+      const char* what[] = { "pushToSprite() 16 bpp", "pushToSprite() 8 bpp", "pushToSprite() 1 bpp", "pushRotated() TFT",
+                             "pushRotated() Sprite", "pushTransformed() nearest", "pushTransformed() bilinear" };
+      if (out[0] != out[1] && badPush++ < 10)
+        CHECK(false, "case %d rotation %d %dx%d: %s transparent %d differs", n, rotation, w, h, what[k], useTransp);
+    }
+  }
+  CHECK(badRead == 0, "%d pixels read back wrong", badRead);
+  CHECK(badPush == 0, "%d of %d pushes differ from the 16 bpp copy", badPush, pushes);
+
+  return testResult();
+}
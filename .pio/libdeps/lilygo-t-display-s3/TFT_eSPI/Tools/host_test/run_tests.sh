@@ -0,0 +1,19 @@
+#!/bin/sh
+# Build and run the host tests and benchmarks, run from any directory
+# usage: run_tests.sh [program.cpp ...]
+
+cd "$(dirname "$0")/../.." || exit 1
+OUT=${OUT:-/tmp/tft_host_test}
+mkdir -p "$OUT"
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=gnu++17 -O2 -no-pie -Wall -Wno-cpp -Wno-int-to-pointer-cast -Wno-strict-aliasing}
+
+if [ $# -eq 0 ]; then set -- Tools/host_test/*.cpp; fi
+
+for src in "$@"; do
+  name=$(basename "$src" .cpp)
+  echo "== $name"
+  $CXX $CXXFLAGS -I Tools/host_test/shim -I . "$src" TFT_eSPI.cpp -o "$OUT/$name" || exit 1
+  "$OUT/$name" || exit 1
+done
@@ -0,0 +1,92 @@
+// Minimal Arduino core stand-in so the library can be compiled and run on a PC
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+
+// Standard headers used by the tests must be seen before the min, max and abs macros
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <queue>
+#include <vector>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH         1
+#define LOW          0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define PI         3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+
+// Program memory is ordinary memory
+#define PROGMEM
+#define F(x) x
+#define pgm_read_byte(a)  (*(const uint8_t*)(a))
+#define pgm_read_word(a)  (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(const uintptr_t*)(a))
+#define pgm_read_float(a) (*(const float*)(a))
+#define pgm_read_ptr(a)   (*(void* const*)(a))
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define abs(x)   ((x)>0?(x):-(x))
+#define constrain(a,l,h) ((a)<(l)?(l):((a)>(h)?(h):(a)))
+
+// Time does not pass, benchmarks use std::chrono
+inline void     delay(uint32_t) {}
+inline void     delayMicroseconds(uint32_t) {}
+inline uint32_t millis() { return 0; }
+inline uint32_t micros() { return 0; }
+inline void     yield() {}
+
+// The TFT DC pin is routed to the panel stand-in in SPI.h
+void hostDigitalWrite(int pin, int value);
+inline void pinMode(int, int) {}
+inline void digitalWrite(int pin, int value) { hostDigitalWrite(pin, value); }
+inline int  digitalRead(int) { return 0; }
+
+#define digitalPinToBitMask(p)  (1UL << ((p) & 31))
+#define digitalPinToPort(p)     (0)
+#define portOutputRegister(p)   ((volatile uint32_t*)0)
+
+inline long random(long hi) { return hi > 0 ? rand() % hi : 0; }
+inline long random(long lo, long hi) { return hi > lo ? lo + rand() % (hi - lo) : lo; }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+inline char* ltoa(long v, char* buf, int) { sprintf(buf, "%ld", v); return buf; }
+
+class String {
+ public:
+  std::string s;
+  String(const char* c = "") : s(c) {}
+  String(int v) : s(std::to_string(v)) {}
+  unsigned    length() const { return s.size(); }
+  void        toCharArray(char* b, unsigned n) const { strncpy(b, s.c_str(), n); }
+  const char* c_str() const { return s.c_str(); }
+  bool        operator==(const char* o) const { return s == o; }
+  String      operator+(const String& o) const { String r; r.s = s + o.s; return r; }
+  friend String operator+(const char* a, const String& b) { String r; r.s = std::string(a) + b.s; return r; }
+  char        operator[](unsigned i) const { return s[i]; }
+};
+
+#include "Print.h"
+
+// Serial output goes to stdout
+class HardwareSerial : public Print {
+ public:
+  size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+  void   begin(unsigned long) {}
+};
+extern HardwareSerial Serial;
@@ -0,0 +1,83 @@
+// File system stand-in: fs::FS opens files in a host directory through std::fstream.
+// Reads and seeks are counted so tests can check when a font file is accessed, and a
+// chosen read can be made to fail.
+#pragma once
+
+#include "Arduino.h"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+// Accesses made through all files opened by an FS
+struct FSCount {
+  long reads = 0;
+  long seeks = 0;
+  long bytes = 0;
+  long failRead = 0; // Number of the read that returns no data, 0 for none
+};
+
+class File {
+ public:
+  File(void) {}
+  File(std::shared_ptr<std::fstream> f, FSCount* count) : _f(f), _count(count) {}
+
+  operator bool() const { return _f && _f->is_open(); }
+
+  int read(void)
+  {
+    if (!*this) return -1;
+    _count->reads++;
+    int c = _f->get();
+    if (c == EOF) { _f->clear(); return -1; }
+    _count->bytes++;
+    return c;
+  }
+
+  size_t read(uint8_t* buf, size_t size)
+  {
+    if (!*this) return 0;
+    if (++_count->reads == _count->failRead) return 0;
+    _f->read((char*)buf, size);
+    size_t got = _f->gcount();
+    _f->clear(); // A short read leaves the file usable, as on a board
+    _count->bytes += got;
+    return got;
+  }
+
+  bool seek(uint32_t pos, SeekMode mode = SeekSet)
+  {
+    if (!*this) return false;
+    _count->seeks++;
+    _f->clear();
+    _f->seekg(pos, mode == SeekSet ? std::ios::beg : mode == SeekCur ? std::ios::cur : std::ios::end);
+    return !_f->fail();
+  }
+
+  void close(void) { _f.reset(); }
+
+ private:
+  std::shared_ptr<std::fstream> _f;
+  FSCount* _count = nullptr;
+};
+
+class FS {
+ public:
+  // Directory that holds the files, "/name.vlw" is opened as root + "/name.vlw"
+  std::string root = ".";
+  FSCount     count;
+
+  bool exists(const String& path) { std::ifstream f(root + path.s); return f.good(); }
+
+  File open(const String& path, const char* mode = "r")
+  {
+    (void)mode;
+    auto f = std::make_shared<std::fstream>(root + path.s, std::ios::in | std::ios::binary);
+    if (!f->is_open()) return File();
+    return File(f, &count);
+  }
+};
+
+} // namespace fs
+
+extern fs::FS SPIFFS;
@@ -0,0 +1,23 @@
+// Print class stand-in, only the members the library uses
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class String;
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t* b, size_t n) { size_t r = 0; while (n--) r += write(*b++); return r; }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s);
+  size_t print(long v, int = 10);
+  size_t println(const char* s = "") { return write(s) + write("\n"); }
+  size_t println(const String& s);
+  size_t println(long v, int = 10);
+  size_t printf(const char*, ...) { return 0; }
+};
@@ -0,0 +1,76 @@
+// SPI stand-in. Bytes written with the DC pin high or low are decoded by a fake panel that
+// follows the column/page address set and memory write commands into a frame buffer.
+#pragma once
+
+#include <stdint.h>
+
+#define SPI_MODE0 0
+#define SPI_MODE3 3
+#define MSBFIRST  1
+
+struct HostPanel {
+  static const int W = 320, H = 320;
+  uint16_t fb[W * H];
+  int      dc = 1;
+  uint8_t  cmd = 0, hi = 0, p[4];
+  int      n = 0, x0 = 0, x1 = 0, y0 = 0, y1 = 0, x = 0, y = 0;
+  bool     half = false;
+  long     pixels = 0;  // Pixels written
+  long     windows = 0; // Memory write commands, one per window
+  long     bytes = 0;   // Bytes sent, commands and data
+
+  void command(uint8_t c) {
+    bytes++;
+    cmd = c; n = 0; half = false;
+    if (c == 0x2C) { x = x0; y = y0; windows++; }
+  }
+
+  void data(uint8_t b) {
+    bytes++;
+    if (cmd == 0x2A || cmd == 0x2B) {
+      if (n < 4) p[n++ & 3] = b;
+      if (n == 4) {
+        int a = (p[0] << 8) | p[1], e = (p[2] << 8) | p[3];
+        if (cmd == 0x2A) { x0 = a; x1 = e; }
+        else             { y0 = a; y1 = e; }
+      }
+    }
+    else if (cmd == 0x2C) {
+      if (!half) { hi = b; half = true; return; }
+      half = false;
+      if (x >= 0 && x < W && y >= 0 && y < H) fb[y * W + x] = (hi << 8) | b;
+      pixels++;
+      if (++x > x1) { x = x0; y++; }
+    }
+  }
+
+  uint16_t pixel(int px, int py) const { return fb[py * W + px]; }
+};
+extern HostPanel panel;
+
+class SPISettings {
+ public:
+  SPISettings() {}
+  SPISettings(uint32_t, int, int) {}
+};
+
+class SPIClass {
+ public:
+  void begin() {}
+  void begin(int, int, int, int = -1) {}
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t  transfer(uint8_t b) { if (panel.dc) panel.data(b); else panel.command(b); return 0; }
+  uint16_t transfer16(uint16_t w) { transfer(w >> 8); transfer(w); return 0; }
+  void transfer(void*, uint32_t) {}
+  void setFrequency(uint32_t) {}
+  void setDataMode(int) {}
+  void setBitOrder(int) {}
+  void write(uint8_t b) { transfer(b); }
+  void write16(uint16_t w) { transfer16(w); }
+  void write32(uint32_t) {}
+  void writeBytes(const uint8_t*, uint32_t) {}
+  void writePixels(const void*, uint32_t) {}
+};
+extern SPIClass SPI;
@@ -0,0 +1,67 @@
+// ESP-IDF partition stand-in: a data partition is a host file, added to hostPartitions
+// with its label, and esp_partition_mmap() maps it with mmap(). Mappings still open are
+// counted in hostMappings so tests can check fonts are unmapped.
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Arduino.h"
+
+#define ESP_IDF_VERSION_MAJOR 5
+
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xFF } esp_partition_subtype_t;
+typedef enum { ESP_PARTITION_MMAP_DATA, ESP_PARTITION_MMAP_INST } esp_partition_mmap_memory_t;
+typedef uint32_t esp_partition_mmap_handle_t;
+
+typedef struct {
+  std::string label;
+  std::string path;   // Host file holding the partition
+  uint32_t    size;   // Set from the file size by esp_partition_find_first()
+} esp_partition_t;
+
+inline std::vector<esp_partition_t> hostPartitions;
+inline std::vector<std::pair<void*, size_t>> hostMaps; // Index is the handle - 1
+inline int hostMappings = 0;
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t, const char* label)
+{
+  if (type != ESP_PARTITION_TYPE_DATA) return nullptr;
+  for (esp_partition_t& p : hostPartitions) {
+    struct stat st;
+    if (p.label != label || stat(p.path.c_str(), &st) != 0) continue;
+    p.size = st.st_size;
+    return &p;
+  }
+  return nullptr;
+}
+
+inline esp_err_t esp_partition_mmap(const esp_partition_t* part, size_t offset, size_t size,
+                                    esp_partition_mmap_memory_t, const void** out, esp_partition_mmap_handle_t* handle)
+{
+  if (part == nullptr || offset + size > part->size) return ESP_FAIL;
+  int fd = open(part->path.c_str(), O_RDONLY);
+  if (fd < 0) return ESP_FAIL;
+  void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, offset);
+  close(fd);
+  if (p == MAP_FAILED) return ESP_FAIL;
+  hostMaps.push_back({ p, size });
+  hostMappings++;
+  *out = p;
+  *handle = hostMaps.size();
+  return ESP_OK;
+}
+
+inline void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+  if (handle == 0 || handle > hostMaps.size() || hostMaps[handle - 1].first == nullptr) return;
+  munmap(hostMaps[handle - 1].first, hostMaps[handle - 1].second);
+  hostMaps[handle - 1].first = nullptr;
+  hostMappings--;
+}
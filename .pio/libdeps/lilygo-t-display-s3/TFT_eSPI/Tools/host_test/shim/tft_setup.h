@@ -0,0 +1,30 @@
+// Setup for the host build, a generic processor driving a 240 x 320 ILI9341 over SPI
+#define USER_SETUP_LOADED
+
+#define ILI9341_DRIVER
+#define TFT_WIDTH  240
+#define TFT_HEIGHT 320
+
+#define TFT_MOSI 1
+#define TFT_SCLK 2
+#define TFT_CS   3
+#define TFT_DC   4
+#define TFT_RST  5
+
+#define LOAD_GLCD
+#define LOAD_FONT2
+#define LOAD_FONT4
+#define LOAD_FONT6
+#define LOAD_FONT7
+#define LOAD_FONT8
+#define LOAD_GFXFF
+#define SMOOTH_FONT
+
+#define SPI_FREQUENCY 40000000
+
+// Smooth fonts can also be loaded from files, see the fs::FS stand-in in FS.h
+#include <FS.h>
+#define FONT_FS_AVAILABLE
+
+// In-place fonts can be used from a data partition, see the stand-in in esp_partition.h
+#define FONT_PARTITION_AVAILABLE
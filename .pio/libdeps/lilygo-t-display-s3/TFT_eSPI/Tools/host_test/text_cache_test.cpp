@@ -0,0 +1,140 @@
+/*
+  The cache of rendered opaque smooth font strings, checked against the
+  same strings drawn without the cache.
+
+  Random strings from a small set are drawn by drawString() on a TFT with
+  a TFT_eTextCache and on one without, with random fonts, colours, datums,
+  padding and positions, some partly off screen and some transparent, at
+  each eviction policy with cache sizes that force strings out. Each draw
+  starts from the same screen and must give the same pixels and return
+  the same width.
+
+  Six fixed labels are then drawn each frame, and the windows set per
+  frame are printed without and with the cache.
+*/
+
+#include <string>
+#include "host_test.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+static bytes_t readFile(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  return bytes_t(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static const char* words[] = { "Speed", "Temperature", "12.5", "100%", "jog", "W", " gap ", "km/h",
+                               "\xC3\xA9t\xC3\xA9", "Pressure 1013 hPa", "0", "-7 \xC2\xB0" "C" };
+
+static const uint16_t colors[] = { TFT_WHITE, TFT_BLACK, TFT_YELLOW, TFT_NAVY };
+
+static void checkRandom(TFT_eSPI& tft, TFT_eSPI& ref, TFT_eTextCache& cache, const bytes_t* fonts,
+                        uint8_t policy, size_t bytes, uint16_t entries, uint32_t seed)
+{
+  srand(seed);
+  cache.begin(bytes, entries);
+  cache.setEviction(policy);
+  cache.resetStats();
+  tft.fillScreen(TFT_DARKGREEN);
+
+  // Most draws repeat one of 24 strings set up here, so there are hits to check
+  struct { const char* s; uint8_t datum; uint16_t pad, fg, bg; bool fill; } set[24];
+  for (auto& k : set) {
+    k.s = words[rand() % 12];
+    k.datum = (rand() % 2) ? TL_DATUM : rand() % 9;
+    k.pad = (rand() % 3 == 0) ? 40 + 40 * (rand() % 3) : 0;
+    k.fg = colors[rand() % 4];
+    k.bg = colors[rand() % 4];
+    k.fill = rand() % 4 != 0;
+  }
+
+  int bad = 0;
+  for (int n = 0; n < 1500; n++) {
+    if (n % 500 == 0) {
+      int f = (n / 500) % 3;
+      tft.loadFont(fonts[f].data());
+      ref.loadFont(fonts[f].data());
+    }
+    auto k = set[rand() % 24];
+    if (rand() % 5 == 0) {
+      k.s = words[rand() % 12];
+      k.datum = rand() % 9;
+      k.fg = rand();
+    }
+    const char* s = k.s;
+    int x = (rand() % 4) ? 20 * (rand() % 4) : rand() % 300 - 40;
+    int y = (rand() % 4) ? 40 * (rand() % 4) : rand() % 330 - 20;
+    uint8_t  datum = k.datum;
+    uint16_t pad = k.pad, fg = k.fg, bg = k.bg;
+    bool fill = k.fill;
+
+    std::vector<uint16_t> before(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    int16_t w[2];
+    std::vector<uint16_t> after[2];
+    for (int pass = 0; pass < 2; pass++) {
+      TFT_eSPI& t = pass ? ref : tft;
+      memcpy(panel.fb, before.data(), before.size() * 2);
+      t.setTextDatum(datum);
+      t.setTextPadding(pad);
+      t.setTextColor(fg, bg, fill);
+      w[pass] = t.drawString(s, x, y);
+      after[pass].assign(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+    }
+    if ((after[0] != after[1] || w[0] != w[1]) && bad++ < 10)
+      CHECK(false, "policy %d %zu bytes step %d: \"%s\" at %d,%d datum %d padding %d fill %d differs",
+            policy, bytes, n, s, x, y, datum, pad, fill);
+  }
+  CHECK(bad == 0, "policy %d %zu bytes: %d of 1500 strings differ", policy, bytes, bad);
+  CHECK(cache.hits() > 20, "policy %d %zu bytes: only %u hits", policy, bytes, cache.hits());
+  CHECK(cache.used() <= bytes && cache.count() <= entries, "policy %d: %zu bytes and %u strings cached, limits %zu and %u",
+        policy, cache.used(), cache.count(), bytes, entries);
+  printf("Policy %d, %6zu bytes %2u entries: %4u hits %4u misses %4u evictions\n",
+         policy, bytes, entries, cache.hits(), cache.misses(), cache.evictions());
+
+  cache.end();
+  tft.unloadFont();
+  ref.unloadFont();
+}
+
+// Windows set to draw six labels
+static long frame(TFT_eSPI& tft)
+{
+  static const char* labels[] = { "Speed", "Temperature", "Pressure", "Voltage", "Current", "Power" };
+  long w = panel.windows;
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextPadding(0);
+  tft.setTextColor(TFT_WHITE, TFT_NAVY, true);
+  for (int i = 0; i < 6; i++) tft.drawString(labels[i], 10, 10 + i * 30);
+  return panel.windows - w;
+}
+
+int main()
+{
+  TFT_eSPI tft, ref;
+  tft.init();
+  TFT_eTextCache cache(&tft);
+
+  const char* dir = "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/";
+  bytes_t fonts[] = { readFile(std::string(dir) + "NotoSansBold15.vlw"),
+                      readFile(std::string(dir) + "NotoSansBold36.vlw"),
+                      readFile("examples/Smooth Fonts/SPIFFS/Unicode_test/data/Latin-Hiragana-24.vlw") };
+
+  uint32_t seed = 1;
+  checkRandom(tft, ref, cache, fonts, TEXT_CACHE_LRU,  64000, 32, seed++);
+  checkRandom(tft, ref, cache, fonts, TEXT_CACHE_LRU,   6000,  8, seed++);
+  checkRandom(tft, ref, cache, fonts, TEXT_CACHE_FIFO,  6000,  8, seed++);
+  checkRandom(tft, ref, cache, fonts, TEXT_CACHE_KEEP,  6000,  8, seed++);
+
+  tft.loadFont(fonts[0].data());
+  long uncached = frame(tft);
+  cache.begin(16000, 16);
+  frame(tft);
+  cache.resetStats();
+  long cached = frame(tft);
+  CHECK(cached == 6 && cache.hits() == 6, "cached frame set %ld windows with %u hits, expected 6 and 6", cached, cache.hits());
+  printf("Six labels, 15 pt: %ld windows per frame without the cache, %ld with the strings cached\n", uncached, cached);
+  cache.end();
+
+  return testResult();
+}
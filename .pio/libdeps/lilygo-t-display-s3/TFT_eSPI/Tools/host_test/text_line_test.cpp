@@ -0,0 +1,102 @@
+/*
+  Opaque smooth font strings drawn by drawString() a scanline at a time,
+  checked against the same strings drawn glyph by glyph.
+
+  GlyphTFT overrides drawTextLine() to return false, as a Sprite does, so
+  it always draws glyph by glyph. Random strings are drawn by both with
+  random fonts, colours, datums, padding and positions, some partly off
+  screen, and the panel frame buffers must be identical.
+
+  The windows set and the bytes sent for a padded 12 character label in
+  the 15 point font are printed for both ways of drawing.
+*/
+
+#include <string>
+#include "host_test.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+class GlyphTFT : public TFT_eSPI {
+  bool drawTextLine(const char *, uint16_t, uint8_t, int32_t) { return false; }
+};
+
+static bytes_t readFile(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  return bytes_t(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+static const char* chars[] = { "a", "b", "f", "g", "j", "y", "W", "M", "T", "1", "7", ".", ":", " ", "  ",
+                               "\xC3\xA9", "\xC2\xB0", "%", "_", "|" };
+
+// Draw a string the same way on the TFT and return the frame buffer
+static std::vector<uint16_t> draw(TFT_eSPI& tft, const std::string& s, int x, int y, uint8_t datum,
+                                  uint16_t pad, uint16_t fg, uint16_t bg, bool fill)
+{
+  tft.fillScreen(TFT_DARKGREEN);
+  tft.fillRect(30, 30, 100, 60, TFT_MAROON);
+  tft.setTextDatum(datum);
+  tft.setTextPadding(pad);
+  tft.setTextColor(fg, bg, fill);
+  tft.drawString(s.c_str(), x, y);
+  return std::vector<uint16_t>(panel.fb, panel.fb + HostPanel::W * HostPanel::H);
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  GlyphTFT ref;
+  tft.init();
+
+  const char* dir = "examples/Smooth Fonts/SPIFFS/Font_Demo_2/data/";
+  bytes_t fonts[] = { readFile(std::string(dir) + "NotoSansBold15.vlw"),
+                      readFile(std::string(dir) + "NotoSansBold36.vlw"),
+                      readFile("examples/Smooth Fonts/SPIFFS/Unicode_test/data/Latin-Hiragana-24.vlw") };
+
+  srand(1);
+  int bad = 0, lines = 0;
+  for (int n = 0; n < 3000; n++) {
+    const bytes_t& font = fonts[n % 3];
+    tft.loadFont(font.data());
+    ref.loadFont(font.data());
+
+    std::string s;
+    int len = 1 + rand() % 14;
+    for (int i = 0; i < len; i++) s += chars[rand() % 20];
+    int x = rand() % 300 - 40, y = rand() % 300 - 20;
+    uint8_t datum = rand() % 9;
+    uint16_t pad = (rand() % 2) ? rand() % 240 : 0;
+    uint16_t fg = rand(), bg = (rand() % 8) ? rand() : fg;
+    bool fill = rand() % 2;
+
+    long w = panel.windows;
+    std::vector<uint16_t> a = draw(tft, s, x, y, datum, pad, fg, bg, fill);
+    w = panel.windows - w;
+    long wr = panel.windows;
+    if (a != draw(ref, s, x, y, datum, pad, fg, bg, fill) && bad++ < 10)
+      CHECK(false, "case %d \"%s\" at %d,%d datum %d padding %d fill %d differs", n, s.c_str(), x, y, datum, pad, fill);
+    if (w < panel.windows - wr) lines++;
+
+    tft.unloadFont();
+    ref.unloadFont();
+  }
+  CHECK(bad == 0, "%d of 3000 strings differ", bad);
+  CHECK(lines > 500, "only %d of 3000 strings were drawn a scanline at a time", lines);
+
+  // A label redrawn with padding to clear the last value
+  tft.loadFont(fonts[0].data());
+  ref.loadFont(fonts[0].data());
+  for (int pass = 0; pass < 2; pass++) {
+    TFT_eSPI& t = pass ? (TFT_eSPI&)ref : tft;
+    t.fillScreen(TFT_BLACK);
+    t.setTextDatum(TL_DATUM);
+    t.setTextPadding(t.textWidth("Speed 999 km") + 20);
+    t.setTextColor(TFT_WHITE, TFT_BLUE, true);
+    long w = panel.windows, b = panel.bytes;
+    t.drawString("Speed 123 km", 20, 100);
+    printf("Padded 12 character label, 15 pt: %-16s %4ld windows, %6ld bytes\n",
+           pass ? "glyph by glyph" : "line at a time", panel.windows - w, panel.bytes - b);
+  }
+
+  return testResult();
+}
@@ -0,0 +1,178 @@
+/*
+  pushTransformed() checked against pushRotated() and a floating point
+  bilinear reference.
+
+  Random 16 and 8 bpp Sprites with random pivots are pushed at 0, 90, 180
+  and 270 degrees with pushRotated() and with pushTransformed() using
+  getTransform() for the same angle, with nearest and bilinear sampling,
+  opaque and with a transparent colour, to the TFT and to 16 and 8 bpp
+  Sprites. pushRotated() turns pixels about the corner of the pivot pixel
+  so the transform is moved to the matching corner of the turned pixel.
+  At these angles every sample falls on a pixel centre, where bilinear
+  weights give the pixel itself, so the pixels must match exactly.
+
+  Random rotations, scales and shears of 16 bpp Sprites are pushed to a 16
+  bpp Sprite with bilinear sampling and compared with bilinear sampling in
+  double precision, edge pixels repeated. Pixels whose centre maps within
+  a hundredth of a pixel of the Sprite edge are skipped as either may
+  draw them. Each channel must be within one level.
+
+  A Sprite with a transparent right half moved right by half a pixel has
+  its last opaque column exactly half covered. Those pixels must stay
+  opaque, the average of the two pixels each side of the edge.
+*/
+
+#include <cmath>
+#include "host_test.h"
+
+// Offset of the turned pivot pixel corner, pushRotated() turns pixels about it
+static const float cornerX[4] = { 0, 1, 1, 0 }, cornerY[4] = { 0, 0, 1, 1 };
+
+static void fillRandom(TFT_eSprite& s, uint16_t transp)
+{
+  uint16_t colors[4];
+  for (uint16_t& c : colors) c = rand();
+  for (int y = 0; y < s.height(); y++)
+    for (int x = 0; x < s.width(); x++) s.drawPixel(x, y, rand() % 3 ? (uint16_t)rand() : rand() % 2 ? transp : colors[rand() % 4]);
+}
+
+static void checkRight(TFT_eSPI& tft)
+{
+  TFT_eSprite a(&tft), b(&tft);
+  int bad = 0, cases = 0;
+  for (int n = 0; n < 400; n++) {
+    int sbpp = (n & 1) ? 8 : 16, dbpp = (n & 2) ? 8 : 16;
+    bool tft_ = (n % 8) >= 4;
+    TFT_eSprite src(&tft);
+    src.setColorDepth(sbpp);
+    src.createSprite(1 + rand() % 40, 1 + rand() % 40);
+    uint16_t transp = rand();
+    fillRandom(src, transp);
+    src.setPivot(rand() % 50 - 5, rand() % 50 - 5);
+    bool useTransp = rand() % 2;
+    int32_t px = rand() % 60 - 10, py = rand() % 60 - 10;
+
+    for (int q = 0; q < 4; q++)
+      for (uint8_t filter : { SAMPLE_NEAREST, SAMPLE_BILINEAR }) {
+        std::vector<uint16_t> out[2];
+        for (int pass = 0; pass < 2; pass++) {
+          TFT_eSprite& d = pass ? b : a;
+          if (!tft_) {
+            d.setColorDepth(dbpp);
+            d.createSprite(60, 60);
+            d.fillSprite(TFT_DARKGREY);
+            d.setPivot(px, py);
+          }
+          else {
+            tft.fillScreen(TFT_DARKGREY);
+            tft.setPivot(px, py);
+          }
+          float m[6];
+          src.getTransform(m, q * 90, 1, 1, px + cornerX[q], py + cornerY[q]);
+          uint32_t tp = useTransp ? transp : 0x00FFFFFF;
+          if (!tft_) { if (pass) src.pushTransformed(&d, m, filter, tp); else src.pushRotated(&d, q * 90, tp); }
+          else       { if (pass) src.pushTransformed(m, filter, tp); else src.pushRotated(q * 90, tp); }
+          for (int y = 0; y < 60; y++)
+            for (int x = 0; x < 60; x++) out[pass].push_back(tft_ ? panel.fb[x + y * HostPanel::W] : d.readPixel(x, y));
+          if (!tft_) d.deleteSprite();
+        }
+        cases++;
+        if (out[0] != out[1] && bad++ < 10)
+          CHECK(false, "case %d %d bpp to %s, %d degrees filter %d transparent %d: %dx%d differs", n, sbpp,
+                tft_ ? "TFT" : (dbpp == 8 ? "8 bpp" : "16 bpp"), q * 90, filter, useTransp, src.width(), src.height());
+      }
+  }
+  CHECK(bad == 0, "right angles: %d of %d pushes differ from pushRotated()", bad, cases);
+}
+
+// 565 channel of colour c, 0 red, 1 green, 2 blue
+static int chan(uint16_t c, int ch) { return ch == 0 ? c >> 11 : ch == 1 ? (c >> 5) & 0x3F : c & 0x1F; }
+
+static void checkFloat(TFT_eSPI& tft)
+{
+  TFT_eSprite dst(&tft);
+  dst.createSprite(100, 100);
+
+  int bad = 0, compared = 0, close = 0;
+  for (int n = 0; n < 300; n++) {
+    TFT_eSprite src(&tft);
+    int w = 2 + rand() % 30, h = 2 + rand() % 30;
+    src.createSprite(w, h);
+    fillRandom(src, 0);
+    src.setPivot(rand() % w, rand() % h);
+
+    float m[6];
+    src.getTransform(m, rand() % 360, 0.5f + (rand() % 100) / 40.0f, 0.5f + (rand() % 100) / 40.0f, 50, 50);
+    m[1] += (rand() % 100 - 50) / 100.0f; // Shear
+    dst.fillSprite(TFT_DARKGREY);
+    src.pushTransformed(&dst, m, SAMPLE_BILINEAR);
+
+    double det = (double)m[0] * m[4] - (double)m[1] * m[3];
+    double ia = m[4] / det, ib = -m[1] / det, id = -m[3] / det, ie = m[0] / det;
+    for (int y = 0; y < 100; y++)
+      for (int x = 0; x < 100; x++) {
+        double ux = x + 0.5 - m[2], uy = y + 0.5 - m[5];
+        double sx = ia * ux + ib * uy, sy = id * ux + ie * uy;
+        if (sx < 0.01 || sy < 0.01 || sx > w - 0.01 || sy > h - 0.01) continue;
+        double fx = sx - 0.5, fy = sy - 0.5;
+        int tx = floor(fx), ty = floor(fy);
+        fx -= tx; fy -= ty;
+        double want[3] = { 0, 0, 0 };
+        for (int k = 0; k < 4; k++) {
+          int px = tx + (k & 1), py = ty + (k >> 1);
+          px = px < 0 ? 0 : px >= w ? w - 1 : px;
+          py = py < 0 ? 0 : py >= h ? h - 1 : py;
+          double wt = ((k & 1) ? fx : 1 - fx) * ((k >> 1) ? fy : 1 - fy);
+          uint16_t c = src.readPixel(px, py);
+          for (int ch = 0; ch < 3; ch++) want[ch] += wt * chan(c, ch);
+        }
+        uint16_t got = dst.readPixel(x, y);
+        compared++;
+        double worst = 0;
+        for (int ch = 0; ch < 3; ch++) worst = max(worst, fabs(chan(got, ch) - want[ch]));
+        if (worst > 0.5) close++;
+        if (worst > 1.0 && bad++ < 10)
+          CHECK(false, "case %d pixel %d,%d: %04X is %.2f levels from the reference", n, x, y, got, worst);
+      }
+  }
+  CHECK(bad == 0, "bilinear: %d of %d pixels more than a level from the reference", bad, compared);
+  printf("Bilinear: %d pixels compared, %d not the nearest level\n", compared, close);
+}
+
+static void checkHalf(TFT_eSPI& tft)
+{
+  // Columns 0 to 2 white, 3 black and 4 to 7 transparent
+  TFT_eSprite src(&tft), dst(&tft);
+  src.createSprite(8, 8);
+  dst.createSprite(20, 20);
+  src.fillSprite(TFT_MAGENTA);
+  src.fillRect(0, 0, 3, 8, TFT_WHITE);
+  src.fillRect(3, 0, 1, 8, TFT_BLACK);
+
+  // Moved by 5.5, x = 8 samples between columns 2 and 3, x = 9 between 3 and 4
+  float m[6] = { 1, 0, 5.5f, 0, 1, 5 };
+  dst.fillSprite(TFT_BLUE);
+  src.pushTransformed(&dst, m, SAMPLE_BILINEAR, TFT_MAGENTA);
+
+  int bad = 0;
+  for (int y = 6; y < 12; y++) {
+    if (dst.readPixel(8, y) != 0x8410) bad++;     // Half white, half black
+    if (dst.readPixel(9, y) != TFT_BLACK) bad++;  // Half covered, opaque
+    if (dst.readPixel(10, y) != TFT_BLUE) bad++;  // Not covered
+  }
+  CHECK(bad == 0, "half covered: %d of 18 pixels wrong, x = 8 to 10 on row 8 are %04X %04X %04X", bad,
+        dst.readPixel(8, 8), dst.readPixel(9, 8), dst.readPixel(10, 8));
+}
+
+int main()
+{
+  TFT_eSPI tft;
+  tft.init();
+
+  srand(1);
+  checkRight(tft);
+  checkFloat(tft);
+  checkHalf(tft);
+
+  return testResult();
+}
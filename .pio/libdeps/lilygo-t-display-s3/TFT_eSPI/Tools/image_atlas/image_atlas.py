@@ -0,0 +1,219 @@
+'''
+
+    This script packs all the images in a directory into one image atlas
+    and writes a C header for use with pushAtlasImage().
+
+    The header holds the atlas pixel array, a rectangle table and an
+    imageAtlas_t structure. Each image gets a #define with its id, made
+    from the atlas name and the file name.
+
+    You'll need python 3.6 and the Pillow library (pip install Pillow)
+
+    usage: python image_atlas.py [-v] icons [-o icons.h] [-n icons] [-b 16|8|4]
+                                 [-w 256] [-p 0] [-k 0x0120]
+
+    Pixels with an alpha value below 128 are set to the key colour, which
+    defaults to TFT_TRANSPARENT (0x0120). The header defines <NAME>_KEY as
+    the colour these pixels are read back as, push images with it as the
+    transparent colour to skip them. Opaque pixels that would be read back
+    as the key colour are changed slightly so they stay opaque.
+
+    A 4 bpp atlas uses one 16 colour palette for all images. The image
+    pixels are reduced to 15 colours and entry 15 is the key colour, the
+    header defines <NAME>_KEY_INDEX as this palette index.
+
+'''
+
+import sys
+import os
+import re
+import argparse
+
+try:
+    from PIL import Image
+except ImportError:
+    print("The Pillow library is needed: pip install Pillow")
+    sys.exit(1)
+
+debug = None
+
+def debugOut(s):
+    if debug:
+        print(s)
+
+# look at arguments
+parser = argparse.ArgumentParser(description="Pack a directory of images into an image atlas C header")
+parser.add_argument("-v", "--verbose", help="debug output", action="store_true")
+parser.add_argument("input", help="input directory")
+parser.add_argument("-o", "--output", help="output file name")
+parser.add_argument("-n", "--name", help="atlas name, default is the directory name")
+parser.add_argument("-b", "--bpp", help="bits per pixel: 16, 8 or 4", type=int, choices=[16, 8, 4], default=16)
+parser.add_argument("-w", "--width", help="maximum atlas width in pixels", type=int, default=256)
+parser.add_argument("-p", "--pad", help="pixels between images", type=int, default=0)
+parser.add_argument("-k", "--key", help="RGB565 colour for transparent pixels", default="0x0120")
+args = parser.parse_args()
+
+if not os.path.isdir(args.input):
+    parser.print_help()
+    print("The input directory {} does not exist".format(args.input))
+    sys.exit(1)
+
+debug = args.verbose
+
+name = args.name
+if name is None:
+    name = os.path.basename(os.path.normpath(args.input))
+name = re.sub(r"\W", "_", name)
+if name[0].isdigit():
+    name = "_" + name
+
+output = args.output
+if output is None:
+    output = name + ".h"
+
+key = int(args.key, 0) & 0xFFFF
+keyRGB = ((key >> 8) & 0xF8, (key >> 3) & 0xFC, (key << 3) & 0xF8)
+
+# Load images, fully transparent pixels take the key colour
+images = []
+for f in sorted(os.listdir(args.input)):
+    path = os.path.join(args.input, f)
+    try:
+        img = Image.open(path)
+    except Exception:
+        debugOut("skipping {}".format(f))
+        continue
+    img = img.convert("RGBA")
+    opaque = img.getchannel("A").point(lambda a: 255 if a >= 128 else 0)
+    rgb = Image.new("RGB", img.size, keyRGB)
+    rgb.paste(img.convert("RGB"), mask=opaque)
+    ident = re.sub(r"\W", "_", os.path.splitext(f)[0]).upper()
+    if ident in ("KEY", "KEY_INDEX"):
+        print("The image name {} is used for the key colour #define, rename {}".format(ident, f))
+        sys.exit(1)
+    images.append({"id": ident, "img": rgb, "mask": opaque, "w": img.width, "h": img.height})
+    debugOut("loaded {} {}x{}".format(f, img.width, img.height))
+
+if not images:
+    print("No images found in {}".format(args.input))
+    sys.exit(1)
+
+# Shelf packing, tallest images first
+width = max(args.width, max(i["w"] for i in images))
+x = y = shelf = 0
+for i in sorted(images, key=lambda i: (-i["h"], -i["w"])):
+    if x + i["w"] > width:
+        x = 0
+        y += shelf + args.pad
+        shelf = 0
+    i["x"], i["y"] = x, y
+    x += i["w"] + args.pad
+    shelf = max(shelf, i["h"])
+height = y + shelf
+
+# Trim unused width, 4 bpp rows hold an even number of pixels
+width = max(i["x"] + i["w"] for i in images)
+if args.bpp == 4:
+    width = (width + 1) & ~1
+
+atlas = Image.new("RGB", (width, height), keyRGB)
+mask = Image.new("L", (width, height), 0)
+for i in images:
+    atlas.paste(i["img"], (i["x"], i["y"]))
+    mask.paste(i["mask"], (i["x"], i["y"]))
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+def rgb332(r, g, b):
+    return (r & 0xE0) | ((g & 0xE0) >> 3) | (b >> 6)
+
+def color8to16(c):
+    # As TFT_eSPI::color8to16(), the colour an 8 bpp pixel is read back as
+    return (c & 0x1C) << 6 | (c & 0xC0) << 5 | (c & 0xE0) << 8 | (c & 0x1C) << 3 | [0, 11, 21, 31][c & 3]
+
+pixels = atlas.tobytes()
+rgb = [tuple(pixels[p:p + 3]) for p in range(0, len(pixels), 3)]
+opaque = list(mask.tobytes())
+
+# Opaque pixels equal to the key have the lowest blue bit flipped so they are still drawn
+palette = None
+keyIndex = None
+if args.bpp == 16:
+    ctype = "uint16_t"
+    keyColor = key
+    data = [rgb565(*p) for p in rgb]
+    data = [keyColor ^ 1 if (o and d == keyColor) else d for d, o in zip(data, opaque)]
+    fmt = "0x{:04X}"
+elif args.bpp == 8:
+    ctype = "uint8_t"
+    key8 = rgb332(*keyRGB)
+    keyColor = color8to16(key8)
+    data = [rgb332(*p) for p in rgb]
+    data = [key8 ^ 1 if (o and d == key8) else d for d, o in zip(data, opaque)]
+    fmt = "0x{:02X}"
+else:
+    ctype = "uint8_t"
+    fmt = "0x{:02X}"
+    # Reduce the opaque pixels to 15 colours, median cut can average the key colour into
+    # an entry so the key is not quantized, it is added as entry 15
+    keyIndex = 15
+    keyColor = key
+    solid = [p for p, o in zip(rgb, opaque) if o]
+    pal = []
+    idx = []
+    if solid:
+        strip = Image.new("RGB", (len(solid), 1))
+        strip.putdata(solid)
+        indexed = strip.quantize(colors=15, dither=Image.NONE)
+        pal = indexed.getpalette()[:45]
+        idx = list(indexed.tobytes())
+    pal += [0] * (45 - len(pal))
+    palette = [rgb565(pal[c * 3], pal[c * 3 + 1], pal[c * 3 + 2]) for c in range(15)]
+    palette = [c ^ 1 if c == keyColor else c for c in palette] + [keyColor]
+    solid = iter(idx)
+    idx = [next(solid) if o else keyIndex for o in opaque]
+    # Even x pixel in the high nibble
+    data = [(idx[p] << 4) | idx[p + 1] for p in range(0, len(idx), 2)]
+
+debugOut("atlas {}x{} at {} bpp, {} bytes".format(width, height, args.bpp, width * height * args.bpp // 8))
+
+def array(values, fmt, perLine):
+    lines = []
+    for p in range(0, len(values), perLine):
+        lines.append("  " + ", ".join(fmt.format(v) for v in values[p:p + perLine]) + ",")
+    return "\n".join(lines)
+
+out  = "// Image atlas generated by image_atlas.py from {}\n".format(os.path.basename(os.path.normpath(args.input)))
+out += "// {} images, {} x {} pixels, {} bpp\n".format(len(images), width, height, args.bpp)
+out += "// Use with tft.pushAtlasImage(&{}, id, x, y) or spr.pushAtlasImage(...)\n\n".format(name)
+out += "#pragma once\n\n"
+
+out += "// Colour of transparent pixels, use as the pushAtlasImage() transparent colour\n"
+out += "#define {}_KEY 0x{:04X}\n".format(name.upper(), keyColor)
+if keyIndex is not None:
+    out += "// Palette index of transparent pixels\n"
+    out += "#define {}_KEY_INDEX {}\n".format(name.upper(), keyIndex)
+out += "\n"
+
+for n, i in enumerate(images):
+    out += "#define {}_{} {}\n".format(name.upper(), i["id"], n)
+out += "\n"
+
+out += "const atlasRect_t {}_rect[{}] PROGMEM = {{\n".format(name, len(images))
+for i in images:
+    out += "  {{ {}, {}, {}, {} }}, // {}\n".format(i["x"], i["y"], i["w"], i["h"], i["id"])
+out += "};\n\n"
+
+if palette:
+    out += "const uint16_t {}_palette[16] PROGMEM = {{\n{}\n}};\n\n".format(name, array(palette, "0x{:04X}", 8))
+
+out += "const {} {}_data[{}] PROGMEM = {{\n{}\n}};\n\n".format(ctype, name, len(data), array(data, fmt, 16 if args.bpp == 16 else 24))
+
+out += "const imageAtlas_t {} = {{ {}_data, {}_rect, {}, {}, {}, {}, {} }};\n".format(
+    name, name, name, name + "_palette" if palette else "nullptr", width, height, len(images), args.bpp)
+
+with open(output, "w") as f:
+    f.write(out)
+
+print("Wrote {} images ({} x {}, {} bpp) to {}".format(len(images), width, height, args.bpp, output))
@@ -0,0 +1,228 @@
+'''
+
+    This script converts a smooth font .vlw file into the run length coded
+    variant drawn by loadFont(). Alpha values are reduced to 4 or 2 bits and
+    each glyph row is coded as runs of transparent and opaque pixels, with
+    the partly transparent pixels between them.
+
+    With -f inplace the font is written in the in-place layout instead. The
+    glyph metrics are stored as little-endian arrays, sorted by code, which
+    loadFont() uses where they are without allocating any RAM. Bitmaps are
+    kept at 8 bits (-b 8) or run length coded.
+
+    The output is a font file for SPIFFS, LittleFS or SD, a binary for a data
+    partition (in-place fonts), or a C header with the font as a PROGMEM
+    array if the output file name ends in .h
+
+    usage: python vlw_compress.py [-v] font.vlw [-o font_rle.vlw] [-b 8|4|2]
+                                  [-f vlw|inplace]
+
+    See loadFont() in Extensions/Smooth_font.cpp and inPlaceFont_t in
+    Extensions/Smooth_font.h for the formats.
+
+'''
+
+import sys
+import os
+import re
+import struct
+import argparse
+
+debug = None
+
+def debugOut(s):
+    if debug:
+        print(s)
+
+# look at arguments
+parser = argparse.ArgumentParser(description="Convert a .vlw smooth font to the run length coded or in-place variant")
+parser.add_argument("-v", "--verbose", help="debug output", action="store_true")
+parser.add_argument("input", help="input .vlw file")
+parser.add_argument("-o", "--output", help="output file, .h for a C header, default is the input name with _rle or _inplace added")
+parser.add_argument("-b", "--bits", help="bits of alpha per pixel: 8 (in-place only), 4 or 2", type=int, choices=[8, 4, 2], default=4)
+parser.add_argument("-f", "--format", help="vlw or inplace", choices=["vlw", "inplace"], default="vlw")
+args = parser.parse_args()
+
+if not os.path.isfile(args.input):
+    parser.print_help()
+    print("The input file {} does not exist".format(args.input))
+    sys.exit(1)
+
+if args.format == "vlw" and args.bits == 8:
+    print("8 bit alpha is only used for in-place fonts, the input is already a vlw font")
+    sys.exit(1)
+
+debug = args.verbose
+
+output = args.output
+if output is None:
+    if args.format == "vlw":
+        output = os.path.splitext(args.input)[0] + "_rle.vlw"
+    else:
+        output = os.path.splitext(args.input)[0] + "_inplace.bin"
+
+with open(args.input, "rb") as f:
+    vlw = f.read()
+
+count, version, size, mbox, ascent, descent = struct.unpack_from(">6I", vlw, 0)
+if version != 11:
+    print("{} is not an uncompressed vlw font (version {:#x})".format(args.input, version))
+    sys.exit(1)
+
+# Glyph metrics, 7 values per glyph after the 24 byte header
+metrics = [list(struct.unpack_from(">7i", vlw, 24 + 28 * n)) for n in range(count)]
+
+bits = args.bits
+top  = (1 << bits) - 1
+
+def quantize(a):
+    return (a * top + 127) // 255
+
+def codeRow(row):
+    # Values 0 and top start a run and are followed by the run length - 1
+    out = []
+    x = 0
+    w = len(row)
+    while x < w:
+        v = row[x]
+        if v == 0 or v == top:
+            n = 1
+            while x + n < w and n <= top and row[x + n] == v:
+                n += 1
+            out += [v, n - 1]
+            x += n
+        else:
+            out.append(v)
+            x += 1
+    return out
+
+def pack(values):
+    # Most significant bits first, padded to a whole byte
+    out = bytearray()
+    acc = used = 0
+    for v in values:
+        acc = (acc << bits) | v
+        used += bits
+        if used == 8:
+            out.append(acc)
+            acc = used = 0
+    if used:
+        out.append(acc << (8 - used))
+    return out
+
+# Code the bitmaps, which follow the metrics in glyph order
+ptr = 24 + 28 * count
+glyphs = []
+for m in metrics:
+    height, width = m[1], m[2]
+    if bits == 8:
+        glyph = vlw[ptr:ptr + width * height]
+    else:
+        values = []
+        for y in range(height):
+            values += codeRow([quantize(a) for a in vlw[ptr + y * width:ptr + (y + 1) * width]])
+        glyph = pack(values)
+    ptr += width * height
+    glyphs.append(bytes(glyph))
+    debugOut("glyph 0x{:04X} {}x{} {} bytes".format(m[0], width, height, len(glyph)))
+
+names = vlw[ptr:]
+
+def vlwFont():
+    # Header with the new version, metrics with the byte count in place of the padding value,
+    # coded bitmaps, then the font names unchanged
+    font = bytearray(vlw[0:24])
+    struct.pack_into(">I", font, 4, 0x524C4500 | bits)
+    for m, g in zip(metrics, glyphs):
+        font += struct.pack(">6ii", *m[0:6], len(g))
+    for g in glyphs:
+        font += g
+    return font + names
+
+def inPlaceFont():
+    # The values loadFont() would calculate from a vlw font
+    asc  = ascent & 0xFFFF
+    desc = descent & 0xFFFF
+    maxDescent = desc
+    for m in metrics:
+        code, height, dY = m[0] & 0xFFFF, m[1] & 0xFF, ((m[4] + 0x8000) & 0xFFFF) - 0x8000
+        if height - dY > maxDescent:
+            if (code > 0x20 and code < 0xA0 and code != 0x7F) or code > 0xFF:
+                maxDescent = height - dY
+    maxAscent  = asc
+    yAdvance   = (maxAscent + maxDescent) & 0xFFFF
+    spaceWidth = ((asc + desc) * 2 // 7) & 0xFFFF
+
+    # Glyphs in code order, a stable sort keeps the first of any duplicated code first
+    order = sorted(range(count), key=lambda n: metrics[n][0] & 0xFFFF)
+
+    arrays = [
+        ("<H", [metrics[n][0] & 0xFFFF for n in order]),
+        ("<B", [metrics[n][1] & 0xFF for n in order]),
+        ("<B", [metrics[n][2] & 0xFF for n in order]),
+        ("<B", [metrics[n][3] & 0xFF for n in order]),
+        ("<h", [((metrics[n][4] + 0x8000) & 0xFFFF) - 0x8000 for n in order]),
+        ("<b", [((metrics[n][5] + 0x80) & 0xFF) - 0x80 for n in order]),
+    ]
+
+    latin1 = [0xFFFF] * 256
+    for i in range(count - 1, -1, -1):
+        code = metrics[order[i]][0] & 0xFFFF
+        if code < 256:
+            latin1[code] = i
+
+    headerSize = 56
+    offsets = []
+    body = bytearray()
+    pos = headerSize
+    for fmt, values in arrays:
+        offsets.append(pos)
+        data = b"".join(struct.pack(fmt, v) for v in values)
+        data += bytes(-len(data) & 3)
+        body += data
+        pos += len(data)
+
+    bitmapOffsets = pos
+    pos += 4 * count
+    latin1Offset = pos
+    pos += 512
+
+    bitmapPos = []
+    bitmaps = bytearray()
+    for n in order:
+        bitmapPos.append(pos + len(bitmaps))
+        bitmaps += glyphs[n]
+    bitmapEnd = pos + len(bitmaps)
+
+    body += b"".join(struct.pack("<I", p) for p in bitmapPos)
+    body += b"".join(struct.pack("<H", i) for i in latin1)
+    body += bitmaps
+
+    header = struct.pack("<IBBHHHhhHH9I", 0x49574C56, bits, 1, count, yAdvance, spaceWidth,
+                         ((asc + 0x8000) & 0xFFFF) - 0x8000, ((desc + 0x8000) & 0xFFFF) - 0x8000,
+                         maxAscent, maxDescent, *offsets, bitmapOffsets, latin1Offset, bitmapEnd)
+    return header + body
+
+font = vlwFont() if args.format == "vlw" else inPlaceFont()
+
+if output.endswith(".h"):
+    name = re.sub(r"\W", "_", os.path.splitext(os.path.basename(output))[0])
+    if name[0].isdigit():
+        name = "_" + name
+    kind = "Run length coded" if args.format == "vlw" else "In-place"
+    out  = "// {} smooth font generated by vlw_compress.py from {}\n".format(kind, os.path.basename(args.input))
+    out += "// Load with tft.loadFont({})\n\n".format(name)
+    out += "#include <pgmspace.h>\n\n"
+    # In-place fonts are read as arrays of 16 and 32 bit values
+    out += "alignas(4) const uint8_t {}[] PROGMEM = {{\n".format(name)
+    for p in range(0, len(font), 16):
+        out += "  " + ", ".join("0x{:02X}".format(b) for b in font[p:p + 16]) + ",\n"
+    out += "};\n"
+    with open(output, "w") as f:
+        f.write(out)
+else:
+    with open(output, "wb") as f:
+        f.write(font)
+
+print("Wrote {} glyphs with {} bit alpha to {}, {} bytes ({}% of {})".format(
+    count, bits, output, len(font), len(font) * 100 // len(vlw), len(vlw)))
@@ -0,0 +1,125 @@
+/*
+  Sketch to show save-under buffers for a moving meter needle.
+
+  The meter dial is drawn once on the screen. Before the needle is
+  drawn the screen area it will cover is saved, and the next update
+  restores that area to remove the old needle. Only the needle box
+  is held in RAM, so no full screen Sprite is needed to redraw the
+  background under the needle.
+
+  A second overlay, a small value label, is saved after the needle so
+  the two are restored in reverse order with restoreAll().
+
+  The TFT must support pixel reads (readRect) for this sketch to work.
+
+  Example for library:
+  https://github.com/Bodmer/TFT_eSPI
+
+*/
+
+#include <TFT_eSPI.h>                 // Include the graphics library
+
+TFT_eSPI tft = TFT_eSPI();            // Declare object "tft"
+
+TFT_eSaveUnder under(&tft);           // Areas under the needle and label
+
+#define STORE_SIZE  (24 * 1024)       // Save-under store size in bytes
+
+#define DIAL_R      80                // Dial radius
+#define NEEDLE_L    70                // Needle length
+#define NEEDLE_W    5                 // Needle width at the pivot
+
+int32_t cx, cy;                       // Dial centre
+
+// -------------------------------------------------------------------------
+// Setup
+// -------------------------------------------------------------------------
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  tft.init();
+  tft.setRotation(1);
+
+  if (!under.begin(STORE_SIZE)) Serial.println("Save-under store allocation failed");
+
+  cx = tft.width() / 2;
+  cy = tft.height() / 2 + 20;
+
+  drawDial();
+}
+
+// -------------------------------------------------------------------------
+// Loop
+// -------------------------------------------------------------------------
+void loop()
+{
+  static float value = 0, step = 0.7;
+
+  value += step;
+  if (value >= 100 || value <= 0) step = -step;
+
+  // Remove the label and the needle, most recent first
+  under.restoreAll();
+
+  drawNeedle(value);
+  drawLabel(value);
+
+  delay(10);
+}
+
+// -------------------------------------------------------------------------
+// Draw a dial background with a gradient and scale ticks
+// -------------------------------------------------------------------------
+void drawDial()
+{
+  tft.fillScreen(TFT_NAVY);
+
+  for (int32_t r = DIAL_R; r > 0; r -= 2) {
+    tft.fillCircle(cx, cy, r, tft.color565(40 + r, 40 + r, 60 + r));
+  }
+
+  // Scale from 210 to 330 degrees (0 to 100), 0 degrees is at 3 o'clock
+  for (int32_t i = 0; i <= 10; i++) {
+    float a = (210 + i * 12) * DEG_TO_RAD;
+    float len = (i % 5) ? 8 : 14;
+    tft.drawWideLine(cx + cos(a) * (DIAL_R - len), cy + sin(a) * (DIAL_R - len),
+                     cx + cos(a) * (DIAL_R - 2), cy + sin(a) * (DIAL_R - 2), 2, TFT_WHITE);
+  }
+}
+
+// -------------------------------------------------------------------------
+// Save the area under the needle, then draw it
+// -------------------------------------------------------------------------
+void drawNeedle(float value)
+{
+  float a  = (210 + value * 1.2) * DEG_TO_RAD;
+  float tx = cx + cos(a) * NEEDLE_L;
+  float ty = cy + sin(a) * NEEDLE_L;
+
+  // Bounding box of the needle with a margin for the width and anti-aliasing
+  int32_t m  = NEEDLE_W + 2;
+  int32_t x0 = min(cx, (int32_t)tx) - m, y0 = min(cy, (int32_t)ty) - m;
+  int32_t x1 = max(cx, (int32_t)tx) + m, y1 = max(cy, (int32_t)ty) + m;
+
+  if (!under.save(x0, y0, x1 - x0 + 1, y1 - y0 + 1)) Serial.println("Save-under store full");
+
+  tft.drawWedgeLine(cx, cy, tx, ty, NEEDLE_W, 1, TFT_RED);
+}
+
+// -------------------------------------------------------------------------
+// Save the area under the value label, then draw it
+// -------------------------------------------------------------------------
+void drawLabel(float value)
+{
+  int32_t w = 60, h = 20;
+  int32_t x = cx - w / 2, y = cy + 24;
+
+  under.save(x, y, w, h);
+
+  tft.fillRoundRect(x, y, w, h, 4, TFT_BLACK);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  tft.setTextDatum(MC_DATUM);
+  tft.drawNumber((int32_t)value, cx, y + h / 2, 2);
+}
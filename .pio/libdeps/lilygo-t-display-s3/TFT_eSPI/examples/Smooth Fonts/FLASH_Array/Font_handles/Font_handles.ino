@@ -0,0 +1,83 @@
+/*
+  Sketch to show smooth font handles.
+
+  Each font is loaded once into a TFT_eSmoothFont handle. The TFT and any
+  number of Sprites then select a font with setFont(), which only points
+  them at the metrics held by the handle. Switching between the fonts does
+  not reload them, and the two Sprites share one copy of each font.
+
+  A font handle must stay loaded while a TFT or Sprite has it selected.
+
+  Example for library:
+  https://github.com/Bodmer/TFT_eSPI
+
+*/
+
+#include "NotoSansBold15.h"
+#include "NotoSansBold36.h"
+
+#include <TFT_eSPI.h>                 // Include the graphics library
+
+TFT_eSPI    tft = TFT_eSPI();         // Declare object "tft"
+
+TFT_eSprite label = TFT_eSprite(&tft);   // Sprite for a label
+TFT_eSprite value = TFT_eSprite(&tft);   // Sprite for a value
+
+TFT_eSmoothFont smallFont(&tft);      // Font handles, loaded using "tft"
+TFT_eSmoothFont largeFont(&tft);
+
+// -------------------------------------------------------------------------
+// Setup
+// -------------------------------------------------------------------------
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  tft.init();
+  tft.setRotation(1);
+  tft.fillScreen(TFT_BLACK);
+
+  // Load each font once
+  if (!smallFont.load(NotoSansBold15)) Serial.println("Small font load failed");
+  if (!largeFont.load(NotoSansBold36)) Serial.println("Large font load failed");
+
+  label.createSprite(120, 20);
+  value.createSprite(120, 40);
+
+  // The Sprites keep their own font selection
+  label.setFont(&smallFont);
+  value.setFont(&largeFont);
+
+  label.setTextColor(TFT_WHITE, TFT_BLACK);
+  value.setTextColor(TFT_YELLOW, TFT_BLACK);
+}
+
+// -------------------------------------------------------------------------
+// Loop
+// -------------------------------------------------------------------------
+void loop()
+{
+  static uint32_t count = 0;
+
+  // Mix both fonts on the screen, no font is reloaded
+  tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
+  tft.setFont(&largeFont);
+  tft.drawString("Fonts", 10, 10);
+  tft.setFont(&smallFont);
+  tft.drawString("selected with setFont()", 10, 50);
+
+  for (int32_t i = 0; i < 2; i++)
+  {
+    label.fillSprite(TFT_BLACK);
+    label.drawString(i ? "Seconds" : "Count", 0, 2);
+    label.pushSprite(10 + i * 140, 80);
+
+    value.fillSprite(TFT_BLACK);
+    value.drawNumber(i ? millis() / 1000 : count, 0, 4);
+    value.pushSprite(10 + i * 140, 100);
+  }
+
+  count++;
+  delay(100);
+}
@@ -0,0 +1,82 @@
+/*
+  Sketch to show the cache of rendered smooth font strings.
+
+  A dashboard redraws the same labels every frame. With a TFT_eTextCache
+  started, each opaque string drawn by drawString() is kept as rendered
+  pixels, and drawing it again in the same font, colours and datum sends
+  the copy to the TFT in one window instead of rendering it again.
+
+  Only strings that change, such as the values, are rendered each frame.
+  The cache statistics are printed to the Serial Monitor.
+
+  Example for library:
+  https://github.com/Bodmer/TFT_eSPI
+
+*/
+
+#include "NotoSansBold15.h"
+
+#include <TFT_eSPI.h>                 // Include the graphics library
+
+TFT_eSPI       tft = TFT_eSPI();      // Declare object "tft"
+
+TFT_eTextCache cache(&tft);           // Rendered strings drawn on "tft"
+
+#define CACHE_SIZE  (16 * 1024)       // Cache size in bytes
+
+const char* names[] = { "Speed", "Temperature", "Pressure", "Voltage" };
+
+// -------------------------------------------------------------------------
+// Setup
+// -------------------------------------------------------------------------
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  tft.init();
+  tft.setRotation(1);
+  tft.fillScreen(TFT_BLACK);
+
+  tft.loadFont(NotoSansBold15);
+
+  if (!cache.begin(CACHE_SIZE, 16)) Serial.println("Text cache allocation failed");
+}
+
+// -------------------------------------------------------------------------
+// Loop
+// -------------------------------------------------------------------------
+void loop()
+{
+  static uint32_t frame = 0;
+
+  uint32_t t = micros();
+
+  for (int32_t i = 0; i < 4; i++)
+  {
+    int32_t y = 10 + i * 30;
+
+    // The labels are the same every frame so are drawn from the cache
+    tft.setTextColor(TFT_WHITE, TFT_NAVY, true);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(names[i], 10, y);
+
+    // Values with padding, repeated values are also drawn from the cache
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.setTextDatum(TR_DATUM);
+    tft.setTextPadding(tft.textWidth("8888"));
+    tft.drawNumber((frame / (i + 1)) % 100, 200, y);
+    tft.setTextPadding(0);
+  }
+
+  t = micros() - t;
+
+  if (++frame % 100 == 0)
+  {
+    Serial.printf("Frame %u us, hits %u, misses %u, evictions %u, %u strings in %u bytes\n",
+                  t, cache.hits(), cache.misses(), cache.evictions(), cache.count(), cache.used());
+    cache.resetStats();
+  }
+
+  delay(20);
+}
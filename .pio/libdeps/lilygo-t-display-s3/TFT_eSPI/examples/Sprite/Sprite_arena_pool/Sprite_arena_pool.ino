@@ -0,0 +1,142 @@
+/*
+  Sketch to show the Sprite arena and pool allocators.
+
+  The sketch replays a trace of screen changes. Each screen creates a
+  set of Sprites of different sizes and colour depths from an arena,
+  draws in them, pushes them to the screen and deletes them again in
+  a random order. The arena mark() taken when the screen opens is
+  released when it closes, so the arena is empty again for the next
+  screen however the Sprites were deleted.
+
+  A pool of equal sized blocks is used for small icon Sprites that
+  are created and deleted in any order.
+
+  The current and peak usage of both allocators, and the largest free
+  heap block, are printed to the Serial Monitor. When Sprites come from
+  the heap a long run of screen changes fragments the heap, with the
+  allocators the largest free block stays the same.
+
+  Example for library:
+  https://github.com/Bodmer/TFT_eSPI
+
+*/
+
+#include <TFT_eSPI.h>                 // Include the graphics library (this includes the sprite functions)
+
+TFT_eSPI tft = TFT_eSPI();            // Declare object "tft"
+
+TFT_eSpriteArena arena;               // Memory for the Sprites of one screen
+TFT_eSpritePool  pool;                // Memory for the icon Sprites
+
+#define ARENA_SIZE  (48 * 1024)       // Arena size in bytes
+#define ICON_SIZE   32                // Icon Sprite width and height in pixels
+#define ICONS       8                 // Number of icon Sprites in the pool
+#define SPRITES     6                 // Maximum Sprites per screen
+
+const uint8_t depth[] = { 16, 8, 4, 1 };
+
+// -------------------------------------------------------------------------
+// Setup
+// -------------------------------------------------------------------------
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  tft.init();
+  tft.setRotation(1);
+  tft.fillScreen(TFT_BLACK);
+
+  if (!arena.begin(ARENA_SIZE)) Serial.println("Arena allocation failed");
+
+  // The pool block size is the memory needed by one icon Sprite
+  size_t iconBytes = TFT_eSpriteAllocator::spriteSize(ICON_SIZE, ICON_SIZE, 16);
+  if (!pool.begin(iconBytes, ICONS)) Serial.println("Pool allocation failed");
+
+  randomSeed(1);
+}
+
+// -------------------------------------------------------------------------
+// Loop
+// -------------------------------------------------------------------------
+void loop()
+{
+  static uint32_t screen = 0;
+
+  openScreen();
+  swapIcons();
+
+  if ((++screen % 50) == 0) {
+    Serial.printf("Screens %u\n", screen);
+    Serial.printf("  Arena used %u, peak %u of %u bytes\n", arena.used(), arena.peak(), arena.capacity());
+    Serial.printf("  Pool  used %u, peak %u bytes, %u of %u blocks free\n",
+                  pool.used(), pool.peak(), pool.available(), pool.blocks());
+#ifdef ESP32
+    Serial.printf("  Largest free heap block %u bytes\n", ESP.getMaxAllocHeap());
+#endif
+  }
+}
+
+// -------------------------------------------------------------------------
+// Create the Sprites for one screen from the arena then delete them all
+// -------------------------------------------------------------------------
+void openScreen()
+{
+  TFT_eSprite* spr[SPRITES];
+  uint8_t n = 0;
+
+  size_t mark = arena.mark();
+
+  for (uint8_t i = 0; i < SPRITES; i++) {
+    TFT_eSprite* s = new TFT_eSprite(&tft);
+    s->setColorDepth(depth[random(4)]);
+    s->setAllocator(&arena);
+
+    int16_t w = random(20, tft.width()  / 2);
+    int16_t h = random(20, tft.height() / 2);
+
+    // createSprite() returns nullptr when the arena is full
+    if (s->createSprite(w, h)) {
+      s->setBitmapColor(random(0x10000), TFT_BLACK);
+      s->fillSprite(random(0x10000));
+      s->drawRect(0, 0, w, h, TFT_WHITE);
+      s->pushSprite(random(tft.width() - w), random(tft.height() - h));
+      spr[n++] = s;
+    }
+    else delete s;
+  }
+
+  // Delete in random order, only the last created Sprite is freed at once
+  while (n) {
+    uint8_t k = random(n);
+    delete spr[k];
+    spr[k] = spr[--n];
+  }
+
+  // Return all the memory used by the screen
+  arena.release(mark);
+}
+
+// -------------------------------------------------------------------------
+// Create and delete icon Sprites from the pool in any order
+// -------------------------------------------------------------------------
+void swapIcons()
+{
+  static TFT_eSprite* icon[ICONS] = { nullptr };
+
+  uint8_t k = random(ICONS);
+
+  if (icon[k]) {
+    delete icon[k];
+    icon[k] = nullptr;
+    return;
+  }
+
+  icon[k] = new TFT_eSprite(&tft);
+  icon[k]->setAllocator(&pool);
+  if (icon[k]->createSprite(ICON_SIZE, ICON_SIZE)) {
+    icon[k]->fillSprite(TFT_BLACK);
+    icon[k]->fillCircle(ICON_SIZE / 2, ICON_SIZE / 2, ICON_SIZE / 2 - 1, random(0x10000));
+    icon[k]->pushSprite(k * ICON_SIZE, tft.height() - ICON_SIZE);
+  }
+}
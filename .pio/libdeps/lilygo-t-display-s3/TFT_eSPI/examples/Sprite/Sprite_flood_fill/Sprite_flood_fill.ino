@@ -0,0 +1,127 @@
+/*
+  Sketch to show and benchmark the Sprite flood fill functions.
+
+  A random maze is drawn in a 320 x 170 Sprite at each colour depth,
+  then the area connected to the top left cell is flood filled. The
+  fill time is printed to the Serial Monitor and the Sprite is pushed
+  to the screen.
+
+  floodFill() fills all connected pixels that have the same colour as
+  the start pixel. floodFillTolerance() also fills pixels whose colour
+  channels (in the range 0-255) are within a tolerance of the start
+  pixel, the maze paths here have speckle noise added to show this.
+
+  The fill works on spans of pixels and keeps a stack of spans still
+  to be searched. The stack memory can be supplied by the sketch so
+  the stack size is under control. Each span uses 8 bytes and a maze
+  like this one needs several hundred spans. If the stack runs out the
+  functions return false and the fill may be incomplete.
+
+  Example for library:
+  https://github.com/Bodmer/TFT_eSPI
+
+*/
+
+// Width and height of sprite
+#define WIDTH  320
+#define HEIGHT 170
+
+// Maze cell size in pixels
+#define CELL 6
+
+#include <TFT_eSPI.h>                 // Include the graphics library (this includes the sprite functions)
+
+TFT_eSPI    tft = TFT_eSPI();         // Declare object "tft"
+
+TFT_eSprite spr = TFT_eSprite(&tft);  // Declare Sprite object "spr" with pointer to "tft" object
+
+uint8_t spanStack[8 * 1024];          // Flood fill span stack memory (1024 spans)
+
+// 16 colour palette for the 4 bit Sprite
+uint16_t cmap[16];
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+
+  // Initialise the TFT registers
+  tft.init();
+  tft.setRotation(1);
+  tft.fillScreen(TFT_BLACK);
+
+  for (uint8_t i = 0; i < 16; i++) cmap[i] = default_4bit_palette[i];
+}
+
+void loop()
+{
+  benchmark(16, false);
+  benchmark(16, true);
+  benchmark(8,  false);
+  benchmark(8,  true);
+  benchmark(4,  false);
+  benchmark(1,  false);
+  Serial.println();
+}
+
+// Draw a random maze, colours are palette indexes for 4 bpp and 0 or 1 for 1 bpp
+void drawMaze(uint32_t wall, uint32_t path)
+{
+  spr.fillSprite(path);
+
+  for (int32_t y = 0; y < HEIGHT; y += CELL)
+    for (int32_t x = 0; x < WIDTH; x += CELL)
+      if (random(4)) spr.drawFastHLine(x, y, CELL, wall);
+
+  for (int32_t x = 0; x < WIDTH; x += CELL)
+    for (int32_t y = 0; y < HEIGHT; y += CELL)
+      if (random(4)) spr.drawFastVLine(x, y, CELL, wall);
+}
+
+void benchmark(uint8_t depth, bool noise)
+{
+  spr.setColorDepth(depth);
+  if (!spr.createSprite(WIDTH, HEIGHT)) {
+    Serial.println("Sprite memory allocation failed");
+    return;
+  }
+
+  uint32_t wall = TFT_WHITE, path = TFT_BLACK, fill = TFT_RED;
+
+  if (depth == 4) {
+    spr.createPalette(cmap);
+    wall = 15; path = 0; fill = 2;
+  }
+  else if (depth == 1) {
+    spr.setBitmapColor(TFT_WHITE, TFT_BLACK);
+    wall = 1; path = 0; fill = 1;
+  }
+
+  randomSeed(depth);
+  drawMaze(wall, path);
+
+  // Speckle the paths with a dark grey that only a tolerance fill will cross
+  if (noise) {
+    for (uint16_t i = 0; i < 2000; i++) {
+      int32_t x = random(WIDTH), y = random(HEIGHT);
+      if (spr.readPixel(x, y) == TFT_BLACK) spr.drawPixel(x, y, 0x2104);
+    }
+  }
+
+  uint32_t dt = micros();
+  bool ok;
+  if (noise) ok = spr.floodFillTolerance(CELL / 2, CELL / 2, fill, 40, spanStack, sizeof(spanStack));
+  else       ok = spr.floodFill(CELL / 2, CELL / 2, fill, spanStack, sizeof(spanStack));
+  dt = micros() - dt;
+
+  Serial.print(depth); Serial.print(" bpp ");
+  Serial.print(noise ? "floodFillTolerance: " : "floodFill: ");
+  Serial.print(dt); Serial.print(" us");
+  if (!ok) Serial.print(" (span stack overflow)");
+  Serial.println();
+
+  spr.pushSprite(0, 0);
+  spr.deleteSprite();
+
+  delay(1000);
+}